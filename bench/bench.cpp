@@ -0,0 +1,133 @@
+#include "bench.h"
+
+#include "glgpu/log.h"
+
+namespace gl {
+
+static std::shared_ptr<RenderBackend> s_backend = nullptr;
+static RenderAPI s_render_api = RenderAPI::VULKAN;
+static std::filesystem::path s_capture_path;
+
+BenchState::BenchState(const char* p_name) : name(p_name) {}
+
+std::shared_ptr<RenderBackend> BenchState::get_backend() {
+	if (!s_backend) {
+		// No window is given so the backend runs headless, on machines without
+		// a GPU point the loader at lavapipe (see README).
+		RenderBackendCreateInfo info = {};
+		info.api = s_render_api;
+		s_backend = RenderBackend::create(info);
+	}
+
+	return s_backend;
+}
+
+void BenchState::report(const char* p_label, uint64_t p_iterations,
+		std::chrono::nanoseconds p_duration, uint64_t p_bytes) {
+	BenchResult result = {};
+	result.name = std::format("{}/{}", name, p_label);
+	result.iterations = p_iterations;
+	result.total_ms = p_duration.count() / 1e6;
+	result.ns_per_op = p_iterations > 0 ? double(p_duration.count()) / p_iterations : 0.0;
+	if (p_bytes > 0 && p_duration.count() > 0) {
+		result.bytes_per_second = double(p_bytes) / (p_duration.count() / 1e9);
+	}
+
+	GL_LOG_INFO("{:<48} {:>10} iters {:>14.1f} ns/op{}", result.name, result.iterations,
+			result.ns_per_op,
+			result.bytes_per_second
+					? std::format(" {:>10.1f} MB/s", *result.bytes_per_second / (1024.0 * 1024.0))
+					: "");
+
+	results.push_back(result);
+}
+
+const std::vector<BenchResult>& BenchState::get_results() const { return results; }
+
+std::vector<BenchEntry>& get_bench_registry() {
+	static std::vector<BenchEntry> s_registry;
+	return s_registry;
+}
+
+const std::filesystem::path& get_bench_capture_path() { return s_capture_path; }
+
+static bool _write_json(
+		const std::filesystem::path& p_path, const std::vector<BenchResult>& p_results) {
+	std::ofstream file(p_path);
+	if (!file.is_open()) {
+		GL_LOG_ERROR("[BENCH] Unable to open file '{}' for writing.", p_path.string());
+		return false;
+	}
+
+	file << "{\n\t\"benchmarks\": [";
+	for (size_t i = 0; i < p_results.size(); i++) {
+		const BenchResult& result = p_results[i];
+
+		file << (i == 0 ? "\n" : ",\n");
+		file << std::format("\t\t{{\"name\": \"{}\", \"iterations\": {}, \"total_ms\": {:.6f}, "
+							"\"ns_per_op\": {:.3f}",
+				result.name, result.iterations, result.total_ms, result.ns_per_op);
+		if (result.bytes_per_second) {
+			file << std::format(", \"bytes_per_second\": {:.1f}", *result.bytes_per_second);
+		}
+		file << "}";
+	}
+	file << "\n\t]\n}\n";
+
+	return file.good();
+}
+
+} //namespace gl
+
+using namespace gl;
+
+static void _print_usage() {
+	std::cout << "usage: glgpu_bench [--filter <substring>] [--output <file.json>] [--list] "
+				 "[--null] [--replay <capture>]\n";
+}
+
+int main(int argc, char** argv) {
+	std::string filter;
+	std::filesystem::path output_path;
+
+	for (int i = 1; i < argc; i++) {
+		const std::string arg = argv[i];
+		if (arg == "--filter" && i + 1 < argc) {
+			filter = argv[++i];
+		} else if (arg == "--output" && i + 1 < argc) {
+			output_path = argv[++i];
+		} else if (arg == "--replay" && i + 1 < argc) {
+			s_capture_path = argv[++i];
+		} else if (arg == "--null") {
+			// CPU side overhead only, no driver calls are made
+			s_render_api = RenderAPI::NULL_BACKEND;
+		} else if (arg == "--list") {
+			for (const BenchEntry& entry : get_bench_registry()) {
+				std::cout << entry.name << "\n";
+			}
+			return 0;
+		} else {
+			_print_usage();
+			return 1;
+		}
+	}
+
+	std::vector<BenchResult> results;
+	for (const BenchEntry& entry : get_bench_registry()) {
+		if (!filter.empty() && std::string(entry.name).find(filter) == std::string::npos) {
+			continue;
+		}
+
+		BenchState state(entry.name);
+		entry.function(state);
+
+		const std::vector<BenchResult>& entry_results = state.get_results();
+		results.insert(results.end(), entry_results.begin(), entry_results.end());
+	}
+
+	if (!output_path.empty() && !_write_json(output_path, results)) {
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "glgpu/assert.h"
+#include "glgpu/backend.h"
+
+namespace gl {
+
+struct BenchResult {
+	std::string name;
+	uint64_t iterations = 0;
+	double total_ms = 0.0;
+	double ns_per_op = 0.0;
+	// Only set for benchmarks moving data
+	std::optional<double> bytes_per_second;
+};
+
+/**
+ * State handed to every benchmark, owns the results of the run.
+ */
+class BenchState {
+public:
+	BenchState(const char* p_name);
+
+	// Headless backend shared by every benchmark, created on first use so
+	// CPU only benchmarks run without a device.
+	std::shared_ptr<RenderBackend> get_backend();
+
+	template <typename Fn>
+	void measure(const char* p_label, uint64_t p_iterations, Fn&& p_fn,
+			uint64_t p_bytes_per_iteration = 0) {
+		const auto begin = std::chrono::high_resolution_clock::now();
+		for (uint64_t i = 0; i < p_iterations; i++) {
+			p_fn(i);
+		}
+		const auto end = std::chrono::high_resolution_clock::now();
+
+		report(p_label, p_iterations, end - begin, p_iterations * p_bytes_per_iteration);
+	}
+
+	void report(const char* p_label, uint64_t p_iterations, std::chrono::nanoseconds p_duration,
+			uint64_t p_bytes = 0);
+
+	const std::vector<BenchResult>& get_results() const;
+
+private:
+	const char* name;
+	std::vector<BenchResult> results;
+};
+
+typedef void (*BenchFunction)(BenchState& p_state);
+
+struct BenchEntry {
+	const char* name;
+	BenchFunction function;
+};
+
+std::vector<BenchEntry>& get_bench_registry();
+
+// Capture given with `--replay`, empty if none
+const std::filesystem::path& get_bench_capture_path();
+
+struct BenchRegistrar {
+	BenchRegistrar(const char* p_name, BenchFunction p_function) {
+		get_bench_registry().push_back({ p_name, p_function });
+	}
+};
+
+#define GL_BENCH(name)                                                                             \
+	static void name(::gl::BenchState& state);                                                     \
+	static ::gl::BenchRegistrar GL_CONCAT_MACRO(_gl_bench_registrar_, name)(#name, name);          \
+	static void name(::gl::BenchState& state)
+
+} //namespace gl
@@ -0,0 +1,131 @@
+#include "bench.h"
+
+#include "glgpu/paged_allocator.h"
+
+namespace gl {
+
+// Roughly the size of a resource slot
+struct BenchResource {
+	uint8_t data[128];
+};
+
+// What callers had to do before the allocator was thread safe
+struct LockedAllocator {
+	PagedAllocator<BenchResource> allocator;
+	std::mutex mutex;
+
+	BenchResource* alloc() {
+		std::lock_guard<std::mutex> lock(mutex);
+		return allocator.alloc();
+	}
+
+	void free(BenchResource* p_resource) {
+		std::lock_guard<std::mutex> lock(mutex);
+		allocator.free(p_resource);
+	}
+};
+
+template <typename Allocator>
+static std::chrono::nanoseconds _run_contended(
+		Allocator& p_allocator, uint32_t p_thread_count, uint64_t p_iterations) {
+	// Batches keep several slots live per thread, like asset loading does
+	constexpr uint32_t BATCH_SIZE = 64;
+
+	std::atomic<uint32_t> ready = 0;
+	std::atomic<bool> start = false;
+
+	std::vector<std::thread> threads;
+	for (uint32_t t = 0; t < p_thread_count; t++) {
+		threads.emplace_back([&]() {
+			BenchResource* batch[BATCH_SIZE];
+
+			ready++;
+			while (!start.load(std::memory_order_acquire)) {
+				std::this_thread::yield();
+			}
+
+			for (uint64_t i = 0; i < p_iterations / BATCH_SIZE; i++) {
+				for (uint32_t j = 0; j < BATCH_SIZE; j++) {
+					batch[j] = p_allocator.alloc();
+					batch[j]->data[0] = uint8_t(j);
+				}
+				for (uint32_t j = 0; j < BATCH_SIZE; j++) {
+					p_allocator.free(batch[j]);
+				}
+			}
+		});
+	}
+
+	while (ready.load() != p_thread_count) {
+		std::this_thread::yield();
+	}
+
+	const auto begin = std::chrono::high_resolution_clock::now();
+	start.store(true, std::memory_order_release);
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	return std::chrono::high_resolution_clock::now() - begin;
+}
+
+GL_BENCH(paged_allocator_contention) {
+	constexpr uint64_t ITERATIONS = 1 << 20;
+
+	for (uint32_t thread_count : { 1, 2, 4, 8 }) {
+		const uint64_t total = ITERATIONS * thread_count;
+
+		PagedAllocator<BenchResource> allocator;
+		state.report(std::format("lock_free_{}_threads", thread_count).c_str(), total,
+				_run_contended(allocator, thread_count, ITERATIONS));
+
+		LockedAllocator locked_allocator;
+		state.report(std::format("mutex_{}_threads", thread_count).c_str(), total,
+				_run_contended(locked_allocator, thread_count, ITERATIONS));
+	}
+}
+
+// Reference point, every allocation goes through the general purpose heap.
+// Calls the operators directly, new and delete expressions may be elided.
+struct HeapAllocator {
+	BenchResource* alloc() { return new (::operator new(sizeof(BenchResource))) BenchResource; }
+	void free(BenchResource* p_resource) { ::operator delete(p_resource); }
+};
+
+template <typename Allocator>
+static void _measure_throughput(BenchState& p_state, const char* p_name, Allocator& p_allocator) {
+	constexpr uint64_t ITERATIONS = 1 << 22;
+	// Enough live objects to span many pages, like a scene worth of resources
+	constexpr uint32_t LIVE_COUNT = 1 << 16;
+
+	p_state.measure(std::format("{}_alloc_free", p_name).c_str(), ITERATIONS, [&](uint64_t i) {
+		BenchResource* resource = p_allocator.alloc();
+		resource->data[0] = uint8_t(i);
+		p_allocator.free(resource);
+	});
+
+	std::vector<BenchResource*> live(LIVE_COUNT);
+	p_state.measure(std::format("{}_bulk_alloc", p_name).c_str(), LIVE_COUNT, [&](uint64_t i) {
+		live[i] = p_allocator.alloc();
+		live[i]->data[0] = uint8_t(i);
+	});
+	p_state.measure(std::format("{}_bulk_free", p_name).c_str(), LIVE_COUNT,
+			[&](uint64_t i) { p_allocator.free(live[i]); });
+}
+
+GL_BENCH(paged_allocator_throughput) {
+	{
+		PagedAllocator<BenchResource> allocator;
+		_measure_throughput(state, "paged", allocator);
+	}
+	{
+		PagedAllocator<BenchResource> allocator(PagedAllocator<BenchResource>::DEFAULT_PAGE_SIZE,
+				true);
+		_measure_throughput(state, "paged_huge_pages", allocator);
+	}
+	{
+		HeapAllocator allocator;
+		_measure_throughput(state, "heap", allocator);
+	}
+}
+
+} //namespace gl
@@ -0,0 +1,228 @@
+#include "bench.h"
+
+#include "glgpu/log.h"
+
+namespace gl {
+
+// The only SPIR-V shipped with the repository is the compute demo shader, so
+// recording and pipeline benchmarks are built around compute work.
+static std::vector<uint32_t> _load_bench_shader() {
+	const std::filesystem::path path = GL_BENCH_SHADER_PATH;
+
+	std::ifstream file(path, std::ios::in | std::ios::binary);
+	if (!file.is_open()) {
+		GL_LOG_ERROR("[BENCH] Unable to open SPIRV file at path: '{}'.", path.string());
+		return {};
+	}
+
+	const size_t file_size = std::filesystem::file_size(path);
+
+	std::vector<uint32_t> buffer(file_size / sizeof(uint32_t));
+	file.read(reinterpret_cast<char*>(buffer.data()), buffer.size() * sizeof(uint32_t));
+	return buffer;
+}
+
+static Shader _create_bench_shader(RenderBackend* p_backend) {
+	SpirvEntry entry;
+	entry.byte_code = _load_bench_shader();
+	entry.stage = SHADER_STAGE_COMPUTE_BIT;
+
+	if (entry.byte_code.empty()) {
+		return GL_NULL_HANDLE;
+	}
+
+	return p_backend->shader_create_from_bytecode({ entry });
+}
+
+GL_BENCH(buffer_create_free) {
+	auto backend = state.get_backend();
+
+	constexpr uint64_t ITERATIONS = 10000;
+
+	std::vector<Buffer> buffers(ITERATIONS);
+
+	state.measure("gpu_4k_create", ITERATIONS, [&](uint64_t i) {
+		buffers[i] = backend->buffer_create(4096,
+				BUFFER_USAGE_STORAGE_BUFFER_BIT | BUFFER_USAGE_TRANSFER_DST_BIT,
+				MemoryAllocationType::GPU);
+	});
+	state.measure("gpu_4k_free", ITERATIONS, [&](uint64_t i) { backend->buffer_free(buffers[i]); });
+
+	state.measure("gpu_1m_create_free", ITERATIONS / 10, [&](uint64_t i) {
+		Buffer buffer = backend->buffer_create(1024 * 1024,
+				BUFFER_USAGE_STORAGE_BUFFER_BIT | BUFFER_USAGE_TRANSFER_DST_BIT,
+				MemoryAllocationType::GPU);
+		backend->buffer_free(buffer);
+	});
+
+	state.measure("cpu_staging_create_free", ITERATIONS, [&](uint64_t i) {
+		Buffer buffer = backend->buffer_create(
+				4096, BUFFER_USAGE_TRANSFER_SRC_BIT, MemoryAllocationType::CPU);
+		backend->buffer_free(buffer);
+	});
+}
+
+GL_BENCH(uniform_set_create) {
+	auto backend = state.get_backend();
+
+	Shader shader = _create_bench_shader(backend.get());
+	if (!shader) {
+		return;
+	}
+
+	Buffer buffer = backend->buffer_create(
+			4096, BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryAllocationType::GPU);
+
+	ShaderUniform uniform;
+	uniform.binding = 0;
+	uniform.type = ShaderUniformType::STORAGE_BUFFER;
+	uniform.data.push_back(buffer);
+
+	constexpr uint64_t ITERATIONS = 10000;
+
+	std::vector<UniformSet> uniform_sets(ITERATIONS);
+
+	state.measure("create", ITERATIONS, [&](uint64_t i) {
+		uniform_sets[i] = backend->uniform_set_create({ uniform }, shader, 0);
+	});
+	state.measure("free", ITERATIONS,
+			[&](uint64_t i) { backend->uniform_set_free(uniform_sets[i]); });
+
+	backend->buffer_free(buffer);
+	backend->shader_free(shader);
+}
+
+GL_BENCH(pipeline_create) {
+	auto backend = state.get_backend();
+
+	Shader shader = _create_bench_shader(backend.get());
+	if (!shader) {
+		return;
+	}
+
+	// The first creation compiles the shader, following ones are expected to
+	// hit the pipeline cache or the driver's internal cache.
+	state.measure("compute_cold", 1, [&](uint64_t i) {
+		Pipeline pipeline = backend->compute_pipeline_create(shader);
+		backend->pipeline_free(pipeline);
+	});
+
+	state.measure("compute_warm", 100, [&](uint64_t i) {
+		Pipeline pipeline = backend->compute_pipeline_create(shader);
+		backend->pipeline_free(pipeline);
+	});
+
+	backend->shader_free(shader);
+}
+
+GL_BENCH(command_recording) {
+	auto backend = state.get_backend();
+
+	Shader shader = _create_bench_shader(backend.get());
+	if (!shader) {
+		return;
+	}
+
+	Pipeline pipeline = backend->compute_pipeline_create(shader);
+
+	Buffer buffer = backend->buffer_create(
+			64 * sizeof(float), BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryAllocationType::GPU);
+
+	ShaderUniform uniform;
+	uniform.binding = 0;
+	uniform.type = ShaderUniformType::STORAGE_BUFFER;
+	uniform.data.push_back(buffer);
+
+	UniformSet uniform_set = backend->uniform_set_create({ uniform }, shader, 0);
+
+	CommandQueue queue = backend->queue_get(QueueType::GRAPHICS);
+	CommandPool command_pool = backend->command_pool_create(queue);
+	CommandBuffer cmd = backend->command_pool_allocate(command_pool);
+
+	constexpr uint64_t DISPATCHES = 10000;
+
+	// Bind + dispatch per iteration, matching the per draw cost of a renderer
+	// that does not filter redundant state.
+	backend->command_begin(cmd);
+	state.measure("bind_dispatch", DISPATCHES, [&](uint64_t i) {
+		backend->command_bind_compute_pipeline(cmd, pipeline);
+		backend->command_bind_uniform_sets(cmd, shader, 0, { uniform_set }, PipelineType::COMPUTE);
+		backend->command_dispatch(cmd, 1, 1, 1);
+	});
+	backend->command_end(cmd);
+	backend->command_reset(cmd);
+
+	backend->command_begin(cmd);
+	backend->command_bind_compute_pipeline(cmd, pipeline);
+	backend->command_bind_uniform_sets(cmd, shader, 0, { uniform_set }, PipelineType::COMPUTE);
+	state.measure("dispatch", DISPATCHES,
+			[&](uint64_t i) { backend->command_dispatch(cmd, 1, 1, 1); });
+	backend->command_end(cmd);
+
+	backend->command_pool_free(command_pool);
+	backend->uniform_set_free(uniform_set);
+	backend->buffer_free(buffer);
+	backend->pipeline_free(pipeline);
+	backend->shader_free(shader);
+}
+
+GL_BENCH(submit_latency) {
+	auto backend = state.get_backend();
+
+	CommandQueue queue = backend->queue_get(QueueType::GRAPHICS);
+	CommandPool command_pool = backend->command_pool_create(queue);
+	CommandBuffer cmd = backend->command_pool_allocate(command_pool);
+
+	Fence fence = backend->fence_create(false);
+
+	// Round trip of an empty command buffer, submit to fence signal
+	state.measure("empty_roundtrip", 1000, [&](uint64_t i) {
+		backend->command_reset(cmd);
+		backend->command_begin(cmd);
+		backend->command_end(cmd);
+
+		backend->queue_submit(queue, cmd, fence);
+		backend->fence_wait(fence);
+		backend->fence_reset(fence);
+	});
+
+	state.measure("immediate_submit", 1000, [&](uint64_t i) {
+		backend->command_immediate_submit([](CommandBuffer p_cmd) {}, QueueType::GRAPHICS);
+	});
+
+	backend->fence_free(fence);
+	backend->command_pool_free(command_pool);
+}
+
+GL_BENCH(upload_bandwidth) {
+	auto backend = state.get_backend();
+
+	constexpr uint64_t UPLOAD_SIZE = 64 * 1024 * 1024;
+
+	Buffer staging_buffer = backend->buffer_create(
+			UPLOAD_SIZE, BUFFER_USAGE_TRANSFER_SRC_BIT, MemoryAllocationType::CPU);
+	Buffer gpu_buffer = backend->buffer_create(
+			UPLOAD_SIZE, BUFFER_USAGE_TRANSFER_DST_BIT, MemoryAllocationType::GPU);
+
+	uint8_t* mapped_data = backend->buffer_map(staging_buffer);
+
+	std::vector<uint8_t> source(UPLOAD_SIZE, 0xAB);
+
+	state.measure("memcpy_to_staging", 10,
+			[&](uint64_t i) { memcpy(mapped_data, source.data(), UPLOAD_SIZE); }, UPLOAD_SIZE);
+
+	backend->buffer_unmap(staging_buffer);
+
+	state.measure("staging_to_gpu", 10, [&](uint64_t i) {
+		backend->command_immediate_submit([&](CommandBuffer p_cmd) {
+			BufferCopyRegion region = {};
+			region.size = UPLOAD_SIZE;
+			backend->command_copy_buffer(p_cmd, staging_buffer, gpu_buffer, { region });
+		});
+	}, UPLOAD_SIZE);
+
+	backend->buffer_free(gpu_buffer);
+	backend->buffer_free(staging_buffer);
+}
+
+} //namespace gl
@@ -0,0 +1,32 @@
+#include "bench.h"
+
+#include "glgpu/capture.h"
+#include "glgpu/log.h"
+
+namespace gl {
+
+GL_BENCH(capture_replay) {
+	const std::filesystem::path& path = get_bench_capture_path();
+	if (path.empty()) {
+		return;
+	}
+
+	auto backend = state.get_backend();
+
+	CaptureReplayer replayer(backend);
+	if (!replayer.load(path)) {
+		return;
+	}
+
+	// First replay warms up pipeline and driver caches
+	if (!replayer.replay()) {
+		return;
+	}
+
+	GL_LOG_INFO("[BENCH] Replaying '{}', {} calls over {} frames.", path.string(),
+			replayer.get_call_count(), replayer.get_frame_count());
+
+	state.measure("replay", 10, [&](uint64_t i) { replayer.replay(); });
+}
+
+} //namespace gl
@@ -0,0 +1,57 @@
+#include "bench.h"
+
+#include "glgpu/deletion_queue.h"
+
+namespace gl {
+
+// Layout of the deletion queue before deletors were stored inline
+struct StdFunctionDeletionQueue {
+	std::deque<std::function<void()>> deletors;
+
+	void push_function(std::function<void()>&& p_function) { deletors.push_back(p_function); }
+
+	void flush() {
+		for (auto it = deletors.rbegin(); it != deletors.rend(); it++) {
+			(*it)();
+		}
+
+		deletors.clear();
+	}
+};
+
+// Captures a handful of handles, the size of a typical deferred destroy and
+// past the small buffer of most `std::function` implementations
+struct DeferredDestroy {
+	uint64_t* destroyed;
+	uint64_t handles[3];
+
+	void operator()() const { *destroyed += handles[0] + handles[1] + handles[2]; }
+};
+
+template <typename Queue>
+static void _measure_frames(BenchState& p_state, const char* p_name, Queue& p_queue) {
+	constexpr uint64_t FRAMES = 64;
+	constexpr uint64_t DESTROYS_PER_FRAME = 20000;
+
+	uint64_t destroyed = 0;
+
+	p_state.measure(p_name, FRAMES * DESTROYS_PER_FRAME, [&](uint64_t i) {
+		p_queue.push_function(DeferredDestroy{ &destroyed, { i, i + 1, i + 2 } });
+
+		if ((i + 1) % DESTROYS_PER_FRAME == 0) {
+			p_queue.flush();
+		}
+	});
+
+	GL_ASSERT(destroyed > 0);
+}
+
+GL_BENCH(deletion_queue) {
+	StdFunctionDeletionQueue std_function_queue;
+	_measure_frames(state, "std_function_push_flush", std_function_queue);
+
+	DeletionQueue queue;
+	_measure_frames(state, "inplace_push_flush", queue);
+}
+
+} //namespace gl
@@ -0,0 +1,64 @@
+#include "bench.h"
+
+#include "glgpu/draw_queue.h"
+
+namespace gl {
+
+GL_BENCH(draw_queue) {
+	constexpr uint32_t DRAWS = 100000;
+	constexpr uint32_t ROUNDS = 10;
+
+	// Roughly the distribution of a large scene, few passes and pipelines,
+	// many materials and every draw at its own depth.
+	std::mt19937 rng(1234);
+	std::vector<uint64_t> keys(DRAWS);
+	for (uint64_t& key : keys) {
+		key = make_draw_sort_key(rng() % 4, rng() % 32, rng() % 512,
+				quantize_draw_sort_depth(std::uniform_real_distribution<float>(0, 1)(rng)));
+	}
+
+	// Sorting never touches the backend, keep the benchmark CPU only
+	DrawQueue queue(nullptr, DRAWS);
+
+	const DrawPacket packet = {};
+
+	std::chrono::nanoseconds push_time(0);
+	std::chrono::nanoseconds sort_time(0);
+	for (uint32_t round = 0; round < ROUNDS; round++) {
+		queue.clear();
+
+		const auto push_begin = std::chrono::high_resolution_clock::now();
+		for (uint64_t key : keys) {
+			queue.push(key, packet);
+		}
+		const auto sort_begin = std::chrono::high_resolution_clock::now();
+		queue.sort();
+		const auto sort_end = std::chrono::high_resolution_clock::now();
+
+		push_time += sort_begin - push_begin;
+		sort_time += sort_end - sort_begin;
+	}
+
+	GL_ASSERT(queue.is_sorted() && queue.size() == DRAWS);
+
+	state.report("push", uint64_t(DRAWS) * ROUNDS, push_time);
+	state.report("radix_sort", uint64_t(DRAWS) * ROUNDS, sort_time);
+
+	// Baseline, comparison sort of the same key and index pairs
+	std::chrono::nanoseconds std_sort_time(0);
+	std::vector<std::pair<uint64_t, uint32_t>> pairs(DRAWS);
+	for (uint32_t round = 0; round < ROUNDS; round++) {
+		for (uint32_t i = 0; i < DRAWS; i++) {
+			pairs[i] = { keys[i], i };
+		}
+
+		const auto begin = std::chrono::high_resolution_clock::now();
+		std::stable_sort(pairs.begin(), pairs.end(),
+				[](const auto& p_lhs, const auto& p_rhs) { return p_lhs.first < p_rhs.first; });
+		std_sort_time += std::chrono::high_resolution_clock::now() - begin;
+	}
+
+	state.report("std_stable_sort", uint64_t(DRAWS) * ROUNDS, std_sort_time);
+}
+
+} //namespace gl
@@ -0,0 +1,66 @@
+#include "bench.h"
+
+namespace gl {
+
+// Comparable in size to a validation message with an object handle in it,
+// worded so the lines printed by the bench are not mistaken for real ones
+static void _log_message(uint64_t p_index) {
+	GL_LOG_WARNING("[BENCH] Sample message: object 0x{:x} is in use by command buffer {}",
+			p_index, p_index % 3);
+}
+
+static void _log_message_rate_limited(uint64_t p_index) {
+	GL_LOG_WARNING_RATE_LIMITED(
+			"[BENCH] Sample message: object 0x{:x} is in use by command buffer {}", p_index,
+			p_index % 3);
+}
+
+GL_BENCH(log) {
+	constexpr uint64_t ITERATIONS = 200000;
+
+	const LogLevel level = Logger::get_level();
+
+	// Timed by hand, the report is logged at INFO and would be filtered too
+	Logger::set_level(LOG_LEVEL_ERROR);
+	const auto filtered_begin = std::chrono::high_resolution_clock::now();
+	for (uint64_t i = 0; i < ITERATIONS; i++) {
+		_log_message(i);
+	}
+	const auto filtered_end = std::chrono::high_resolution_clock::now();
+	Logger::set_level(level);
+
+	state.report("filtered", ITERATIONS, filtered_end - filtered_begin);
+
+	// Everything past the first burst is only counted
+	state.measure("rate_limited", ITERATIONS, [](uint64_t i) { _log_message_rate_limited(i); });
+
+	const std::filesystem::path path =
+			std::filesystem::temp_directory_path() / "glgpu_bench_log.bin";
+
+	const bool async = Logger::is_async();
+	Logger::set_async(true);
+
+	if (Logger::set_binary_sink(path)) {
+		// Stays under the ring capacity so nothing is dropped
+		constexpr uint64_t BATCH = 512;
+
+		const auto begin = std::chrono::high_resolution_clock::now();
+		for (uint64_t i = 0; i < ITERATIONS; i++) {
+			_log_message(i);
+			if ((i + 1) % BATCH == 0) {
+				Logger::flush();
+			}
+		}
+		const auto end = std::chrono::high_resolution_clock::now();
+
+		// Reported once the sink is closed, the report is logged as well
+		Logger::set_binary_sink({});
+		std::filesystem::remove(path);
+
+		state.report("binary_async", ITERATIONS, end - begin);
+	}
+
+	Logger::set_async(async);
+}
+
+} //namespace gl
@@ -0,0 +1,145 @@
+#include "bench.h"
+
+#include "glgpu/instance_batch.h"
+#include "glgpu/mat_batch.h"
+
+namespace gl {
+
+// Enough instances to leave the L2 cache, like a large scene
+constexpr size_t MATH_INSTANCE_COUNT = 64 * 1024;
+
+static Mat4 _make_transform(size_t p_index) {
+	const float f = float(p_index % 1024);
+	return Mat4::translate({ f, -f, 0.5f * f }) * Mat4::rotate(0.01f * f, { 0.0f, 1.0f, 0.0f }) *
+			Mat4::scale({ 1.0f + 0.001f * f, 1.0f, 1.0f });
+}
+
+// Reports the time per instance over a few rounds of the whole array
+template <typename Fn>
+static void _measure_batch(
+		BenchState& p_state, const std::string& p_label, uint64_t p_bytes_per_instance, Fn&& p_fn) {
+	constexpr uint64_t ROUNDS = 16;
+
+	const auto begin = std::chrono::high_resolution_clock::now();
+	for (uint64_t i = 0; i < ROUNDS; i++) {
+		p_fn();
+	}
+	const auto end = std::chrono::high_resolution_clock::now();
+
+	p_state.report(p_label.c_str(), ROUNDS * MATH_INSTANCE_COUNT, end - begin,
+			ROUNDS * MATH_INSTANCE_COUNT * p_bytes_per_instance);
+}
+
+GL_BENCH(math) {
+	std::vector<Mat4> models(MATH_INSTANCE_COUNT);
+	for (size_t i = 0; i < models.size(); i++) {
+		models[i] = _make_transform(i);
+	}
+
+	std::vector<Mat4> results(MATH_INSTANCE_COUNT);
+
+	const Mat4 view_proj = Mat4::perspective(as_radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f) *
+			Mat4::look_at({ 0.0f, 2.0f, 5.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f });
+
+	std::vector<float> xs(MATH_INSTANCE_COUNT), ys(MATH_INSTANCE_COUNT),
+			zs(MATH_INSTANCE_COUNT), ws(MATH_INSTANCE_COUNT);
+	for (size_t i = 0; i < MATH_INSTANCE_COUNT; i++) {
+		xs[i] = float(i % 97);
+		ys[i] = float(i % 89);
+		zs[i] = float(i % 83);
+	}
+
+	const Vec4SoA points = { xs.data(), ys.data(), zs.data(), nullptr };
+	std::vector<float> out_x(MATH_INSTANCE_COUNT), out_y(MATH_INSTANCE_COUNT),
+			out_z(MATH_INSTANCE_COUNT), out_w(MATH_INSTANCE_COUNT);
+	const Vec4SoA transformed = { out_x.data(), out_y.data(), out_z.data(), out_w.data() };
+
+	// Instances spread around the camera so roughly half of them are culled
+	std::vector<float> instance_data[10];
+	for (std::vector<float>& component : instance_data) {
+		component.resize(MATH_INSTANCE_COUNT);
+	}
+	for (size_t i = 0; i < MATH_INSTANCE_COUNT; i++) {
+		const float angle = 0.001f * float(i);
+		instance_data[0][i] = float(i % 101) - 50.0f;
+		instance_data[1][i] = float(i % 7);
+		instance_data[2][i] = float(i % 103) - 51.0f;
+		instance_data[3][i] = 0.0f;
+		instance_data[4][i] = std::sin(angle);
+		instance_data[5][i] = 0.0f;
+		instance_data[6][i] = std::cos(angle);
+		const float scale = 1.0f + 0.001f * float(i % 64);
+		instance_data[7][i] = scale;
+		instance_data[8][i] = scale;
+		instance_data[9][i] = scale;
+	}
+
+	InstanceWriteInfo write_info = {};
+	write_info.transforms = { instance_data[0].data(), instance_data[1].data(),
+		instance_data[2].data(), instance_data[3].data(), instance_data[4].data(),
+		instance_data[5].data(), instance_data[6].data(), instance_data[7].data(),
+		instance_data[8].data(), instance_data[9].data() };
+	write_info.count = MATH_INSTANCE_COUNT;
+
+	const Frustum frustum = Frustum::from_matrix(view_proj);
+
+	InstanceWriteInfo cull_info = write_info;
+	cull_info.frustum = &frustum;
+	cull_info.bounding_radius = 1.0f;
+	cull_info.compact = true;
+
+	// Stands in for a mapped instance buffer, which is at least 64 byte aligned
+	Mat4* instances = (Mat4*)::operator new(
+			MATH_INSTANCE_COUNT * sizeof(Mat4), std::align_val_t(64));
+
+	// The matrices composed one by one and copied, as callers did before
+	_measure_batch(state, "instance_write_per_instance", sizeof(Mat4), [&]() {
+		const InstanceTransformSoA& t = write_info.transforms;
+		for (size_t i = 0; i < MATH_INSTANCE_COUNT; i++) {
+			const float angle = 2.0f * std::atan2(t.rotation_y[i], t.rotation_w[i]);
+			const Mat4 model =
+					Mat4::translate({ t.position_x[i], t.position_y[i], t.position_z[i] }) *
+					Mat4::rotate(angle, { 0.0f, 1.0f, 0.0f }) *
+					Mat4::scale({ t.scale_x[i], t.scale_y[i], t.scale_z[i] });
+			memcpy(&instances[i], &model, sizeof(Mat4));
+		}
+	});
+
+	const SimdLevel detected = simd_get_level();
+
+	for (SimdLevel level : { SimdLevel::SCALAR, SimdLevel::BASELINE, SimdLevel::AVX2 }) {
+		simd_set_level(level);
+		if (simd_get_level() != level) {
+			continue; // Not supported by this CPU
+		}
+
+		const char* suffix = simd_level_to_string(level);
+
+		_measure_batch(state, std::format("mat4_mul_batch_{}", suffix), sizeof(Mat4), [&]() {
+			mat4_mul_batch(view_proj, models.data(), results.data(), MATH_INSTANCE_COUNT);
+		});
+
+		_measure_batch(state, std::format("mat4_inverse_batch_{}", suffix), sizeof(Mat4), [&]() {
+			mat4_inverse_batch(models.data(), results.data(), MATH_INSTANCE_COUNT);
+		});
+
+		_measure_batch(state, std::format("mat4_transpose_batch_{}", suffix), sizeof(Mat4), [&]() {
+			mat4_transpose_batch(models.data(), results.data(), MATH_INSTANCE_COUNT);
+		});
+
+		_measure_batch(state, std::format("mat4_transform_soa_{}", suffix), sizeof(float) * 3,
+				[&]() { mat4_transform_soa(view_proj, points, transformed, MATH_INSTANCE_COUNT); });
+
+		_measure_batch(state, std::format("instance_write_{}", suffix), sizeof(Mat4),
+				[&]() { instance_write_transforms(write_info, instances); });
+
+		_measure_batch(state, std::format("instance_write_culled_{}", suffix), sizeof(Mat4),
+				[&]() { instance_write_transforms(cull_info, instances); });
+	}
+
+	::operator delete(instances, std::align_val_t(64));
+
+	simd_set_level(detected);
+}
+
+} //namespace gl
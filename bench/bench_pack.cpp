@@ -0,0 +1,117 @@
+#include "bench.h"
+
+#include "glgpu/frame_capture.h"
+#include "glgpu/pack.h"
+#include "glgpu/simd.h"
+
+namespace gl {
+
+// A large mesh worth of float components
+constexpr size_t PACK_COMPONENT_COUNT = 1024 * 1024;
+
+template <typename Fn>
+static void _measure_pack(
+		BenchState& p_state, const std::string& p_label, uint64_t p_bytes_written, Fn&& p_fn) {
+	constexpr uint64_t ROUNDS = 16;
+
+	const auto begin = std::chrono::high_resolution_clock::now();
+	for (uint64_t i = 0; i < ROUNDS; i++) {
+		p_fn();
+	}
+	const auto end = std::chrono::high_resolution_clock::now();
+
+	p_state.report(p_label.c_str(), ROUNDS * PACK_COMPONENT_COUNT, end - begin,
+			ROUNDS * p_bytes_written);
+}
+
+GL_BENCH(pack) {
+	std::vector<float> components(PACK_COMPONENT_COUNT);
+	for (size_t i = 0; i < PACK_COMPONENT_COUNT; i++) {
+		components[i] = std::sin(0.01f * float(i));
+	}
+
+	// Stands in for a mapped staging buffer
+	std::vector<uint8_t> staging(PACK_COMPONENT_COUNT * sizeof(float));
+
+	_measure_pack(state, "memcpy_float", PACK_COMPONENT_COUNT * sizeof(float), [&]() {
+		memcpy(staging.data(), components.data(), PACK_COMPONENT_COUNT * sizeof(float));
+	});
+
+	const SimdLevel detected = simd_get_level();
+
+	for (SimdLevel level : { SimdLevel::SCALAR, SimdLevel::BASELINE, SimdLevel::AVX2 }) {
+		simd_set_level(level);
+		if (simd_get_level() != level) {
+			continue; // Not supported by this CPU
+		}
+
+		const char* suffix = simd_level_to_string(level);
+
+		_measure_pack(state, std::format("pack_half_{}", suffix),
+				PACK_COMPONENT_COUNT * sizeof(uint16_t), [&]() {
+					pack_half(components.data(), (uint16_t*)staging.data(), PACK_COMPONENT_COUNT);
+				});
+
+		_measure_pack(state, std::format("unpack_half_{}", suffix),
+				PACK_COMPONENT_COUNT * sizeof(float), [&]() {
+					unpack_half((const uint16_t*)staging.data(), components.data(),
+							PACK_COMPONENT_COUNT);
+				});
+
+		_measure_pack(state, std::format("pack_unorm8_{}", suffix), PACK_COMPONENT_COUNT, [&]() {
+			pack_unorm8(components.data(), staging.data(), PACK_COMPONENT_COUNT);
+		});
+
+		_measure_pack(state, std::format("pack_snorm16_{}", suffix),
+				PACK_COMPONENT_COUNT * sizeof(int16_t), [&]() {
+					pack_snorm16(components.data(), (int16_t*)staging.data(), PACK_COMPONENT_COUNT);
+				});
+
+		_measure_pack(state, std::format("pack_snorm_2_10_10_10_{}", suffix),
+				PACK_COMPONENT_COUNT, [&]() {
+					pack_snorm_2_10_10_10(components.data(), (uint32_t*)staging.data(),
+							PACK_COMPONENT_COUNT / 4);
+				});
+	}
+
+	simd_set_level(detected);
+}
+
+GL_BENCH(frame_convert) {
+	// A 1024x1024 BGRA swapchain image, one pixel per component of the pack bench
+	const Vec2u size = { 1024, 1024 };
+	static_assert(PACK_COMPONENT_COUNT == 1024 * 1024);
+
+	std::vector<uint8_t> pixels(PACK_COMPONENT_COUNT * 4);
+	for (size_t i = 0; i < pixels.size(); i++) {
+		pixels[i] = uint8_t(i * 7 + (i >> 12));
+	}
+
+	std::vector<uint8_t> converted(pixels.size());
+	uint8_t* y = converted.data();
+	uint8_t* u = y + PACK_COMPONENT_COUNT;
+	uint8_t* v = u + PACK_COMPONENT_COUNT / 4;
+
+	const SimdLevel detected = simd_get_level();
+
+	for (SimdLevel level : { SimdLevel::SCALAR, SimdLevel::BASELINE }) {
+		simd_set_level(level);
+		if (simd_get_level() != level) {
+			continue; // Not supported by this CPU
+		}
+
+		const char* suffix = simd_level_to_string(level);
+
+		_measure_pack(state, std::format("swap_red_blue_{}", suffix), pixels.size(), [&]() {
+			convert_swap_red_blue(pixels.data(), converted.data(), PACK_COMPONENT_COUNT);
+		});
+
+		_measure_pack(state, std::format("bgra8_to_yuv420_{}", suffix),
+				PACK_COMPONENT_COUNT * 3 / 2,
+				[&]() { convert_rgba8_to_yuv420(pixels.data(), size, true, y, u, v); });
+	}
+
+	simd_set_level(detected);
+}
+
+} //namespace gl
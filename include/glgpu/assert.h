@@ -13,6 +13,8 @@
 
 #define GL_EXPAND_MACRO(x) x
 #define GL_STRINGIFY_MACRO(x) #x
+#define GL_CONCAT_MACRO_IMPL(x, y) x##y
+#define GL_CONCAT_MACRO(x, y) GL_CONCAT_MACRO_IMPL(x, y)
 
 #define GL_INTERNAL_ASSERT_IMPL(check, msg, ...)                                                   \
 	if (!(check)) {                                                                                \
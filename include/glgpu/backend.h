@@ -25,6 +25,31 @@ struct RenderBackendCreateInfo {
 	void* native_window_handle = nullptr; // HWND or XWindow
 };
 
+/**
+ * Backend API call counters accumulated since the last `reset_frame_stats`.
+ * `descriptor_pools_live` is a gauge and is not affected by resets.
+ */
+struct FrameStats {
+	// Indirect draws count the `p_draw_count` draws they can issue
+	uint64_t draw_calls = 0;
+	uint64_t dispatches = 0;
+	uint64_t pipeline_binds = 0;
+	uint64_t uniform_set_binds = 0;
+	// Vertex and index buffer binds
+	uint64_t buffer_binds = 0;
+	uint64_t barriers = 0;
+	uint64_t submits = 0;
+	uint64_t bytes_copied = 0;
+	uint64_t resources_created = 0;
+	uint64_t resources_destroyed = 0;
+	uint64_t descriptor_pools_live = 0;
+	// Binds skipped because the command buffer already had the same state
+	uint64_t filtered_pipeline_binds = 0;
+	uint64_t filtered_uniform_set_binds = 0;
+	uint64_t filtered_buffer_binds = 0;
+	uint64_t filtered_dynamic_states = 0;
+};
+
 /**
  * Abstract class responsible for communicating with the GPU.
  */
@@ -46,25 +71,50 @@ public:
 	virtual CommandQueue queue_get(QueueType p_type) = 0;
 	virtual uint32_t get_max_msaa_samples() const = 0;
 
+	// Counters are updated from every recording thread, a snapshot taken while
+	// other threads record is not guaranteed to be consistent across fields.
+	virtual FrameStats get_frame_stats() const = 0;
+	virtual void reset_frame_stats() = 0;
+
 	// =========================================================================
 	// Swapchain
 	// =========================================================================
 
 	virtual Swapchain swapchain_create() = 0;
 
-	virtual void swapchain_resize(CommandQueue p_cmd_queue, Swapchain p_swapchain, Vec2u p_size,
-			bool p_vsync = false) = 0;
+	// Recreates the swapchain without waiting for the device, the previous one
+	// is retired and freed after its images have been presented. Image
+	// handles from before the resize become invalid.
+	virtual void swapchain_resize(
+			CommandQueue p_cmd_queue, Swapchain p_swapchain, const SwapchainCreateInfo& p_info) = 0;
 
 	virtual size_t swapchain_get_image_count(Swapchain p_swapchain) = 0;
 	virtual std::vector<Image> swapchain_get_images(Swapchain p_swapchain) = 0;
 
-	// Returns Image or Error if resize is needed
-
-	virtual Result<Image, Error> swapchain_acquire_image(
-			Swapchain p_swapchain, Semaphore p_semaphore, uint32_t* o_image_index = nullptr) = 0;
+	// Returns the next image, waiting at most `p_timeout` nanoseconds for one
+	// to become available. Fails with `NOT_READY` if none did, nothing is
+	// signaled then, and with `SWAPCHAIN_OUT_OF_DATE` if a resize is needed.
+	// A swapchain that is merely suboptimal still returns its image, the frame
+	// can be presented and `queue_present` asks for the resize afterwards.
+	virtual Result<Image, Error> swapchain_acquire_image(Swapchain p_swapchain,
+			Semaphore p_semaphore, uint64_t p_timeout = UINT64_MAX,
+			uint32_t* o_image_index = nullptr) = 0;
+
+	// Non-blocking acquire, lets the caller keep working on the CPU until an
+	// image is available instead of stalling inside the acquire
+	Result<Image, Error> swapchain_try_acquire_image(
+			Swapchain p_swapchain, Semaphore p_semaphore, uint32_t* o_image_index = nullptr) {
+		return swapchain_acquire_image(p_swapchain, p_semaphore, 0, o_image_index);
+	}
 
 	virtual Vec2u swapchain_get_extent(Swapchain p_swapchain) = 0;
 	virtual DataFormat swapchain_get_format(Swapchain p_swapchain) = 0;
+
+	// Swapchains resized without a surface are backed by offscreen images that
+	// are read back once presented. Moves the oldest finished frame to
+	// `o_frame`, reusing the storage it had. Returns false if there is none or
+	// the swapchain is not headless.
+	virtual bool swapchain_pop_frame(Swapchain p_swapchain, SwapchainFrame* o_frame) = 0;
 	virtual void swapchain_free(Swapchain p_swapchain) = 0;
 
 	// =========================================================================
@@ -140,6 +190,52 @@ public:
 	virtual Semaphore semaphore_create() = 0;
 	virtual void semaphore_free(Semaphore p_semaphore) = 0;
 
+	// =========================================================================
+	// Queries
+	// =========================================================================
+
+	virtual QueryPool query_pool_create(QueryType p_type, uint32_t p_query_count) = 0;
+	virtual void query_pool_free(QueryPool p_query_pool) = 0;
+
+	// Returns false if the results are not available yet, never blocks.
+	// `o_results` must hold `p_query_count * get_query_result_count(type)` values
+
+	virtual bool query_pool_get_results(QueryPool p_query_pool, uint32_t p_first_query,
+			uint32_t p_query_count, uint64_t* o_results) = 0;
+
+	// Nanoseconds per timestamp tick, 0 if timestamps are not supported
+	virtual float get_timestamp_period() const = 0;
+
+	// Meaningful low bits of a timestamp, the rest is garbage and the counter
+	// wraps around at this width
+	virtual uint32_t get_timestamp_valid_bits() const = 0;
+
+	// Whether `QueryType::PIPELINE_STATISTICS` pools can be created
+	virtual bool is_pipeline_statistics_supported() const = 0;
+
+	// =========================================================================
+	// Debugging
+	// =========================================================================
+
+	// Names show up in validation messages, captures and external profilers.
+	// No-ops if the driver does not support it and in dist builds.
+
+	virtual void buffer_set_name(Buffer p_buffer, const char* p_name) = 0;
+	virtual void image_set_name(Image p_image, const char* p_name) = 0;
+	virtual void sampler_set_name(Sampler p_sampler, const char* p_name) = 0;
+	virtual void command_pool_set_name(CommandPool p_command_pool, const char* p_name) = 0;
+	virtual void command_buffer_set_name(CommandBuffer p_command_buffer, const char* p_name) = 0;
+	virtual void queue_set_name(CommandQueue p_queue, const char* p_name) = 0;
+	virtual void render_pass_set_name(RenderPass p_render_pass, const char* p_name) = 0;
+	virtual void frame_buffer_set_name(FrameBuffer p_frame_buffer, const char* p_name) = 0;
+	virtual void swapchain_set_name(Swapchain p_swapchain, const char* p_name) = 0;
+	virtual void pipeline_set_name(Pipeline p_pipeline, const char* p_name) = 0;
+	virtual void shader_set_name(Shader p_shader, const char* p_name) = 0;
+	virtual void uniform_set_set_name(UniformSet p_uniform_set, const char* p_name) = 0;
+	virtual void fence_set_name(Fence p_fence, const char* p_name) = 0;
+	virtual void semaphore_set_name(Semaphore p_semaphore, const char* p_name) = 0;
+	virtual void query_pool_set_name(QueryPool p_query_pool, const char* p_name) = 0;
+
 	// =========================================================================
 	// Command Submission & Presentation
 	// =========================================================================
@@ -150,6 +246,8 @@ public:
 
 	// Returns true if success, false if resize needed
 
+	// Returns false if the swapchain has to be resized, including when the
+	// image was acquired from a suboptimal swapchain and presented anyway
 	virtual bool queue_present(CommandQueue p_queue, Swapchain p_swapchain,
 			Semaphore p_wait_semaphore = GL_NULL_HANDLE) = 0;
 
@@ -245,6 +343,11 @@ public:
 	virtual void command_copy_buffer_to_image(CommandBuffer p_cmd, Buffer p_src_buffer,
 			Image p_dst_image, std::vector<BufferImageCopyRegion> p_regions) = 0;
 
+	// The image has to be in TRANSFER_SRC_OPTIMAL layout. The buffer can be read
+	// from the host once the submission finished.
+	virtual void command_copy_image_to_buffer(CommandBuffer p_cmd, Image p_src_image,
+			Buffer p_dst_buffer, std::vector<BufferImageCopyRegion> p_regions) = 0;
+
 	virtual void command_copy_image_to_image(CommandBuffer p_cmd, Image p_src_image,
 			Image p_dst_image, const Vec2u& src_extent, const Vec2u& p_dst_extent,
 			uint32_t p_src_mip_level = 0, uint32_t p_dst_mip_level = 0) = 0;
@@ -252,6 +355,28 @@ public:
 	virtual void command_transition_image(CommandBuffer p_cmd, Image p_image,
 			ImageLayout p_current_layout, ImageLayout p_new_layout, uint32_t p_base_mip_level = 0,
 			uint32_t p_level_count = GL_REMAINING_MIP_LEVELS) = 0;
+
+	// Queries
+
+	// Must be recorded outside of a render pass
+	virtual void command_reset_query_pool(CommandBuffer p_cmd, QueryPool p_query_pool,
+			uint32_t p_first_query, uint32_t p_query_count) = 0;
+
+	virtual void command_write_timestamp(
+			CommandBuffer p_cmd, QueryPool p_query_pool, uint32_t p_query_index) = 0;
+
+	// Occlusion and pipeline statistics queries, queries of the same type can not be nested
+
+	virtual void command_begin_query(CommandBuffer p_cmd, QueryPool p_query_pool,
+			uint32_t p_query_index, bool p_precise = false) = 0;
+	virtual void command_end_query(
+			CommandBuffer p_cmd, QueryPool p_query_pool, uint32_t p_query_index) = 0;
+
+	// Debug Labels
+
+	virtual void command_begin_label(
+			CommandBuffer p_cmd, const char* p_name, const Color& p_color = COLOR_WHITE) = 0;
+	virtual void command_end_label(CommandBuffer p_cmd) = 0;
 };
 
 } // namespace gl
@@ -0,0 +1,531 @@
+#pragma once
+
+#include "glgpu/backend.h"
+
+namespace gl {
+
+// Id of a captured handle, 0 is reserved for null handles
+typedef uint32_t CaptureHandle;
+
+constexpr uint32_t CAPTURE_MAGIC = 0x50434c47; // "GLCP"
+constexpr uint32_t CAPTURE_VERSION = 3;
+
+enum class CaptureCall : uint16_t {
+	// Device
+	DEVICE_WAIT,
+	QUEUE_GET,
+	// Swapchain
+	SWAPCHAIN_CREATE,
+	SWAPCHAIN_RESIZE,
+	SWAPCHAIN_GET_IMAGES,
+	SWAPCHAIN_ACQUIRE_IMAGE,
+	SWAPCHAIN_FREE,
+	// Resources
+	BUFFER_CREATE,
+	BUFFER_FREE,
+	BUFFER_MAP,
+	BUFFER_UNMAP,
+	BUFFER_INVALIDATE,
+	BUFFER_FLUSH,
+	BUFFER_DATA,
+	IMAGE_CREATE,
+	IMAGE_FREE,
+	SAMPLER_CREATE,
+	SAMPLER_FREE,
+	// Shaders & pipelines
+	SHADER_CREATE,
+	SHADER_FREE,
+	RENDER_PIPELINE_CREATE,
+	COMPUTE_PIPELINE_CREATE,
+	PIPELINE_FREE,
+	UNIFORM_SET_CREATE,
+	UNIFORM_SET_FREE,
+	RENDER_PASS_CREATE,
+	RENDER_PASS_DESTROY,
+	FRAME_BUFFER_CREATE,
+	FRAME_BUFFER_DESTROY,
+	// Synchronization
+	FENCE_CREATE,
+	FENCE_FREE,
+	FENCE_WAIT,
+	FENCE_RESET,
+	SEMAPHORE_CREATE,
+	SEMAPHORE_FREE,
+	// Queries
+	QUERY_POOL_CREATE,
+	QUERY_POOL_FREE,
+	QUERY_POOL_GET_RESULTS,
+	// Debugging
+	SET_NAME,
+	// Submission
+	QUEUE_SUBMIT,
+	QUEUE_PRESENT,
+	COMMAND_POOL_CREATE,
+	COMMAND_POOL_FREE,
+	COMMAND_POOL_ALLOCATE,
+	COMMAND_POOL_RESET,
+	IMMEDIATE_SUBMIT_BEGIN,
+	IMMEDIATE_SUBMIT_END,
+	// Recording
+	COMMAND_BEGIN,
+	COMMAND_END,
+	COMMAND_RESET,
+	COMMAND_BEGIN_RENDER_PASS,
+	COMMAND_END_RENDER_PASS,
+	COMMAND_BEGIN_RENDERING,
+	COMMAND_END_RENDERING,
+	COMMAND_BIND_GRAPHICS_PIPELINE,
+	COMMAND_BIND_COMPUTE_PIPELINE,
+	COMMAND_BIND_VERTEX_BUFFERS,
+	COMMAND_BIND_INDEX_BUFFER,
+	COMMAND_BIND_UNIFORM_SETS,
+	COMMAND_PUSH_CONSTANTS,
+	COMMAND_DRAW,
+	COMMAND_DRAW_INDEXED,
+	COMMAND_DRAW_INDEXED_INDIRECT,
+	COMMAND_DISPATCH,
+	COMMAND_SET_VIEWPORT,
+	COMMAND_SET_SCISSOR,
+	COMMAND_SET_DEPTH_BIAS,
+	COMMAND_CLEAR_COLOR,
+	COMMAND_COPY_BUFFER,
+	COMMAND_BUFFER_MEMORY_BARRIER,
+	COMMAND_COPY_BUFFER_TO_IMAGE,
+	COMMAND_COPY_IMAGE_TO_BUFFER,
+	COMMAND_COPY_IMAGE_TO_IMAGE,
+	COMMAND_TRANSITION_IMAGE,
+	COMMAND_RESET_QUERY_POOL,
+	COMMAND_WRITE_TIMESTAMP,
+	COMMAND_BEGIN_QUERY,
+	COMMAND_END_QUERY,
+	COMMAND_BEGIN_LABEL,
+	COMMAND_END_LABEL,
+	MAX,
+};
+
+/**
+ * `RenderBackend` decorator serializing every call, with its arguments,
+ * created resources and the contents written into mapped buffers, into a
+ * binary capture file that `CaptureReplayer` can execute on any backend.
+ *
+ * Capturing starts with the decorator, resources created through the wrapped
+ * backend directly are unknown to the capture. Mapped buffers are diffed
+ * against a shadow copy at unmap, flush and submission time so only the
+ * modified range is written. Thread safe.
+ *
+ * Buffer device addresses written into buffers or push constants are
+ * replayed as is and will not be valid on another device.
+ */
+class CaptureRenderBackend : public RenderBackend {
+public:
+	CaptureRenderBackend(
+			std::shared_ptr<RenderBackend> p_backend, const std::filesystem::path& p_path);
+	virtual ~CaptureRenderBackend();
+
+	bool is_open() const;
+
+	// Writes the pending stream to disk
+	void flush();
+
+	// =========================================================================
+	// Device & Surface
+	// =========================================================================
+
+	void device_wait() override;
+
+	Error attach_surface(void* p_connection_handle, void* p_window_handle) override;
+
+	bool is_swapchain_supported() override;
+
+	CommandQueue queue_get(QueueType p_type) override;
+
+	uint32_t get_max_msaa_samples() const override;
+
+	FrameStats get_frame_stats() const override;
+
+	void reset_frame_stats() override;
+
+	// =========================================================================
+	// Swapchain
+	// =========================================================================
+
+	Swapchain swapchain_create() override;
+
+	void swapchain_resize(CommandQueue p_cmd_queue, Swapchain p_swapchain,
+			const SwapchainCreateInfo& p_info) override;
+
+	size_t swapchain_get_image_count(Swapchain p_swapchain) override;
+
+	std::vector<Image> swapchain_get_images(Swapchain p_swapchain) override;
+
+	Result<Image, Error> swapchain_acquire_image(Swapchain p_swapchain, Semaphore p_semaphore,
+			uint64_t p_timeout, uint32_t* o_image_index) override;
+
+	Vec2u swapchain_get_extent(Swapchain p_swapchain) override;
+
+	DataFormat swapchain_get_format(Swapchain p_swapchain) override;
+
+	bool swapchain_pop_frame(Swapchain p_swapchain, SwapchainFrame* o_frame) override;
+
+	void swapchain_free(Swapchain p_swapchain) override;
+
+	// =========================================================================
+	// Resource Management (Buffers & Images)
+	// =========================================================================
+
+	Buffer buffer_create(uint64_t p_size, BufferUsageFlags p_usage,
+			MemoryAllocationType p_allocation_type) override;
+
+	void buffer_free(Buffer p_buffer) override;
+
+	BufferDeviceAddress buffer_get_device_address(Buffer p_buffer) override;
+
+	uint8_t* buffer_map(Buffer p_buffer) override;
+
+	void buffer_unmap(Buffer p_buffer) override;
+
+	void buffer_invalidate(Buffer p_buffer) override;
+
+	void buffer_flush(Buffer p_buffer) override;
+
+	Image image_create(const ImageCreateInfo& p_info) override;
+
+	void image_free(Image p_image) override;
+
+	Vec3u image_get_size(Image p_image) override;
+
+	DataFormat image_get_format(Image p_image) override;
+
+	uint32_t image_get_mip_levels(Image p_image) override;
+
+	Sampler sampler_create(const SamplerCreateInfo& p_info) override;
+
+	void sampler_free(Sampler p_sampler) override;
+
+	// =========================================================================
+	// Shader & Pipelines
+	// =========================================================================
+
+	Shader shader_create_from_bytecode(const std::vector<SpirvEntry>& p_shaders) override;
+
+	void shader_free(Shader p_shader) override;
+
+	std::vector<ShaderInterfaceVariable> shader_get_vertex_inputs(Shader p_shader) override;
+
+	Pipeline render_pipeline_create(const RenderPipelineCreateInfo& p_info) override;
+
+	Pipeline compute_pipeline_create(Shader p_shader) override;
+
+	void pipeline_free(Pipeline p_pipeline) override;
+
+	UniformSet uniform_set_create(
+			std::vector<ShaderUniform> p_uniforms, Shader p_shader, uint32_t p_set_index) override;
+
+	void uniform_set_free(UniformSet p_uniform_set) override;
+
+	// =========================================================================
+	// Render Pass & Framebuffer
+	// =========================================================================
+
+	RenderPass render_pass_create(std::vector<RenderPassAttachment> p_attachments,
+			std::vector<SubpassInfo> p_subpasses) override;
+
+	void render_pass_destroy(RenderPass p_render_pass) override;
+
+	FrameBuffer frame_buffer_create(RenderPass p_render_pass, std::vector<Image> p_attachments,
+			const Vec2u& p_extent) override;
+
+	void frame_buffer_destroy(FrameBuffer p_frame_buffer) override;
+
+	// =========================================================================
+	// Synchronization
+	// =========================================================================
+
+	Fence fence_create(bool p_create_signaled = true) override;
+
+	void fence_free(Fence p_fence) override;
+
+	void fence_wait(Fence p_fence) override;
+
+	void fence_reset(Fence p_fence) override;
+
+	Semaphore semaphore_create() override;
+
+	void semaphore_free(Semaphore p_semaphore) override;
+
+	// =========================================================================
+	// Queries
+	// =========================================================================
+
+	QueryPool query_pool_create(QueryType p_type, uint32_t p_query_count) override;
+
+	void query_pool_free(QueryPool p_query_pool) override;
+
+	bool query_pool_get_results(QueryPool p_query_pool, uint32_t p_first_query,
+			uint32_t p_query_count, uint64_t* o_results) override;
+
+	float get_timestamp_period() const override;
+
+	uint32_t get_timestamp_valid_bits() const override;
+
+	bool is_pipeline_statistics_supported() const override;
+
+	// =========================================================================
+	// Debugging
+	// =========================================================================
+
+	void buffer_set_name(Buffer p_buffer, const char* p_name) override;
+
+	void image_set_name(Image p_image, const char* p_name) override;
+
+	void sampler_set_name(Sampler p_sampler, const char* p_name) override;
+
+	void command_pool_set_name(CommandPool p_command_pool, const char* p_name) override;
+
+	void command_buffer_set_name(CommandBuffer p_command_buffer, const char* p_name) override;
+
+	void queue_set_name(CommandQueue p_queue, const char* p_name) override;
+
+	void render_pass_set_name(RenderPass p_render_pass, const char* p_name) override;
+
+	void frame_buffer_set_name(FrameBuffer p_frame_buffer, const char* p_name) override;
+
+	void swapchain_set_name(Swapchain p_swapchain, const char* p_name) override;
+
+	void pipeline_set_name(Pipeline p_pipeline, const char* p_name) override;
+
+	void shader_set_name(Shader p_shader, const char* p_name) override;
+
+	void uniform_set_set_name(UniformSet p_uniform_set, const char* p_name) override;
+
+	void fence_set_name(Fence p_fence, const char* p_name) override;
+
+	void semaphore_set_name(Semaphore p_semaphore, const char* p_name) override;
+
+	void query_pool_set_name(QueryPool p_query_pool, const char* p_name) override;
+
+	// =========================================================================
+	// Command Submission & Recording
+	// =========================================================================
+
+	void queue_submit(CommandQueue p_queue, CommandBuffer p_cmd, Fence p_fence = GL_NULL_HANDLE,
+			Semaphore p_wait_semaphore = GL_NULL_HANDLE,
+			Semaphore p_signal_semaphore = GL_NULL_HANDLE) override;
+
+	bool queue_present(CommandQueue p_queue, Swapchain p_swapchain,
+			Semaphore p_wait_semaphore = GL_NULL_HANDLE) override;
+
+	CommandPool command_pool_create(CommandQueue p_queue) override;
+
+	void command_pool_free(CommandPool p_command_pool) override;
+
+	CommandBuffer command_pool_allocate(CommandPool p_command_pool) override;
+
+	std::vector<CommandBuffer> command_pool_allocate(
+			CommandPool p_command_pool, const uint32_t p_count) override;
+
+	void command_pool_reset(CommandPool p_command_pool) override;
+
+	void command_immediate_submit(std::function<void(CommandBuffer p_cmd)>&& p_function,
+			QueueType p_queue_type = QueueType::TRANSFER) override;
+
+	void command_begin(CommandBuffer p_cmd) override;
+
+	void command_end(CommandBuffer p_cmd) override;
+
+	void command_reset(CommandBuffer p_cmd) override;
+
+	void command_begin_render_pass(CommandBuffer p_cmd, RenderPass p_render_pass,
+			FrameBuffer p_framebuffer, const Vec2u& p_draw_extent,
+			Color p_clear_color = COLOR_GRAY) override;
+
+	void command_end_render_pass(CommandBuffer p_cmd) override;
+
+	void command_begin_rendering(CommandBuffer p_cmd, const Vec2u& p_draw_extent,
+			std::vector<RenderingAttachment> p_color_attachments,
+			Image p_depth_attachment = GL_NULL_HANDLE) override;
+
+	void command_end_rendering(CommandBuffer p_cmd) override;
+
+	void command_bind_graphics_pipeline(CommandBuffer p_cmd, Pipeline p_pipeline) override;
+
+	void command_bind_compute_pipeline(CommandBuffer p_cmd, Pipeline p_pipeline) override;
+
+	void command_bind_vertex_buffers(CommandBuffer p_cmd, uint32_t p_first_binding,
+			std::vector<Buffer> p_vertex_buffers, std::vector<uint64_t> p_offsets) override;
+
+	void command_bind_index_buffer(CommandBuffer p_cmd, Buffer p_index_buffer, uint64_t p_offset,
+			IndexType p_index_type) override;
+
+	void command_bind_uniform_sets(CommandBuffer p_cmd, Shader p_shader, uint32_t p_first_set,
+			std::vector<UniformSet> p_uniform_sets,
+			PipelineType p_type = PipelineType::GRAPHICS) override;
+
+	void command_push_constants(CommandBuffer p_cmd, Shader p_shader, uint64_t p_offset,
+			uint32_t p_size, const void* p_push_constants) override;
+
+	void command_draw(CommandBuffer p_cmd, uint32_t p_vertex_count, uint32_t p_instance_count = 1,
+			uint32_t p_first_vertex = 0, uint32_t p_first_instance = 0) override;
+
+	void command_draw_indexed(CommandBuffer p_cmd, uint32_t p_index_count,
+			uint32_t p_instance_count = 1, uint32_t p_first_index = 0, int32_t p_vertex_offset = 0,
+			uint32_t p_first_instance = 0) override;
+
+	void command_draw_indexed_indirect(CommandBuffer p_cmd, Buffer p_buffer, uint64_t p_offset,
+			uint32_t p_draw_count, uint32_t p_stride) override;
+
+	void command_dispatch(CommandBuffer p_cmd, uint32_t p_group_count_x, uint32_t p_group_count_y,
+			uint32_t p_group_count_z) override;
+
+	void command_set_viewport(CommandBuffer p_cmd, const Vec2u& p_size) override;
+
+	void command_set_scissor(
+			CommandBuffer p_cmd, const Vec2u& p_size, const Vec2u& p_offset = { 0, 0 }) override;
+
+	void command_set_depth_bias(CommandBuffer p_cmd, float p_depth_bias_constant_factor,
+			float p_depth_bias_clamp, float p_depth_bias_slope_factor) override;
+
+	void command_clear_color(CommandBuffer p_cmd, Image p_image, const Color& p_clear_color,
+			ImageAspectFlags p_image_aspect = IMAGE_ASPECT_COLOR_BIT) override;
+
+	void command_copy_buffer(CommandBuffer p_cmd, Buffer p_src_buffer, Buffer p_dst_buffer,
+			std::vector<BufferCopyRegion> p_regions) override;
+
+	void command_buffer_memory_barrier(CommandBuffer p_cmd, BufferUsageFlags p_src_usage,
+			BufferUsageFlags p_dst_usage, Buffer p_buffer) override;
+
+	void command_copy_buffer_to_image(CommandBuffer p_cmd, Buffer p_src_buffer, Image p_dst_image,
+			std::vector<BufferImageCopyRegion> p_regions) override;
+
+	void command_copy_image_to_buffer(CommandBuffer p_cmd, Image p_src_image, Buffer p_dst_buffer,
+			std::vector<BufferImageCopyRegion> p_regions) override;
+
+	void command_copy_image_to_image(CommandBuffer p_cmd, Image p_src_image, Image p_dst_image,
+			const Vec2u& p_src_extent, const Vec2u& p_dst_extent, uint32_t p_src_mip_level = 0,
+			uint32_t p_dst_mip_level = 0) override;
+
+	void command_transition_image(CommandBuffer p_cmd, Image p_image, ImageLayout p_current_layout,
+			ImageLayout p_new_layout, uint32_t p_base_mip_level = 0,
+			uint32_t p_level_count = GL_REMAINING_MIP_LEVELS) override;
+
+	void command_reset_query_pool(CommandBuffer p_cmd, QueryPool p_query_pool,
+			uint32_t p_first_query, uint32_t p_query_count) override;
+
+	void command_write_timestamp(
+			CommandBuffer p_cmd, QueryPool p_query_pool, uint32_t p_query_index) override;
+
+	void command_begin_query(CommandBuffer p_cmd, QueryPool p_query_pool, uint32_t p_query_index,
+			bool p_precise = false) override;
+
+	void command_end_query(
+			CommandBuffer p_cmd, QueryPool p_query_pool, uint32_t p_query_index) override;
+
+	void command_begin_label(
+			CommandBuffer p_cmd, const char* p_name, const Color& p_color = COLOR_WHITE) override;
+
+	void command_end_label(CommandBuffer p_cmd) override;
+
+private:
+	CaptureHandle _get_id(const void* p_handle);
+	CaptureHandle _register(const void* p_handle);
+	CaptureHandle _unregister(const void* p_handle);
+
+	void _write_call(CaptureCall p_call);
+	void _write_handle(const void* p_handle);
+	// Objects are identified by the call creating them
+	void _set_name(CaptureCall p_object_type, const void* p_handle, const char* p_name);
+
+	// Writes modified ranges of every mapped buffer
+	void _write_dirty_buffers();
+	void _write_dirty_buffer(CaptureHandle p_id);
+
+private:
+	std::shared_ptr<RenderBackend> backend;
+
+	std::ofstream file;
+	std::vector<uint8_t> stream;
+
+	// Recursive so immediate submissions are written as a single block
+	// including the commands their function records.
+	std::recursive_mutex mutex;
+
+	std::unordered_map<const void*, CaptureHandle> handle_ids;
+	CaptureHandle next_id = 1;
+
+	struct MappedBuffer {
+		uint8_t* data;
+		std::vector<uint8_t> shadow;
+	};
+
+	std::unordered_map<CaptureHandle, uint64_t> buffer_sizes;
+	std::unordered_map<CaptureHandle, MappedBuffer> mapped_buffers;
+};
+
+/**
+ * Executes a capture written by `CaptureRenderBackend` on the given backend.
+ *
+ * Swapchains are replaced by offscreen images unless `p_use_swapchain` is set,
+ * in which case the backend must have a surface attached already. Resources
+ * still alive when the capture ends are freed so a capture can be replayed
+ * repeatedly.
+ */
+class CaptureReplayer {
+public:
+	CaptureReplayer(std::shared_ptr<RenderBackend> p_backend, bool p_use_swapchain = false);
+	~CaptureReplayer();
+
+	// Reads the whole file into memory, returns false if it is not a valid capture
+	bool load(const std::filesystem::path& p_path);
+
+	// Returns false if the capture is malformed
+	bool replay();
+
+	uint64_t get_call_count() const;
+	uint32_t get_frame_count() const;
+
+private:
+	struct Reader;
+
+	bool _replay_calls(Reader& p_reader, bool p_immediate);
+	bool _replay_call(Reader& p_reader, CaptureCall p_call);
+
+	void* _get_handle(CaptureHandle p_id) const;
+	void _free_remaining();
+
+	void _submit_empty(CommandQueue p_queue, Semaphore p_wait_semaphore,
+			Semaphore p_signal_semaphore);
+
+private:
+	std::shared_ptr<RenderBackend> backend;
+	bool use_swapchain;
+
+	std::vector<uint8_t> data;
+
+	struct ReplayResource {
+		void* handle;
+		CaptureCall free_call;
+	};
+
+	std::unordered_map<CaptureHandle, ReplayResource> resources;
+	// Handles not owned by the replay, queues and swapchain images
+	std::unordered_map<CaptureHandle, void*> borrowed_handles;
+	std::unordered_map<CaptureHandle, uint8_t*> mapped_buffers;
+	// Bounds for the writes of `BUFFER_DATA`
+	std::unordered_map<CaptureHandle, uint64_t> buffer_sizes;
+
+	struct OffscreenSwapchain {
+		std::vector<Image> images;
+		uint32_t image_index = 0;
+	};
+
+	std::unordered_map<CaptureHandle, OffscreenSwapchain> offscreen_swapchains;
+
+	CommandPool empty_command_pool = GL_NULL_HANDLE;
+	CommandBuffer empty_command_buffer = GL_NULL_HANDLE;
+	Fence empty_fence = GL_NULL_HANDLE;
+
+	uint64_t call_count = 0;
+	uint32_t frame_count = 0;
+};
+
+} //namespace gl
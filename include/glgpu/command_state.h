@@ -0,0 +1,132 @@
+#pragma once
+
+#include "glgpu/types.h"
+
+namespace gl {
+
+constexpr uint32_t MAX_CACHED_VERTEX_BINDINGS = 16;
+
+/**
+ * Struct tracking the state last bound on a command buffer so backends can
+ * skip binds that would not change anything. Every `bind_*` and `set_*`
+ * function updates the cached state and returns false if the call is
+ * redundant, the backend should only record the command when it returns true.
+ *
+ * Handles are compared by identity, the cache must be reset whenever the
+ * command buffer begins recording or gets reset since Vulkan discards all
+ * bound state at that point.
+ */
+struct CommandStateCache {
+	Pipeline pipelines[2] = {};
+
+	// Uniform sets are only comparable while bound with the same shader layout
+	Shader uniform_set_shaders[2] = {};
+	UniformSet uniform_sets[2][MAX_UNIFORM_SETS] = {};
+
+	Buffer vertex_buffers[MAX_CACHED_VERTEX_BINDINGS] = {};
+	uint64_t vertex_buffer_offsets[MAX_CACHED_VERTEX_BINDINGS] = {};
+
+	Buffer index_buffer = GL_NULL_HANDLE;
+	uint64_t index_buffer_offset = 0;
+	IndexType index_type = IndexType::UINT32;
+
+	bool viewport_valid = false;
+	Vec2u viewport_size = { 0, 0 };
+
+	bool scissor_valid = false;
+	Vec2u scissor_size = { 0, 0 };
+	Vec2u scissor_offset = { 0, 0 };
+
+	void reset() { *this = CommandStateCache(); }
+
+	bool bind_pipeline(PipelineType p_type, Pipeline p_pipeline) {
+		Pipeline& bound = pipelines[static_cast<uint32_t>(p_type)];
+		if (bound == p_pipeline) {
+			return false;
+		}
+
+		bound = p_pipeline;
+		return true;
+	}
+
+	bool bind_uniform_sets(PipelineType p_type, Shader p_shader, uint32_t p_first_set,
+			const std::vector<UniformSet>& p_uniform_sets) {
+		const uint32_t type = static_cast<uint32_t>(p_type);
+
+		// A different layout may disturb every set bound so far, start over
+		if (uniform_set_shaders[type] != p_shader) {
+			uniform_set_shaders[type] = p_shader;
+			std::fill_n(uniform_sets[type], MAX_UNIFORM_SETS, GL_NULL_HANDLE);
+		}
+
+		bool changed = false;
+		for (uint32_t i = 0; i < p_uniform_sets.size(); i++) {
+			const uint32_t set = p_first_set + i;
+			if (set >= MAX_UNIFORM_SETS) {
+				return true;
+			}
+
+			if (uniform_sets[type][set] != p_uniform_sets[i]) {
+				uniform_sets[type][set] = p_uniform_sets[i];
+				changed = true;
+			}
+		}
+
+		return changed;
+	}
+
+	bool bind_vertex_buffers(uint32_t p_first_binding, const std::vector<Buffer>& p_buffers,
+			const std::vector<uint64_t>& p_offsets) {
+		bool changed = false;
+		for (uint32_t i = 0; i < p_buffers.size(); i++) {
+			const uint32_t binding = p_first_binding + i;
+			if (binding >= MAX_CACHED_VERTEX_BINDINGS) {
+				return true;
+			}
+
+			if (vertex_buffers[binding] != p_buffers[i] ||
+					vertex_buffer_offsets[binding] != p_offsets[i]) {
+				vertex_buffers[binding] = p_buffers[i];
+				vertex_buffer_offsets[binding] = p_offsets[i];
+				changed = true;
+			}
+		}
+
+		return changed;
+	}
+
+	bool bind_index_buffer(Buffer p_buffer, uint64_t p_offset, IndexType p_index_type) {
+		if (index_buffer == p_buffer && index_buffer_offset == p_offset &&
+				index_type == p_index_type) {
+			return false;
+		}
+
+		index_buffer = p_buffer;
+		index_buffer_offset = p_offset;
+		index_type = p_index_type;
+		return true;
+	}
+
+	bool set_viewport(const Vec2u& p_size) {
+		if (viewport_valid && viewport_size == p_size) {
+			return false;
+		}
+
+		viewport_valid = true;
+		viewport_size = p_size;
+		return true;
+	}
+
+	bool set_scissor(const Vec2u& p_size, const Vec2u& p_offset) {
+		if (scissor_valid && scissor_size == p_size && scissor_offset == p_offset) {
+			return false;
+		}
+
+		scissor_valid = true;
+		scissor_size = p_size;
+		scissor_offset = p_offset;
+		return true;
+	}
+};
+
+} //namespace gl
@@ -1,15 +1,30 @@
 #pragma once
 
+#include "glgpu/inplace_function.h"
+
 namespace gl {
 
 /**
  * Struct representing a queue which deletor functions can be assigned into and
  * later they will be deleted in the reverse order you have pushed.
+ *
+ * Deletors are stored inline in a single contiguous array that keeps its
+ * capacity across flushes, once warmed up pushing does not allocate and
+ * flushing is a linear sweep.
  */
 struct DeletionQueue {
-	std::deque<std::function<void()>> deletors;
+	// Fits a handful of captured handles, raise if a deletor needs more
+	static constexpr size_t DELETOR_CAPACITY = 48;
+
+	using Deletor = InplaceFunction<void(), DELETOR_CAPACITY>;
+
+	std::vector<Deletor> deletors;
 
-	void push_function(std::function<void()>&& p_function) { deletors.push_back(p_function); }
+	DeletionQueue(size_t p_initial_capacity = 64) { deletors.reserve(p_initial_capacity); }
+
+	template <typename F> void push_function(F&& p_function) {
+		deletors.emplace_back(std::forward<F>(p_function));
+	}
 
 	void flush() {
 		for (auto it = deletors.rbegin(); it != deletors.rend(); it++) {
@@ -20,4 +35,4 @@ struct DeletionQueue {
 	}
 };
 
-} //namespace gl
\ No newline at end of file
+} //namespace gl
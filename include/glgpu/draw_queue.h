@@ -0,0 +1,130 @@
+#pragma once
+
+#include "glgpu/backend.h"
+
+namespace gl {
+
+// Sort key layout, most significant field first:
+// | pass (8) | pipeline (16) | material (16) | depth (24) |
+constexpr uint32_t DRAW_SORT_KEY_DEPTH_BITS = 24;
+constexpr uint32_t DRAW_SORT_KEY_MATERIAL_BITS = 16;
+constexpr uint32_t DRAW_SORT_KEY_PIPELINE_BITS = 16;
+constexpr uint32_t DRAW_SORT_KEY_PASS_BITS = 8;
+
+constexpr uint32_t DRAW_SORT_KEY_MATERIAL_SHIFT = DRAW_SORT_KEY_DEPTH_BITS;
+constexpr uint32_t DRAW_SORT_KEY_PIPELINE_SHIFT =
+		DRAW_SORT_KEY_MATERIAL_SHIFT + DRAW_SORT_KEY_MATERIAL_BITS;
+constexpr uint32_t DRAW_SORT_KEY_PASS_SHIFT =
+		DRAW_SORT_KEY_PIPELINE_SHIFT + DRAW_SORT_KEY_PIPELINE_BITS;
+
+constexpr uint32_t DRAW_SORT_KEY_MAX_DEPTH = (1u << DRAW_SORT_KEY_DEPTH_BITS) - 1;
+
+/**
+ * Builds a sort key from its fields. Pipeline and material ids are assigned
+ * by the application, packets sharing them should share the same pipeline
+ * and uniform set so sorting groups their binds together.
+ */
+inline constexpr uint64_t make_draw_sort_key(
+		uint8_t p_pass, uint16_t p_pipeline_id, uint16_t p_material_id, uint32_t p_depth) {
+	return (uint64_t(p_pass) << DRAW_SORT_KEY_PASS_SHIFT) |
+			(uint64_t(p_pipeline_id) << DRAW_SORT_KEY_PIPELINE_SHIFT) |
+			(uint64_t(p_material_id) << DRAW_SORT_KEY_MATERIAL_SHIFT) |
+			(p_depth & DRAW_SORT_KEY_MAX_DEPTH);
+}
+
+inline constexpr uint8_t get_draw_sort_key_pass(uint64_t p_key) {
+	return uint8_t(p_key >> DRAW_SORT_KEY_PASS_SHIFT);
+}
+
+/**
+ * Quantizes a normalized [0, 1] depth into the depth field of the key,
+ * `p_reverse` sorts back to front for transparent geometry.
+ */
+inline uint32_t quantize_draw_sort_depth(float p_depth, bool p_reverse = false) {
+	const float depth = std::clamp(p_reverse ? 1.0f - p_depth : p_depth, 0.0f, 1.0f);
+	return static_cast<uint32_t>(depth * float(DRAW_SORT_KEY_MAX_DEPTH));
+}
+
+/**
+ * Compact record of a single draw. `index_buffer` selects between indexed and
+ * non-indexed draws, `count` and `first` refer to indices or vertices
+ * accordingly.
+ */
+struct DrawPacket {
+	Pipeline pipeline = GL_NULL_HANDLE;
+	// Shader the uniform set and push constants are bound with
+	Shader shader = GL_NULL_HANDLE;
+	UniformSet uniform_set = GL_NULL_HANDLE;
+	uint32_t uniform_set_index = 0;
+
+	Buffer vertex_buffer = GL_NULL_HANDLE;
+	uint64_t vertex_buffer_offset = 0;
+
+	Buffer index_buffer = GL_NULL_HANDLE;
+	uint64_t index_buffer_offset = 0;
+	IndexType index_type = IndexType::UINT32;
+
+	uint32_t count = 0;
+	uint32_t instance_count = 1;
+	uint32_t first = 0;
+	int32_t vertex_offset = 0;
+	uint32_t first_instance = 0;
+
+	// Range in the push constant storage of the queue, set by `DrawQueue::push`
+	uint32_t push_constants_offset = 0;
+	uint32_t push_constants_size = 0;
+};
+
+/**
+ * Queue of draw packets ordered by a 64-bit sort key before being recorded.
+ *
+ * Packets are sorted with an LSD radix sort, equal keys keep the order they
+ * were pushed in. Executing the queue only binds state that differs from
+ * the previous packet, so pipeline and uniform set changes happen once per
+ * key group instead of once per draw. Not thread safe, each recording thread
+ * should own its queue.
+ */
+class DrawQueue {
+public:
+	DrawQueue(std::shared_ptr<RenderBackend> p_backend, uint32_t p_initial_capacity = 1024);
+
+	void push(uint64_t p_key, const DrawPacket& p_packet, const void* p_push_constants = nullptr,
+			uint32_t p_push_constants_size = 0);
+
+	void sort();
+
+	// Records every packet, has to be sorted beforehand.
+	void execute(CommandBuffer p_cmd);
+
+	// Records only the packets of `p_pass` so each pass can be executed
+	// inside its own render pass.
+	void execute(CommandBuffer p_cmd, uint8_t p_pass);
+
+	void clear();
+
+	size_t size() const;
+	bool is_sorted() const;
+
+	uint64_t get_key(size_t p_index) const;
+	const DrawPacket& get_packet(size_t p_index) const;
+
+private:
+	struct SortEntry {
+		uint64_t key;
+		uint32_t index;
+	};
+
+	void _execute_range(CommandBuffer p_cmd, size_t p_begin, size_t p_end);
+
+private:
+	std::shared_ptr<RenderBackend> backend;
+
+	std::vector<DrawPacket> packets;
+	std::vector<SortEntry> entries;
+	std::vector<SortEntry> scratch;
+	std::vector<uint8_t> push_constants;
+
+	bool sorted = true;
+};
+
+} //namespace gl
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "glgpu/backend.h"
+
+namespace gl {
+
+// Swaps the red and blue channels of `p_count` 8 bit four channel pixels,
+// turning RGBA into BGRA and back. `p_in` may be `o_out`.
+void convert_swap_red_blue(const uint8_t* p_in, uint8_t* o_out, size_t p_count);
+
+/**
+ * Converts 8 bit RGBA pixels, or BGRA with `p_bgra`, to planar Y'CbCr 4:2:0
+ * with BT.709 coefficients in limited range. Rows are tightly packed on both
+ * sides, the chroma planes are `(size + 1) / 2` large and every chroma sample
+ * is the average of a 2x2 block. Alpha is ignored.
+ */
+void convert_rgba8_to_yuv420(
+		const uint8_t* p_in, Vec2u p_size, bool p_bgra, uint8_t* o_y, uint8_t* o_u, uint8_t* o_v);
+
+enum class FrameCaptureFormat {
+	// Red first, whatever the channel order of the captured image
+	RGBA8,
+	// See `convert_rgba8_to_yuv420`
+	YUV420,
+};
+
+struct CapturedFrame {
+	// Counts the calls to `FrameCapture::capture`, starting at 0
+	uint64_t frame_index = 0;
+	Vec2u size = { 0, 0 };
+	FrameCaptureFormat format = FrameCaptureFormat::RGBA8;
+	// RGBA8 only fills the first plane, YUV420 the Y, U and V planes
+	std::array<const uint8_t*, 3> planes = {};
+	// Bytes per row of each plane
+	std::array<uint32_t, 3> strides = {};
+};
+
+// Called on the capture's worker thread, the planes are only valid for the
+// duration of the call
+typedef std::function<void(const CapturedFrame&)> FrameCaptureCallback;
+
+/**
+ * Copies images, usually the swapchain image right before it is presented,
+ * into a ring of host visible readback buffers and hands them to a callback.
+ *
+ * Like the profiler's queries, each frame in flight owns a readback buffer.
+ * A capture is handed to a worker thread `frames_in_flight` captures later,
+ * the application waited on the fence of that frame by then, so neither
+ * capturing nor presenting ever waits for the GPU as long as
+ * `frames_in_flight` is at least the number of frames the application keeps
+ * in flight. The worker swizzles or converts the pixels and calls the
+ * callback, one spare readback buffer gives it a whole frame to do so before
+ * `capture` has to wait for it. `capture` and `flush` are not thread safe.
+ */
+class FrameCapture {
+public:
+	FrameCapture(std::shared_ptr<RenderBackend> p_backend, FrameCaptureFormat p_format,
+			FrameCaptureCallback p_callback, uint32_t p_frames_in_flight = 3);
+	~FrameCapture();
+
+	// Hands the oldest finished capture to the worker and records a copy of
+	// `p_image`, an 8 bit
+	// RGBA or BGRA image in `p_layout` that it is returned to afterwards. Has
+	// to be recorded outside of a render pass, after the last write to the
+	// image. Swapchain images need a device supporting them as copy source.
+	void capture(CommandBuffer p_cmd, Image p_image, ImageLayout p_layout);
+
+	// Resolves every capture still in flight and waits for the callbacks,
+	// the device has to be idle
+	void flush();
+
+private:
+	struct Slot {
+		Buffer readback = GL_NULL_HANDLE;
+		uint8_t* data = nullptr;
+		uint64_t capacity = 0;
+		Vec2u size = { 0, 0 };
+		bool bgra = false;
+	};
+
+	void _worker_loop();
+	void _resolve_slot(const Slot& p_slot, uint64_t p_frame_index);
+
+private:
+	std::shared_ptr<RenderBackend> backend;
+	FrameCaptureFormat format;
+	FrameCaptureCallback callback;
+
+	// `frames_in_flight + 1` slots, capture `n` is in slot `n % slots.size()`
+	std::vector<Slot> slots;
+	uint32_t frames_in_flight;
+	uint64_t frame_counter = 0;
+
+	std::thread worker;
+	// Guards the counters below, slots before `resolved_count` belong to
+	// `capture` again
+	std::mutex worker_mutex;
+	std::condition_variable worker_cv;
+	uint64_t ready_count = 0;
+	uint64_t resolved_count = 0;
+	bool stop_requested = false;
+
+	// Swizzled or converted pixels, reused across frames by the worker
+	std::vector<uint8_t> converted;
+};
+
+} //namespace gl
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "glgpu/assert.h"
+
+namespace gl {
+
+/**
+ * Table of generational handles, maps 32-bit slot indices to objects.
+ *
+ * A handle stores its slot index in the lower 32 bits and the generation of
+ * the slot in the upper 32 bits. Removing an object bumps the generation so
+ * handles still referring to it are caught in debug builds instead of
+ * silently aliasing the next object placed in the slot. Release builds skip
+ * the check entirely.
+ *
+ * Slot 0 is reserved with generation 0 and no object, `GL_NULL_HANDLE`
+ * therefore resolves to nullptr without a branch.
+ *
+ * Slots live in fixed size pages that never move so lookups stay valid while
+ * other threads insert or remove. Free slots form a lock-free stack with a
+ * tagged head, same as `PagedAllocator`.
+ */
+template <typename T> class HandleTable {
+public:
+	static constexpr uint32_t PAGE_BITS = 10;
+	static constexpr uint32_t PAGE_SIZE = 1u << PAGE_BITS;
+	static constexpr uint32_t MAX_PAGES = 4096;
+
+	HandleTable() {
+		_allocate_new_page();
+
+		// Reserve the null slot
+		const uint32_t index = _pop_free_index();
+		GL_ASSERT(index == 0);
+		pages[0][0].generation = 0;
+	}
+
+	~HandleTable() {
+		for (uint32_t i = 0; i < page_count.load(std::memory_order_relaxed); i++) {
+			delete[] pages[i];
+		}
+	}
+
+	HandleTable(const HandleTable&) = delete;
+	HandleTable& operator=(const HandleTable&) = delete;
+
+	template <typename H> H insert(T* p_object) {
+		const uint32_t index = _pop_free_index();
+
+		Slot& slot = _get_slot(index);
+		slot.object = p_object;
+
+		return (H)uintptr_t((uint64_t(slot.generation) << 32) | index);
+	}
+
+	template <typename H> T* get(H p_handle) const {
+		const uint64_t value = uint64_t(uintptr_t(p_handle));
+#ifdef GL_DEBUG_BUILD
+		GL_ASSERT(is_valid(p_handle), "Use of a freed or invalid handle");
+#endif
+		return _get_slot(uint32_t(value)).object;
+	}
+
+	template <typename H> bool is_valid(H p_handle) const {
+		const uint64_t value = uint64_t(uintptr_t(p_handle));
+
+		const uint32_t index = uint32_t(value);
+		if ((index >> PAGE_BITS) >= page_count.load(std::memory_order_acquire)) {
+			return false;
+		}
+
+		return _get_slot(index).generation == uint32_t(value >> 32);
+	}
+
+	// Invalidates every handle to the slot and returns the object it held
+	template <typename H> T* remove(H p_handle) {
+		if (!p_handle) {
+			return nullptr;
+		}
+
+		T* object = get(p_handle);
+
+		const uint32_t index = uint32_t(uint64_t(uintptr_t(p_handle)));
+
+		Slot& slot = _get_slot(index);
+		slot.object = nullptr;
+		// Generation 0 is reserved for the null slot
+		slot.generation = slot.generation == UINT32_MAX ? 1 : slot.generation + 1;
+
+		_push_free_index(index, index);
+
+		return object;
+	}
+
+private:
+	static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+	struct Slot {
+		T* object = nullptr;
+		uint32_t generation = 1;
+		std::atomic<uint32_t> next_free = INVALID_INDEX;
+	};
+
+	Slot& _get_slot(uint32_t p_index) const {
+		return pages[p_index >> PAGE_BITS][p_index & (PAGE_SIZE - 1)];
+	}
+
+	// Head packs the top index with a tag bumped on every exchange (ABA)
+	static uint64_t _make_head(uint32_t p_index, uint64_t p_head) {
+		return ((p_head >> 32) + 1) << 32 | p_index;
+	}
+
+	uint32_t _pop_free_index() {
+		uint64_t head = free_head.load(std::memory_order_acquire);
+		while (true) {
+			const uint32_t index = uint32_t(head);
+			if (index == INVALID_INDEX) {
+				_allocate_new_page();
+				head = free_head.load(std::memory_order_acquire);
+				continue;
+			}
+
+			const uint32_t next = _get_slot(index).next_free.load(std::memory_order_relaxed);
+			if (free_head.compare_exchange_weak(head, _make_head(next, head),
+						std::memory_order_acquire, std::memory_order_acquire)) {
+				return index;
+			}
+		}
+	}
+
+	// Pushes the already linked chain `p_first` .. `p_last`
+	void _push_free_index(uint32_t p_first, uint32_t p_last) {
+		uint64_t head = free_head.load(std::memory_order_relaxed);
+		do {
+			_get_slot(p_last).next_free.store(uint32_t(head), std::memory_order_relaxed);
+		} while (!free_head.compare_exchange_weak(head, _make_head(p_first, head),
+				std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	void _allocate_new_page() {
+		std::lock_guard<std::mutex> lock(page_mutex);
+
+		// Another thread grew the table while this one was waiting
+		if (uint32_t(free_head.load(std::memory_order_acquire)) != INVALID_INDEX) {
+			return;
+		}
+
+		const uint32_t page_index = page_count.load(std::memory_order_relaxed);
+		GL_ASSERT(page_index < MAX_PAGES, "Handle table is out of slots");
+
+		Slot* page = new Slot[PAGE_SIZE];
+		for (uint32_t i = 0; i + 1 < PAGE_SIZE; i++) {
+			page[i].next_free.store(
+					(page_index << PAGE_BITS) + i + 1, std::memory_order_relaxed);
+		}
+
+		pages[page_index] = page;
+		page_count.store(page_index + 1, std::memory_order_release);
+
+		const uint32_t first = page_index << PAGE_BITS;
+		_push_free_index(first, first + PAGE_SIZE - 1);
+	}
+
+private:
+	Slot* pages[MAX_PAGES] = {};
+	std::atomic<uint32_t> page_count = 0;
+	std::mutex page_mutex;
+
+	std::atomic<uint64_t> free_head = INVALID_INDEX;
+};
+
+} //namespace gl
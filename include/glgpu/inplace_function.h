@@ -0,0 +1,89 @@
+#pragma once
+
+namespace gl {
+
+template <typename Signature, size_t Capacity = 48> class InplaceFunction;
+
+/**
+ * Move only replacement for `std::function` that never allocates, the callable
+ * is stored inline and has to fit in `Capacity` bytes, checked at compile
+ * time.
+ */
+template <typename R, typename... Args, size_t Capacity>
+class InplaceFunction<R(Args...), Capacity> {
+public:
+	InplaceFunction() = default;
+
+	template <typename F>
+		requires(!std::is_same_v<std::decay_t<F>, InplaceFunction>)
+	InplaceFunction(F&& p_function) {
+		using Fn = std::decay_t<F>;
+		static_assert(sizeof(Fn) <= Capacity, "Callable does not fit, raise the capacity");
+		static_assert(alignof(Fn) <= alignof(std::max_align_t), "Callable is over-aligned");
+
+		new (storage) Fn(std::forward<F>(p_function));
+		ops = &OPS<Fn>;
+	}
+
+	InplaceFunction(InplaceFunction&& p_other) noexcept : ops(p_other.ops) {
+		if (ops) {
+			ops->relocate(storage, p_other.storage);
+			p_other.ops = nullptr;
+		}
+	}
+
+	InplaceFunction& operator=(InplaceFunction&& p_other) noexcept {
+		if (this != &p_other) {
+			reset();
+
+			ops = p_other.ops;
+			if (ops) {
+				ops->relocate(storage, p_other.storage);
+				p_other.ops = nullptr;
+			}
+		}
+
+		return *this;
+	}
+
+	InplaceFunction(const InplaceFunction&) = delete;
+	InplaceFunction& operator=(const InplaceFunction&) = delete;
+
+	~InplaceFunction() { reset(); }
+
+	R operator()(Args... p_args) { return ops->invoke(storage, std::forward<Args>(p_args)...); }
+
+	explicit operator bool() const { return ops != nullptr; }
+
+	void reset() {
+		if (ops) {
+			ops->destroy(storage);
+			ops = nullptr;
+		}
+	}
+
+private:
+	struct Ops {
+		R (*invoke)(void* p_storage, Args&&... p_args);
+		// Moves into uninitialized `p_dst` and destroys `p_src`
+		void (*relocate)(void* p_dst, void* p_src);
+		void (*destroy)(void* p_storage);
+	};
+
+	template <typename Fn>
+	static constexpr Ops OPS = {
+		[](void* p_storage, Args&&... p_args) -> R {
+			return (*(Fn*)p_storage)(std::forward<Args>(p_args)...);
+		},
+		[](void* p_dst, void* p_src) {
+			new (p_dst) Fn(std::move(*(Fn*)p_src));
+			((Fn*)p_src)->~Fn();
+		},
+		[](void* p_storage) { ((Fn*)p_storage)->~Fn(); },
+	};
+
+	alignas(std::max_align_t) uint8_t storage[Capacity];
+	const Ops* ops = nullptr;
+};
+
+} //namespace gl
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "glgpu/mat.h"
+
+namespace gl {
+
+/**
+ * Six normalized planes facing inwards, `dot(plane.xyz, p) + plane.w` is the
+ * signed distance of `p`.
+ */
+struct Frustum {
+	// Left, right, bottom, top, near, far
+	std::array<Vec4f, 6> planes;
+
+	// Extracts the planes of a `Mat4::perspective` or `Mat4::ortho` based
+	// view projection matrix
+	static Frustum from_matrix(const Mat4& p_view_proj);
+};
+
+/**
+ * Instance transforms in structure of arrays layout, each array holds one
+ * component of every instance.
+ */
+struct InstanceTransformSoA {
+	const float* position_x;
+	const float* position_y;
+	const float* position_z;
+
+	// Unit quaternion
+	const float* rotation_x;
+	const float* rotation_y;
+	const float* rotation_z;
+	const float* rotation_w;
+
+	// Optional, null means no scaling on any axis
+	const float* scale_x;
+	const float* scale_y;
+	const float* scale_z;
+};
+
+struct InstanceWriteInfo {
+	InstanceTransformSoA transforms;
+	size_t count;
+
+	// Optional, instances whose bounding sphere lies outside are culled. The
+	// sphere is centered on the position, its radius scaled by the largest
+	// scale component.
+	const Frustum* frustum = nullptr;
+	float bounding_radius = 0.0f;
+
+	// Optional, receives 1 for visible and 0 for culled instances
+	uint8_t* o_visibility = nullptr;
+
+	// Write only the visible instances, packed from the start of the output,
+	// otherwise every instance is written at its own index
+	bool compact = false;
+};
+
+/**
+ * Composes translation * rotation * scale model matrices and writes them to
+ * `o_out`, usually a mapped instance buffer that stays mapped for the
+ * lifetime of the buffer. Outputs aligned to the vector width are written
+ * with non-temporal stores so the matrices bypass the cache on their way to
+ * the GPU, the output should not be read back by the CPU.
+ *
+ * @returns Number of matrices written.
+ */
+size_t instance_write_transforms(const InstanceWriteInfo& p_info, Mat4* o_out);
+
+} //namespace gl
@@ -10,15 +10,225 @@ enum LogLevel : uint8_t {
 	LOG_LEVEL_FATAL,
 };
 
+// Type tag of an argument in binary logs
+enum LogBinaryArgType : uint8_t {
+	LOG_BINARY_ARG_INT,
+	LOG_BINARY_ARG_UINT,
+	LOG_BINARY_ARG_FLOAT,
+	LOG_BINARY_ARG_BOOL,
+	LOG_BINARY_ARG_CHAR,
+	LOG_BINARY_ARG_POINTER,
+	LOG_BINARY_ARG_STRING,
+};
+
+/**
+ * Lets through a burst of messages per second and counts the rest, so a flood
+ * of the same message costs an atomic increment instead of a write. Constant
+ * initialized, meant to live in static storage.
+ */
+struct LogRateLimiter {
+	// Shown in summaries of suppressed messages
+	const char* name;
+
+	std::atomic<int64_t> window = 0;
+	std::atomic<uint32_t> window_count = 0;
+	std::atomic<uint32_t> suppressed = 0;
+	// Set while queued for a summary
+	std::atomic<bool> pending = false;
+
+	constexpr LogRateLimiter(const char* p_name = nullptr) : name(p_name) {}
+
+	// Returns whether the message should be logged, along with the number of
+	// messages suppressed since the last one that was.
+	bool acquire(uint32_t* o_suppressed);
+};
+
+/**
+ * Static state of a single `GL_LOG_*` call site.
+ */
+struct LogSite {
+	const char* format;
+	const char* file;
+	uint32_t line;
+
+	// Id of the site in binary logs, 0 until first written
+	std::atomic<uint32_t> id = 0;
+	// Binary sink the site description was last written to
+	std::atomic<uint32_t> binary_session = 0;
+
+	LogRateLimiter limiter;
+
+	constexpr LogSite(const char* p_format, const char* p_file, uint32_t p_line) :
+			format(p_format), file(p_file), line(p_line), limiter(p_format) {}
+};
+
+/**
+ * Process wide logger writing colored, timestamped lines to stdout.
+ *
+ * Messages are written synchronously by default. Once switched to asynchronous
+ * mode every thread pushes into its own lock-free ring and a background thread
+ * does the writing, so logging from hot paths only costs the formatting.
+ * Fatal messages are always written synchronously, after everything queued
+ * before them. Thread safe.
+ *
+ * With a binary sink set, messages are not formatted at all. The site's format
+ * string is written once and each message only records the site id and the
+ * raw arguments, `decode_binary_log` turns the file back into text.
+ */
 class Logger {
 public:
-	static void log(LogLevel p_level, const std::string& p_fmt);
+	static void log(LogLevel p_level, std::string&& p_message);
+
+	// Entry point of the `GL_LOG_*` macros
+	template <typename... Args>
+	static void log_site(LogLevel p_level, LogSite& p_site, uint32_t p_suppressed,
+			std::format_string<Args...> p_fmt, Args&&... p_args) {
+		if (p_level < LOG_LEVEL_FATAL && is_binary_sink_enabled()) {
+			std::string& record =
+					_begin_binary_record(p_level, p_site, p_suppressed, sizeof...(Args));
+			(_append_binary_arg(record, p_args), ...);
+			_end_binary_record();
+			return;
+		}
+
+		std::string message = std::format(p_fmt, std::forward<Args>(p_args)...);
+		if (p_suppressed > 0) {
+			message += std::format(" ({} similar messages suppressed)", p_suppressed);
+		}
+
+		log(p_level, std::move(message));
+	}
+
+	// Messages below the level are filtered before being formatted
+	static void set_level(LogLevel p_level);
+	static LogLevel get_level();
+	static bool is_level_enabled(LogLevel p_level);
+
+	// Starts or stops the background writer, stopping flushes pending messages
+	static void set_async(bool p_async);
+	static bool is_async();
+
+	// Routes messages to a binary file instead of stdout, empty path closes it
+	static bool set_binary_sink(const std::filesystem::path& p_path);
+	static bool is_binary_sink_enabled();
+
+	// Writes the binary log at `p_path` as text lines to `o_out`
+	static bool decode_binary_log(const std::filesystem::path& p_path, std::ostream& o_out);
+
+	// Blocks until every message logged before the call is written, along
+	// with summaries of rate limited sites that went quiet.
+	static void flush();
+
+	// Number of messages dropped because a thread's ring was full
+	static uint64_t get_dropped_message_count();
+
+private:
+	static std::string& _begin_binary_record(
+			LogLevel p_level, LogSite& p_site, uint32_t p_suppressed, uint8_t p_arg_count);
+	static void _end_binary_record();
+
+	template <typename T> static void _append_binary_value(std::string& o_record, T p_value) {
+		o_record.append((const char*)&p_value, sizeof(T));
+	}
+
+	template <typename T> static void _append_binary_arg(std::string& o_record, const T& p_arg) {
+		if constexpr (std::is_same_v<T, bool>) {
+			o_record += (char)LOG_BINARY_ARG_BOOL;
+			o_record += (char)p_arg;
+		} else if constexpr (std::is_same_v<T, char>) {
+			o_record += (char)LOG_BINARY_ARG_CHAR;
+			o_record += p_arg;
+		} else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+			o_record += (char)LOG_BINARY_ARG_INT;
+			_append_binary_value<int64_t>(o_record, p_arg);
+		} else if constexpr (std::is_integral_v<T>) {
+			o_record += (char)LOG_BINARY_ARG_UINT;
+			_append_binary_value<uint64_t>(o_record, p_arg);
+		} else if constexpr (std::is_floating_point_v<T>) {
+			o_record += (char)LOG_BINARY_ARG_FLOAT;
+			_append_binary_value<double>(o_record, p_arg);
+		} else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+			const std::string_view str = p_arg;
+			o_record += (char)LOG_BINARY_ARG_STRING;
+			_append_binary_value<uint32_t>(o_record, str.size());
+			o_record += str;
+		} else if constexpr (std::is_pointer_v<T> || std::is_null_pointer_v<T>) {
+			o_record += (char)LOG_BINARY_ARG_POINTER;
+			_append_binary_value<uint64_t>(o_record, (uintptr_t)p_arg);
+		} else {
+			// Anything with a custom formatter is formatted right away
+			_append_binary_arg(o_record, std::format("{}", p_arg));
+		}
+	}
 };
 
-#define GL_LOG_TRACE(...) Logger::log(LOG_LEVEL_TRACE, std::format(__VA_ARGS__))
-#define GL_LOG_INFO(...) Logger::log(LOG_LEVEL_INFO, std::format(__VA_ARGS__))
-#define GL_LOG_WARNING(...) Logger::log(LOG_LEVEL_WARNING, std::format(__VA_ARGS__))
-#define GL_LOG_ERROR(...) Logger::log(LOG_LEVEL_ERROR, std::format(__VA_ARGS__))
-#define GL_LOG_FATAL(...) Logger::log(LOG_LEVEL_FATAL, std::format(__VA_ARGS__))
+// Levels below are compiled out entirely, see `LogLevel` for the values
+#ifndef GL_LOG_LEVEL_MIN
+#define GL_LOG_LEVEL_MIN 0
+#endif
+
+#define GL_LOG_EXPAND_MACRO(x) x
+#define GL_LOG_FORMAT_STRING_IMPL(fmt, ...) fmt
+#define GL_LOG_FORMAT_STRING(...) GL_LOG_EXPAND_MACRO(GL_LOG_FORMAT_STRING_IMPL(__VA_ARGS__, _))
+
+#define GL_LOG_SITE(...)                                                                           \
+	static constinit ::gl::LogSite _gl_log_site(                                                   \
+			GL_LOG_FORMAT_STRING(__VA_ARGS__), __FILE__, __LINE__)
+
+#define GL_LOG_IMPL(level, ...)                                                                    \
+	do {                                                                                           \
+		GL_LOG_SITE(__VA_ARGS__);                                                                  \
+		if (::gl::Logger::is_level_enabled(level)) {                                               \
+			::gl::Logger::log_site(level, _gl_log_site, 0, __VA_ARGS__);                           \
+		}                                                                                          \
+	} while (false)
+
+// Lets a burst of messages per second through, the rest are counted and
+// reported with the next message or in a summary once the site goes quiet.
+#define GL_LOG_RATE_LIMITED_IMPL(level, ...)                                                       \
+	do {                                                                                           \
+		GL_LOG_SITE(__VA_ARGS__);                                                                  \
+		uint32_t _gl_log_suppressed = 0;                                                           \
+		if (::gl::Logger::is_level_enabled(level) &&                                               \
+				_gl_log_site.limiter.acquire(&_gl_log_suppressed)) {                               \
+			::gl::Logger::log_site(level, _gl_log_site, _gl_log_suppressed, __VA_ARGS__);          \
+		}                                                                                          \
+	} while (false)
+
+#if GL_LOG_LEVEL_MIN <= 0
+#define GL_LOG_TRACE(...) GL_LOG_IMPL(::gl::LOG_LEVEL_TRACE, __VA_ARGS__)
+#define GL_LOG_TRACE_RATE_LIMITED(...) GL_LOG_RATE_LIMITED_IMPL(::gl::LOG_LEVEL_TRACE, __VA_ARGS__)
+#else
+#define GL_LOG_TRACE(...) ((void)0)
+#define GL_LOG_TRACE_RATE_LIMITED(...) ((void)0)
+#endif
+
+#if GL_LOG_LEVEL_MIN <= 1
+#define GL_LOG_INFO(...) GL_LOG_IMPL(::gl::LOG_LEVEL_INFO, __VA_ARGS__)
+#define GL_LOG_INFO_RATE_LIMITED(...) GL_LOG_RATE_LIMITED_IMPL(::gl::LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define GL_LOG_INFO(...) ((void)0)
+#define GL_LOG_INFO_RATE_LIMITED(...) ((void)0)
+#endif
+
+#if GL_LOG_LEVEL_MIN <= 2
+#define GL_LOG_WARNING(...) GL_LOG_IMPL(::gl::LOG_LEVEL_WARNING, __VA_ARGS__)
+#define GL_LOG_WARNING_RATE_LIMITED(...)                                                           \
+	GL_LOG_RATE_LIMITED_IMPL(::gl::LOG_LEVEL_WARNING, __VA_ARGS__)
+#else
+#define GL_LOG_WARNING(...) ((void)0)
+#define GL_LOG_WARNING_RATE_LIMITED(...) ((void)0)
+#endif
+
+#if GL_LOG_LEVEL_MIN <= 3
+#define GL_LOG_ERROR(...) GL_LOG_IMPL(::gl::LOG_LEVEL_ERROR, __VA_ARGS__)
+#define GL_LOG_ERROR_RATE_LIMITED(...) GL_LOG_RATE_LIMITED_IMPL(::gl::LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define GL_LOG_ERROR(...) ((void)0)
+#define GL_LOG_ERROR_RATE_LIMITED(...) ((void)0)
+#endif
+
+// Fatal messages precede asserts and are never compiled out
+#define GL_LOG_FATAL(...) GL_LOG_IMPL(::gl::LOG_LEVEL_FATAL, __VA_ARGS__)
 
 } //namespace gl
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "glgpu/math.h"
+#include "glgpu/simd.h"
 #include "glgpu/vec.h"
 
 namespace gl {
@@ -46,6 +47,46 @@ template <> struct Mat<4, 4> {
 	}
 
 	Mat operator*(const Mat& p_other) const {
+#if defined(GL_SIMD_SSE)
+		const __m128 c0 = _mm_loadu_ps(cols[0].data());
+		const __m128 c1 = _mm_loadu_ps(cols[1].data());
+		const __m128 c2 = _mm_loadu_ps(cols[2].data());
+		const __m128 c3 = _mm_loadu_ps(cols[3].data());
+
+		Mat res = Mat::empty();
+		for (int c = 0; c < 4; ++c) {
+			// Linear combination of our columns weighted by the other column
+			const __m128 o = _mm_loadu_ps(p_other.cols[c].data());
+			__m128 r = _mm_mul_ps(c0, _mm_shuffle_ps(o, o, _MM_SHUFFLE(0, 0, 0, 0)));
+			r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_shuffle_ps(o, o, _MM_SHUFFLE(1, 1, 1, 1))));
+			r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_shuffle_ps(o, o, _MM_SHUFFLE(2, 2, 2, 2))));
+			r = _mm_add_ps(r, _mm_mul_ps(c3, _mm_shuffle_ps(o, o, _MM_SHUFFLE(3, 3, 3, 3))));
+			_mm_storeu_ps(res.cols[c].data(), r);
+		}
+		return res;
+#elif defined(GL_SIMD_NEON)
+		const float32x4_t c0 = vld1q_f32(cols[0].data());
+		const float32x4_t c1 = vld1q_f32(cols[1].data());
+		const float32x4_t c2 = vld1q_f32(cols[2].data());
+		const float32x4_t c3 = vld1q_f32(cols[3].data());
+
+		Mat res = Mat::empty();
+		for (int c = 0; c < 4; ++c) {
+			const float32x4_t o = vld1q_f32(p_other.cols[c].data());
+			float32x4_t r = vmulq_laneq_f32(c0, o, 0);
+			r = vfmaq_laneq_f32(r, c1, o, 1);
+			r = vfmaq_laneq_f32(r, c2, o, 2);
+			r = vfmaq_laneq_f32(r, c3, o, 3);
+			vst1q_f32(res.cols[c].data(), r);
+		}
+		return res;
+#else
+		return mul_scalar(p_other);
+#endif
+	}
+
+	// Reference implementation the vectorized paths are checked against
+	Mat mul_scalar(const Mat& p_other) const {
 		Mat res = Mat::empty();
 		for (int c = 0; c < 4; ++c) {
 			for (int r = 0; r < 4; ++r) {
@@ -60,11 +101,27 @@ template <> struct Mat<4, 4> {
 	// Matrix * Vector Multiplication
 	Vec4f operator*(const Vec4f& p_v) const {
 		Vec4f res;
+#if defined(GL_SIMD_SSE)
+		const __m128 v = _mm_loadu_ps(&p_v.x);
+		__m128 r = _mm_mul_ps(_mm_loadu_ps(cols[0].data()), _mm_shuffle_ps(v, v, 0x00));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(cols[1].data()), _mm_shuffle_ps(v, v, 0x55)));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(cols[2].data()), _mm_shuffle_ps(v, v, 0xAA)));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(cols[3].data()), _mm_shuffle_ps(v, v, 0xFF)));
+		_mm_storeu_ps(&res.x, r);
+#elif defined(GL_SIMD_NEON)
+		const float32x4_t v = vld1q_f32(&p_v.x);
+		float32x4_t r = vmulq_laneq_f32(vld1q_f32(cols[0].data()), v, 0);
+		r = vfmaq_laneq_f32(r, vld1q_f32(cols[1].data()), v, 1);
+		r = vfmaq_laneq_f32(r, vld1q_f32(cols[2].data()), v, 2);
+		r = vfmaq_laneq_f32(r, vld1q_f32(cols[3].data()), v, 3);
+		vst1q_f32(&res.x, r);
+#else
 		// Linear combination of columns
 		res.x = cols[0][0] * p_v.x + cols[1][0] * p_v.y + cols[2][0] * p_v.z + cols[3][0] * p_v.w;
 		res.y = cols[0][1] * p_v.x + cols[1][1] * p_v.y + cols[2][1] * p_v.z + cols[3][1] * p_v.w;
 		res.z = cols[0][2] * p_v.x + cols[1][2] * p_v.y + cols[2][2] * p_v.z + cols[3][2] * p_v.w;
 		res.w = cols[0][3] * p_v.x + cols[1][3] * p_v.y + cols[2][3] * p_v.z + cols[3][3] * p_v.w;
+#endif
 		return res;
 	}
 
@@ -82,6 +139,35 @@ template <> struct Mat<4, 4> {
 	// Linalg utilities
 
 	Mat transpose() const {
+#if defined(GL_SIMD_SSE)
+		__m128 c0 = _mm_loadu_ps(cols[0].data());
+		__m128 c1 = _mm_loadu_ps(cols[1].data());
+		__m128 c2 = _mm_loadu_ps(cols[2].data());
+		__m128 c3 = _mm_loadu_ps(cols[3].data());
+		_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+		Mat res = Mat::empty();
+		_mm_storeu_ps(res.cols[0].data(), c0);
+		_mm_storeu_ps(res.cols[1].data(), c1);
+		_mm_storeu_ps(res.cols[2].data(), c2);
+		_mm_storeu_ps(res.cols[3].data(), c3);
+		return res;
+#elif defined(GL_SIMD_NEON)
+		// De-interleaving load, every 4th element ends up in the same register
+		const float32x4x4_t rows = vld4q_f32(cols[0].data());
+
+		Mat res = Mat::empty();
+		vst1q_f32(res.cols[0].data(), rows.val[0]);
+		vst1q_f32(res.cols[1].data(), rows.val[1]);
+		vst1q_f32(res.cols[2].data(), rows.val[2]);
+		vst1q_f32(res.cols[3].data(), rows.val[3]);
+		return res;
+#else
+		return transpose_scalar();
+#endif
+	}
+
+	Mat transpose_scalar() const {
 		Mat res = Mat::empty();
 		for (int c = 0; c < 4; ++c) {
 			for (int r = 0; r < 4; ++r) {
@@ -107,6 +193,14 @@ template <> struct Mat<4, 4> {
 	}
 
 	Mat inverse() const {
+#if defined(GL_SIMD_SSE)
+		return _inverse_sse();
+#else
+		return inverse_scalar();
+#endif
+	}
+
+	Mat inverse_scalar() const {
 		const float det = determinant();
 		if (std::abs(det) < 1e-6f)
 			return Mat::empty();
@@ -142,6 +236,94 @@ template <> struct Mat<4, 4> {
 		return res;
 	}
 
+#if defined(GL_SIMD_SSE)
+	// Inverse through 2x2 blocks, the matrix is split into
+	//  | A B |
+	//  | C D |
+	// and the adjugates of the blocks are computed in one register each.
+	// Agnostic to the storage order since inverse(transpose(M)) is the
+	// transpose of inverse(M).
+	Mat _inverse_sse() const {
+		const __m128 c0 = _mm_loadu_ps(cols[0].data());
+		const __m128 c1 = _mm_loadu_ps(cols[1].data());
+		const __m128 c2 = _mm_loadu_ps(cols[2].data());
+		const __m128 c3 = _mm_loadu_ps(cols[3].data());
+
+		const __m128 a = _mm_movelh_ps(c0, c1);
+		const __m128 b = _mm_movehl_ps(c1, c0);
+		const __m128 c = _mm_movelh_ps(c2, c3);
+		const __m128 d = _mm_movehl_ps(c3, c2);
+
+		// Determinants of the blocks as (|A| |B| |C| |D|)
+		const __m128 det_sub = _mm_sub_ps(
+				_mm_mul_ps(_mm_shuffle_ps(c0, c2, _MM_SHUFFLE(2, 0, 2, 0)),
+						_mm_shuffle_ps(c1, c3, _MM_SHUFFLE(3, 1, 3, 1))),
+				_mm_mul_ps(_mm_shuffle_ps(c0, c2, _MM_SHUFFLE(3, 1, 3, 1)),
+						_mm_shuffle_ps(c1, c3, _MM_SHUFFLE(2, 0, 2, 0))));
+		const __m128 det_a = _swizzle<0, 0, 0, 0>(det_sub);
+		const __m128 det_b = _swizzle<1, 1, 1, 1>(det_sub);
+		const __m128 det_c = _swizzle<2, 2, 2, 2>(det_sub);
+		const __m128 det_d = _swizzle<3, 3, 3, 3>(det_sub);
+
+		const __m128 d_c = _mat2_adj_mul(d, c);
+		const __m128 a_b = _mat2_adj_mul(a, b);
+
+		__m128 x = _mm_sub_ps(_mm_mul_ps(det_d, a), _mat2_mul(b, d_c));
+		__m128 w = _mm_sub_ps(_mm_mul_ps(det_a, d), _mat2_mul(c, a_b));
+		__m128 y = _mm_sub_ps(_mm_mul_ps(det_b, c), _mat2_mul_adj(d, a_b));
+		__m128 z = _mm_sub_ps(_mm_mul_ps(det_c, b), _mat2_mul_adj(a, d_c));
+
+		// |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+		__m128 tr = _mm_mul_ps(a_b, _swizzle<0, 2, 1, 3>(d_c));
+		tr = _mm_add_ps(tr, _swizzle<2, 3, 0, 1>(tr));
+		tr = _mm_add_ps(tr, _swizzle<1, 0, 3, 2>(tr));
+		const __m128 det =
+				_mm_sub_ps(_mm_add_ps(_mm_mul_ps(det_a, det_d), _mm_mul_ps(det_b, det_c)), tr);
+
+		if (std::abs(_mm_cvtss_f32(det)) < 1e-6f) {
+			return Mat::empty();
+		}
+
+		const __m128 inv_det = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+		x = _mm_mul_ps(x, inv_det);
+		y = _mm_mul_ps(y, inv_det);
+		z = _mm_mul_ps(z, inv_det);
+		w = _mm_mul_ps(w, inv_det);
+
+		// Adjugate of the blocks folded into the shuffles of the store
+		Mat res = Mat::empty();
+		_mm_storeu_ps(res.cols[0].data(), _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)));
+		_mm_storeu_ps(res.cols[1].data(), _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)));
+		_mm_storeu_ps(res.cols[2].data(), _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)));
+		_mm_storeu_ps(res.cols[3].data(), _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)));
+		return res;
+	}
+
+	template <int X, int Y, int Z, int W> static __m128 _swizzle(__m128 p_v) {
+		return _mm_shuffle_ps(p_v, p_v, _MM_SHUFFLE(W, Z, Y, X));
+	}
+
+	// 2x2 blocks are stored as (m00 m01 m10 m11)
+
+	// A * B
+	static __m128 _mat2_mul(__m128 p_a, __m128 p_b) {
+		return _mm_add_ps(_mm_mul_ps(p_a, _swizzle<0, 3, 0, 3>(p_b)),
+				_mm_mul_ps(_swizzle<1, 0, 3, 2>(p_a), _swizzle<2, 1, 2, 1>(p_b)));
+	}
+
+	// adj(A) * B
+	static __m128 _mat2_adj_mul(__m128 p_a, __m128 p_b) {
+		return _mm_sub_ps(_mm_mul_ps(_swizzle<3, 3, 0, 0>(p_a), p_b),
+				_mm_mul_ps(_swizzle<1, 1, 2, 2>(p_a), _swizzle<2, 3, 0, 1>(p_b)));
+	}
+
+	// A * adj(B)
+	static __m128 _mat2_mul_adj(__m128 p_a, __m128 p_b) {
+		return _mm_sub_ps(_mm_mul_ps(p_a, _swizzle<3, 0, 3, 0>(p_b)),
+				_mm_mul_ps(_swizzle<1, 0, 3, 2>(p_a), _swizzle<2, 1, 2, 1>(p_b)));
+	}
+#endif
+
 	// Transformations
 
 	// Creates a translation matrix
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "glgpu/mat.h"
+
+namespace gl {
+
+/**
+ * Kernels working on whole arrays of matrices and vectors, dispatched at
+ * runtime to the widest instruction set `simd_get_level` reports. Outputs may
+ * alias the inputs element for element.
+ */
+
+// o_out[i] = p_lhs * p_rhs[i]
+void mat4_mul_batch(const Mat4& p_lhs, const Mat4* p_rhs, Mat4* o_out, size_t p_count);
+
+// o_out[i] = p_lhs[i] * p_rhs[i]
+void mat4_mul_pairs(const Mat4* p_lhs, const Mat4* p_rhs, Mat4* o_out, size_t p_count);
+
+void mat4_transpose_batch(const Mat4* p_in, Mat4* o_out, size_t p_count);
+
+// Singular matrices become zero matrices, same as `Mat4::inverse`
+void mat4_inverse_batch(const Mat4* p_in, Mat4* o_out, size_t p_count);
+
+/**
+ * Vectors in structure of arrays layout, component `i` of vector `n` is at
+ * `components[i][n]`.
+ */
+struct Vec4SoA {
+	float* x;
+	float* y;
+	float* z;
+	// Optional on input, null means every vector is a point (w = 1)
+	float* w;
+};
+
+// o_out[i] = p_mat * p_in[i], `o_out.w` is optional as well
+void mat4_transform_soa(const Mat4& p_mat, const Vec4SoA& p_in, const Vec4SoA& o_out,
+		size_t p_count);
+
+} //namespace gl
@@ -0,0 +1,573 @@
+#pragma once
+
+#include "glgpu/assert.h"
+#include "glgpu/backend.h"
+#include "glgpu/command_state.h"
+#include "glgpu/handle_table.h"
+#include "glgpu/paged_allocator.h"
+
+namespace gl {
+
+enum class NullCommandType : uint8_t {
+	BEGIN_RENDER_PASS,
+	END_RENDER_PASS,
+	BEGIN_RENDERING,
+	END_RENDERING,
+	BIND_GRAPHICS_PIPELINE,
+	BIND_COMPUTE_PIPELINE,
+	BIND_VERTEX_BUFFERS,
+	BIND_INDEX_BUFFER,
+	BIND_UNIFORM_SETS,
+	PUSH_CONSTANTS,
+	DRAW,
+	DRAW_INDEXED,
+	DRAW_INDEXED_INDIRECT,
+	DISPATCH,
+	SET_VIEWPORT,
+	SET_SCISSOR,
+	SET_DEPTH_BIAS,
+	CLEAR_COLOR,
+	COPY_BUFFER,
+	BUFFER_MEMORY_BARRIER,
+	COPY_BUFFER_TO_IMAGE,
+	COPY_IMAGE_TO_BUFFER,
+	COPY_IMAGE_TO_IMAGE,
+	TRANSITION_IMAGE,
+	RESET_QUERY_POOL,
+	WRITE_TIMESTAMP,
+	BEGIN_QUERY,
+	END_QUERY,
+	BEGIN_LABEL,
+	END_LABEL,
+};
+
+const char* get_null_command_name(NullCommandType p_type);
+
+/**
+ * Single recorded command. Handles the command refers to are stored in the
+ * owning command buffer's handle stream, scalar arguments are stored in `args`
+ * in the order of the matching `RenderBackend::command_*` parameters. Array
+ * arguments go to a stream of the command buffer as well, `BIND_VERTEX_BUFFERS`
+ * stores the index of its first offset in `args[1]`, one offset per handle.
+ * `BEGIN_LABEL` stores the index of its copied name in `args[1]`.
+ */
+struct NullCommand {
+	NullCommandType type;
+	uint32_t handle_offset = 0;
+	uint32_t handle_count = 0;
+	uint64_t args[4] = {};
+};
+
+struct NullSubmission {
+	CommandQueue queue;
+	CommandBuffer command_buffer;
+	Fence fence;
+	Semaphore wait_semaphore;
+	Semaphore signal_semaphore;
+	// Number of commands the command buffer held at submission time
+	uint32_t command_count;
+};
+
+/**
+ * Backend implementing the whole `RenderBackend` interface without a driver.
+ * Handles are bookkept like the Vulkan backend does and commands are recorded
+ * into an inspectable stream, making it possible to measure and test the CPU
+ * side of an application deterministically on machines without a GPU.
+ *
+ * Queue operations complete immediately, fences are signaled on submit and
+ * query results read as zeros. Not thread safe.
+ */
+class NullRenderBackend : public RenderBackend {
+public:
+	NullRenderBackend(const RenderBackendCreateInfo& p_info);
+	virtual ~NullRenderBackend();
+
+	// =========================================================================
+	// Inspection
+	// =========================================================================
+
+	struct NullCommandBuffer {
+		std::vector<NullCommand> commands;
+		std::vector<const void*> handles;
+		// Vertex buffer offsets and label names, see `NullCommand`
+		std::vector<uint64_t> offsets;
+		std::vector<std::string> labels;
+		CommandPool pool = GL_NULL_HANDLE;
+		CommandStateCache state;
+		bool recording = false;
+	};
+
+	const NullCommandBuffer& get_command_buffer(CommandBuffer p_cmd) const;
+
+	template <typename T> T get_command_handle(CommandBuffer p_cmd, const NullCommand& p_command,
+			uint32_t p_index) const {
+		const NullCommandBuffer& command_buffer = get_command_buffer(p_cmd);
+
+		GL_ASSERT(p_index < p_command.handle_count, "Command handle index out of range");
+		return (T)command_buffer.handles[p_command.handle_offset + p_index];
+	}
+
+	uint64_t get_command_offset(
+			CommandBuffer p_cmd, const NullCommand& p_command, uint32_t p_index) const {
+		const NullCommandBuffer& command_buffer = get_command_buffer(p_cmd);
+
+		GL_ASSERT(p_command.type == NullCommandType::BIND_VERTEX_BUFFERS,
+				"Only vertex buffer binds record offsets");
+		GL_ASSERT(p_index < p_command.handle_count, "Command offset index out of range");
+		return command_buffer.offsets[p_command.args[1] + p_index];
+	}
+
+	const std::string& get_command_label(CommandBuffer p_cmd, const NullCommand& p_command) const {
+		const NullCommandBuffer& command_buffer = get_command_buffer(p_cmd);
+
+		GL_ASSERT(p_command.type == NullCommandType::BEGIN_LABEL, "Only labels record names");
+		return command_buffer.labels[p_command.args[1]];
+	}
+
+	const std::vector<NullSubmission>& get_submissions() const;
+	void clear_submissions();
+
+	// Empty string if the object was never named
+	std::string get_object_name(const void* p_handle) const;
+
+	// Number of resources currently alive, including command pools and buffers
+	uint64_t get_live_resource_count() const;
+
+	// =========================================================================
+	// Device & Surface
+	// =========================================================================
+
+	void device_wait() override;
+
+	Error attach_surface(void* p_connection_handle, void* p_window_handle) override;
+
+	bool is_swapchain_supported() override;
+
+	CommandQueue queue_get(QueueType p_type) override;
+
+	uint32_t get_max_msaa_samples() const override;
+
+	FrameStats get_frame_stats() const override;
+
+	void reset_frame_stats() override;
+
+	// =========================================================================
+	// Swapchain
+	// =========================================================================
+
+	Swapchain swapchain_create() override;
+
+	void swapchain_resize(CommandQueue p_cmd_queue, Swapchain p_swapchain,
+			const SwapchainCreateInfo& p_info) override;
+
+	size_t swapchain_get_image_count(Swapchain p_swapchain) override;
+
+	std::vector<Image> swapchain_get_images(Swapchain p_swapchain) override;
+
+	Result<Image, Error> swapchain_acquire_image(Swapchain p_swapchain, Semaphore p_semaphore,
+			uint64_t p_timeout, uint32_t* o_image_index) override;
+
+	Vec2u swapchain_get_extent(Swapchain p_swapchain) override;
+
+	DataFormat swapchain_get_format(Swapchain p_swapchain) override;
+
+	bool swapchain_pop_frame(Swapchain p_swapchain, SwapchainFrame* o_frame) override;
+
+	void swapchain_free(Swapchain p_swapchain) override;
+
+	// =========================================================================
+	// Resource Management (Buffers & Images)
+	// =========================================================================
+
+	Buffer buffer_create(uint64_t p_size, BufferUsageFlags p_usage,
+			MemoryAllocationType p_allocation_type) override;
+
+	void buffer_free(Buffer p_buffer) override;
+
+	BufferDeviceAddress buffer_get_device_address(Buffer p_buffer) override;
+
+	uint8_t* buffer_map(Buffer p_buffer) override;
+
+	void buffer_unmap(Buffer p_buffer) override;
+
+	void buffer_invalidate(Buffer p_buffer) override;
+
+	void buffer_flush(Buffer p_buffer) override;
+
+	Image image_create(const ImageCreateInfo& p_info) override;
+
+	void image_free(Image p_image) override;
+
+	Vec3u image_get_size(Image p_image) override;
+
+	DataFormat image_get_format(Image p_image) override;
+
+	uint32_t image_get_mip_levels(Image p_image) override;
+
+	Sampler sampler_create(const SamplerCreateInfo& p_info) override;
+
+	void sampler_free(Sampler p_sampler) override;
+
+	// =========================================================================
+	// Shader & Pipelines
+	// =========================================================================
+
+	Shader shader_create_from_bytecode(const std::vector<SpirvEntry>& p_shaders) override;
+
+	void shader_free(Shader p_shader) override;
+
+	std::vector<ShaderInterfaceVariable> shader_get_vertex_inputs(Shader p_shader) override;
+
+	Pipeline render_pipeline_create(const RenderPipelineCreateInfo& p_info) override;
+
+	Pipeline compute_pipeline_create(Shader p_shader) override;
+
+	void pipeline_free(Pipeline p_pipeline) override;
+
+	UniformSet uniform_set_create(
+			std::vector<ShaderUniform> p_uniforms, Shader p_shader, uint32_t p_set_index) override;
+
+	void uniform_set_free(UniformSet p_uniform_set) override;
+
+	// =========================================================================
+	// Render Pass & Framebuffer
+	// =========================================================================
+
+	RenderPass render_pass_create(std::vector<RenderPassAttachment> p_attachments,
+			std::vector<SubpassInfo> p_subpasses) override;
+
+	void render_pass_destroy(RenderPass p_render_pass) override;
+
+	FrameBuffer frame_buffer_create(RenderPass p_render_pass, std::vector<Image> p_attachments,
+			const Vec2u& p_extent) override;
+
+	void frame_buffer_destroy(FrameBuffer p_frame_buffer) override;
+
+	// =========================================================================
+	// Synchronization
+	// =========================================================================
+
+	Fence fence_create(bool p_create_signaled = true) override;
+
+	void fence_free(Fence p_fence) override;
+
+	void fence_wait(Fence p_fence) override;
+
+	void fence_reset(Fence p_fence) override;
+
+	Semaphore semaphore_create() override;
+
+	void semaphore_free(Semaphore p_semaphore) override;
+
+	// =========================================================================
+	// Queries
+	// =========================================================================
+
+	QueryPool query_pool_create(QueryType p_type, uint32_t p_query_count) override;
+
+	void query_pool_free(QueryPool p_query_pool) override;
+
+	bool query_pool_get_results(QueryPool p_query_pool, uint32_t p_first_query,
+			uint32_t p_query_count, uint64_t* o_results) override;
+
+	float get_timestamp_period() const override;
+
+	uint32_t get_timestamp_valid_bits() const override;
+
+	bool is_pipeline_statistics_supported() const override;
+
+	// =========================================================================
+	// Debugging
+	// =========================================================================
+
+	void buffer_set_name(Buffer p_buffer, const char* p_name) override;
+
+	void image_set_name(Image p_image, const char* p_name) override;
+
+	void sampler_set_name(Sampler p_sampler, const char* p_name) override;
+
+	void command_pool_set_name(CommandPool p_command_pool, const char* p_name) override;
+
+	void command_buffer_set_name(CommandBuffer p_command_buffer, const char* p_name) override;
+
+	void queue_set_name(CommandQueue p_queue, const char* p_name) override;
+
+	void render_pass_set_name(RenderPass p_render_pass, const char* p_name) override;
+
+	void frame_buffer_set_name(FrameBuffer p_frame_buffer, const char* p_name) override;
+
+	void swapchain_set_name(Swapchain p_swapchain, const char* p_name) override;
+
+	void pipeline_set_name(Pipeline p_pipeline, const char* p_name) override;
+
+	void shader_set_name(Shader p_shader, const char* p_name) override;
+
+	void uniform_set_set_name(UniformSet p_uniform_set, const char* p_name) override;
+
+	void fence_set_name(Fence p_fence, const char* p_name) override;
+
+	void semaphore_set_name(Semaphore p_semaphore, const char* p_name) override;
+
+	void query_pool_set_name(QueryPool p_query_pool, const char* p_name) override;
+
+	// =========================================================================
+	// Command Submission & Recording
+	// =========================================================================
+
+	void queue_submit(CommandQueue p_queue, CommandBuffer p_cmd, Fence p_fence = GL_NULL_HANDLE,
+			Semaphore p_wait_semaphore = GL_NULL_HANDLE,
+			Semaphore p_signal_semaphore = GL_NULL_HANDLE) override;
+
+	bool queue_present(CommandQueue p_queue, Swapchain p_swapchain,
+			Semaphore p_wait_semaphore = GL_NULL_HANDLE) override;
+
+	CommandPool command_pool_create(CommandQueue p_queue) override;
+
+	void command_pool_free(CommandPool p_command_pool) override;
+
+	CommandBuffer command_pool_allocate(CommandPool p_command_pool) override;
+
+	std::vector<CommandBuffer> command_pool_allocate(
+			CommandPool p_command_pool, const uint32_t p_count) override;
+
+	void command_pool_reset(CommandPool p_command_pool) override;
+
+	void command_immediate_submit(std::function<void(CommandBuffer p_cmd)>&& p_function,
+			QueueType p_queue_type = QueueType::TRANSFER) override;
+
+	void command_begin(CommandBuffer p_cmd) override;
+
+	void command_end(CommandBuffer p_cmd) override;
+
+	void command_reset(CommandBuffer p_cmd) override;
+
+	void command_begin_render_pass(CommandBuffer p_cmd, RenderPass p_render_pass,
+			FrameBuffer p_framebuffer, const Vec2u& p_draw_extent,
+			Color p_clear_color = COLOR_GRAY) override;
+
+	void command_end_render_pass(CommandBuffer p_cmd) override;
+
+	void command_begin_rendering(CommandBuffer p_cmd, const Vec2u& p_draw_extent,
+			std::vector<RenderingAttachment> p_color_attachments,
+			Image p_depth_attachment = GL_NULL_HANDLE) override;
+
+	void command_end_rendering(CommandBuffer p_cmd) override;
+
+	void command_bind_graphics_pipeline(CommandBuffer p_cmd, Pipeline p_pipeline) override;
+
+	void command_bind_compute_pipeline(CommandBuffer p_cmd, Pipeline p_pipeline) override;
+
+	void command_bind_vertex_buffers(CommandBuffer p_cmd, uint32_t p_first_binding,
+			std::vector<Buffer> p_vertex_buffers, std::vector<uint64_t> p_offsets) override;
+
+	void command_bind_index_buffer(CommandBuffer p_cmd, Buffer p_index_buffer, uint64_t p_offset,
+			IndexType p_index_type) override;
+
+	void command_bind_uniform_sets(CommandBuffer p_cmd, Shader p_shader, uint32_t p_first_set,
+			std::vector<UniformSet> p_uniform_sets,
+			PipelineType p_type = PipelineType::GRAPHICS) override;
+
+	void command_push_constants(CommandBuffer p_cmd, Shader p_shader, uint64_t p_offset,
+			uint32_t p_size, const void* p_push_constants) override;
+
+	void command_draw(CommandBuffer p_cmd, uint32_t p_vertex_count, uint32_t p_instance_count = 1,
+			uint32_t p_first_vertex = 0, uint32_t p_first_instance = 0) override;
+
+	void command_draw_indexed(CommandBuffer p_cmd, uint32_t p_index_count,
+			uint32_t p_instance_count = 1, uint32_t p_first_index = 0, int32_t p_vertex_offset = 0,
+			uint32_t p_first_instance = 0) override;
+
+	void command_draw_indexed_indirect(CommandBuffer p_cmd, Buffer p_buffer, uint64_t p_offset,
+			uint32_t p_draw_count, uint32_t p_stride) override;
+
+	void command_dispatch(CommandBuffer p_cmd, uint32_t p_group_count_x, uint32_t p_group_count_y,
+			uint32_t p_group_count_z) override;
+
+	void command_set_viewport(CommandBuffer p_cmd, const Vec2u& p_size) override;
+
+	void command_set_scissor(
+			CommandBuffer p_cmd, const Vec2u& p_size, const Vec2u& p_offset = { 0, 0 }) override;
+
+	void command_set_depth_bias(CommandBuffer p_cmd, float p_depth_bias_constant_factor,
+			float p_depth_bias_clamp, float p_depth_bias_slope_factor) override;
+
+	void command_clear_color(CommandBuffer p_cmd, Image p_image, const Color& p_clear_color,
+			ImageAspectFlags p_image_aspect = IMAGE_ASPECT_COLOR_BIT) override;
+
+	void command_copy_buffer(CommandBuffer p_cmd, Buffer p_src_buffer, Buffer p_dst_buffer,
+			std::vector<BufferCopyRegion> p_regions) override;
+
+	void command_buffer_memory_barrier(CommandBuffer p_cmd, BufferUsageFlags p_src_usage,
+			BufferUsageFlags p_dst_usage, Buffer p_buffer) override;
+
+	void command_copy_buffer_to_image(CommandBuffer p_cmd, Buffer p_src_buffer, Image p_dst_image,
+			std::vector<BufferImageCopyRegion> p_regions) override;
+
+	void command_copy_image_to_buffer(CommandBuffer p_cmd, Image p_src_image, Buffer p_dst_buffer,
+			std::vector<BufferImageCopyRegion> p_regions) override;
+
+	void command_copy_image_to_image(CommandBuffer p_cmd, Image p_src_image, Image p_dst_image,
+			const Vec2u& p_src_extent, const Vec2u& p_dst_extent, uint32_t p_src_mip_level = 0,
+			uint32_t p_dst_mip_level = 0) override;
+
+	void command_transition_image(CommandBuffer p_cmd, Image p_image, ImageLayout p_current_layout,
+			ImageLayout p_new_layout, uint32_t p_base_mip_level = 0,
+			uint32_t p_level_count = GL_REMAINING_MIP_LEVELS) override;
+
+	void command_reset_query_pool(CommandBuffer p_cmd, QueryPool p_query_pool,
+			uint32_t p_first_query, uint32_t p_query_count) override;
+
+	void command_write_timestamp(
+			CommandBuffer p_cmd, QueryPool p_query_pool, uint32_t p_query_index) override;
+
+	void command_begin_query(CommandBuffer p_cmd, QueryPool p_query_pool, uint32_t p_query_index,
+			bool p_precise = false) override;
+
+	void command_end_query(
+			CommandBuffer p_cmd, QueryPool p_query_pool, uint32_t p_query_index) override;
+
+	void command_begin_label(
+			CommandBuffer p_cmd, const char* p_name, const Color& p_color = COLOR_WHITE) override;
+
+	void command_end_label(CommandBuffer p_cmd) override;
+
+public:
+	struct NullBuffer {
+		uint64_t size = 0;
+		BufferUsageFlags usage = 0;
+		MemoryAllocationType allocation_type = MemoryAllocationType::GPU;
+		// Backing storage, only allocated once the buffer gets mapped
+		std::vector<uint8_t> data;
+	};
+
+	struct NullImage {
+		DataFormat format = DataFormat::UNDEFINED;
+		Vec3u size = { 0, 0, 0 };
+		ImageUsageFlags usage = 0;
+		uint32_t mip_levels = 1;
+		uint32_t samples = 1;
+	};
+
+	struct NullSampler {
+		SamplerCreateInfo info;
+	};
+
+	struct NullShader {
+		std::vector<ShaderStageFlags> stages;
+		size_t byte_code_size = 0;
+	};
+
+	struct NullPipeline {
+		Shader shader = GL_NULL_HANDLE;
+		PipelineType type = PipelineType::GRAPHICS;
+	};
+
+	struct NullUniformSet {
+		Shader shader = GL_NULL_HANDLE;
+		uint32_t set_index = 0;
+		std::vector<ShaderUniform> uniforms;
+	};
+
+	struct NullRenderPass {
+		std::vector<RenderPassAttachment> attachments;
+		std::vector<SubpassInfo> subpasses;
+	};
+
+	struct NullFrameBuffer {
+		RenderPass render_pass = GL_NULL_HANDLE;
+		std::vector<Image> attachments;
+		Vec2u extent = { 0, 0 };
+	};
+
+	struct NullSwapchain {
+		std::vector<NullImage> images;
+		std::vector<Image> image_handles;
+		Vec2u extent = { 0, 0 };
+		DataFormat format = DataFormat::B8G8R8A8_UNORM;
+		uint32_t image_index = 0;
+		PresentMode present_mode = PresentMode::FIFO;
+	};
+
+	struct NullFence {
+		bool signaled = false;
+	};
+
+	struct NullSemaphore {
+		uint64_t signal_count = 0;
+	};
+
+	struct NullQueryPool {
+		QueryType type = QueryType::TIMESTAMP;
+		uint32_t query_count = 0;
+	};
+
+	struct NullQueue {
+		QueueType type;
+	};
+
+	struct NullCommandPool {
+		CommandQueue queue = GL_NULL_HANDLE;
+		std::vector<CommandBuffer> command_buffers;
+	};
+
+private:
+	NullCommandBuffer* _get_recording_command_buffer(CommandBuffer p_cmd);
+
+	void _swapchain_release_images(NullSwapchain* p_swapchain);
+
+	NullCommand& _record(CommandBuffer p_cmd, NullCommandType p_type,
+			std::initializer_list<const void*> p_handles = {});
+
+	template <typename T> PagedAllocator<T>& _get_allocator() {
+		return std::get<PagedAllocator<T>>(allocators);
+	}
+
+	template <typename T> T* _allocate() {
+		stats.resources_created++;
+		live_resource_count++;
+		return _get_allocator<T>().alloc();
+	}
+
+	template <typename T, typename H> T* _get(H p_handle) const {
+		return (T*)handles.get(p_handle);
+	}
+
+	template <typename T, typename H> void _free(H p_handle) {
+		stats.resources_destroyed++;
+		live_resource_count--;
+		object_names.erase(p_handle);
+
+		_get_allocator<T>().free((T*)handles.remove(p_handle));
+	}
+
+	void _set_name(const void* p_handle, const char* p_name);
+
+private:
+	// One pool per resource type, see `_get_allocator`
+	std::tuple<PagedAllocator<NullBuffer>, PagedAllocator<NullImage>,
+			PagedAllocator<NullSampler>, PagedAllocator<NullShader>, PagedAllocator<NullPipeline>,
+			PagedAllocator<NullUniformSet>, PagedAllocator<NullRenderPass>,
+			PagedAllocator<NullFrameBuffer>, PagedAllocator<NullSwapchain>,
+			PagedAllocator<NullFence>, PagedAllocator<NullSemaphore>, PagedAllocator<NullQueryPool>,
+			PagedAllocator<NullCommandPool>, PagedAllocator<NullCommandBuffer>>
+			allocators;
+
+	// Shared by every resource type, only the generation check matters here
+	HandleTable<void> handles;
+
+	NullQueue graphics_queue = { QueueType::GRAPHICS };
+	NullQueue present_queue = { QueueType::PRESENT };
+	NullQueue transfer_queue = { QueueType::TRANSFER };
+	NullQueue compute_queue = { QueueType::COMPUTE };
+
+	CommandPool imm_command_pool = GL_NULL_HANDLE;
+	CommandBuffer imm_command_buffer = GL_NULL_HANDLE;
+
+	std::vector<NullSubmission> submissions;
+	std::unordered_map<const void*, std::string> object_names;
+
+	FrameStats stats;
+	uint64_t live_resource_count = 0;
+};
+
+} //namespace gl
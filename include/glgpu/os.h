@@ -14,4 +14,14 @@ enum class WindowCompositor {
  */
 WindowCompositor get_window_compositor();
 
+/**
+ * Allocates memory backed by huge pages, falls back to regular pages when
+ * the OS has none available. `p_size` is rounded up to the huge page size,
+ * the actual size is written to `o_size` and has to be passed back to
+ * `free_huge_pages`.
+ */
+void* allocate_huge_pages(size_t p_size, size_t* o_size);
+
+void free_huge_pages(void* p_memory, size_t p_size);
+
 } //namespace gl
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "glgpu/types.h"
+
+namespace gl {
+
+/**
+ * Conversions from 32 bit floats to the smaller vertex and texture formats,
+ * dispatched at runtime like the batched matrix kernels. Outputs are written
+ * front to back so they can point straight into mapped staging memory.
+ *
+ * Normalized conversions clamp to the representable range, round to the
+ * nearest value and turn NaN into zero.
+ */
+
+// IEEE 754 half precision, rounded to nearest even. Values too large for a
+// half become infinity, NaNs stay NaN.
+void pack_half(const float* p_in, uint16_t* o_out, size_t p_count);
+void unpack_half(const uint16_t* p_in, float* o_out, size_t p_count);
+
+void pack_unorm8(const float* p_in, uint8_t* o_out, size_t p_count);
+void pack_snorm8(const float* p_in, int8_t* o_out, size_t p_count);
+void pack_unorm16(const float* p_in, uint16_t* o_out, size_t p_count);
+void pack_snorm16(const float* p_in, int16_t* o_out, size_t p_count);
+
+// Packs `p_count` xyzw vectors to the `A2B10G10R10_*_PACK32` layout, x in the
+// lowest 10 bits and w in the highest 2
+void pack_unorm_2_10_10_10(const float* p_in, uint32_t* o_out, size_t p_count);
+void pack_snorm_2_10_10_10(const float* p_in, uint32_t* o_out, size_t p_count);
+
+/**
+ * Packs `p_count` floats, laid out in the component order of `p_format`, to
+ * `o_out`. Supports the UNORM, SNORM and SFLOAT variants of the R, RG, RGB and
+ * RGBA formats with 8, 16 and 32 bit components, as well as the A8B8G8R8 and
+ * A2B10G10R10 packed formats.
+ *
+ * @returns Number of bytes written, 0 if the format is not supported.
+ */
+size_t pack_to_format(DataFormat p_format, const float* p_in, size_t p_count, void* o_out);
+
+} //namespace gl
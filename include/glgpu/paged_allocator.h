@@ -1,44 +1,164 @@
 #pragma once
 
+#include "glgpu/assert.h"
+#include "glgpu/os.h"
+
 namespace gl {
 
 /**
- * Class representing a dynamic allocator that will grow when
- * the underlying data exceeds `page_size`
+ * Class representing a dynamic allocator that will grow by pages of
+ * `page_size` bytes, the first page is only allocated once the first object
+ * is. Pages are left uninitialized, objects are only constructed on `alloc`.
+ *
+ * `p_huge_pages` backs pages with huge pages where the OS provides them, the
+ * page size is rounded up to the huge page size then. Worth it for pools
+ * holding many thousands of objects, TLB misses dominate walking them.
+ *
+ * Safe to use from multiple threads. Free slots form a lock-free Treiber stack
+ * linked through the slots themselves, the head is a tagged pointer so a slot
+ * popped and pushed back by another thread in between can not be mistaken for
+ * an unchanged head (ABA). Only growing takes a lock. The link sits in a
+ * header in front of the object rather than in its storage, a pop reading a
+ * stale link must not overlap the object another thread constructs there.
  */
 template <typename T> class PagedAllocator {
+	static_assert(sizeof(void*) == 8, "Tagged pointers require a 64-bit address space");
+
 public:
-	PagedAllocator(size_t p_page_size = 4096) : page_size(p_page_size) { _allocate_new_page(); }
+	static constexpr size_t DEFAULT_PAGE_SIZE = 64 * 1024;
+
+	PagedAllocator(size_t p_page_size = DEFAULT_PAGE_SIZE, bool p_huge_pages = false) :
+			page_size(p_page_size), huge_pages(p_huge_pages) {}
 
 	~PagedAllocator() {
-		for (auto page : pages) {
-			delete[] page;
+		for (const Page& page : pages) {
+			if (huge_pages) {
+				free_huge_pages(page.data, page.size);
+			} else {
+				::operator delete(page.data, std::align_val_t(SLOT_ALIGNMENT));
+			}
 		}
 	}
 
+	PagedAllocator(const PagedAllocator&) = delete;
+	PagedAllocator& operator=(const PagedAllocator&) = delete;
+
+	// Returns a default initialized object
 	T* alloc() {
-		if (free_list.empty()) {
-			_allocate_new_page();
+		uint64_t head = free_head.load(std::memory_order_acquire);
+		while (true) {
+			FreeSlot* slot = _get_slot(head);
+			if (!slot) {
+				_allocate_new_page();
+				head = free_head.load(std::memory_order_acquire);
+				continue;
+			}
+
+			// `slot` might have been popped and reused by another thread since
+			// the head was read, `next` is stale then but the tag will no
+			// longer match and the exchange fails.
+			FreeSlot* next = slot->next.load(std::memory_order_relaxed);
+			if (free_head.compare_exchange_weak(head, _make_head(next, _get_tag(head) + 1),
+						std::memory_order_acquire, std::memory_order_acquire)) {
+				return new ((uint8_t*)slot + OBJECT_OFFSET) T;
+			}
 		}
-		T* obj = free_list.back();
-		free_list.pop_back();
-		return obj;
 	}
 
-	void free(T* obj) { free_list.push_back(obj); }
+	// Destroys the object, the slot is reused by the next allocation
+	void free(T* obj) {
+		obj->~T();
+
+		FreeSlot* slot = (FreeSlot*)((uint8_t*)obj - OBJECT_OFFSET);
+		_push(slot, slot);
+	}
 
 private:
-	size_t page_size;
-	std::vector<T*> pages;
-	std::vector<T*> free_list;
+	// Lives as long as its page, whether the slot holds an object or not
+	struct FreeSlot {
+		std::atomic<FreeSlot*> next = nullptr;
+	};
+
+	static constexpr size_t SLOT_ALIGNMENT = std::max(alignof(T), alignof(FreeSlot));
+	static constexpr size_t OBJECT_OFFSET =
+			(sizeof(FreeSlot) + alignof(T) - 1) & ~(alignof(T) - 1);
+	static constexpr size_t SLOT_SIZE = OBJECT_OFFSET + sizeof(T);
+	static constexpr size_t SLOT_STRIDE = (SLOT_SIZE + SLOT_ALIGNMENT - 1) & ~(SLOT_ALIGNMENT - 1);
+
+	// User space addresses fit in the lower 48 bits on x86-64 and AArch64
+	static constexpr uint32_t POINTER_BITS = 48;
+	static constexpr uint64_t POINTER_MASK = (uint64_t(1) << POINTER_BITS) - 1;
+
+	static uint64_t _make_head(FreeSlot* p_slot, uint64_t p_tag) {
+		return (uint64_t(uintptr_t(p_slot)) & POINTER_MASK) | (p_tag << POINTER_BITS);
+	}
+
+	static FreeSlot* _get_slot(uint64_t p_head) {
+		return (FreeSlot*)uintptr_t(p_head & POINTER_MASK);
+	}
+
+	static uint64_t _get_tag(uint64_t p_head) { return p_head >> POINTER_BITS; }
+
+	// Pushes the already linked chain `p_first` .. `p_last`
+	void _push(FreeSlot* p_first, FreeSlot* p_last) {
+		uint64_t head = free_head.load(std::memory_order_relaxed);
+		do {
+			p_last->next.store(_get_slot(head), std::memory_order_relaxed);
+		} while (!free_head.compare_exchange_weak(head, _make_head(p_first, _get_tag(head) + 1),
+				std::memory_order_release, std::memory_order_relaxed));
+	}
 
 	void _allocate_new_page() {
-		T* page = new T[page_size]();
-		pages.push_back(page);
-		for (size_t i = 0; i < page_size; ++i) {
-			free_list.push_back(&page[i]);
+		std::lock_guard<std::mutex> lock(page_mutex);
+
+		// Another thread grew the allocator while this one was waiting
+		if (pages.size() > 0 && _get_slot(free_head.load(std::memory_order_acquire))) {
+			return;
+		}
+
+		// Always room for at least one slot, whatever the page size
+		size_t size = std::max(page_size, SLOT_STRIDE);
+
+		uint8_t* page;
+		if (huge_pages) {
+			page = (uint8_t*)allocate_huge_pages(size, &size);
+		} else {
+			page = (uint8_t*)::operator new(size, std::align_val_t(SLOT_ALIGNMENT));
+		}
+
+		GL_ASSERT((uintptr_t(page) & (SLOT_ALIGNMENT - 1)) == 0, "Page is misaligned");
+		GL_ASSERT((uintptr_t(page + size) & ~POINTER_MASK) == 0,
+				"Page address does not fit in a tagged pointer");
+
+		pages.push_back({ page, size });
+
+		// Link the whole page up front so it is published with a single exchange
+		const size_t slot_count = size / SLOT_STRIDE;
+
+		FreeSlot* first = new (page) FreeSlot;
+		FreeSlot* last = first;
+		for (size_t i = 1; i < slot_count; ++i) {
+			FreeSlot* slot = new (page + i * SLOT_STRIDE) FreeSlot;
+			last->next.store(slot, std::memory_order_relaxed);
+			last = slot;
 		}
+
+		_push(first, last);
 	}
+
+private:
+	struct Page {
+		void* data;
+		size_t size;
+	};
+
+	size_t page_size;
+	bool huge_pages;
+
+	std::atomic<uint64_t> free_head = 0;
+
+	std::mutex page_mutex;
+	std::vector<Page> pages;
 };
 
-} //namespace gl
\ No newline at end of file
+} //namespace gl
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "glgpu/assert.h"
+#include "glgpu/backend.h"
+
+namespace gl {
+
+constexpr uint32_t PROFILE_SCOPE_NO_PARENT = UINT32_MAX;
+
+/**
+ * Resolved timings of a single profiled region. Results of a frame are stored
+ * in the order the scopes were opened so the tree can be walked using `depth`
+ * or `parent`.
+ */
+struct ProfileScopeResult {
+	std::string name;
+	uint32_t depth = 0;
+	uint32_t parent = PROFILE_SCOPE_NO_PARENT;
+	double cpu_time_ms = 0.0;
+	double gpu_time_ms = 0.0;
+	// Only set for scopes opened with `p_collect_statistics` once the GPU
+	// results are available
+	std::optional<PipelineStatistics> statistics;
+};
+
+/**
+ * Scoped CPU/GPU profiler built on top of timestamp queries.
+ *
+ * GPU results can only be read after the frame has finished executing, so each
+ * frame in flight owns its own query pool and its timings are resolved when the
+ * same slot is reused `frames_in_flight` frames later. Not thread safe, scopes
+ * must be recorded from the thread that calls `begin_frame`.
+ */
+class Profiler {
+public:
+	Profiler(std::shared_ptr<RenderBackend> p_backend, uint32_t p_frames_in_flight = 3,
+			uint32_t p_max_scopes = 256);
+	~Profiler();
+
+	// Resolves the oldest frame in flight and resets its queries. Has to be
+	// recorded outside of a render pass, ideally right after `command_begin`.
+	void begin_frame(CommandBuffer p_cmd);
+
+	// Pipeline statistics queries can not be nested, statistics are only
+	// collected for the outermost scope requesting them. Has to be opened and
+	// closed within the same subpass or outside of a render pass.
+	void begin_scope(
+			CommandBuffer p_cmd, const char* p_name, bool p_collect_statistics = false);
+	void end_scope(CommandBuffer p_cmd);
+
+	// Timings of the most recently resolved frame
+	const std::vector<ProfileScopeResult>& get_results() const;
+
+	// Index of the frame `get_results` belongs to, UINT64_MAX if there are none yet
+	uint64_t get_results_frame_index() const;
+
+private:
+	struct Scope {
+		const char* name;
+		uint32_t depth;
+		uint32_t parent;
+		bool has_statistics;
+		std::chrono::high_resolution_clock::time_point cpu_begin;
+		std::chrono::high_resolution_clock::time_point cpu_end;
+	};
+
+	struct FrameData {
+		QueryPool query_pool = GL_NULL_HANDLE;
+		QueryPool statistics_query_pool = GL_NULL_HANDLE;
+		std::vector<Scope> scopes;
+		uint64_t frame_index = UINT64_MAX;
+	};
+
+	void _resolve_frame(FrameData& p_frame);
+
+	// Innermost open scope that got recorded, skipping dropped ones
+	uint32_t _get_recorded_parent() const;
+
+private:
+	std::shared_ptr<RenderBackend> backend;
+
+	uint32_t max_scopes;
+	float timestamp_period;
+	// Clears the bits above `get_timestamp_valid_bits`
+	uint64_t timestamp_mask = UINT64_MAX;
+	bool statistics_supported = false;
+
+	std::vector<FrameData> frames;
+	uint32_t current_frame = 0;
+	uint64_t frame_counter = 0;
+
+	std::vector<uint32_t> scope_stack;
+	uint32_t statistics_scope = PROFILE_SCOPE_NO_PARENT;
+	std::vector<uint64_t> timestamps;
+
+	std::vector<ProfileScopeResult> results;
+	uint64_t results_frame_index = UINT64_MAX;
+};
+
+/**
+ * RAII helper opening a profiler scope for its lifetime.
+ */
+class ProfileScope {
+public:
+	ProfileScope(Profiler& p_profiler, CommandBuffer p_cmd, const char* p_name,
+			bool p_collect_statistics = false) :
+			profiler(p_profiler), cmd(p_cmd) {
+		profiler.begin_scope(cmd, p_name, p_collect_statistics);
+	}
+
+	~ProfileScope() { profiler.end_scope(cmd); }
+
+private:
+	Profiler& profiler;
+	CommandBuffer cmd;
+};
+
+#define GL_PROFILE_SCOPE(profiler, cmd, name)                                                      \
+	::gl::ProfileScope GL_CONCAT_MACRO(_gl_profile_scope_, __LINE__)(profiler, cmd, name)
+
+#define GL_PROFILE_SCOPE_STATISTICS(profiler, cmd, name)                                           \
+	::gl::ProfileScope GL_CONCAT_MACRO(_gl_profile_scope_, __LINE__)(profiler, cmd, name, true)
+
+} //namespace gl
@@ -0,0 +1,46 @@
+#pragma once
+
+// SSE2 is part of x86-64 and NEON of AArch64, both are used without checks.
+// Wider instruction sets are picked at runtime, see `simd_get_level`.
+#if defined(__x86_64__) || defined(_M_X64)
+#define GL_SIMD_SSE 1
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define GL_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+// Marks a function as compiled for AVX2 + FMA regardless of the target flags,
+// only call it after checking `simd_get_level`.
+#if defined(GL_SIMD_SSE) && (defined(__GNUC__) || defined(__clang__))
+#define GL_SIMD_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define GL_SIMD_TARGET_F16C __attribute__((target("avx2,fma,f16c")))
+#else
+#define GL_SIMD_TARGET_AVX2
+#define GL_SIMD_TARGET_F16C
+#endif
+
+namespace gl {
+
+enum class SimdLevel {
+	SCALAR,
+	// SSE2 on x86-64, NEON on AArch64
+	BASELINE,
+	// AVX2 + FMA + F16C
+	AVX2,
+};
+
+/**
+ * Widest instruction set the batched kernels use, detected once from the CPU.
+ */
+SimdLevel simd_get_level();
+
+/**
+ * Overrides the detected level, clamped to what the CPU supports. Meant for
+ * benchmarking and validating the kernels against each other.
+ */
+void simd_set_level(SimdLevel p_level);
+
+const char* simd_level_to_string(SimdLevel p_level);
+
+} //namespace gl
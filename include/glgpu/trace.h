@@ -0,0 +1,85 @@
+#pragma once
+
+#include "glgpu/assert.h"
+
+namespace gl {
+
+typedef std::chrono::high_resolution_clock::time_point TracePoint;
+
+/**
+ * Single complete event of the trace, timestamps are relative to the moment
+ * the recorder got enabled.
+ */
+struct TraceEvent {
+	std::string name;
+	const char* category;
+	uint32_t thread_id;
+	uint64_t begin_us;
+	uint64_t duration_us;
+};
+
+// Thread id the GPU timeline is recorded on
+constexpr uint32_t TRACE_GPU_THREAD_ID = UINT32_MAX;
+
+/**
+ * Process wide recorder of CPU and GPU timelines which can be exported as a
+ * Chrome Trace Event JSON, viewable in `chrome://tracing` or Perfetto.
+ *
+ * Recording is disabled by default and costs a single atomic load per scope
+ * while disabled. Thread safe.
+ */
+class TraceRecorder {
+public:
+	static void set_enabled(bool p_enabled);
+	static bool is_enabled();
+
+	static void add_event(const char* p_name, const char* p_category, TracePoint p_begin,
+			TracePoint p_end, uint32_t p_thread_id = get_thread_id());
+
+	// Small sequential id of the calling thread
+	static uint32_t get_thread_id();
+
+	// Number of events dropped because the event limit was reached
+	static uint64_t get_dropped_event_count();
+
+	static void clear();
+
+	static bool write_chrome_trace(const std::filesystem::path& p_path);
+};
+
+/**
+ * RAII helper recording a CPU event for its lifetime.
+ */
+class TraceScope {
+public:
+	TraceScope(const char* p_name, const char* p_category) :
+			name(p_name), category(p_category), enabled(TraceRecorder::is_enabled()) {
+		if (enabled) {
+			begin = std::chrono::high_resolution_clock::now();
+		}
+	}
+
+	~TraceScope() {
+		if (enabled) {
+			TraceRecorder::add_event(
+					name, category, begin, std::chrono::high_resolution_clock::now());
+		}
+	}
+
+private:
+	const char* name;
+	const char* category;
+	bool enabled;
+	TracePoint begin;
+};
+
+#ifndef GL_DIST_BUILD
+#define GL_TRACE_SCOPE_CATEGORY(name, category)                                                    \
+	::gl::TraceScope GL_CONCAT_MACRO(_gl_trace_scope_, __LINE__)(name, category)
+#else
+#define GL_TRACE_SCOPE_CATEGORY(name, category)
+#endif
+
+#define GL_TRACE_SCOPE(name) GL_TRACE_SCOPE_CATEGORY(name, "glgpu")
+
+} //namespace gl
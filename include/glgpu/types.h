@@ -29,6 +29,7 @@ GL_DEFINE_NON_DISPATCHABLE_HANDLE(Shader)
 GL_DEFINE_NON_DISPATCHABLE_HANDLE(UniformSet)
 GL_DEFINE_NON_DISPATCHABLE_HANDLE(Fence)
 GL_DEFINE_NON_DISPATCHABLE_HANDLE(Semaphore)
+GL_DEFINE_NON_DISPATCHABLE_HANDLE(QueryPool)
 
 #define GL_NULL_HANDLE nullptr
 #define GL_REMAINING_MIP_LEVELS (~0U)
@@ -48,6 +49,8 @@ enum class Error {
 	UNKNOWN,
 	OUT_OF_MEMORY,
 	DEVICE_LOST,
+	// Timed out or would have blocked, retry later
+	NOT_READY,
 	// Surface / Windowing
 	SURFACE_INVALID_COMPOSITOR,
 	SURFACE_SWAPCHAIN_NOT_SUPPORTED,
@@ -65,6 +68,8 @@ enum class MemoryAllocationType {
 
 enum class RenderAPI {
 	VULKAN,
+	// No driver calls, see NullRenderBackend
+	NULL_BACKEND,
 };
 
 // -----------------------------------------------------------------------------
@@ -122,6 +127,8 @@ enum class DataFormat : int {
 	A8B8G8R8_UINT_PACK32 = 55,
 	A8B8G8R8_SINT_PACK32 = 56,
 	A8B8G8R8_SRGB_PACK32 = 57,
+	A2B10G10R10_UNORM_PACK32 = 64,
+	A2B10G10R10_SNORM_PACK32 = 65,
 	R16_UNORM = 70,
 	R16_SNORM = 71,
 	R16_USCALED = 72,
@@ -602,6 +609,48 @@ struct RenderingAttachment {
 	ImageLayout resolve_layout = ImageLayout::COLOR_ATTACHMENT_OPTIMAL;
 };
 
+// -----------------------------------------------------------------------------
+// Swapchain
+// -----------------------------------------------------------------------------
+
+enum class PresentMode : uint32_t {
+	// Tears, lowest latency
+	IMMEDIATE = 0,
+	// Replaces the queued image, no tearing and no throttling
+	MAILBOX = 1,
+	// Vsync, always supported
+	FIFO = 2,
+	// Vsync unless a frame is late, then it tears instead of waiting
+	FIFO_RELAXED = 3,
+};
+
+struct SwapchainCreateInfo {
+	Vec2u size = { 0, 0 };
+	// Unsupported modes fall back to the closest supported one, ending in FIFO
+	PresentMode present_mode = PresentMode::FIFO;
+	// Clamped to the surface limits, 0 picks one more than the minimum
+	uint32_t image_count = 0;
+	// Presents that may be in flight before acquiring waits for the oldest of
+	// them to be displayed, 0 disables the limit. Needs VK_KHR_present_wait,
+	// ignored where it is not supported.
+	uint32_t max_frame_latency = 0;
+	// Headless swapchains only, read back frames kept for `swapchain_pop_frame`
+	// before the oldest is dropped. 0 skips the readback.
+	uint32_t readback_queue_size = 0;
+};
+
+/**
+ * An image presented to a headless swapchain, read back to host memory with
+ * tightly packed rows.
+ */
+struct SwapchainFrame {
+	// Counts the presents of the swapchain, starting at 1
+	uint64_t frame_index = 0;
+	Vec2u size = { 0, 0 };
+	DataFormat format = DataFormat::UNDEFINED;
+	std::vector<uint8_t> data;
+};
+
 // -----------------------------------------------------------------------------
 // Queues & Commands
 // -----------------------------------------------------------------------------
@@ -609,4 +658,31 @@ struct RenderingAttachment {
 enum class QueueType { GRAPHICS, PRESENT, TRANSFER, COMPUTE };
 enum class IndexType : uint32_t { UINT16 = 1, UINT32 = 2 };
 
+// -----------------------------------------------------------------------------
+// Queries
+// -----------------------------------------------------------------------------
+
+enum class QueryType {
+	TIMESTAMP,
+	OCCLUSION,
+	PIPELINE_STATISTICS,
+};
+
+/**
+ * Values written by a single QueryType::PIPELINE_STATISTICS query, results
+ * retrieved from the backend can be reinterpreted as an array of this struct.
+ */
+struct PipelineStatistics {
+	uint64_t input_assembly_vertices;
+	uint64_t input_assembly_primitives;
+	uint64_t vertex_shader_invocations;
+	uint64_t clipping_invocations;
+	uint64_t clipping_primitives;
+	uint64_t fragment_shader_invocations;
+	uint64_t compute_shader_invocations;
+};
+
+// Number of 64-bit values a single query of the given type writes
+uint32_t get_query_result_count(QueryType p_type);
+
 } // namespace gl
@@ -1,8 +1,11 @@
 #include <algorithm>
 #include <any>
 #include <array>
+#include <atomic>
 #include <bitset>
+#include <charconv>
 #include <chrono>
+#include <condition_variable>
 #include <cmath>
 #include <cstdint>
 #include <cstring>
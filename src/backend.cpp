@@ -1,11 +1,19 @@
 #include "glgpu/backend.h"
 
+#include "glgpu/null_backend.h"
+
 #include "platform/vulkan/vk_backend.h"
 
 namespace gl {
 
 std::shared_ptr<RenderBackend> RenderBackend::create(const RenderBackendCreateInfo& p_info) {
-	return std::make_shared<VulkanRenderBackend>(p_info);
+	switch (p_info.api) {
+		case RenderAPI::NULL_BACKEND:
+			return std::make_shared<NullRenderBackend>(p_info);
+		case RenderAPI::VULKAN:
+		default:
+			return std::make_shared<VulkanRenderBackend>(p_info);
+	}
 }
 
 } //namespace gl
\ No newline at end of file
@@ -0,0 +1,1415 @@
+#include "glgpu/capture.h"
+
+#include "glgpu/log.h"
+
+namespace gl {
+
+// Pending stream is written to disk once it grows past this size
+constexpr size_t CAPTURE_FLUSH_THRESHOLD = 16 * 1024 * 1024;
+
+template <typename T> static void _write(std::vector<uint8_t>& p_stream, const T& p_value) {
+	static_assert(std::is_trivially_copyable_v<T>);
+
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&p_value);
+	p_stream.insert(p_stream.end(), bytes, bytes + sizeof(T));
+}
+
+static void _write_bytes(std::vector<uint8_t>& p_stream, const void* p_data, size_t p_size) {
+	const uint8_t* bytes = static_cast<const uint8_t*>(p_data);
+	p_stream.insert(p_stream.end(), bytes, bytes + p_size);
+}
+
+static void _write_string(std::vector<uint8_t>& p_stream, const char* p_string) {
+	const uint32_t length = p_string ? static_cast<uint32_t>(strlen(p_string)) : 0;
+	_write(p_stream, length);
+	_write_bytes(p_stream, p_string, length);
+}
+
+template <typename T>
+static void _write_vector(std::vector<uint8_t>& p_stream, const std::vector<T>& p_vector) {
+	static_assert(std::is_trivially_copyable_v<T>);
+
+	_write(p_stream, static_cast<uint32_t>(p_vector.size()));
+	_write_bytes(p_stream, p_vector.data(), p_vector.size() * sizeof(T));
+}
+
+CaptureRenderBackend::CaptureRenderBackend(
+		std::shared_ptr<RenderBackend> p_backend, const std::filesystem::path& p_path) :
+		backend(p_backend), file(p_path, std::ios::out | std::ios::binary) {
+	if (!file.is_open()) {
+		GL_LOG_ERROR("[CAPTURE] Unable to open file '{}' for writing.", p_path.string());
+		return;
+	}
+
+	_write(stream, CAPTURE_MAGIC);
+	_write(stream, CAPTURE_VERSION);
+}
+
+CaptureRenderBackend::~CaptureRenderBackend() { flush(); }
+
+bool CaptureRenderBackend::is_open() const { return file.is_open(); }
+
+void CaptureRenderBackend::flush() {
+	std::scoped_lock lock(mutex);
+
+	if (file.is_open()) {
+		file.write(reinterpret_cast<const char*>(stream.data()), stream.size());
+		file.flush();
+	}
+	stream.clear();
+}
+
+CaptureHandle CaptureRenderBackend::_get_id(const void* p_handle) {
+	if (!p_handle) {
+		return 0;
+	}
+
+	const auto it = handle_ids.find(p_handle);
+	if (it != handle_ids.end()) {
+		return it->second;
+	}
+
+	// Handles the capture did not see being created, e.g. swapchain images
+	return _register(p_handle);
+}
+
+CaptureHandle CaptureRenderBackend::_register(const void* p_handle) {
+	const CaptureHandle id = next_id++;
+	handle_ids[p_handle] = id;
+	return id;
+}
+
+CaptureHandle CaptureRenderBackend::_unregister(const void* p_handle) {
+	const CaptureHandle id = _get_id(p_handle);
+	handle_ids.erase(p_handle);
+	return id;
+}
+
+void CaptureRenderBackend::_write_call(CaptureCall p_call) {
+	if (stream.size() >= CAPTURE_FLUSH_THRESHOLD) {
+		flush();
+	}
+
+	_write(stream, p_call);
+}
+
+void CaptureRenderBackend::_write_handle(const void* p_handle) { _write(stream, _get_id(p_handle)); }
+
+void CaptureRenderBackend::_set_name(
+		CaptureCall p_object_type, const void* p_handle, const char* p_name) {
+	_write_call(CaptureCall::SET_NAME);
+	_write(stream, p_object_type);
+	_write_handle(p_handle);
+	_write_string(stream, p_name);
+}
+
+void CaptureRenderBackend::_write_dirty_buffers() {
+	for (const auto& [id, mapped_buffer] : mapped_buffers) {
+		_write_dirty_buffer(id);
+	}
+}
+
+void CaptureRenderBackend::_write_dirty_buffer(CaptureHandle p_id) {
+	const auto it = mapped_buffers.find(p_id);
+	if (it == mapped_buffers.end()) {
+		return;
+	}
+
+	MappedBuffer& mapped_buffer = it->second;
+	const uint64_t size = mapped_buffer.shadow.size();
+
+	uint64_t first = 0;
+	while (first < size && mapped_buffer.data[first] == mapped_buffer.shadow[first]) {
+		first++;
+	}
+
+	if (first == size) {
+		return;
+	}
+
+	uint64_t last = size;
+	while (last > first && mapped_buffer.data[last - 1] == mapped_buffer.shadow[last - 1]) {
+		last--;
+	}
+
+	_write_call(CaptureCall::BUFFER_DATA);
+	_write(stream, p_id);
+	_write(stream, first);
+	_write(stream, last - first);
+	_write_bytes(stream, mapped_buffer.data + first, last - first);
+
+	memcpy(mapped_buffer.shadow.data() + first, mapped_buffer.data + first, last - first);
+}
+
+// =============================================================================
+// Device & Surface
+// =============================================================================
+
+void CaptureRenderBackend::device_wait() {
+	std::scoped_lock lock(mutex);
+
+	backend->device_wait();
+
+	_write_call(CaptureCall::DEVICE_WAIT);
+}
+
+Error CaptureRenderBackend::attach_surface(void* p_connection_handle, void* p_window_handle) {
+	// Native handles are meaningless to the replay, it brings its own surface
+	return backend->attach_surface(p_connection_handle, p_window_handle);
+}
+
+bool CaptureRenderBackend::is_swapchain_supported() { return backend->is_swapchain_supported(); }
+
+CommandQueue CaptureRenderBackend::queue_get(QueueType p_type) {
+	std::scoped_lock lock(mutex);
+
+	CommandQueue queue = backend->queue_get(p_type);
+
+	_write_call(CaptureCall::QUEUE_GET);
+	_write(stream, p_type);
+	_write_handle(queue);
+
+	return queue;
+}
+
+uint32_t CaptureRenderBackend::get_max_msaa_samples() const {
+	return backend->get_max_msaa_samples();
+}
+
+FrameStats CaptureRenderBackend::get_frame_stats() const { return backend->get_frame_stats(); }
+
+void CaptureRenderBackend::reset_frame_stats() { backend->reset_frame_stats(); }
+
+// =============================================================================
+// Swapchain
+// =============================================================================
+
+Swapchain CaptureRenderBackend::swapchain_create() {
+	std::scoped_lock lock(mutex);
+
+	Swapchain swapchain = backend->swapchain_create();
+
+	_write_call(CaptureCall::SWAPCHAIN_CREATE);
+	_write(stream, _register(swapchain));
+
+	return swapchain;
+}
+
+void CaptureRenderBackend::swapchain_resize(
+		CommandQueue p_cmd_queue, Swapchain p_swapchain, const SwapchainCreateInfo& p_info) {
+	std::scoped_lock lock(mutex);
+
+	backend->swapchain_resize(p_cmd_queue, p_swapchain, p_info);
+
+	_write_call(CaptureCall::SWAPCHAIN_RESIZE);
+	_write_handle(p_cmd_queue);
+	_write_handle(p_swapchain);
+	_write(stream, p_info.size);
+	_write(stream, p_info.present_mode);
+	_write(stream, p_info.image_count);
+	_write(stream, p_info.max_frame_latency);
+	// Needed to create matching offscreen images on replay
+	_write(stream, backend->swapchain_get_format(p_swapchain));
+	_write(stream, static_cast<uint32_t>(backend->swapchain_get_image_count(p_swapchain)));
+}
+
+size_t CaptureRenderBackend::swapchain_get_image_count(Swapchain p_swapchain) {
+	return backend->swapchain_get_image_count(p_swapchain);
+}
+
+std::vector<Image> CaptureRenderBackend::swapchain_get_images(Swapchain p_swapchain) {
+	std::scoped_lock lock(mutex);
+
+	std::vector<Image> images = backend->swapchain_get_images(p_swapchain);
+
+	_write_call(CaptureCall::SWAPCHAIN_GET_IMAGES);
+	_write_handle(p_swapchain);
+	_write(stream, static_cast<uint32_t>(images.size()));
+	for (Image image : images) {
+		_write_handle(image);
+	}
+
+	return images;
+}
+
+Result<Image, Error> CaptureRenderBackend::swapchain_acquire_image(Swapchain p_swapchain,
+		Semaphore p_semaphore, uint64_t p_timeout, uint32_t* o_image_index) {
+	std::scoped_lock lock(mutex);
+
+	uint32_t image_index = 0;
+	Result<Image, Error> result =
+			backend->swapchain_acquire_image(p_swapchain, p_semaphore, p_timeout, &image_index);
+
+	// Nothing happened, the replay acquires blocking once the caller retries
+	if (!result.has_value() && result.get_error() == Error::NOT_READY) {
+		return result;
+	}
+
+	_write_call(CaptureCall::SWAPCHAIN_ACQUIRE_IMAGE);
+	_write_handle(p_swapchain);
+	_write_handle(p_semaphore);
+	_write(stream, result.has_value());
+	_write(stream, image_index);
+	_write_handle(result.has_value() ? result.get_value() : GL_NULL_HANDLE);
+
+	if (o_image_index) {
+		*o_image_index = image_index;
+	}
+
+	return result;
+}
+
+Vec2u CaptureRenderBackend::swapchain_get_extent(Swapchain p_swapchain) {
+	return backend->swapchain_get_extent(p_swapchain);
+}
+
+DataFormat CaptureRenderBackend::swapchain_get_format(Swapchain p_swapchain) {
+	return backend->swapchain_get_format(p_swapchain);
+}
+
+bool CaptureRenderBackend::swapchain_pop_frame(Swapchain p_swapchain, SwapchainFrame* o_frame) {
+	return backend->swapchain_pop_frame(p_swapchain, o_frame);
+}
+
+void CaptureRenderBackend::swapchain_free(Swapchain p_swapchain) {
+	std::scoped_lock lock(mutex);
+
+	_write_call(CaptureCall::SWAPCHAIN_FREE);
+	_write(stream, _unregister(p_swapchain));
+
+	backend->swapchain_free(p_swapchain);
+}
+
+// =============================================================================
+// Resource Management (Buffers & Images)
+// =============================================================================
+
+Buffer CaptureRenderBackend::buffer_create(
+		uint64_t p_size, BufferUsageFlags p_usage, MemoryAllocationType p_allocation_type) {
+	std::scoped_lock lock(mutex);
+
+	Buffer buffer = backend->buffer_create(p_size, p_usage, p_allocation_type);
+
+	const CaptureHandle id = _register(buffer);
+	buffer_sizes[id] = p_size;
+
+	_write_call(CaptureCall::BUFFER_CREATE);
+	_write(stream, id);
+	_write(stream, p_size);
+	_write(stream, p_usage);
+	_write(stream, p_allocation_type);
+
+	return buffer;
+}
+
+void CaptureRenderBackend::buffer_free(Buffer p_buffer) {
+	std::scoped_lock lock(mutex);
+
+	const CaptureHandle id = _unregister(p_buffer);
+	buffer_sizes.erase(id);
+	mapped_buffers.erase(id);
+
+	_write_call(CaptureCall::BUFFER_FREE);
+	_write(stream, id);
+
+	backend->buffer_free(p_buffer);
+}
+
+BufferDeviceAddress CaptureRenderBackend::buffer_get_device_address(Buffer p_buffer) {
+	return backend->buffer_get_device_address(p_buffer);
+}
+
+uint8_t* CaptureRenderBackend::buffer_map(Buffer p_buffer) {
+	std::scoped_lock lock(mutex);
+
+	uint8_t* data = backend->buffer_map(p_buffer);
+
+	const CaptureHandle id = _get_id(p_buffer);
+
+	_write_call(CaptureCall::BUFFER_MAP);
+	_write(stream, id);
+
+	if (data && !mapped_buffers.contains(id)) {
+		// Only writes made through the mapping are captured, the current
+		// contents are expected to be reproduced by the replayed GPU work.
+		const uint64_t size = buffer_sizes[id];
+		mapped_buffers[id] = { data, std::vector<uint8_t>(data, data + size) };
+	}
+
+	return data;
+}
+
+void CaptureRenderBackend::buffer_unmap(Buffer p_buffer) {
+	std::scoped_lock lock(mutex);
+
+	const CaptureHandle id = _get_id(p_buffer);
+
+	_write_dirty_buffer(id);
+	mapped_buffers.erase(id);
+
+	_write_call(CaptureCall::BUFFER_UNMAP);
+	_write(stream, id);
+
+	backend->buffer_unmap(p_buffer);
+}
+
+void CaptureRenderBackend::buffer_invalidate(Buffer p_buffer) {
+	std::scoped_lock lock(mutex);
+
+	backend->buffer_invalidate(p_buffer);
+
+	const CaptureHandle id = _get_id(p_buffer);
+
+	// GPU writes are not part of the capture, treat them as the new baseline
+	const auto it = mapped_buffers.find(id);
+	if (it != mapped_buffers.end()) {
+		memcpy(it->second.shadow.data(), it->second.data, it->second.shadow.size());
+	}
+
+	_write_call(CaptureCall::BUFFER_INVALIDATE);
+	_write(stream, id);
+}
+
+void CaptureRenderBackend::buffer_flush(Buffer p_buffer) {
+	std::scoped_lock lock(mutex);
+
+	const CaptureHandle id = _get_id(p_buffer);
+
+	_write_dirty_buffer(id);
+
+	_write_call(CaptureCall::BUFFER_FLUSH);
+	_write(stream, id);
+
+	backend->buffer_flush(p_buffer);
+}
+
+Image CaptureRenderBackend::image_create(const ImageCreateInfo& p_info) {
+	std::scoped_lock lock(mutex);
+
+	Image image = backend->image_create(p_info);
+
+	_write_call(CaptureCall::IMAGE_CREATE);
+	_write(stream, _register(image));
+	_write(stream, p_info.format);
+	_write(stream, p_info.size);
+	_write(stream, p_info.usage);
+	_write(stream, p_info.mipmapped);
+	_write(stream, p_info.samples);
+
+	const uint64_t data_size = p_info.data
+			? uint64_t(p_info.size.x) * p_info.size.y * get_data_format_size(p_info.format)
+			: 0;
+	_write(stream, data_size);
+	_write_bytes(stream, p_info.data, data_size);
+
+	return image;
+}
+
+void CaptureRenderBackend::image_free(Image p_image) {
+	std::scoped_lock lock(mutex);
+
+	_write_call(CaptureCall::IMAGE_FREE);
+	_write(stream, _unregister(p_image));
+
+	backend->image_free(p_image);
+}
+
+Vec3u CaptureRenderBackend::image_get_size(Image p_image) {
+	return backend->image_get_size(p_image);
+}
+
+DataFormat CaptureRenderBackend::image_get_format(Image p_image) {
+	return backend->image_get_format(p_image);
+}
+
+uint32_t CaptureRenderBackend::image_get_mip_levels(Image p_image) {
+	return backend->image_get_mip_levels(p_image);
+}
+
+Sampler CaptureRenderBackend::sampler_create(const SamplerCreateInfo& p_info) {
+	std::scoped_lock lock(mutex);
+
+	Sampler sampler = backend->sampler_create(p_info);
+
+	_write_call(CaptureCall::SAMPLER_CREATE);
+	_write(stream, _register(sampler));
+	_write(stream, p_info);
+
+	return sampler;
+}
+
+void CaptureRenderBackend::sampler_free(Sampler p_sampler) {
+	std::scoped_lock lock(mutex);
+
+	_write_call(CaptureCall::SAMPLER_FREE);
+	_write(stream, _unregister(p_sampler));
+
+	backend->sampler_free(p_sampler);
+}
+
+// =============================================================================
+// Shader & Pipelines
+// =============================================================================
+
+Shader CaptureRenderBackend::shader_create_from_bytecode(const std::vector<SpirvEntry>& p_shaders) {
+	std::scoped_lock lock(mutex);
+
+	Shader shader = backend->shader_create_from_bytecode(p_shaders);
+
+	_write_call(CaptureCall::SHADER_CREATE);
+	_write(stream, _register(shader));
+	_write(stream, static_cast<uint32_t>(p_shaders.size()));
+	for (const SpirvEntry& entry : p_shaders) {
+		_write(stream, entry.stage);
+		_write_vector(stream, entry.byte_code);
+	}
+
+	return shader;
+}
+
+void CaptureRenderBackend::shader_free(Shader p_shader) {
+	std::scoped_lock lock(mutex);
+
+	_write_call(CaptureCall::SHADER_FREE);
+	_write(stream, _unregister(p_shader));
+
+	backend->shader_free(p_shader);
+}
+
+std::vector<ShaderInterfaceVariable> CaptureRenderBackend::shader_get_vertex_inputs(
+		Shader p_shader) {
+	return backend->shader_get_vertex_inputs(p_shader);
+}
+
+Pipeline CaptureRenderBackend::render_pipeline_create(const RenderPipelineCreateInfo& p_info) {
+	std::scoped_lock lock(mutex);
+
+	Pipeline pipeline = backend->render_pipeline_create(p_info);
+
+	_write_call(CaptureCall::RENDER_PIPELINE_CREATE);
+	_write(stream, _register(pipeline));
+	_write_handle(p_info.shader);
+	_write(stream, p_info.primitive);
+	_write(stream, p_info.vertex_input_state);
+	_write(stream, p_info.rasterization_state);
+
+	const PipelineMultisampleState& multisample_state = p_info.multisample_state;
+	_write(stream, multisample_state.sample_count);
+	_write(stream, multisample_state.enable_sample_shading);
+	_write(stream, multisample_state.min_sample_shading);
+	_write_vector(stream, multisample_state.sample_mask);
+	_write(stream, multisample_state.enable_alpha_to_coverage);
+	_write(stream, multisample_state.enable_alpha_to_one);
+
+	_write(stream, p_info.depth_stencil_state);
+
+	const PipelineColorBlendState& color_blend_state = p_info.color_blend_state;
+	_write(stream, color_blend_state.enable_logic_op);
+	_write(stream, color_blend_state.logic_op);
+	_write_vector(stream, color_blend_state.attachments);
+	_write(stream, color_blend_state.blend_constant);
+
+	_write(stream, p_info.dynamic_state);
+	_write_handle(p_info.render_pass);
+	_write_vector(stream, p_info.rendering_info.color_attachments);
+	_write(stream, p_info.rendering_info.depth_attachment);
+
+	return pipeline;
+}
+
+Pipeline CaptureRenderBackend::compute_pipeline_create(Shader p_shader) {
+	std::scoped_lock lock(mutex);
+
+	Pipeline pipeline = backend->compute_pipeline_create(p_shader);
+
+	_write_call(CaptureCall::COMPUTE_PIPELINE_CREATE);
+	_write(stream, _register(pipeline));
+	_write_handle(p_shader);
+
+	return pipeline;
+}
+
+void CaptureRenderBackend::pipeline_free(Pipeline p_pipeline) {
+	std::scoped_lock lock(mutex);
+
+	_write_call(CaptureCall::PIPELINE_FREE);
+	_write(stream, _unregister(p_pipeline));
+
+	backend->pipeline_free(p_pipeline);
+}
+
+UniformSet CaptureRenderBackend::uniform_set_create(
+		std::vector<ShaderUniform> p_uniforms, Shader p_shader, uint32_t p_set_index) {
+	std::scoped_lock lock(mutex);
+
+	_write_call(CaptureCall::UNIFORM_SET_CREATE);
+	_write(stream, static_cast<uint32_t>(p_uniforms.size()));
+	for (const ShaderUniform& uniform : p_uniforms) {
+		_write(stream, uniform.type);
+		_write(stream, uniform.binding);
+		_write(stream, static_cast<uint32_t>(uniform.data.size()));
+		for (const void* handle : uniform.data) {
+			_write_handle(handle);
+		}
+	}
+	_write_handle(p_shader);
+	_write(stream, p_set_index);
+
+	UniformSet uniform_set = backend->uniform_set_create(std::move(p_uniforms), p_shader, p_set_index);
+
+	// Written last, the uniforms are moved into the wrapped backend
+	_write(stream, _register(uniform_set));
+
+	return uniform_set;
+}
+
+void CaptureRenderBackend::uniform_set_free(UniformSet p_uniform_set) {
+	std::scoped_lock lock(mutex);
+
+	_write_call(CaptureCall::UNIFORM_SET_FREE);
+	_write(stream, _unregister(p_uniform_set));
+
+	backend->uniform_set_free(p_uniform_set);
+}
+
+// =============================================================================
+// Render Pass & Framebuffer
+// =============================================================================
+
+RenderPass CaptureRenderBackend::render_pass_create(
+		std::vector<RenderPassAttachment> p_attachments, std::vector<SubpassInfo> p_subpasses) {
+	std::scoped_lock lock(mutex);
+
+	_write_call(CaptureCall::RENDER_PASS_CREATE);
+	_write_vector(stream, p_attachments);
+	_write(stream, static_cast<uint32_t>(p_subpasses.size()));
+	for (const SubpassInfo& subpass : p_subpasses) {
+		_write_vector(stream, subpass.attachments);
+	}
+
+	RenderPass render_pass =
+			backend->render_pass_create(std::move(p_attachments), std::move(p_subpasses));
+
+	_write(stream, _register(render_pass));
+
+	return render_pass;
+}
+
+void CaptureRenderBackend::render_pass_destroy(RenderPass p_render_pass) {
+	std::scoped_lock lock(mutex);
+
+	_write_call(CaptureCall::RENDER_PASS_DESTROY);
+	_write(stream, _unregister(p_render_pass));
+
+	backend->render_pass_destroy(p_render_pass);
+}
+
+FrameBuffer CaptureRenderBackend::frame_buffer_create(
+		RenderPass p_render_pass, std::vector<Image> p_attachments, const Vec2u& p_extent) {
+	std::scoped_lock lock(mutex);
+
+	_write_call(CaptureCall::FRAME_BUFFER_CREATE);
+	_write_handle(p_render_pass);
+	_write(stream, static_cast<uint32_t>(p_attachments.size()));
+	for (Image image : p_attachments) {
+		_write_handle(image);
+	}
+	_write(stream, p_extent);
+
+	FrameBuffer frame_buffer =
+			backend->frame_buffer_create(p_render_pass, std::move(p_attachments), p_extent);
+
+	_write(stream, _register(frame_buffer));
+
+	return frame_buffer;
+}
+
+void CaptureRenderBackend::frame_buffer_destroy(FrameBuffer p_frame_buffer) {
+	std::scoped_lock lock(mutex);
+
+	_write_call(CaptureCall::FRAME_BUFFER_DESTROY);
+	_write(stream, _unregister(p_frame_buffer));
+
+	backend->frame_buffer_destroy(p_frame_buffer);
+}
+
+// =============================================================================
+// Synchronization
+// =============================================================================
+
+Fence CaptureRenderBackend::fence_create(bool p_create_signaled) {
+	std::scoped_lock lock(mutex);
+
+	Fence fence = backend->fence_create(p_create_signaled);
+
+	_write_call(CaptureCall::FENCE_CREATE);
+	_write(stream, _register(fence));
+	_write(stream, p_create_signaled);
+
+	return fence;
+}
+
+void CaptureRenderBackend::fence_free(Fence p_fence) {
+	std::scoped_lock lock(mutex);
+
+	_write_call(CaptureCall::FENCE_FREE);
+	_write(stream, _unregister(p_fence));
+
+	backend->fence_free(p_fence);
+}
+
+void CaptureRenderBackend::fence_wait(Fence p_fence) {
+	// Not locked, other threads keep capturing while this one blocks
+	backend->fence_wait(p_fence);
+
+	std::scoped_lock lock(mutex);
+
+	_write_call(CaptureCall::FENCE_WAIT);
+	_write_handle(p_fence);
+}
+
+void CaptureRenderBackend::fence_reset(Fence p_fence) {
+	std::scoped_lock lock(mutex);
+
+	backend->fence_reset(p_fence);
+
+	_write_call(CaptureCall::FENCE_RESET);
+	_write_handle(p_fence);
+}
+
+Semaphore CaptureRenderBackend::semaphore_create() {
+	std::scoped_lock lock(mutex);
+
+	Semaphore semaphore = backend->semaphore_create();
+
+	_write_call(CaptureCall::SEMAPHORE_CREATE);
+	_write(stream, _register(semaphore));
+
+	return semaphore;
+}
+
+void CaptureRenderBackend::semaphore_free(Semaphore p_semaphore) {
+	std::scoped_lock lock(mutex);
+
+	_write_call(CaptureCall::SEMAPHORE_FREE);
+	_write(stream, _unregister(p_semaphore));
+
+	backend->semaphore_free(p_semaphore);
+}
+
+// =============================================================================
+// Queries
+// =============================================================================
+
+QueryPool CaptureRenderBackend::query_pool_create(QueryType p_type, uint32_t p_query_count) {
+	std::scoped_lock lock(mutex);
+
+	QueryPool query_pool = backend->query_pool_create(p_type, p_query_count);
+
+	_write_call(CaptureCall::QUERY_POOL_CREATE);
+	_write(stream, _register(query_pool));
+	_write(stream, p_type);
+	_write(stream, p_query_count);
+
+	return query_pool;
+}
+
+void CaptureRenderBackend::query_pool_free(QueryPool p_query_pool) {
+	std::scoped_lock lock(mutex);
+
+	_write_call(CaptureCall::QUERY_POOL_FREE);
+	_write(stream, _unregister(p_query_pool));
+
+	backend->query_pool_free(p_query_pool);
+}
+
+bool CaptureRenderBackend::query_pool_get_results(QueryPool p_query_pool, uint32_t p_first_query,
+		uint32_t p_query_count, uint64_t* o_results) {
+	std::scoped_lock lock(mutex);
+
+	const bool available =
+			backend->query_pool_get_results(p_query_pool, p_first_query, p_query_count, o_results);
+
+	_write_call(CaptureCall::QUERY_POOL_GET_RESULTS);
+	_write_handle(p_query_pool);
+	_write(stream, p_first_query);
+	_write(stream, p_query_count);
+
+	return available;
+}
+
+float CaptureRenderBackend::get_timestamp_period() const {
+	return backend->get_timestamp_period();
+}
+
+uint32_t CaptureRenderBackend::get_timestamp_valid_bits() const {
+	return backend->get_timestamp_valid_bits();
+}
+
+bool CaptureRenderBackend::is_pipeline_statistics_supported() const {
+	return backend->is_pipeline_statistics_supported();
+}
+
+// =============================================================================
+// Debugging
+// =============================================================================
+
+void CaptureRenderBackend::buffer_set_name(Buffer p_buffer, const char* p_name) {
+	std::scoped_lock lock(mutex);
+
+	backend->buffer_set_name(p_buffer, p_name);
+	_set_name(CaptureCall::BUFFER_CREATE, p_buffer, p_name);
+}
+
+void CaptureRenderBackend::image_set_name(Image p_image, const char* p_name) {
+	std::scoped_lock lock(mutex);
+
+	backend->image_set_name(p_image, p_name);
+	_set_name(CaptureCall::IMAGE_CREATE, p_image, p_name);
+}
+
+void CaptureRenderBackend::sampler_set_name(Sampler p_sampler, const char* p_name) {
+	std::scoped_lock lock(mutex);
+
+	backend->sampler_set_name(p_sampler, p_name);
+	_set_name(CaptureCall::SAMPLER_CREATE, p_sampler, p_name);
+}
+
+void CaptureRenderBackend::command_pool_set_name(CommandPool p_command_pool, const char* p_name) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_pool_set_name(p_command_pool, p_name);
+	_set_name(CaptureCall::COMMAND_POOL_CREATE, p_command_pool, p_name);
+}
+
+void CaptureRenderBackend::command_buffer_set_name(
+		CommandBuffer p_command_buffer, const char* p_name) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_buffer_set_name(p_command_buffer, p_name);
+	_set_name(CaptureCall::COMMAND_POOL_ALLOCATE, p_command_buffer, p_name);
+}
+
+void CaptureRenderBackend::queue_set_name(CommandQueue p_queue, const char* p_name) {
+	std::scoped_lock lock(mutex);
+
+	backend->queue_set_name(p_queue, p_name);
+	_set_name(CaptureCall::QUEUE_GET, p_queue, p_name);
+}
+
+void CaptureRenderBackend::render_pass_set_name(RenderPass p_render_pass, const char* p_name) {
+	std::scoped_lock lock(mutex);
+
+	backend->render_pass_set_name(p_render_pass, p_name);
+	_set_name(CaptureCall::RENDER_PASS_CREATE, p_render_pass, p_name);
+}
+
+void CaptureRenderBackend::frame_buffer_set_name(FrameBuffer p_frame_buffer, const char* p_name) {
+	std::scoped_lock lock(mutex);
+
+	backend->frame_buffer_set_name(p_frame_buffer, p_name);
+	_set_name(CaptureCall::FRAME_BUFFER_CREATE, p_frame_buffer, p_name);
+}
+
+void CaptureRenderBackend::swapchain_set_name(Swapchain p_swapchain, const char* p_name) {
+	std::scoped_lock lock(mutex);
+
+	backend->swapchain_set_name(p_swapchain, p_name);
+	_set_name(CaptureCall::SWAPCHAIN_CREATE, p_swapchain, p_name);
+}
+
+void CaptureRenderBackend::pipeline_set_name(Pipeline p_pipeline, const char* p_name) {
+	std::scoped_lock lock(mutex);
+
+	backend->pipeline_set_name(p_pipeline, p_name);
+	_set_name(CaptureCall::COMPUTE_PIPELINE_CREATE, p_pipeline, p_name);
+}
+
+void CaptureRenderBackend::shader_set_name(Shader p_shader, const char* p_name) {
+	std::scoped_lock lock(mutex);
+
+	backend->shader_set_name(p_shader, p_name);
+	_set_name(CaptureCall::SHADER_CREATE, p_shader, p_name);
+}
+
+void CaptureRenderBackend::uniform_set_set_name(UniformSet p_uniform_set, const char* p_name) {
+	std::scoped_lock lock(mutex);
+
+	backend->uniform_set_set_name(p_uniform_set, p_name);
+	_set_name(CaptureCall::UNIFORM_SET_CREATE, p_uniform_set, p_name);
+}
+
+void CaptureRenderBackend::fence_set_name(Fence p_fence, const char* p_name) {
+	std::scoped_lock lock(mutex);
+
+	backend->fence_set_name(p_fence, p_name);
+	_set_name(CaptureCall::FENCE_CREATE, p_fence, p_name);
+}
+
+void CaptureRenderBackend::semaphore_set_name(Semaphore p_semaphore, const char* p_name) {
+	std::scoped_lock lock(mutex);
+
+	backend->semaphore_set_name(p_semaphore, p_name);
+	_set_name(CaptureCall::SEMAPHORE_CREATE, p_semaphore, p_name);
+}
+
+void CaptureRenderBackend::query_pool_set_name(QueryPool p_query_pool, const char* p_name) {
+	std::scoped_lock lock(mutex);
+
+	backend->query_pool_set_name(p_query_pool, p_name);
+	_set_name(CaptureCall::QUERY_POOL_CREATE, p_query_pool, p_name);
+}
+
+// =============================================================================
+// Command Submission
+// =============================================================================
+
+void CaptureRenderBackend::queue_submit(CommandQueue p_queue, CommandBuffer p_cmd, Fence p_fence,
+		Semaphore p_wait_semaphore, Semaphore p_signal_semaphore) {
+	std::scoped_lock lock(mutex);
+
+	// Data the GPU reads from mapped buffers must be in place before the submit
+	_write_dirty_buffers();
+
+	backend->queue_submit(p_queue, p_cmd, p_fence, p_wait_semaphore, p_signal_semaphore);
+
+	_write_call(CaptureCall::QUEUE_SUBMIT);
+	_write_handle(p_queue);
+	_write_handle(p_cmd);
+	_write_handle(p_fence);
+	_write_handle(p_wait_semaphore);
+	_write_handle(p_signal_semaphore);
+}
+
+bool CaptureRenderBackend::queue_present(
+		CommandQueue p_queue, Swapchain p_swapchain, Semaphore p_wait_semaphore) {
+	std::scoped_lock lock(mutex);
+
+	const bool result = backend->queue_present(p_queue, p_swapchain, p_wait_semaphore);
+
+	_write_call(CaptureCall::QUEUE_PRESENT);
+	_write_handle(p_queue);
+	_write_handle(p_swapchain);
+	_write_handle(p_wait_semaphore);
+
+	return result;
+}
+
+CommandPool CaptureRenderBackend::command_pool_create(CommandQueue p_queue) {
+	std::scoped_lock lock(mutex);
+
+	CommandPool command_pool = backend->command_pool_create(p_queue);
+
+	_write_call(CaptureCall::COMMAND_POOL_CREATE);
+	_write(stream, _register(command_pool));
+	_write_handle(p_queue);
+
+	return command_pool;
+}
+
+void CaptureRenderBackend::command_pool_free(CommandPool p_command_pool) {
+	std::scoped_lock lock(mutex);
+
+	_write_call(CaptureCall::COMMAND_POOL_FREE);
+	_write(stream, _unregister(p_command_pool));
+
+	backend->command_pool_free(p_command_pool);
+}
+
+CommandBuffer CaptureRenderBackend::command_pool_allocate(CommandPool p_command_pool) {
+	std::scoped_lock lock(mutex);
+
+	CommandBuffer cmd = backend->command_pool_allocate(p_command_pool);
+
+	_write_call(CaptureCall::COMMAND_POOL_ALLOCATE);
+	_write_handle(p_command_pool);
+	_write(stream, _register(cmd));
+
+	return cmd;
+}
+
+std::vector<CommandBuffer> CaptureRenderBackend::command_pool_allocate(
+		CommandPool p_command_pool, const uint32_t p_count) {
+	std::scoped_lock lock(mutex);
+
+	std::vector<CommandBuffer> command_buffers =
+			backend->command_pool_allocate(p_command_pool, p_count);
+
+	// Replayed as individual allocations
+	for (CommandBuffer cmd : command_buffers) {
+		_write_call(CaptureCall::COMMAND_POOL_ALLOCATE);
+		_write_handle(p_command_pool);
+		_write(stream, _register(cmd));
+	}
+
+	return command_buffers;
+}
+
+void CaptureRenderBackend::command_pool_reset(CommandPool p_command_pool) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_pool_reset(p_command_pool);
+
+	_write_call(CaptureCall::COMMAND_POOL_RESET);
+	_write_handle(p_command_pool);
+}
+
+void CaptureRenderBackend::command_immediate_submit(
+		std::function<void(CommandBuffer p_cmd)>&& p_function, QueueType p_queue_type) {
+	std::scoped_lock lock(mutex);
+
+	_write_dirty_buffers();
+
+	backend->command_immediate_submit(
+			[&](CommandBuffer p_cmd) {
+				_write_call(CaptureCall::IMMEDIATE_SUBMIT_BEGIN);
+				_write(stream, p_queue_type);
+				_write_handle(p_cmd);
+
+				p_function(p_cmd);
+
+				_write_call(CaptureCall::IMMEDIATE_SUBMIT_END);
+			},
+			p_queue_type);
+}
+
+void CaptureRenderBackend::command_begin(CommandBuffer p_cmd) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_begin(p_cmd);
+
+	_write_call(CaptureCall::COMMAND_BEGIN);
+	_write_handle(p_cmd);
+}
+
+void CaptureRenderBackend::command_end(CommandBuffer p_cmd) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_end(p_cmd);
+
+	_write_call(CaptureCall::COMMAND_END);
+	_write_handle(p_cmd);
+}
+
+void CaptureRenderBackend::command_reset(CommandBuffer p_cmd) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_reset(p_cmd);
+
+	_write_call(CaptureCall::COMMAND_RESET);
+	_write_handle(p_cmd);
+}
+
+// =============================================================================
+// Command Recording
+// =============================================================================
+
+void CaptureRenderBackend::command_begin_render_pass(CommandBuffer p_cmd, RenderPass p_render_pass,
+		FrameBuffer p_framebuffer, const Vec2u& p_draw_extent, Color p_clear_color) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_begin_render_pass(
+			p_cmd, p_render_pass, p_framebuffer, p_draw_extent, p_clear_color);
+
+	_write_call(CaptureCall::COMMAND_BEGIN_RENDER_PASS);
+	_write_handle(p_cmd);
+	_write_handle(p_render_pass);
+	_write_handle(p_framebuffer);
+	_write(stream, p_draw_extent);
+	_write(stream, p_clear_color);
+}
+
+void CaptureRenderBackend::command_end_render_pass(CommandBuffer p_cmd) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_end_render_pass(p_cmd);
+
+	_write_call(CaptureCall::COMMAND_END_RENDER_PASS);
+	_write_handle(p_cmd);
+}
+
+void CaptureRenderBackend::command_begin_rendering(CommandBuffer p_cmd,
+		const Vec2u& p_draw_extent, std::vector<RenderingAttachment> p_color_attachments,
+		Image p_depth_attachment) {
+	std::scoped_lock lock(mutex);
+
+	_write_call(CaptureCall::COMMAND_BEGIN_RENDERING);
+	_write_handle(p_cmd);
+	_write(stream, p_draw_extent);
+	_write(stream, static_cast<uint32_t>(p_color_attachments.size()));
+	for (const RenderingAttachment& attachment : p_color_attachments) {
+		_write_handle(attachment.image);
+		_write(stream, attachment.layout);
+		_write(stream, attachment.load_op);
+		_write(stream, attachment.store_op);
+		_write(stream, attachment.clear_color);
+		_write(stream, attachment.resolve_mode);
+		_write_handle(attachment.resolve_image);
+		_write(stream, attachment.resolve_layout);
+	}
+	_write_handle(p_depth_attachment);
+
+	backend->command_begin_rendering(
+			p_cmd, p_draw_extent, std::move(p_color_attachments), p_depth_attachment);
+}
+
+void CaptureRenderBackend::command_end_rendering(CommandBuffer p_cmd) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_end_rendering(p_cmd);
+
+	_write_call(CaptureCall::COMMAND_END_RENDERING);
+	_write_handle(p_cmd);
+}
+
+void CaptureRenderBackend::command_bind_graphics_pipeline(
+		CommandBuffer p_cmd, Pipeline p_pipeline) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_bind_graphics_pipeline(p_cmd, p_pipeline);
+
+	_write_call(CaptureCall::COMMAND_BIND_GRAPHICS_PIPELINE);
+	_write_handle(p_cmd);
+	_write_handle(p_pipeline);
+}
+
+void CaptureRenderBackend::command_bind_compute_pipeline(CommandBuffer p_cmd, Pipeline p_pipeline) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_bind_compute_pipeline(p_cmd, p_pipeline);
+
+	_write_call(CaptureCall::COMMAND_BIND_COMPUTE_PIPELINE);
+	_write_handle(p_cmd);
+	_write_handle(p_pipeline);
+}
+
+void CaptureRenderBackend::command_bind_vertex_buffers(CommandBuffer p_cmd,
+		uint32_t p_first_binding, std::vector<Buffer> p_vertex_buffers,
+		std::vector<uint64_t> p_offsets) {
+	std::scoped_lock lock(mutex);
+
+	_write_call(CaptureCall::COMMAND_BIND_VERTEX_BUFFERS);
+	_write_handle(p_cmd);
+	_write(stream, p_first_binding);
+	_write(stream, static_cast<uint32_t>(p_vertex_buffers.size()));
+	for (Buffer buffer : p_vertex_buffers) {
+		_write_handle(buffer);
+	}
+	_write_vector(stream, p_offsets);
+
+	backend->command_bind_vertex_buffers(
+			p_cmd, p_first_binding, std::move(p_vertex_buffers), std::move(p_offsets));
+}
+
+void CaptureRenderBackend::command_bind_index_buffer(
+		CommandBuffer p_cmd, Buffer p_index_buffer, uint64_t p_offset, IndexType p_index_type) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_bind_index_buffer(p_cmd, p_index_buffer, p_offset, p_index_type);
+
+	_write_call(CaptureCall::COMMAND_BIND_INDEX_BUFFER);
+	_write_handle(p_cmd);
+	_write_handle(p_index_buffer);
+	_write(stream, p_offset);
+	_write(stream, p_index_type);
+}
+
+void CaptureRenderBackend::command_bind_uniform_sets(CommandBuffer p_cmd, Shader p_shader,
+		uint32_t p_first_set, std::vector<UniformSet> p_uniform_sets, PipelineType p_type) {
+	std::scoped_lock lock(mutex);
+
+	_write_call(CaptureCall::COMMAND_BIND_UNIFORM_SETS);
+	_write_handle(p_cmd);
+	_write_handle(p_shader);
+	_write(stream, p_first_set);
+	_write(stream, static_cast<uint32_t>(p_uniform_sets.size()));
+	for (UniformSet uniform_set : p_uniform_sets) {
+		_write_handle(uniform_set);
+	}
+	_write(stream, p_type);
+
+	backend->command_bind_uniform_sets(
+			p_cmd, p_shader, p_first_set, std::move(p_uniform_sets), p_type);
+}
+
+void CaptureRenderBackend::command_push_constants(CommandBuffer p_cmd, Shader p_shader,
+		uint64_t p_offset, uint32_t p_size, const void* p_push_constants) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_push_constants(p_cmd, p_shader, p_offset, p_size, p_push_constants);
+
+	_write_call(CaptureCall::COMMAND_PUSH_CONSTANTS);
+	_write_handle(p_cmd);
+	_write_handle(p_shader);
+	_write(stream, p_offset);
+	_write(stream, p_size);
+	_write_bytes(stream, p_push_constants, p_size);
+}
+
+void CaptureRenderBackend::command_draw(CommandBuffer p_cmd, uint32_t p_vertex_count,
+		uint32_t p_instance_count, uint32_t p_first_vertex, uint32_t p_first_instance) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_draw(p_cmd, p_vertex_count, p_instance_count, p_first_vertex, p_first_instance);
+
+	_write_call(CaptureCall::COMMAND_DRAW);
+	_write_handle(p_cmd);
+	_write(stream, p_vertex_count);
+	_write(stream, p_instance_count);
+	_write(stream, p_first_vertex);
+	_write(stream, p_first_instance);
+}
+
+void CaptureRenderBackend::command_draw_indexed(CommandBuffer p_cmd, uint32_t p_index_count,
+		uint32_t p_instance_count, uint32_t p_first_index, int32_t p_vertex_offset,
+		uint32_t p_first_instance) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_draw_indexed(p_cmd, p_index_count, p_instance_count, p_first_index,
+			p_vertex_offset, p_first_instance);
+
+	_write_call(CaptureCall::COMMAND_DRAW_INDEXED);
+	_write_handle(p_cmd);
+	_write(stream, p_index_count);
+	_write(stream, p_instance_count);
+	_write(stream, p_first_index);
+	_write(stream, p_vertex_offset);
+	_write(stream, p_first_instance);
+}
+
+void CaptureRenderBackend::command_draw_indexed_indirect(CommandBuffer p_cmd, Buffer p_buffer,
+		uint64_t p_offset, uint32_t p_draw_count, uint32_t p_stride) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_draw_indexed_indirect(p_cmd, p_buffer, p_offset, p_draw_count, p_stride);
+
+	_write_call(CaptureCall::COMMAND_DRAW_INDEXED_INDIRECT);
+	_write_handle(p_cmd);
+	_write_handle(p_buffer);
+	_write(stream, p_offset);
+	_write(stream, p_draw_count);
+	_write(stream, p_stride);
+}
+
+void CaptureRenderBackend::command_dispatch(CommandBuffer p_cmd, uint32_t p_group_count_x,
+		uint32_t p_group_count_y, uint32_t p_group_count_z) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_dispatch(p_cmd, p_group_count_x, p_group_count_y, p_group_count_z);
+
+	_write_call(CaptureCall::COMMAND_DISPATCH);
+	_write_handle(p_cmd);
+	_write(stream, p_group_count_x);
+	_write(stream, p_group_count_y);
+	_write(stream, p_group_count_z);
+}
+
+void CaptureRenderBackend::command_set_viewport(CommandBuffer p_cmd, const Vec2u& p_size) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_set_viewport(p_cmd, p_size);
+
+	_write_call(CaptureCall::COMMAND_SET_VIEWPORT);
+	_write_handle(p_cmd);
+	_write(stream, p_size);
+}
+
+void CaptureRenderBackend::command_set_scissor(
+		CommandBuffer p_cmd, const Vec2u& p_size, const Vec2u& p_offset) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_set_scissor(p_cmd, p_size, p_offset);
+
+	_write_call(CaptureCall::COMMAND_SET_SCISSOR);
+	_write_handle(p_cmd);
+	_write(stream, p_size);
+	_write(stream, p_offset);
+}
+
+void CaptureRenderBackend::command_set_depth_bias(CommandBuffer p_cmd,
+		float p_depth_bias_constant_factor, float p_depth_bias_clamp,
+		float p_depth_bias_slope_factor) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_set_depth_bias(
+			p_cmd, p_depth_bias_constant_factor, p_depth_bias_clamp, p_depth_bias_slope_factor);
+
+	_write_call(CaptureCall::COMMAND_SET_DEPTH_BIAS);
+	_write_handle(p_cmd);
+	_write(stream, p_depth_bias_constant_factor);
+	_write(stream, p_depth_bias_clamp);
+	_write(stream, p_depth_bias_slope_factor);
+}
+
+void CaptureRenderBackend::command_clear_color(CommandBuffer p_cmd, Image p_image,
+		const Color& p_clear_color, ImageAspectFlags p_image_aspect) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_clear_color(p_cmd, p_image, p_clear_color, p_image_aspect);
+
+	_write_call(CaptureCall::COMMAND_CLEAR_COLOR);
+	_write_handle(p_cmd);
+	_write_handle(p_image);
+	_write(stream, p_clear_color);
+	_write(stream, p_image_aspect);
+}
+
+void CaptureRenderBackend::command_copy_buffer(CommandBuffer p_cmd, Buffer p_src_buffer,
+		Buffer p_dst_buffer, std::vector<BufferCopyRegion> p_regions) {
+	std::scoped_lock lock(mutex);
+
+	_write_call(CaptureCall::COMMAND_COPY_BUFFER);
+	_write_handle(p_cmd);
+	_write_handle(p_src_buffer);
+	_write_handle(p_dst_buffer);
+	_write_vector(stream, p_regions);
+
+	backend->command_copy_buffer(p_cmd, p_src_buffer, p_dst_buffer, std::move(p_regions));
+}
+
+void CaptureRenderBackend::command_buffer_memory_barrier(CommandBuffer p_cmd,
+		BufferUsageFlags p_src_usage, BufferUsageFlags p_dst_usage, Buffer p_buffer) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_buffer_memory_barrier(p_cmd, p_src_usage, p_dst_usage, p_buffer);
+
+	_write_call(CaptureCall::COMMAND_BUFFER_MEMORY_BARRIER);
+	_write_handle(p_cmd);
+	_write(stream, p_src_usage);
+	_write(stream, p_dst_usage);
+	_write_handle(p_buffer);
+}
+
+void CaptureRenderBackend::command_copy_buffer_to_image(CommandBuffer p_cmd,
+		Buffer p_src_buffer, Image p_dst_image, std::vector<BufferImageCopyRegion> p_regions) {
+	std::scoped_lock lock(mutex);
+
+	_write_call(CaptureCall::COMMAND_COPY_BUFFER_TO_IMAGE);
+	_write_handle(p_cmd);
+	_write_handle(p_src_buffer);
+	_write_handle(p_dst_image);
+	_write_vector(stream, p_regions);
+
+	backend->command_copy_buffer_to_image(p_cmd, p_src_buffer, p_dst_image, std::move(p_regions));
+}
+
+void CaptureRenderBackend::command_copy_image_to_buffer(CommandBuffer p_cmd,
+		Image p_src_image, Buffer p_dst_buffer, std::vector<BufferImageCopyRegion> p_regions) {
+	std::scoped_lock lock(mutex);
+
+	_write_call(CaptureCall::COMMAND_COPY_IMAGE_TO_BUFFER);
+	_write_handle(p_cmd);
+	_write_handle(p_src_image);
+	_write_handle(p_dst_buffer);
+	_write_vector(stream, p_regions);
+
+	backend->command_copy_image_to_buffer(p_cmd, p_src_image, p_dst_buffer, std::move(p_regions));
+}
+
+void CaptureRenderBackend::command_copy_image_to_image(CommandBuffer p_cmd, Image p_src_image,
+		Image p_dst_image, const Vec2u& p_src_extent, const Vec2u& p_dst_extent,
+		uint32_t p_src_mip_level, uint32_t p_dst_mip_level) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_copy_image_to_image(p_cmd, p_src_image, p_dst_image, p_src_extent,
+			p_dst_extent, p_src_mip_level, p_dst_mip_level);
+
+	_write_call(CaptureCall::COMMAND_COPY_IMAGE_TO_IMAGE);
+	_write_handle(p_cmd);
+	_write_handle(p_src_image);
+	_write_handle(p_dst_image);
+	_write(stream, p_src_extent);
+	_write(stream, p_dst_extent);
+	_write(stream, p_src_mip_level);
+	_write(stream, p_dst_mip_level);
+}
+
+void CaptureRenderBackend::command_transition_image(CommandBuffer p_cmd, Image p_image,
+		ImageLayout p_current_layout, ImageLayout p_new_layout, uint32_t p_base_mip_level,
+		uint32_t p_level_count) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_transition_image(
+			p_cmd, p_image, p_current_layout, p_new_layout, p_base_mip_level, p_level_count);
+
+	_write_call(CaptureCall::COMMAND_TRANSITION_IMAGE);
+	_write_handle(p_cmd);
+	_write_handle(p_image);
+	_write(stream, p_current_layout);
+	_write(stream, p_new_layout);
+	_write(stream, p_base_mip_level);
+	_write(stream, p_level_count);
+}
+
+void CaptureRenderBackend::command_reset_query_pool(CommandBuffer p_cmd, QueryPool p_query_pool,
+		uint32_t p_first_query, uint32_t p_query_count) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_reset_query_pool(p_cmd, p_query_pool, p_first_query, p_query_count);
+
+	_write_call(CaptureCall::COMMAND_RESET_QUERY_POOL);
+	_write_handle(p_cmd);
+	_write_handle(p_query_pool);
+	_write(stream, p_first_query);
+	_write(stream, p_query_count);
+}
+
+void CaptureRenderBackend::command_write_timestamp(
+		CommandBuffer p_cmd, QueryPool p_query_pool, uint32_t p_query_index) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_write_timestamp(p_cmd, p_query_pool, p_query_index);
+
+	_write_call(CaptureCall::COMMAND_WRITE_TIMESTAMP);
+	_write_handle(p_cmd);
+	_write_handle(p_query_pool);
+	_write(stream, p_query_index);
+}
+
+void CaptureRenderBackend::command_begin_query(
+		CommandBuffer p_cmd, QueryPool p_query_pool, uint32_t p_query_index, bool p_precise) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_begin_query(p_cmd, p_query_pool, p_query_index, p_precise);
+
+	_write_call(CaptureCall::COMMAND_BEGIN_QUERY);
+	_write_handle(p_cmd);
+	_write_handle(p_query_pool);
+	_write(stream, p_query_index);
+	_write(stream, p_precise);
+}
+
+void CaptureRenderBackend::command_end_query(
+		CommandBuffer p_cmd, QueryPool p_query_pool, uint32_t p_query_index) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_end_query(p_cmd, p_query_pool, p_query_index);
+
+	_write_call(CaptureCall::COMMAND_END_QUERY);
+	_write_handle(p_cmd);
+	_write_handle(p_query_pool);
+	_write(stream, p_query_index);
+}
+
+void CaptureRenderBackend::command_begin_label(
+		CommandBuffer p_cmd, const char* p_name, const Color& p_color) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_begin_label(p_cmd, p_name, p_color);
+
+	_write_call(CaptureCall::COMMAND_BEGIN_LABEL);
+	_write_handle(p_cmd);
+	_write_string(stream, p_name);
+	_write(stream, p_color);
+}
+
+void CaptureRenderBackend::command_end_label(CommandBuffer p_cmd) {
+	std::scoped_lock lock(mutex);
+
+	backend->command_end_label(p_cmd);
+
+	_write_call(CaptureCall::COMMAND_END_LABEL);
+	_write_handle(p_cmd);
+}
+
+} //namespace gl
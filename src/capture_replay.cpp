@@ -0,0 +1,1105 @@
+#include "glgpu/capture.h"
+
+#include "glgpu/log.h"
+
+namespace gl {
+
+struct CaptureReplayer::Reader {
+	const uint8_t* data;
+	size_t size;
+	size_t offset = 0;
+	bool failed = false;
+
+	bool at_end() const { return failed || offset >= size; }
+
+	const uint8_t* read_bytes(size_t p_size) {
+		if (failed || size - offset < p_size) {
+			failed = true;
+			return nullptr;
+		}
+
+		const uint8_t* bytes = data + offset;
+		offset += p_size;
+		return bytes;
+	}
+
+	template <typename T> T read() {
+		static_assert(std::is_trivially_copyable_v<T>);
+
+		T value = {};
+		if (const uint8_t* bytes = read_bytes(sizeof(T))) {
+			memcpy(&value, bytes, sizeof(T));
+		}
+		return value;
+	}
+
+	std::string read_string() {
+		const uint32_t length = read<uint32_t>();
+		const uint8_t* bytes = read_bytes(length);
+		return bytes ? std::string(reinterpret_cast<const char*>(bytes), length) : "";
+	}
+
+	template <typename T> std::vector<T> read_vector() {
+		static_assert(std::is_trivially_copyable_v<T>);
+
+		const uint32_t count = read<uint32_t>();
+		const uint8_t* bytes = read_bytes(size_t(count) * sizeof(T));
+		if (!bytes) {
+			return {};
+		}
+
+		std::vector<T> vector(count);
+		memcpy(vector.data(), bytes, size_t(count) * sizeof(T));
+		return vector;
+	}
+};
+
+CaptureReplayer::CaptureReplayer(std::shared_ptr<RenderBackend> p_backend, bool p_use_swapchain) :
+		backend(p_backend), use_swapchain(p_use_swapchain) {}
+
+CaptureReplayer::~CaptureReplayer() {
+	if (!empty_command_pool) {
+		return;
+	}
+
+	backend->fence_wait(empty_fence);
+	backend->fence_free(empty_fence);
+	backend->command_pool_free(empty_command_pool);
+}
+
+bool CaptureReplayer::load(const std::filesystem::path& p_path) {
+	std::ifstream file(p_path, std::ios::in | std::ios::binary);
+	if (!file.is_open()) {
+		GL_LOG_ERROR("[CAPTURE] Unable to open capture file at path: '{}'.", p_path.string());
+		return false;
+	}
+
+	data.resize(std::filesystem::file_size(p_path));
+	file.read(reinterpret_cast<char*>(data.data()), data.size());
+
+	Reader reader = { data.data(), data.size() };
+	const uint32_t magic = reader.read<uint32_t>();
+	const uint32_t version = reader.read<uint32_t>();
+
+	if (reader.failed || magic != CAPTURE_MAGIC) {
+		GL_LOG_ERROR("[CAPTURE] '{}' is not a capture file.", p_path.string());
+		data.clear();
+		return false;
+	}
+
+	if (version != CAPTURE_VERSION) {
+		GL_LOG_ERROR("[CAPTURE] Capture version {} is not supported, expected {}.", version,
+				CAPTURE_VERSION);
+		data.clear();
+		return false;
+	}
+
+	return true;
+}
+
+bool CaptureReplayer::replay() {
+	if (data.empty()) {
+		GL_LOG_ERROR("[CAPTURE] No capture loaded.");
+		return false;
+	}
+
+	call_count = 0;
+	frame_count = 0;
+
+	// Skip the header validated by `load`
+	Reader reader = { data.data(), data.size(), 2 * sizeof(uint32_t) };
+	const bool result = _replay_calls(reader, false);
+
+	_free_remaining();
+
+	return result;
+}
+
+uint64_t CaptureReplayer::get_call_count() const { return call_count; }
+
+uint32_t CaptureReplayer::get_frame_count() const { return frame_count; }
+
+bool CaptureReplayer::_replay_calls(Reader& p_reader, bool p_immediate) {
+	while (!p_reader.at_end()) {
+		const CaptureCall call = p_reader.read<CaptureCall>();
+		if (p_immediate && call == CaptureCall::IMMEDIATE_SUBMIT_END) {
+			return true;
+		}
+
+		if (call >= CaptureCall::MAX || !_replay_call(p_reader, call)) {
+			GL_LOG_ERROR("[CAPTURE] Invalid call {} at offset {}.", static_cast<uint32_t>(call),
+					p_reader.offset);
+			return false;
+		}
+
+		call_count++;
+	}
+
+	if (p_reader.failed) {
+		GL_LOG_ERROR("[CAPTURE] Capture is truncated.");
+		return false;
+	}
+
+	// Immediate submissions must be closed before the capture ends
+	return !p_immediate;
+}
+
+void* CaptureReplayer::_get_handle(CaptureHandle p_id) const {
+	if (p_id == 0) {
+		return nullptr;
+	}
+
+	if (const auto it = resources.find(p_id); it != resources.end()) {
+		return it->second.handle;
+	}
+
+	if (const auto it = borrowed_handles.find(p_id); it != borrowed_handles.end()) {
+		return it->second;
+	}
+
+	GL_LOG_WARNING("[CAPTURE] Unknown handle id {}.", p_id);
+	return nullptr;
+}
+
+void CaptureReplayer::_submit_empty(
+		CommandQueue p_queue, Semaphore p_wait_semaphore, Semaphore p_signal_semaphore) {
+	if (!empty_command_pool) {
+		empty_command_pool = backend->command_pool_create(backend->queue_get(QueueType::GRAPHICS));
+		empty_command_buffer = backend->command_pool_allocate(empty_command_pool);
+		empty_fence = backend->fence_create(true);
+	}
+
+	backend->fence_wait(empty_fence);
+	backend->fence_reset(empty_fence);
+
+	backend->command_reset(empty_command_buffer);
+	backend->command_begin(empty_command_buffer);
+	backend->command_end(empty_command_buffer);
+
+	backend->queue_submit(
+			p_queue, empty_command_buffer, empty_fence, p_wait_semaphore, p_signal_semaphore);
+}
+
+void CaptureReplayer::_free_remaining() {
+	backend->device_wait();
+
+	for (const auto& [id, mapped_data] : mapped_buffers) {
+		backend->buffer_unmap(Buffer(_get_handle(id)));
+	}
+	mapped_buffers.clear();
+
+	// Dependents first, command buffers go with their pools
+	constexpr CaptureCall FREE_ORDER[] = {
+		CaptureCall::COMMAND_POOL_FREE,
+		CaptureCall::UNIFORM_SET_FREE,
+		CaptureCall::PIPELINE_FREE,
+		CaptureCall::FRAME_BUFFER_DESTROY,
+		CaptureCall::RENDER_PASS_DESTROY,
+		CaptureCall::SHADER_FREE,
+		CaptureCall::SAMPLER_FREE,
+		CaptureCall::IMAGE_FREE,
+		CaptureCall::BUFFER_FREE,
+		CaptureCall::QUERY_POOL_FREE,
+		CaptureCall::SEMAPHORE_FREE,
+		CaptureCall::FENCE_FREE,
+		CaptureCall::SWAPCHAIN_FREE,
+	};
+
+	for (CaptureCall free_call : FREE_ORDER) {
+		for (const auto& [id, resource] : resources) {
+			if (resource.free_call != free_call) {
+				continue;
+			}
+
+			switch (free_call) {
+				case CaptureCall::COMMAND_POOL_FREE:
+					backend->command_pool_free(CommandPool(resource.handle));
+					break;
+				case CaptureCall::UNIFORM_SET_FREE:
+					backend->uniform_set_free(UniformSet(resource.handle));
+					break;
+				case CaptureCall::PIPELINE_FREE:
+					backend->pipeline_free(Pipeline(resource.handle));
+					break;
+				case CaptureCall::FRAME_BUFFER_DESTROY:
+					backend->frame_buffer_destroy(FrameBuffer(resource.handle));
+					break;
+				case CaptureCall::RENDER_PASS_DESTROY:
+					backend->render_pass_destroy(RenderPass(resource.handle));
+					break;
+				case CaptureCall::SHADER_FREE:
+					backend->shader_free(Shader(resource.handle));
+					break;
+				case CaptureCall::SAMPLER_FREE:
+					backend->sampler_free(Sampler(resource.handle));
+					break;
+				case CaptureCall::IMAGE_FREE:
+					backend->image_free(Image(resource.handle));
+					break;
+				case CaptureCall::BUFFER_FREE:
+					backend->buffer_free(Buffer(resource.handle));
+					break;
+				case CaptureCall::QUERY_POOL_FREE:
+					backend->query_pool_free(QueryPool(resource.handle));
+					break;
+				case CaptureCall::SEMAPHORE_FREE:
+					backend->semaphore_free(Semaphore(resource.handle));
+					break;
+				case CaptureCall::FENCE_FREE:
+					backend->fence_free(Fence(resource.handle));
+					break;
+				case CaptureCall::SWAPCHAIN_FREE:
+					if (use_swapchain) {
+						backend->swapchain_free(Swapchain(resource.handle));
+					}
+					break;
+				default:
+					break;
+			}
+		}
+	}
+
+	for (const auto& [id, swapchain] : offscreen_swapchains) {
+		for (Image image : swapchain.images) {
+			backend->image_free(image);
+		}
+	}
+
+	resources.clear();
+	buffer_sizes.clear();
+	borrowed_handles.clear();
+	offscreen_swapchains.clear();
+}
+
+bool CaptureReplayer::_replay_call(Reader& p_reader, CaptureCall p_call) {
+	Reader& r = p_reader;
+
+	const auto read_handle = [&]() { return _get_handle(r.read<CaptureHandle>()); };
+
+	switch (p_call) {
+		// Device
+
+		case CaptureCall::DEVICE_WAIT: {
+			backend->device_wait();
+		} break;
+		case CaptureCall::QUEUE_GET: {
+			const QueueType type = r.read<QueueType>();
+			const CaptureHandle id = r.read<CaptureHandle>();
+			borrowed_handles[id] = backend->queue_get(type);
+		} break;
+
+		// Swapchain
+
+		case CaptureCall::SWAPCHAIN_CREATE: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+			if (use_swapchain) {
+				resources[id] = { backend->swapchain_create(), CaptureCall::SWAPCHAIN_FREE };
+			} else {
+				// Offscreen swapchains are tracked separately, the id maps to nothing
+				offscreen_swapchains[id] = {};
+				borrowed_handles[id] = nullptr;
+			}
+		} break;
+		case CaptureCall::SWAPCHAIN_RESIZE: {
+			CommandQueue queue = CommandQueue(read_handle());
+			const CaptureHandle id = r.read<CaptureHandle>();
+			SwapchainCreateInfo swapchain_info = {};
+			swapchain_info.size = r.read<Vec2u>();
+			swapchain_info.present_mode = r.read<PresentMode>();
+			swapchain_info.image_count = r.read<uint32_t>();
+			swapchain_info.max_frame_latency = r.read<uint32_t>();
+			const DataFormat format = r.read<DataFormat>();
+			const uint32_t image_count = r.read<uint32_t>();
+
+			if (use_swapchain) {
+				backend->swapchain_resize(queue, Swapchain(_get_handle(id)), swapchain_info);
+				break;
+			}
+
+			OffscreenSwapchain& swapchain = offscreen_swapchains[id];
+			for (Image image : swapchain.images) {
+				backend->image_free(image);
+			}
+			swapchain.images.clear();
+
+			ImageCreateInfo info = {};
+			info.format = format;
+			info.size = swapchain_info.size;
+			info.usage = IMAGE_USAGE_COLOR_ATTACHMENT_BIT | IMAGE_USAGE_TRANSFER_SRC_BIT |
+					IMAGE_USAGE_TRANSFER_DST_BIT;
+
+			for (uint32_t i = 0; i < image_count; i++) {
+				swapchain.images.push_back(backend->image_create(info));
+			}
+		} break;
+		case CaptureCall::SWAPCHAIN_GET_IMAGES: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+			const uint32_t count = r.read<uint32_t>();
+
+			std::vector<Image> images = use_swapchain
+					? backend->swapchain_get_images(Swapchain(_get_handle(id)))
+					: offscreen_swapchains[id].images;
+
+			for (uint32_t i = 0; i < count; i++) {
+				const CaptureHandle image_id = r.read<CaptureHandle>();
+				borrowed_handles[image_id] = i < images.size() ? images[i] : GL_NULL_HANDLE;
+			}
+		} break;
+		case CaptureCall::SWAPCHAIN_ACQUIRE_IMAGE: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+			Semaphore semaphore = Semaphore(read_handle());
+			const bool acquired = r.read<bool>();
+			const uint32_t image_index = r.read<uint32_t>();
+			const CaptureHandle image_id = r.read<CaptureHandle>();
+
+			if (use_swapchain) {
+				Result<Image, Error> result =
+						backend->swapchain_acquire_image(Swapchain(_get_handle(id)), semaphore);
+				if (result.has_value()) {
+					borrowed_handles[image_id] = result.get_value();
+				}
+				break;
+			}
+
+			OffscreenSwapchain& swapchain = offscreen_swapchains[id];
+			if (!acquired || image_index >= swapchain.images.size()) {
+				break;
+			}
+
+			swapchain.image_index = image_index;
+			borrowed_handles[image_id] = swapchain.images[image_index];
+
+			// Nothing signals the semaphore without a presentation engine
+			if (semaphore) {
+				_submit_empty(backend->queue_get(QueueType::GRAPHICS), GL_NULL_HANDLE, semaphore);
+			}
+		} break;
+		case CaptureCall::SWAPCHAIN_FREE: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+			if (use_swapchain) {
+				backend->swapchain_free(Swapchain(_get_handle(id)));
+				resources.erase(id);
+				break;
+			}
+
+			for (Image image : offscreen_swapchains[id].images) {
+				backend->image_free(image);
+			}
+			offscreen_swapchains.erase(id);
+		} break;
+
+		// Resources
+
+		case CaptureCall::BUFFER_CREATE: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+			const uint64_t size = r.read<uint64_t>();
+			const BufferUsageFlags usage = r.read<BufferUsageFlags>();
+			const MemoryAllocationType allocation_type = r.read<MemoryAllocationType>();
+
+			resources[id] = { backend->buffer_create(size, usage, allocation_type),
+				CaptureCall::BUFFER_FREE };
+			buffer_sizes[id] = size;
+		} break;
+		case CaptureCall::BUFFER_FREE: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+			if (mapped_buffers.erase(id)) {
+				backend->buffer_unmap(Buffer(_get_handle(id)));
+			}
+			backend->buffer_free(Buffer(_get_handle(id)));
+			resources.erase(id);
+			buffer_sizes.erase(id);
+		} break;
+		case CaptureCall::BUFFER_MAP: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+			mapped_buffers[id] = backend->buffer_map(Buffer(_get_handle(id)));
+		} break;
+		case CaptureCall::BUFFER_UNMAP: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+			backend->buffer_unmap(Buffer(_get_handle(id)));
+			mapped_buffers.erase(id);
+		} break;
+		case CaptureCall::BUFFER_INVALIDATE: {
+			backend->buffer_invalidate(Buffer(read_handle()));
+		} break;
+		case CaptureCall::BUFFER_FLUSH: {
+			backend->buffer_flush(Buffer(read_handle()));
+		} break;
+		case CaptureCall::BUFFER_DATA: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+			const uint64_t offset = r.read<uint64_t>();
+			const uint64_t size = r.read<uint64_t>();
+			const uint8_t* bytes = r.read_bytes(size);
+
+			const auto it = mapped_buffers.find(id);
+			if (!bytes || it == mapped_buffers.end() || !it->second) {
+				return false;
+			}
+
+			// Written as `offset > buffer_size - size` so it cannot overflow
+			const auto size_it = buffer_sizes.find(id);
+			if (size_it == buffer_sizes.end() || size > size_it->second ||
+					offset > size_it->second - size) {
+				return false;
+			}
+
+			memcpy(it->second + offset, bytes, size);
+		} break;
+		case CaptureCall::IMAGE_CREATE: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+
+			ImageCreateInfo info = {};
+			info.format = r.read<DataFormat>();
+			info.size = r.read<Vec2u>();
+			info.usage = r.read<ImageUsageFlags>();
+			info.mipmapped = r.read<bool>();
+			info.samples = r.read<uint32_t>();
+
+			const uint64_t data_size = r.read<uint64_t>();
+			info.data = data_size > 0 ? r.read_bytes(data_size) : nullptr;
+
+			// The backend uploads a whole image worth of bytes from `data`
+			const uint64_t image_size =
+					uint64_t(info.size.x) * info.size.y * get_data_format_size(info.format);
+			if (data_size > 0 && (!info.data || data_size < image_size)) {
+				return false;
+			}
+
+			resources[id] = { backend->image_create(info), CaptureCall::IMAGE_FREE };
+		} break;
+		case CaptureCall::IMAGE_FREE: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+			backend->image_free(Image(_get_handle(id)));
+			resources.erase(id);
+		} break;
+		case CaptureCall::SAMPLER_CREATE: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+			const SamplerCreateInfo info = r.read<SamplerCreateInfo>();
+
+			resources[id] = { backend->sampler_create(info), CaptureCall::SAMPLER_FREE };
+		} break;
+		case CaptureCall::SAMPLER_FREE: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+			backend->sampler_free(Sampler(_get_handle(id)));
+			resources.erase(id);
+		} break;
+
+		// Shaders & pipelines
+
+		case CaptureCall::SHADER_CREATE: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+
+			std::vector<SpirvEntry> entries(r.read<uint32_t>());
+			for (SpirvEntry& entry : entries) {
+				entry.stage = r.read<ShaderStageFlags>();
+				entry.byte_code = r.read_vector<uint32_t>();
+			}
+
+			if (r.failed) {
+				return false;
+			}
+
+			resources[id] = { backend->shader_create_from_bytecode(entries),
+				CaptureCall::SHADER_FREE };
+		} break;
+		case CaptureCall::SHADER_FREE: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+			backend->shader_free(Shader(_get_handle(id)));
+			resources.erase(id);
+		} break;
+		case CaptureCall::RENDER_PIPELINE_CREATE: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+
+			RenderPipelineCreateInfo info = {};
+			info.shader = Shader(read_handle());
+			info.primitive = r.read<RenderPrimitive>();
+			info.vertex_input_state = r.read<PipelineVertexInputState>();
+			info.rasterization_state = r.read<PipelineRasterizationState>();
+
+			PipelineMultisampleState& multisample_state = info.multisample_state;
+			multisample_state.sample_count = r.read<uint32_t>();
+			multisample_state.enable_sample_shading = r.read<bool>();
+			multisample_state.min_sample_shading = r.read<float>();
+			multisample_state.sample_mask = r.read_vector<uint32_t>();
+			multisample_state.enable_alpha_to_coverage = r.read<bool>();
+			multisample_state.enable_alpha_to_one = r.read<bool>();
+
+			info.depth_stencil_state = r.read<PipelineDepthStencilState>();
+
+			PipelineColorBlendState& color_blend_state = info.color_blend_state;
+			color_blend_state.enable_logic_op = r.read<bool>();
+			color_blend_state.logic_op = r.read<LogicOperator>();
+			color_blend_state.attachments = r.read_vector<PipelineColorBlendState::Attachment>();
+			color_blend_state.blend_constant = r.read<Vec4f>();
+
+			info.dynamic_state = r.read<PipelineDynamicStateFlags>();
+			info.render_pass = RenderPass(read_handle());
+			info.rendering_info.color_attachments = r.read_vector<DataFormat>();
+			info.rendering_info.depth_attachment = r.read<DataFormat>();
+
+			if (r.failed) {
+				return false;
+			}
+
+			resources[id] = { backend->render_pipeline_create(info), CaptureCall::PIPELINE_FREE };
+		} break;
+		case CaptureCall::COMPUTE_PIPELINE_CREATE: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+			Shader shader = Shader(read_handle());
+
+			resources[id] = { backend->compute_pipeline_create(shader), CaptureCall::PIPELINE_FREE };
+		} break;
+		case CaptureCall::PIPELINE_FREE: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+			backend->pipeline_free(Pipeline(_get_handle(id)));
+			resources.erase(id);
+		} break;
+		case CaptureCall::UNIFORM_SET_CREATE: {
+			std::vector<ShaderUniform> uniforms(r.read<uint32_t>());
+			for (ShaderUniform& uniform : uniforms) {
+				uniform.type = r.read<ShaderUniformType>();
+				uniform.binding = r.read<uint32_t>();
+				uniform.data.resize(r.read<uint32_t>());
+				for (void*& handle : uniform.data) {
+					handle = read_handle();
+				}
+			}
+			Shader shader = Shader(read_handle());
+			const uint32_t set_index = r.read<uint32_t>();
+			const CaptureHandle id = r.read<CaptureHandle>();
+
+			if (r.failed) {
+				return false;
+			}
+
+			resources[id] = { backend->uniform_set_create(std::move(uniforms), shader, set_index),
+				CaptureCall::UNIFORM_SET_FREE };
+		} break;
+		case CaptureCall::UNIFORM_SET_FREE: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+			backend->uniform_set_free(UniformSet(_get_handle(id)));
+			resources.erase(id);
+		} break;
+		case CaptureCall::RENDER_PASS_CREATE: {
+			std::vector<RenderPassAttachment> attachments = r.read_vector<RenderPassAttachment>();
+			std::vector<SubpassInfo> subpasses(r.read<uint32_t>());
+			for (SubpassInfo& subpass : subpasses) {
+				subpass.attachments = r.read_vector<SubpassAttachment>();
+			}
+			const CaptureHandle id = r.read<CaptureHandle>();
+
+			if (r.failed) {
+				return false;
+			}
+
+			resources[id] = {
+				backend->render_pass_create(std::move(attachments), std::move(subpasses)),
+				CaptureCall::RENDER_PASS_DESTROY
+			};
+		} break;
+		case CaptureCall::RENDER_PASS_DESTROY: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+			backend->render_pass_destroy(RenderPass(_get_handle(id)));
+			resources.erase(id);
+		} break;
+		case CaptureCall::FRAME_BUFFER_CREATE: {
+			RenderPass render_pass = RenderPass(read_handle());
+			std::vector<Image> attachments(r.read<uint32_t>());
+			for (Image& image : attachments) {
+				image = Image(read_handle());
+			}
+			const Vec2u extent = r.read<Vec2u>();
+			const CaptureHandle id = r.read<CaptureHandle>();
+
+			if (r.failed) {
+				return false;
+			}
+
+			resources[id] = {
+				backend->frame_buffer_create(render_pass, std::move(attachments), extent),
+				CaptureCall::FRAME_BUFFER_DESTROY
+			};
+		} break;
+		case CaptureCall::FRAME_BUFFER_DESTROY: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+			backend->frame_buffer_destroy(FrameBuffer(_get_handle(id)));
+			resources.erase(id);
+		} break;
+
+		// Synchronization
+
+		case CaptureCall::FENCE_CREATE: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+			const bool signaled = r.read<bool>();
+
+			resources[id] = { backend->fence_create(signaled), CaptureCall::FENCE_FREE };
+		} break;
+		case CaptureCall::FENCE_FREE: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+			backend->fence_free(Fence(_get_handle(id)));
+			resources.erase(id);
+		} break;
+		case CaptureCall::FENCE_WAIT: {
+			backend->fence_wait(Fence(read_handle()));
+		} break;
+		case CaptureCall::FENCE_RESET: {
+			backend->fence_reset(Fence(read_handle()));
+		} break;
+		case CaptureCall::SEMAPHORE_CREATE: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+			resources[id] = { backend->semaphore_create(), CaptureCall::SEMAPHORE_FREE };
+		} break;
+		case CaptureCall::SEMAPHORE_FREE: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+			backend->semaphore_free(Semaphore(_get_handle(id)));
+			resources.erase(id);
+		} break;
+
+		// Queries
+
+		case CaptureCall::QUERY_POOL_CREATE: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+			const QueryType type = r.read<QueryType>();
+			const uint32_t query_count = r.read<uint32_t>();
+
+			resources[id] = { backend->query_pool_create(type, query_count),
+				CaptureCall::QUERY_POOL_FREE };
+		} break;
+		case CaptureCall::QUERY_POOL_FREE: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+			backend->query_pool_free(QueryPool(_get_handle(id)));
+			resources.erase(id);
+		} break;
+		case CaptureCall::QUERY_POOL_GET_RESULTS: {
+			QueryPool query_pool = QueryPool(read_handle());
+			const uint32_t first_query = r.read<uint32_t>();
+			const uint32_t query_count = r.read<uint32_t>();
+
+			// Sized for the widest query type
+			std::vector<uint64_t> results(
+					query_count * get_query_result_count(QueryType::PIPELINE_STATISTICS));
+			backend->query_pool_get_results(query_pool, first_query, query_count, results.data());
+		} break;
+
+		// Debugging
+
+		case CaptureCall::SET_NAME: {
+			const CaptureCall object_type = r.read<CaptureCall>();
+			void* handle = read_handle();
+			const std::string name = r.read_string();
+
+			if (!handle) {
+				break;
+			}
+
+			switch (object_type) {
+				case CaptureCall::BUFFER_CREATE:
+					backend->buffer_set_name(Buffer(handle), name.c_str());
+					break;
+				case CaptureCall::IMAGE_CREATE:
+					backend->image_set_name(Image(handle), name.c_str());
+					break;
+				case CaptureCall::SAMPLER_CREATE:
+					backend->sampler_set_name(Sampler(handle), name.c_str());
+					break;
+				case CaptureCall::COMMAND_POOL_CREATE:
+					backend->command_pool_set_name(CommandPool(handle), name.c_str());
+					break;
+				case CaptureCall::COMMAND_POOL_ALLOCATE:
+					backend->command_buffer_set_name(CommandBuffer(handle), name.c_str());
+					break;
+				case CaptureCall::QUEUE_GET:
+					backend->queue_set_name(CommandQueue(handle), name.c_str());
+					break;
+				case CaptureCall::RENDER_PASS_CREATE:
+					backend->render_pass_set_name(RenderPass(handle), name.c_str());
+					break;
+				case CaptureCall::FRAME_BUFFER_CREATE:
+					backend->frame_buffer_set_name(FrameBuffer(handle), name.c_str());
+					break;
+				case CaptureCall::SWAPCHAIN_CREATE:
+					backend->swapchain_set_name(Swapchain(handle), name.c_str());
+					break;
+				case CaptureCall::COMPUTE_PIPELINE_CREATE:
+					backend->pipeline_set_name(Pipeline(handle), name.c_str());
+					break;
+				case CaptureCall::SHADER_CREATE:
+					backend->shader_set_name(Shader(handle), name.c_str());
+					break;
+				case CaptureCall::UNIFORM_SET_CREATE:
+					backend->uniform_set_set_name(UniformSet(handle), name.c_str());
+					break;
+				case CaptureCall::FENCE_CREATE:
+					backend->fence_set_name(Fence(handle), name.c_str());
+					break;
+				case CaptureCall::SEMAPHORE_CREATE:
+					backend->semaphore_set_name(Semaphore(handle), name.c_str());
+					break;
+				case CaptureCall::QUERY_POOL_CREATE:
+					backend->query_pool_set_name(QueryPool(handle), name.c_str());
+					break;
+				default:
+					return false;
+			}
+		} break;
+
+		// Submission
+
+		case CaptureCall::QUEUE_SUBMIT: {
+			CommandQueue queue = CommandQueue(read_handle());
+			CommandBuffer cmd = CommandBuffer(read_handle());
+			Fence fence = Fence(read_handle());
+			Semaphore wait_semaphore = Semaphore(read_handle());
+			Semaphore signal_semaphore = Semaphore(read_handle());
+
+			backend->queue_submit(queue, cmd, fence, wait_semaphore, signal_semaphore);
+		} break;
+		case CaptureCall::QUEUE_PRESENT: {
+			CommandQueue queue = CommandQueue(read_handle());
+			const CaptureHandle id = r.read<CaptureHandle>();
+			Semaphore wait_semaphore = Semaphore(read_handle());
+
+			frame_count++;
+
+			if (use_swapchain) {
+				backend->queue_present(queue, Swapchain(_get_handle(id)), wait_semaphore);
+			} else if (wait_semaphore) {
+				// Consume the render finished signal the presentation engine would wait on
+				_submit_empty(queue, wait_semaphore, GL_NULL_HANDLE);
+			}
+		} break;
+		case CaptureCall::COMMAND_POOL_CREATE: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+			CommandQueue queue = CommandQueue(read_handle());
+
+			resources[id] = { backend->command_pool_create(queue), CaptureCall::COMMAND_POOL_FREE };
+		} break;
+		case CaptureCall::COMMAND_POOL_FREE: {
+			const CaptureHandle id = r.read<CaptureHandle>();
+			backend->command_pool_free(CommandPool(_get_handle(id)));
+			resources.erase(id);
+		} break;
+		case CaptureCall::COMMAND_POOL_ALLOCATE: {
+			CommandPool command_pool = CommandPool(read_handle());
+			const CaptureHandle id = r.read<CaptureHandle>();
+
+			// Owned by the pool
+			borrowed_handles[id] = backend->command_pool_allocate(command_pool);
+		} break;
+		case CaptureCall::COMMAND_POOL_RESET: {
+			backend->command_pool_reset(CommandPool(read_handle()));
+		} break;
+		case CaptureCall::IMMEDIATE_SUBMIT_BEGIN: {
+			const QueueType queue_type = r.read<QueueType>();
+			const CaptureHandle id = r.read<CaptureHandle>();
+
+			bool result = true;
+			backend->command_immediate_submit(
+					[&](CommandBuffer p_cmd) {
+						borrowed_handles[id] = p_cmd;
+						result = _replay_calls(r, true);
+					},
+					queue_type);
+
+			if (!result) {
+				return false;
+			}
+		} break;
+		case CaptureCall::IMMEDIATE_SUBMIT_END: {
+			// Only valid inside of an immediate submission
+			return false;
+		}
+
+		// Recording
+
+		case CaptureCall::COMMAND_BEGIN: {
+			backend->command_begin(CommandBuffer(read_handle()));
+		} break;
+		case CaptureCall::COMMAND_END: {
+			backend->command_end(CommandBuffer(read_handle()));
+		} break;
+		case CaptureCall::COMMAND_RESET: {
+			backend->command_reset(CommandBuffer(read_handle()));
+		} break;
+		case CaptureCall::COMMAND_BEGIN_RENDER_PASS: {
+			CommandBuffer cmd = CommandBuffer(read_handle());
+			RenderPass render_pass = RenderPass(read_handle());
+			FrameBuffer frame_buffer = FrameBuffer(read_handle());
+			const Vec2u draw_extent = r.read<Vec2u>();
+			const Color clear_color = r.read<Color>();
+
+			backend->command_begin_render_pass(
+					cmd, render_pass, frame_buffer, draw_extent, clear_color);
+		} break;
+		case CaptureCall::COMMAND_END_RENDER_PASS: {
+			backend->command_end_render_pass(CommandBuffer(read_handle()));
+		} break;
+		case CaptureCall::COMMAND_BEGIN_RENDERING: {
+			CommandBuffer cmd = CommandBuffer(read_handle());
+			const Vec2u draw_extent = r.read<Vec2u>();
+
+			std::vector<RenderingAttachment> color_attachments(r.read<uint32_t>());
+			for (RenderingAttachment& attachment : color_attachments) {
+				attachment.image = Image(read_handle());
+				attachment.layout = r.read<ImageLayout>();
+				attachment.load_op = r.read<AttachmentLoadOp>();
+				attachment.store_op = r.read<AttachmentStoreOp>();
+				attachment.clear_color = r.read<Color>();
+				attachment.resolve_mode = r.read<ResolveModeFlags>();
+				attachment.resolve_image = Image(read_handle());
+				attachment.resolve_layout = r.read<ImageLayout>();
+			}
+			Image depth_attachment = Image(read_handle());
+
+			if (r.failed) {
+				return false;
+			}
+
+			backend->command_begin_rendering(
+					cmd, draw_extent, std::move(color_attachments), depth_attachment);
+		} break;
+		case CaptureCall::COMMAND_END_RENDERING: {
+			backend->command_end_rendering(CommandBuffer(read_handle()));
+		} break;
+		case CaptureCall::COMMAND_BIND_GRAPHICS_PIPELINE: {
+			CommandBuffer cmd = CommandBuffer(read_handle());
+			backend->command_bind_graphics_pipeline(cmd, Pipeline(read_handle()));
+		} break;
+		case CaptureCall::COMMAND_BIND_COMPUTE_PIPELINE: {
+			CommandBuffer cmd = CommandBuffer(read_handle());
+			backend->command_bind_compute_pipeline(cmd, Pipeline(read_handle()));
+		} break;
+		case CaptureCall::COMMAND_BIND_VERTEX_BUFFERS: {
+			CommandBuffer cmd = CommandBuffer(read_handle());
+			const uint32_t first_binding = r.read<uint32_t>();
+
+			std::vector<Buffer> vertex_buffers(r.read<uint32_t>());
+			for (Buffer& buffer : vertex_buffers) {
+				buffer = Buffer(read_handle());
+			}
+			std::vector<uint64_t> offsets = r.read_vector<uint64_t>();
+
+			if (r.failed) {
+				return false;
+			}
+
+			backend->command_bind_vertex_buffers(
+					cmd, first_binding, std::move(vertex_buffers), std::move(offsets));
+		} break;
+		case CaptureCall::COMMAND_BIND_INDEX_BUFFER: {
+			CommandBuffer cmd = CommandBuffer(read_handle());
+			Buffer index_buffer = Buffer(read_handle());
+			const uint64_t offset = r.read<uint64_t>();
+			const IndexType index_type = r.read<IndexType>();
+
+			backend->command_bind_index_buffer(cmd, index_buffer, offset, index_type);
+		} break;
+		case CaptureCall::COMMAND_BIND_UNIFORM_SETS: {
+			CommandBuffer cmd = CommandBuffer(read_handle());
+			Shader shader = Shader(read_handle());
+			const uint32_t first_set = r.read<uint32_t>();
+
+			std::vector<UniformSet> uniform_sets(r.read<uint32_t>());
+			for (UniformSet& uniform_set : uniform_sets) {
+				uniform_set = UniformSet(read_handle());
+			}
+			const PipelineType type = r.read<PipelineType>();
+
+			if (r.failed) {
+				return false;
+			}
+
+			backend->command_bind_uniform_sets(
+					cmd, shader, first_set, std::move(uniform_sets), type);
+		} break;
+		case CaptureCall::COMMAND_PUSH_CONSTANTS: {
+			CommandBuffer cmd = CommandBuffer(read_handle());
+			Shader shader = Shader(read_handle());
+			const uint64_t offset = r.read<uint64_t>();
+			const uint32_t size = r.read<uint32_t>();
+			const uint8_t* push_constants = r.read_bytes(size);
+
+			if (!push_constants) {
+				return false;
+			}
+
+			backend->command_push_constants(cmd, shader, offset, size, push_constants);
+		} break;
+		case CaptureCall::COMMAND_DRAW: {
+			CommandBuffer cmd = CommandBuffer(read_handle());
+			const uint32_t vertex_count = r.read<uint32_t>();
+			const uint32_t instance_count = r.read<uint32_t>();
+			const uint32_t first_vertex = r.read<uint32_t>();
+			const uint32_t first_instance = r.read<uint32_t>();
+
+			backend->command_draw(cmd, vertex_count, instance_count, first_vertex, first_instance);
+		} break;
+		case CaptureCall::COMMAND_DRAW_INDEXED: {
+			CommandBuffer cmd = CommandBuffer(read_handle());
+			const uint32_t index_count = r.read<uint32_t>();
+			const uint32_t instance_count = r.read<uint32_t>();
+			const uint32_t first_index = r.read<uint32_t>();
+			const int32_t vertex_offset = r.read<int32_t>();
+			const uint32_t first_instance = r.read<uint32_t>();
+
+			backend->command_draw_indexed(
+					cmd, index_count, instance_count, first_index, vertex_offset, first_instance);
+		} break;
+		case CaptureCall::COMMAND_DRAW_INDEXED_INDIRECT: {
+			CommandBuffer cmd = CommandBuffer(read_handle());
+			Buffer buffer = Buffer(read_handle());
+			const uint64_t offset = r.read<uint64_t>();
+			const uint32_t draw_count = r.read<uint32_t>();
+			const uint32_t stride = r.read<uint32_t>();
+
+			backend->command_draw_indexed_indirect(cmd, buffer, offset, draw_count, stride);
+		} break;
+		case CaptureCall::COMMAND_DISPATCH: {
+			CommandBuffer cmd = CommandBuffer(read_handle());
+			const uint32_t group_count_x = r.read<uint32_t>();
+			const uint32_t group_count_y = r.read<uint32_t>();
+			const uint32_t group_count_z = r.read<uint32_t>();
+
+			backend->command_dispatch(cmd, group_count_x, group_count_y, group_count_z);
+		} break;
+		case CaptureCall::COMMAND_SET_VIEWPORT: {
+			CommandBuffer cmd = CommandBuffer(read_handle());
+			backend->command_set_viewport(cmd, r.read<Vec2u>());
+		} break;
+		case CaptureCall::COMMAND_SET_SCISSOR: {
+			CommandBuffer cmd = CommandBuffer(read_handle());
+			const Vec2u size = r.read<Vec2u>();
+			const Vec2u offset = r.read<Vec2u>();
+
+			backend->command_set_scissor(cmd, size, offset);
+		} break;
+		case CaptureCall::COMMAND_SET_DEPTH_BIAS: {
+			CommandBuffer cmd = CommandBuffer(read_handle());
+			const float constant_factor = r.read<float>();
+			const float clamp = r.read<float>();
+			const float slope_factor = r.read<float>();
+
+			backend->command_set_depth_bias(cmd, constant_factor, clamp, slope_factor);
+		} break;
+		case CaptureCall::COMMAND_CLEAR_COLOR: {
+			CommandBuffer cmd = CommandBuffer(read_handle());
+			Image image = Image(read_handle());
+			const Color clear_color = r.read<Color>();
+			const ImageAspectFlags image_aspect = r.read<ImageAspectFlags>();
+
+			backend->command_clear_color(cmd, image, clear_color, image_aspect);
+		} break;
+		case CaptureCall::COMMAND_COPY_BUFFER: {
+			CommandBuffer cmd = CommandBuffer(read_handle());
+			Buffer src_buffer = Buffer(read_handle());
+			Buffer dst_buffer = Buffer(read_handle());
+			std::vector<BufferCopyRegion> regions = r.read_vector<BufferCopyRegion>();
+
+			if (r.failed) {
+				return false;
+			}
+
+			backend->command_copy_buffer(cmd, src_buffer, dst_buffer, std::move(regions));
+		} break;
+		case CaptureCall::COMMAND_BUFFER_MEMORY_BARRIER: {
+			CommandBuffer cmd = CommandBuffer(read_handle());
+			const BufferUsageFlags src_usage = r.read<BufferUsageFlags>();
+			const BufferUsageFlags dst_usage = r.read<BufferUsageFlags>();
+			Buffer buffer = Buffer(read_handle());
+
+			backend->command_buffer_memory_barrier(cmd, src_usage, dst_usage, buffer);
+		} break;
+		case CaptureCall::COMMAND_COPY_BUFFER_TO_IMAGE: {
+			CommandBuffer cmd = CommandBuffer(read_handle());
+			Buffer src_buffer = Buffer(read_handle());
+			Image dst_image = Image(read_handle());
+			std::vector<BufferImageCopyRegion> regions = r.read_vector<BufferImageCopyRegion>();
+
+			if (r.failed) {
+				return false;
+			}
+
+			backend->command_copy_buffer_to_image(cmd, src_buffer, dst_image, std::move(regions));
+		} break;
+		case CaptureCall::COMMAND_COPY_IMAGE_TO_BUFFER: {
+			CommandBuffer cmd = CommandBuffer(read_handle());
+			Image src_image = Image(read_handle());
+			Buffer dst_buffer = Buffer(read_handle());
+			std::vector<BufferImageCopyRegion> regions = r.read_vector<BufferImageCopyRegion>();
+
+			if (r.failed) {
+				return false;
+			}
+
+			backend->command_copy_image_to_buffer(cmd, src_image, dst_buffer, std::move(regions));
+		} break;
+		case CaptureCall::COMMAND_COPY_IMAGE_TO_IMAGE: {
+			CommandBuffer cmd = CommandBuffer(read_handle());
+			Image src_image = Image(read_handle());
+			Image dst_image = Image(read_handle());
+			const Vec2u src_extent = r.read<Vec2u>();
+			const Vec2u dst_extent = r.read<Vec2u>();
+			const uint32_t src_mip_level = r.read<uint32_t>();
+			const uint32_t dst_mip_level = r.read<uint32_t>();
+
+			backend->command_copy_image_to_image(cmd, src_image, dst_image, src_extent, dst_extent,
+					src_mip_level, dst_mip_level);
+		} break;
+		case CaptureCall::COMMAND_TRANSITION_IMAGE: {
+			CommandBuffer cmd = CommandBuffer(read_handle());
+			Image image = Image(read_handle());
+			const ImageLayout current_layout = r.read<ImageLayout>();
+			const ImageLayout new_layout = r.read<ImageLayout>();
+			const uint32_t base_mip_level = r.read<uint32_t>();
+			const uint32_t level_count = r.read<uint32_t>();
+
+			backend->command_transition_image(
+					cmd, image, current_layout, new_layout, base_mip_level, level_count);
+		} break;
+		case CaptureCall::COMMAND_RESET_QUERY_POOL: {
+			CommandBuffer cmd = CommandBuffer(read_handle());
+			QueryPool query_pool = QueryPool(read_handle());
+			const uint32_t first_query = r.read<uint32_t>();
+			const uint32_t query_count = r.read<uint32_t>();
+
+			backend->command_reset_query_pool(cmd, query_pool, first_query, query_count);
+		} break;
+		case CaptureCall::COMMAND_WRITE_TIMESTAMP: {
+			CommandBuffer cmd = CommandBuffer(read_handle());
+			QueryPool query_pool = QueryPool(read_handle());
+			const uint32_t query_index = r.read<uint32_t>();
+
+			backend->command_write_timestamp(cmd, query_pool, query_index);
+		} break;
+		case CaptureCall::COMMAND_BEGIN_QUERY: {
+			CommandBuffer cmd = CommandBuffer(read_handle());
+			QueryPool query_pool = QueryPool(read_handle());
+			const uint32_t query_index = r.read<uint32_t>();
+			const bool precise = r.read<bool>();
+
+			backend->command_begin_query(cmd, query_pool, query_index, precise);
+		} break;
+		case CaptureCall::COMMAND_END_QUERY: {
+			CommandBuffer cmd = CommandBuffer(read_handle());
+			QueryPool query_pool = QueryPool(read_handle());
+			const uint32_t query_index = r.read<uint32_t>();
+
+			backend->command_end_query(cmd, query_pool, query_index);
+		} break;
+		case CaptureCall::COMMAND_BEGIN_LABEL: {
+			CommandBuffer cmd = CommandBuffer(read_handle());
+			const std::string name = r.read_string();
+			const Color color = r.read<Color>();
+
+			backend->command_begin_label(cmd, name.c_str(), color);
+		} break;
+		case CaptureCall::COMMAND_END_LABEL: {
+			backend->command_end_label(CommandBuffer(read_handle()));
+		} break;
+		default:
+			return false;
+	}
+
+	return !r.failed;
+}
+
+} //namespace gl
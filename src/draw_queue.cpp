@@ -0,0 +1,220 @@
+#include "glgpu/draw_queue.h"
+
+#include "glgpu/assert.h"
+#include "glgpu/trace.h"
+
+namespace gl {
+
+// Below this count a comparison sort beats clearing and walking the histograms
+static constexpr size_t RADIX_SORT_MIN_COUNT = 256;
+
+static constexpr uint32_t RADIX_DIGIT_BITS = 8;
+static constexpr uint32_t RADIX_DIGIT_COUNT = 64 / RADIX_DIGIT_BITS;
+static constexpr uint32_t RADIX_BUCKET_COUNT = 1u << RADIX_DIGIT_BITS;
+
+DrawQueue::DrawQueue(std::shared_ptr<RenderBackend> p_backend, uint32_t p_initial_capacity) :
+		backend(p_backend) {
+	packets.reserve(p_initial_capacity);
+	entries.reserve(p_initial_capacity);
+	scratch.reserve(p_initial_capacity);
+}
+
+void DrawQueue::push(uint64_t p_key, const DrawPacket& p_packet, const void* p_push_constants,
+		uint32_t p_push_constants_size) {
+	const uint32_t index = static_cast<uint32_t>(packets.size());
+
+	DrawPacket& packet = packets.emplace_back(p_packet);
+	packet.push_constants_offset = 0;
+	packet.push_constants_size = 0;
+
+	if (p_push_constants && p_push_constants_size > 0) {
+		packet.push_constants_offset = static_cast<uint32_t>(push_constants.size());
+		packet.push_constants_size = p_push_constants_size;
+
+		const uint8_t* data = (const uint8_t*)p_push_constants;
+		push_constants.insert(push_constants.end(), data, data + p_push_constants_size);
+	}
+
+	// Packets pushed in key order do not need sorting at all
+	if (sorted && !entries.empty() && entries.back().key > p_key) {
+		sorted = false;
+	}
+
+	entries.push_back({ p_key, index });
+}
+
+void DrawQueue::sort() {
+	if (sorted) {
+		return;
+	}
+
+	GL_TRACE_SCOPE("DrawQueue::sort");
+
+	const size_t count = entries.size();
+
+	if (count < RADIX_SORT_MIN_COUNT) {
+		std::stable_sort(entries.begin(), entries.end(),
+				[](const SortEntry& p_lhs, const SortEntry& p_rhs) {
+					return p_lhs.key < p_rhs.key;
+				});
+
+		sorted = true;
+		return;
+	}
+
+	// Histograms of every digit are built in a single pass over the keys
+	uint32_t histograms[RADIX_DIGIT_COUNT][RADIX_BUCKET_COUNT] = {};
+	for (const SortEntry& entry : entries) {
+		for (uint32_t digit = 0; digit < RADIX_DIGIT_COUNT; digit++) {
+			histograms[digit][(entry.key >> (digit * RADIX_DIGIT_BITS)) & 0xff]++;
+		}
+	}
+
+	scratch.resize(count);
+
+	SortEntry* src = entries.data();
+	SortEntry* dst = scratch.data();
+
+	for (uint32_t digit = 0; digit < RADIX_DIGIT_COUNT; digit++) {
+		const uint32_t shift = digit * RADIX_DIGIT_BITS;
+		uint32_t* histogram = histograms[digit];
+
+		// Every key shares this digit, a pass would not move anything. Keys
+		// rarely use all of their fields so most passes end up skipped.
+		if (histogram[(src[0].key >> shift) & 0xff] == count) {
+			continue;
+		}
+
+		uint32_t offset = 0;
+		for (uint32_t bucket = 0; bucket < RADIX_BUCKET_COUNT; bucket++) {
+			const uint32_t bucket_count = histogram[bucket];
+			histogram[bucket] = offset;
+			offset += bucket_count;
+		}
+
+		for (size_t i = 0; i < count; i++) {
+			dst[histogram[(src[i].key >> shift) & 0xff]++] = src[i];
+		}
+
+		std::swap(src, dst);
+	}
+
+	if (src != entries.data()) {
+		entries.swap(scratch);
+	}
+
+	sorted = true;
+}
+
+void DrawQueue::execute(CommandBuffer p_cmd) {
+	GL_ASSERT(sorted, "DrawQueue has to be sorted before being executed");
+
+	_execute_range(p_cmd, 0, entries.size());
+}
+
+void DrawQueue::execute(CommandBuffer p_cmd, uint8_t p_pass) {
+	GL_ASSERT(sorted, "DrawQueue has to be sorted before being executed");
+
+	const uint64_t pass_begin = uint64_t(p_pass) << DRAW_SORT_KEY_PASS_SHIFT;
+
+	const auto begin = std::lower_bound(entries.begin(), entries.end(), pass_begin,
+			[](const SortEntry& p_entry, uint64_t p_key) { return p_entry.key < p_key; });
+	const auto end = std::find_if(begin, entries.end(),
+			[p_pass](const SortEntry& p_entry) {
+				return get_draw_sort_key_pass(p_entry.key) != p_pass;
+			});
+
+	_execute_range(p_cmd, begin - entries.begin(), end - entries.begin());
+}
+
+void DrawQueue::clear() {
+	packets.clear();
+	entries.clear();
+	push_constants.clear();
+
+	sorted = true;
+}
+
+size_t DrawQueue::size() const { return entries.size(); }
+
+bool DrawQueue::is_sorted() const { return sorted; }
+
+uint64_t DrawQueue::get_key(size_t p_index) const { return entries[p_index].key; }
+
+const DrawPacket& DrawQueue::get_packet(size_t p_index) const {
+	return packets[entries[p_index].index];
+}
+
+void DrawQueue::_execute_range(CommandBuffer p_cmd, size_t p_begin, size_t p_end) {
+	GL_TRACE_SCOPE("DrawQueue::execute");
+
+	// State is tracked here rather than left to the backend so redundant binds
+	// do not even pay for the virtual call and argument vectors.
+	Pipeline bound_pipeline = GL_NULL_HANDLE;
+	Shader bound_shader = GL_NULL_HANDLE;
+	UniformSet bound_uniform_set = GL_NULL_HANDLE;
+	uint32_t bound_uniform_set_index = UINT32_MAX;
+	Buffer bound_vertex_buffer = GL_NULL_HANDLE;
+	uint64_t bound_vertex_buffer_offset = 0;
+	Buffer bound_index_buffer = GL_NULL_HANDLE;
+	uint64_t bound_index_buffer_offset = 0;
+	IndexType bound_index_type = IndexType::UINT32;
+
+	for (size_t i = p_begin; i < p_end; i++) {
+		const DrawPacket& packet = packets[entries[i].index];
+
+		if (packet.pipeline != bound_pipeline) {
+			backend->command_bind_graphics_pipeline(p_cmd, packet.pipeline);
+			bound_pipeline = packet.pipeline;
+		}
+
+		if (packet.uniform_set &&
+				(packet.uniform_set != bound_uniform_set || packet.shader != bound_shader ||
+						packet.uniform_set_index != bound_uniform_set_index)) {
+			backend->command_bind_uniform_sets(p_cmd, packet.shader, packet.uniform_set_index,
+					{ packet.uniform_set }, PipelineType::GRAPHICS);
+
+			bound_shader = packet.shader;
+			bound_uniform_set = packet.uniform_set;
+			bound_uniform_set_index = packet.uniform_set_index;
+		}
+
+		if (packet.vertex_buffer &&
+				(packet.vertex_buffer != bound_vertex_buffer ||
+						packet.vertex_buffer_offset != bound_vertex_buffer_offset)) {
+			backend->command_bind_vertex_buffers(
+					p_cmd, 0, { packet.vertex_buffer }, { packet.vertex_buffer_offset });
+
+			bound_vertex_buffer = packet.vertex_buffer;
+			bound_vertex_buffer_offset = packet.vertex_buffer_offset;
+		}
+
+		if (packet.index_buffer &&
+				(packet.index_buffer != bound_index_buffer ||
+						packet.index_buffer_offset != bound_index_buffer_offset ||
+						packet.index_type != bound_index_type)) {
+			backend->command_bind_index_buffer(
+					p_cmd, packet.index_buffer, packet.index_buffer_offset, packet.index_type);
+
+			bound_index_buffer = packet.index_buffer;
+			bound_index_buffer_offset = packet.index_buffer_offset;
+			bound_index_type = packet.index_type;
+		}
+
+		// Push constants are always written at the start of the range
+		if (packet.push_constants_size > 0) {
+			backend->command_push_constants(p_cmd, packet.shader, 0, packet.push_constants_size,
+					&push_constants[packet.push_constants_offset]);
+		}
+
+		if (packet.index_buffer) {
+			backend->command_draw_indexed(p_cmd, packet.count, packet.instance_count, packet.first,
+					packet.vertex_offset, packet.first_instance);
+		} else {
+			backend->command_draw(p_cmd, packet.count, packet.instance_count, packet.first,
+					packet.first_instance);
+		}
+	}
+}
+
+} //namespace gl
@@ -0,0 +1,449 @@
+#include "glgpu/frame_capture.h"
+
+#include "glgpu/assert.h"
+#include "glgpu/log.h"
+#include "glgpu/simd.h"
+#include "glgpu/trace.h"
+
+namespace gl {
+
+// BT.709 limited range in 8 bit fixed point. The luma weights sum to 220 so
+// white lands on 235, the chroma weights sum to 0 so grey lands on 128.
+constexpr int32_t Y_R = 47, Y_G = 157, Y_B = 16;
+constexpr int32_t U_R = -26, U_G = -86, U_B = 112;
+constexpr int32_t V_R = 112, V_G = -102, V_B = -10;
+
+// ============================================================================
+// Scalar
+// ============================================================================
+
+static void _swap_red_blue_scalar(const uint8_t* p_in, uint8_t* o_out, size_t p_count) {
+	for (size_t i = 0; i < p_count; i++) {
+		const uint8_t r = p_in[i * 4 + 0];
+		const uint8_t b = p_in[i * 4 + 2];
+		o_out[i * 4 + 0] = b;
+		o_out[i * 4 + 1] = p_in[i * 4 + 1];
+		o_out[i * 4 + 2] = r;
+		o_out[i * 4 + 3] = p_in[i * 4 + 3];
+	}
+}
+
+static uint8_t _luma(int32_t p_r, int32_t p_g, int32_t p_b) {
+	return uint8_t(((Y_R * p_r + Y_G * p_g + Y_B * p_b + 128) >> 8) + 16);
+}
+
+static uint8_t _chroma(
+		int32_t p_r, int32_t p_g, int32_t p_b, int32_t p_wr, int32_t p_wg, int32_t p_wb) {
+	return uint8_t(((p_wr * p_r + p_wg * p_g + p_wb * p_b + 128) >> 8) + 128);
+}
+
+// Converts the pixels from `p_begin`, which is even, to the end of a pair of
+// rows. The last row of an odd height is passed as both rows.
+static void _yuv420_rows_scalar(const uint8_t* p_row0, const uint8_t* p_row1, uint32_t p_begin,
+		uint32_t p_width, bool p_bgra, uint8_t* o_y0, uint8_t* o_y1, uint8_t* o_u,
+		uint8_t* o_v) {
+	const uint32_t r_offset = p_bgra ? 2 : 0;
+	const uint32_t b_offset = p_bgra ? 0 : 2;
+
+	for (uint32_t x = p_begin; x < p_width; x += 2) {
+		// Odd widths repeat the last column
+		const uint32_t columns[2] = { x, std::min(x + 1, p_width - 1) };
+
+		int32_t r_sum = 0, g_sum = 0, b_sum = 0;
+		for (uint32_t column : columns) {
+			const uint8_t* pixel0 = p_row0 + column * 4;
+			const uint8_t* pixel1 = p_row1 + column * 4;
+
+			o_y0[column] = _luma(pixel0[r_offset], pixel0[1], pixel0[b_offset]);
+			o_y1[column] = _luma(pixel1[r_offset], pixel1[1], pixel1[b_offset]);
+
+			r_sum += pixel0[r_offset] + pixel1[r_offset];
+			g_sum += pixel0[1] + pixel1[1];
+			b_sum += pixel0[b_offset] + pixel1[b_offset];
+		}
+
+		const int32_t r = (r_sum + 2) >> 2;
+		const int32_t g = (g_sum + 2) >> 2;
+		const int32_t b = (b_sum + 2) >> 2;
+		o_u[x / 2] = _chroma(r, g, b, U_R, U_G, U_B);
+		o_v[x / 2] = _chroma(r, g, b, V_R, V_G, V_B);
+	}
+}
+
+// ============================================================================
+// Baseline, SSE2 or NEON
+// ============================================================================
+
+#if defined(GL_SIMD_SSE)
+
+// Splits 8 pixels into 16 bit red, green and blue lanes
+static void _unpack_rgb16_sse(
+		const uint8_t* p_in, bool p_bgra, __m128i& o_r, __m128i& o_g, __m128i& o_b) {
+	const __m128i mask = _mm_set1_epi32(0xff);
+	const __m128i lo = _mm_loadu_si128((const __m128i*)p_in);
+	const __m128i hi = _mm_loadu_si128((const __m128i*)(p_in + 16));
+
+	const __m128i c0 = _mm_packs_epi32(_mm_and_si128(lo, mask), _mm_and_si128(hi, mask));
+	o_g = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(lo, 8), mask),
+			_mm_and_si128(_mm_srli_epi32(hi, 8), mask));
+	const __m128i c2 = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(lo, 16), mask),
+			_mm_and_si128(_mm_srli_epi32(hi, 16), mask));
+
+	o_r = p_bgra ? c2 : c0;
+	o_b = p_bgra ? c0 : c2;
+}
+
+// At most 220 * 255 + 128 before the shift, fits unsigned 16 bit lanes
+static __m128i _luma_sse(__m128i p_r, __m128i p_g, __m128i p_b) {
+	__m128i y = _mm_mullo_epi16(p_r, _mm_set1_epi16(Y_R));
+	y = _mm_add_epi16(y, _mm_mullo_epi16(p_g, _mm_set1_epi16(Y_G)));
+	y = _mm_add_epi16(y, _mm_mullo_epi16(p_b, _mm_set1_epi16(Y_B)));
+	y = _mm_srli_epi16(_mm_add_epi16(y, _mm_set1_epi16(128)), 8);
+	return _mm_add_epi16(y, _mm_set1_epi16(16));
+}
+
+// Within +-112 * 255 + 128 before the shift, fits signed 16 bit lanes
+static __m128i _chroma_sse(
+		__m128i p_r, __m128i p_g, __m128i p_b, int16_t p_wr, int16_t p_wg, int16_t p_wb) {
+	__m128i c = _mm_mullo_epi16(p_r, _mm_set1_epi16(p_wr));
+	c = _mm_add_epi16(c, _mm_mullo_epi16(p_g, _mm_set1_epi16(p_wg)));
+	c = _mm_add_epi16(c, _mm_mullo_epi16(p_b, _mm_set1_epi16(p_wb)));
+	c = _mm_srai_epi16(_mm_add_epi16(c, _mm_set1_epi16(128)), 8);
+	return _mm_add_epi16(c, _mm_set1_epi16(128));
+}
+
+// Rounded averages of the 2x2 blocks of 16 columns, 8 lanes out
+static __m128i _average_2x2_sse(
+		__m128i p_row0_lo, __m128i p_row0_hi, __m128i p_row1_lo, __m128i p_row1_hi) {
+	const __m128i ones = _mm_set1_epi16(1);
+	const __m128i lo = _mm_madd_epi16(_mm_add_epi16(p_row0_lo, p_row1_lo), ones);
+	const __m128i hi = _mm_madd_epi16(_mm_add_epi16(p_row0_hi, p_row1_hi), ones);
+	return _mm_srli_epi16(_mm_add_epi16(_mm_packs_epi32(lo, hi), _mm_set1_epi16(2)), 2);
+}
+
+#endif
+
+static void _swap_red_blue_baseline(const uint8_t* p_in, uint8_t* o_out, size_t p_count) {
+	size_t i = 0;
+
+#if defined(GL_SIMD_SSE)
+	const __m128i green_alpha = _mm_set1_epi32(int32_t(0xff00ff00));
+	const __m128i low = _mm_set1_epi32(0xff);
+
+	for (; i + 4 <= p_count; i += 4) {
+		const __m128i p = _mm_loadu_si128((const __m128i*)(p_in + i * 4));
+		__m128i swapped = _mm_and_si128(p, green_alpha);
+		swapped = _mm_or_si128(swapped, _mm_and_si128(_mm_srli_epi32(p, 16), low));
+		swapped = _mm_or_si128(swapped, _mm_slli_epi32(_mm_and_si128(p, low), 16));
+		_mm_storeu_si128((__m128i*)(o_out + i * 4), swapped);
+	}
+#elif defined(GL_SIMD_NEON)
+	for (; i + 16 <= p_count; i += 16) {
+		uint8x16x4_t p = vld4q_u8(p_in + i * 4);
+		const uint8x16_t r = p.val[0];
+		p.val[0] = p.val[2];
+		p.val[2] = r;
+		vst4q_u8(o_out + i * 4, p);
+	}
+#endif
+
+	_swap_red_blue_scalar(p_in + i * 4, o_out + i * 4, p_count - i);
+}
+
+static void _yuv420_rows_baseline(const uint8_t* p_row0, const uint8_t* p_row1,
+		uint32_t p_width, bool p_bgra, uint8_t* o_y0, uint8_t* o_y1, uint8_t* o_u,
+		uint8_t* o_v) {
+	uint32_t x = 0;
+
+#if defined(GL_SIMD_SSE)
+	for (; x + 16 <= p_width; x += 16) {
+		__m128i r[4], g[4], b[4];
+		_unpack_rgb16_sse(p_row0 + x * 4, p_bgra, r[0], g[0], b[0]);
+		_unpack_rgb16_sse(p_row0 + x * 4 + 32, p_bgra, r[1], g[1], b[1]);
+		_unpack_rgb16_sse(p_row1 + x * 4, p_bgra, r[2], g[2], b[2]);
+		_unpack_rgb16_sse(p_row1 + x * 4 + 32, p_bgra, r[3], g[3], b[3]);
+
+		_mm_storeu_si128((__m128i*)(o_y0 + x),
+				_mm_packus_epi16(_luma_sse(r[0], g[0], b[0]), _luma_sse(r[1], g[1], b[1])));
+		_mm_storeu_si128((__m128i*)(o_y1 + x),
+				_mm_packus_epi16(_luma_sse(r[2], g[2], b[2]), _luma_sse(r[3], g[3], b[3])));
+
+		const __m128i r_avg = _average_2x2_sse(r[0], r[1], r[2], r[3]);
+		const __m128i g_avg = _average_2x2_sse(g[0], g[1], g[2], g[3]);
+		const __m128i b_avg = _average_2x2_sse(b[0], b[1], b[2], b[3]);
+
+		const __m128i u = _chroma_sse(r_avg, g_avg, b_avg, U_R, U_G, U_B);
+		const __m128i v = _chroma_sse(r_avg, g_avg, b_avg, V_R, V_G, V_B);
+		_mm_storel_epi64((__m128i*)(o_u + x / 2), _mm_packus_epi16(u, u));
+		_mm_storel_epi64((__m128i*)(o_v + x / 2), _mm_packus_epi16(v, v));
+	}
+#elif defined(GL_SIMD_NEON)
+	const uint32_t r_index = p_bgra ? 2 : 0;
+	const uint32_t b_index = p_bgra ? 0 : 2;
+
+	for (; x + 16 <= p_width; x += 16) {
+		const uint8x16x4_t p0 = vld4q_u8(p_row0 + x * 4);
+		const uint8x16x4_t p1 = vld4q_u8(p_row1 + x * 4);
+
+		const uint8x16x4_t* rows[2] = { &p0, &p1 };
+		uint8_t* y_rows[2] = { o_y0, o_y1 };
+		for (uint32_t row = 0; row < 2; row++) {
+			const uint8x16_t r = rows[row]->val[r_index];
+			const uint8x16_t g = rows[row]->val[1];
+			const uint8x16_t b = rows[row]->val[b_index];
+
+			uint16x8_t lo = vmull_u8(vget_low_u8(r), vdup_n_u8(Y_R));
+			lo = vmlal_u8(lo, vget_low_u8(g), vdup_n_u8(Y_G));
+			lo = vmlal_u8(lo, vget_low_u8(b), vdup_n_u8(Y_B));
+			uint16x8_t hi = vmull_u8(vget_high_u8(r), vdup_n_u8(Y_R));
+			hi = vmlal_u8(hi, vget_high_u8(g), vdup_n_u8(Y_G));
+			hi = vmlal_u8(hi, vget_high_u8(b), vdup_n_u8(Y_B));
+
+			const uint8x16_t y = vcombine_u8(vrshrn_n_u16(lo, 8), vrshrn_n_u16(hi, 8));
+			vst1q_u8(y_rows[row] + x, vaddq_u8(y, vdupq_n_u8(16)));
+		}
+
+		const int16x8_t r = vreinterpretq_s16_u16(vrshrq_n_u16(
+				vaddq_u16(vpaddlq_u8(p0.val[r_index]), vpaddlq_u8(p1.val[r_index])), 2));
+		const int16x8_t g = vreinterpretq_s16_u16(
+				vrshrq_n_u16(vaddq_u16(vpaddlq_u8(p0.val[1]), vpaddlq_u8(p1.val[1])), 2));
+		const int16x8_t b = vreinterpretq_s16_u16(vrshrq_n_u16(
+				vaddq_u16(vpaddlq_u8(p0.val[b_index]), vpaddlq_u8(p1.val[b_index])), 2));
+
+		int16x8_t u = vmulq_n_s16(r, U_R);
+		u = vmlaq_n_s16(u, g, U_G);
+		u = vmlaq_n_s16(u, b, U_B);
+		int16x8_t v = vmulq_n_s16(r, V_R);
+		v = vmlaq_n_s16(v, g, V_G);
+		v = vmlaq_n_s16(v, b, V_B);
+
+		const int16x8_t bias = vdupq_n_s16(128);
+		vst1_u8(o_u + x / 2, vqmovun_s16(vaddq_s16(vrshrq_n_s16(u, 8), bias)));
+		vst1_u8(o_v + x / 2, vqmovun_s16(vaddq_s16(vrshrq_n_s16(v, 8), bias)));
+	}
+#endif
+
+	_yuv420_rows_scalar(p_row0, p_row1, x, p_width, p_bgra, o_y0, o_y1, o_u, o_v);
+}
+
+// ============================================================================
+// Dispatch
+// ============================================================================
+
+void convert_swap_red_blue(const uint8_t* p_in, uint8_t* o_out, size_t p_count) {
+	if (simd_get_level() == SimdLevel::SCALAR) {
+		_swap_red_blue_scalar(p_in, o_out, p_count);
+	} else {
+		_swap_red_blue_baseline(p_in, o_out, p_count);
+	}
+}
+
+void convert_rgba8_to_yuv420(
+		const uint8_t* p_in, Vec2u p_size, bool p_bgra, uint8_t* o_y, uint8_t* o_u, uint8_t* o_v) {
+	const bool scalar = simd_get_level() == SimdLevel::SCALAR;
+	const uint32_t chroma_width = (p_size.x + 1) / 2;
+
+	for (uint32_t row = 0; row < p_size.y; row += 2) {
+		const uint32_t next_row = std::min(row + 1, p_size.y - 1);
+
+		const uint8_t* row0 = p_in + size_t(row) * p_size.x * 4;
+		const uint8_t* row1 = p_in + size_t(next_row) * p_size.x * 4;
+		uint8_t* y0 = o_y + size_t(row) * p_size.x;
+		uint8_t* y1 = o_y + size_t(next_row) * p_size.x;
+		uint8_t* u = o_u + size_t(row / 2) * chroma_width;
+		uint8_t* v = o_v + size_t(row / 2) * chroma_width;
+
+		if (scalar) {
+			_yuv420_rows_scalar(row0, row1, 0, p_size.x, p_bgra, y0, y1, u, v);
+		} else {
+			_yuv420_rows_baseline(row0, row1, p_size.x, p_bgra, y0, y1, u, v);
+		}
+	}
+}
+
+// ============================================================================
+// FrameCapture
+// ============================================================================
+
+FrameCapture::FrameCapture(std::shared_ptr<RenderBackend> p_backend,
+		FrameCaptureFormat p_format, FrameCaptureCallback p_callback,
+		uint32_t p_frames_in_flight) :
+		backend(p_backend),
+		format(p_format),
+		callback(std::move(p_callback)),
+		frames_in_flight(p_frames_in_flight) {
+	GL_ASSERT(p_frames_in_flight > 0, "FrameCapture needs at least one frame in flight");
+
+	// The spare slot is the one the worker reads while the others are in flight
+	slots.resize(p_frames_in_flight + 1);
+
+	worker = std::thread(&FrameCapture::_worker_loop, this);
+}
+
+FrameCapture::~FrameCapture() {
+	// Captures not handed to the worker yet are dropped, like before `flush`
+	{
+		std::scoped_lock lock(worker_mutex);
+		stop_requested = true;
+	}
+	worker_cv.notify_all();
+	worker.join();
+
+	for (Slot& slot : slots) {
+		if (slot.readback) {
+			backend->buffer_unmap(slot.readback);
+			backend->buffer_free(slot.readback);
+		}
+	}
+}
+
+void FrameCapture::capture(CommandBuffer p_cmd, Image p_image, ImageLayout p_layout) {
+	GL_TRACE_SCOPE("frame_capture");
+
+	{
+		std::unique_lock lock(worker_mutex);
+
+		// The copy of `frames_in_flight` captures ago is expected to have
+		// finished by now
+		if (frame_counter >= frames_in_flight) {
+			ready_count = std::max(ready_count, frame_counter - frames_in_flight + 1);
+			worker_cv.notify_all();
+		}
+
+		// The slot last held the capture before that one, the worker usually
+		// finished it during the previous frame
+		if (frame_counter >= slots.size() && resolved_count <= frame_counter - slots.size()) {
+			GL_TRACE_SCOPE("frame_capture_wait");
+			worker_cv.wait(lock, [this] { return resolved_count > frame_counter - slots.size(); });
+		}
+	}
+
+	Slot& slot = slots[frame_counter % slots.size()];
+
+	bool bgra;
+	switch (backend->image_get_format(p_image)) {
+		case DataFormat::R8G8B8A8_UNORM:
+		case DataFormat::R8G8B8A8_SRGB:
+			bgra = false;
+			break;
+		case DataFormat::B8G8R8A8_UNORM:
+		case DataFormat::B8G8R8A8_SRGB:
+			bgra = true;
+			break;
+		default:
+			GL_LOG_ERROR("[FRAME_CAPTURE] Only 8 bit RGBA and BGRA images can be captured.");
+			return;
+	}
+
+	const Vec3u size = backend->image_get_size(p_image);
+	const uint64_t required_size = uint64_t(size.x) * size.y * 4;
+
+	// Grows with the swapchain, the worker is done with the old buffer
+	if (required_size > slot.capacity) {
+		if (slot.readback) {
+			backend->buffer_unmap(slot.readback);
+			backend->buffer_free(slot.readback);
+		}
+
+		slot.readback = backend->buffer_create(
+				required_size, BUFFER_USAGE_TRANSFER_DST_BIT, MemoryAllocationType::CPU);
+		slot.data = backend->buffer_map(slot.readback);
+		slot.capacity = required_size;
+	}
+
+	if (p_layout != ImageLayout::TRANSFER_SRC_OPTIMAL) {
+		backend->command_transition_image(
+				p_cmd, p_image, p_layout, ImageLayout::TRANSFER_SRC_OPTIMAL);
+	}
+
+	BufferImageCopyRegion region = {};
+	region.image_subresource.aspect_mask = IMAGE_ASPECT_COLOR_BIT;
+	region.image_subresource.layer_count = 1;
+	region.image_extent = { size.x, size.y, 1 };
+	backend->command_copy_image_to_buffer(p_cmd, p_image, slot.readback, { region });
+
+	if (p_layout != ImageLayout::TRANSFER_SRC_OPTIMAL) {
+		backend->command_transition_image(
+				p_cmd, p_image, ImageLayout::TRANSFER_SRC_OPTIMAL, p_layout);
+	}
+
+	slot.size = { size.x, size.y };
+	slot.bgra = bgra;
+	frame_counter++;
+}
+
+void FrameCapture::flush() {
+	std::unique_lock lock(worker_mutex);
+	ready_count = frame_counter;
+	worker_cv.notify_all();
+	worker_cv.wait(lock, [this] { return resolved_count == frame_counter; });
+}
+
+void FrameCapture::_worker_loop() {
+	while (true) {
+		uint64_t frame_index;
+		{
+			std::unique_lock lock(worker_mutex);
+			worker_cv.wait(lock, [this] { return resolved_count < ready_count || stop_requested; });
+
+			if (stop_requested) {
+				break;
+			}
+
+			frame_index = resolved_count;
+		}
+
+		// `capture` leaves the slot alone until `resolved_count` moves past it
+		_resolve_slot(slots[frame_index % slots.size()], frame_index);
+
+		{
+			std::scoped_lock lock(worker_mutex);
+			resolved_count++;
+		}
+		worker_cv.notify_all();
+	}
+}
+
+void FrameCapture::_resolve_slot(const Slot& p_slot, uint64_t p_frame_index) {
+	GL_TRACE_SCOPE("frame_capture_resolve");
+
+	CapturedFrame frame;
+	frame.frame_index = p_frame_index;
+	frame.size = p_slot.size;
+	frame.format = format;
+
+	const size_t pixel_count = size_t(p_slot.size.x) * p_slot.size.y;
+
+	switch (format) {
+		case FrameCaptureFormat::RGBA8: {
+			if (p_slot.bgra) {
+				converted.resize(pixel_count * 4);
+				convert_swap_red_blue(p_slot.data, converted.data(), pixel_count);
+				frame.planes[0] = converted.data();
+			} else {
+				// Already in order, handed out straight from the readback buffer
+				frame.planes[0] = p_slot.data;
+			}
+			frame.strides[0] = p_slot.size.x * 4;
+		} break;
+		case FrameCaptureFormat::YUV420: {
+			const uint32_t chroma_width = (p_slot.size.x + 1) / 2;
+			const size_t chroma_count = size_t(chroma_width) * ((p_slot.size.y + 1) / 2);
+			converted.resize(pixel_count + chroma_count * 2);
+
+			uint8_t* y = converted.data();
+			uint8_t* u = y + pixel_count;
+			uint8_t* v = u + chroma_count;
+			convert_rgba8_to_yuv420(p_slot.data, p_slot.size, p_slot.bgra, y, u, v);
+
+			frame.planes = { y, u, v };
+			frame.strides = { p_slot.size.x, chroma_width, chroma_width };
+		} break;
+	}
+
+	if (callback) {
+		callback(frame);
+	}
+}
+
+} //namespace gl
@@ -0,0 +1,436 @@
+#include "glgpu/instance_batch.h"
+
+#include "glgpu/assert.h"
+
+namespace gl {
+
+Frustum Frustum::from_matrix(const Mat4& p_view_proj) {
+	const auto row = [&](int p_row) -> Vec4f {
+		return { p_view_proj[0][p_row], p_view_proj[1][p_row], p_view_proj[2][p_row],
+			p_view_proj[3][p_row] };
+	};
+
+	const Vec4f x = row(0);
+	const Vec4f y = row(1);
+	const Vec4f z = row(2);
+	const Vec4f w = row(3);
+
+	Frustum frustum;
+	frustum.planes = { w + x, w - x, w + y, w - y, w + z, w - z };
+
+	for (Vec4f& plane : frustum.planes) {
+		const float length =
+				std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+		if (length > 0.0f) {
+			plane = { plane.x / length, plane.y / length, plane.z / length, plane.w / length };
+		}
+	}
+
+	return frustum;
+}
+
+// ============================================================================
+// Scalar
+// ============================================================================
+
+static void _compose_scalar(const InstanceTransformSoA& p_transforms, size_t p_index,
+		Mat4& o_mat) {
+	const float qx = p_transforms.rotation_x[p_index];
+	const float qy = p_transforms.rotation_y[p_index];
+	const float qz = p_transforms.rotation_z[p_index];
+	const float qw = p_transforms.rotation_w[p_index];
+
+	const float sx = p_transforms.scale_x ? p_transforms.scale_x[p_index] : 1.0f;
+	const float sy = p_transforms.scale_x ? p_transforms.scale_y[p_index] : 1.0f;
+	const float sz = p_transforms.scale_x ? p_transforms.scale_z[p_index] : 1.0f;
+
+	const float xx = qx * qx;
+	const float yy = qy * qy;
+	const float zz = qz * qz;
+	const float xy = qx * qy;
+	const float xz = qx * qz;
+	const float yz = qy * qz;
+	const float wx = qw * qx;
+	const float wy = qw * qy;
+	const float wz = qw * qz;
+
+	o_mat[0] = { (1.0f - 2.0f * (yy + zz)) * sx, 2.0f * (xy + wz) * sx, 2.0f * (xz - wy) * sx,
+		0.0f };
+	o_mat[1] = { 2.0f * (xy - wz) * sy, (1.0f - 2.0f * (xx + zz)) * sy, 2.0f * (yz + wx) * sy,
+		0.0f };
+	o_mat[2] = { 2.0f * (xz + wy) * sz, 2.0f * (yz - wx) * sz, (1.0f - 2.0f * (xx + yy)) * sz,
+		0.0f };
+	o_mat[3] = { p_transforms.position_x[p_index], p_transforms.position_y[p_index],
+		p_transforms.position_z[p_index], 1.0f };
+}
+
+static bool _is_visible_scalar(const InstanceWriteInfo& p_info, size_t p_index) {
+	if (!p_info.frustum) {
+		return true;
+	}
+
+	const InstanceTransformSoA& t = p_info.transforms;
+
+	float radius = p_info.bounding_radius;
+	if (t.scale_x) {
+		radius *= std::max({ std::abs(t.scale_x[p_index]), std::abs(t.scale_y[p_index]),
+				std::abs(t.scale_z[p_index]) });
+	}
+
+	const float x = t.position_x[p_index];
+	const float y = t.position_y[p_index];
+	const float z = t.position_z[p_index];
+
+	for (const Vec4f& plane : p_info.frustum->planes) {
+		if (plane.x * x + plane.y * y + plane.z * z + plane.w < -radius) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Writes instances `p_begin` to the end, also used for the tails of the
+// vectorized kernels. Returns the updated number of written matrices.
+static size_t _instance_write_scalar(
+		const InstanceWriteInfo& p_info, Mat4* o_out, size_t p_begin, size_t p_written) {
+	for (size_t i = p_begin; i < p_info.count; i++) {
+		const bool visible = _is_visible_scalar(p_info, i);
+		if (p_info.o_visibility) {
+			p_info.o_visibility[i] = visible;
+		}
+
+		if (p_info.compact && !visible) {
+			continue;
+		}
+
+		_compose_scalar(p_info.transforms, i, o_out[p_info.compact ? p_written : i]);
+		p_written++;
+	}
+
+	return p_written;
+}
+
+// ============================================================================
+// Baseline, four instances per SSE2 register
+// ============================================================================
+
+static size_t _instance_write_baseline(const InstanceWriteInfo& p_info, Mat4* o_out) {
+	size_t i = 0;
+	size_t written = 0;
+
+#if defined(GL_SIMD_SSE)
+	const InstanceTransformSoA& t = p_info.transforms;
+	const bool stream = (uintptr_t(o_out) & 15) == 0;
+
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+	const __m128 neg_bounding_radius = _mm_set1_ps(-p_info.bounding_radius);
+
+	__m128 planes[6][4];
+	if (p_info.frustum) {
+		for (int p = 0; p < 6; p++) {
+			const Vec4f& plane = p_info.frustum->planes[p];
+			planes[p][0] = _mm_set1_ps(plane.x);
+			planes[p][1] = _mm_set1_ps(plane.y);
+			planes[p][2] = _mm_set1_ps(plane.z);
+			planes[p][3] = _mm_set1_ps(plane.w);
+		}
+	}
+
+	for (; i + 4 <= p_info.count; i += 4) {
+		const __m128 px = _mm_loadu_ps(t.position_x + i);
+		const __m128 py = _mm_loadu_ps(t.position_y + i);
+		const __m128 pz = _mm_loadu_ps(t.position_z + i);
+
+		const __m128 qx = _mm_loadu_ps(t.rotation_x + i);
+		const __m128 qy = _mm_loadu_ps(t.rotation_y + i);
+		const __m128 qz = _mm_loadu_ps(t.rotation_z + i);
+		const __m128 qw = _mm_loadu_ps(t.rotation_w + i);
+
+		const __m128 sx = t.scale_x ? _mm_loadu_ps(t.scale_x + i) : one;
+		const __m128 sy = t.scale_x ? _mm_loadu_ps(t.scale_y + i) : one;
+		const __m128 sz = t.scale_x ? _mm_loadu_ps(t.scale_z + i) : one;
+
+		int visible_bits = 0xf;
+		if (p_info.frustum) {
+			__m128 neg_radius = neg_bounding_radius;
+			if (t.scale_x) {
+				const __m128 max_scale = _mm_max_ps(_mm_and_ps(sx, abs_mask),
+						_mm_max_ps(_mm_and_ps(sy, abs_mask), _mm_and_ps(sz, abs_mask)));
+				neg_radius = _mm_mul_ps(neg_radius, max_scale);
+			}
+
+			__m128 inside = _mm_cmpeq_ps(zero, zero);
+			for (int p = 0; p < 6; p++) {
+				__m128 d = _mm_add_ps(_mm_mul_ps(planes[p][0], px), planes[p][3]);
+				d = _mm_add_ps(d, _mm_mul_ps(planes[p][1], py));
+				d = _mm_add_ps(d, _mm_mul_ps(planes[p][2], pz));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(d, neg_radius));
+			}
+			visible_bits = _mm_movemask_ps(inside);
+		}
+
+		if (p_info.o_visibility) {
+			for (int k = 0; k < 4; k++) {
+				p_info.o_visibility[i + k] = (visible_bits >> k) & 1;
+			}
+		}
+
+		if (p_info.compact && visible_bits == 0) {
+			continue;
+		}
+
+		// Doubled components save the multiplication by two of every term
+		const __m128 qx2 = _mm_add_ps(qx, qx);
+		const __m128 qy2 = _mm_add_ps(qy, qy);
+		const __m128 qz2 = _mm_add_ps(qz, qz);
+
+		const __m128 xx = _mm_mul_ps(qx, qx2);
+		const __m128 yy = _mm_mul_ps(qy, qy2);
+		const __m128 zz = _mm_mul_ps(qz, qz2);
+		const __m128 xy = _mm_mul_ps(qx, qy2);
+		const __m128 xz = _mm_mul_ps(qx, qz2);
+		const __m128 yz = _mm_mul_ps(qy, qz2);
+		const __m128 wx = _mm_mul_ps(qw, qx2);
+		const __m128 wy = _mm_mul_ps(qw, qy2);
+		const __m128 wz = _mm_mul_ps(qw, qz2);
+
+		// Column `c`, row `r` of all four instances
+		__m128 cols[4][4] = {
+			{
+					_mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), sx),
+					_mm_mul_ps(_mm_add_ps(xy, wz), sx),
+					_mm_mul_ps(_mm_sub_ps(xz, wy), sx),
+					zero,
+			},
+			{
+					_mm_mul_ps(_mm_sub_ps(xy, wz), sy),
+					_mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), sy),
+					_mm_mul_ps(_mm_add_ps(yz, wx), sy),
+					zero,
+			},
+			{
+					_mm_mul_ps(_mm_add_ps(xz, wy), sz),
+					_mm_mul_ps(_mm_sub_ps(yz, wx), sz),
+					_mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), sz),
+					zero,
+			},
+			{ px, py, pz, one },
+		};
+
+		// Afterwards `cols[c][k]` is column `c` of instance `k`
+		for (int c = 0; c < 4; c++) {
+			_MM_TRANSPOSE4_PS(cols[c][0], cols[c][1], cols[c][2], cols[c][3]);
+		}
+
+		for (int k = 0; k < 4; k++) {
+			if (p_info.compact && !((visible_bits >> k) & 1)) {
+				continue;
+			}
+
+			Mat4& dst = o_out[p_info.compact ? written : i + k];
+			for (int c = 0; c < 4; c++) {
+				if (stream) {
+					_mm_stream_ps(dst[c].data(), cols[c][k]);
+				} else {
+					_mm_storeu_ps(dst[c].data(), cols[c][k]);
+				}
+			}
+			written++;
+		}
+	}
+
+	if (stream) {
+		// Non-temporal stores are weakly ordered, make them visible before the
+		// caller submits work reading the buffer
+		_mm_sfence();
+	}
+#endif
+
+	return _instance_write_scalar(p_info, o_out, i, written);
+}
+
+// ============================================================================
+// AVX2, eight instances per register
+// ============================================================================
+
+#if defined(GL_SIMD_SSE)
+
+GL_SIMD_TARGET_AVX2 static size_t _instance_write_avx2(
+		const InstanceWriteInfo& p_info, Mat4* o_out) {
+	const InstanceTransformSoA& t = p_info.transforms;
+	const bool stream = (uintptr_t(o_out) & 31) == 0;
+
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+	const __m256 neg_bounding_radius = _mm256_set1_ps(-p_info.bounding_radius);
+
+	__m256 planes[6][4];
+	if (p_info.frustum) {
+		for (int p = 0; p < 6; p++) {
+			const Vec4f& plane = p_info.frustum->planes[p];
+			planes[p][0] = _mm256_set1_ps(plane.x);
+			planes[p][1] = _mm256_set1_ps(plane.y);
+			planes[p][2] = _mm256_set1_ps(plane.z);
+			planes[p][3] = _mm256_set1_ps(plane.w);
+		}
+	}
+
+	size_t i = 0;
+	size_t written = 0;
+
+	for (; i + 8 <= p_info.count; i += 8) {
+		const __m256 px = _mm256_loadu_ps(t.position_x + i);
+		const __m256 py = _mm256_loadu_ps(t.position_y + i);
+		const __m256 pz = _mm256_loadu_ps(t.position_z + i);
+
+		const __m256 qx = _mm256_loadu_ps(t.rotation_x + i);
+		const __m256 qy = _mm256_loadu_ps(t.rotation_y + i);
+		const __m256 qz = _mm256_loadu_ps(t.rotation_z + i);
+		const __m256 qw = _mm256_loadu_ps(t.rotation_w + i);
+
+		const __m256 sx = t.scale_x ? _mm256_loadu_ps(t.scale_x + i) : one;
+		const __m256 sy = t.scale_x ? _mm256_loadu_ps(t.scale_y + i) : one;
+		const __m256 sz = t.scale_x ? _mm256_loadu_ps(t.scale_z + i) : one;
+
+		int visible_bits = 0xff;
+		if (p_info.frustum) {
+			__m256 neg_radius = neg_bounding_radius;
+			if (t.scale_x) {
+				const __m256 max_scale = _mm256_max_ps(_mm256_and_ps(sx, abs_mask),
+						_mm256_max_ps(_mm256_and_ps(sy, abs_mask), _mm256_and_ps(sz, abs_mask)));
+				neg_radius = _mm256_mul_ps(neg_radius, max_scale);
+			}
+
+			__m256 inside = _mm256_cmp_ps(zero, zero, _CMP_EQ_OQ);
+			for (int p = 0; p < 6; p++) {
+				__m256 d = _mm256_fmadd_ps(planes[p][0], px, planes[p][3]);
+				d = _mm256_fmadd_ps(planes[p][1], py, d);
+				d = _mm256_fmadd_ps(planes[p][2], pz, d);
+				inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, neg_radius, _CMP_GE_OQ));
+			}
+			visible_bits = _mm256_movemask_ps(inside);
+		}
+
+		if (p_info.o_visibility) {
+			for (int k = 0; k < 8; k++) {
+				p_info.o_visibility[i + k] = (visible_bits >> k) & 1;
+			}
+		}
+
+		if (p_info.compact && visible_bits == 0) {
+			continue;
+		}
+
+		const __m256 qx2 = _mm256_add_ps(qx, qx);
+		const __m256 qy2 = _mm256_add_ps(qy, qy);
+		const __m256 qz2 = _mm256_add_ps(qz, qz);
+
+		const __m256 xx = _mm256_mul_ps(qx, qx2);
+		const __m256 yy = _mm256_mul_ps(qy, qy2);
+		const __m256 zz = _mm256_mul_ps(qz, qz2);
+		const __m256 xy = _mm256_mul_ps(qx, qy2);
+		const __m256 xz = _mm256_mul_ps(qx, qz2);
+		const __m256 yz = _mm256_mul_ps(qy, qz2);
+		const __m256 wx = _mm256_mul_ps(qw, qx2);
+		const __m256 wy = _mm256_mul_ps(qw, qy2);
+		const __m256 wz = _mm256_mul_ps(qw, qz2);
+
+		const __m256 cols[4][4] = {
+			{
+					_mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(yy, zz)), sx),
+					_mm256_mul_ps(_mm256_add_ps(xy, wz), sx),
+					_mm256_mul_ps(_mm256_sub_ps(xz, wy), sx),
+					zero,
+			},
+			{
+					_mm256_mul_ps(_mm256_sub_ps(xy, wz), sy),
+					_mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, zz)), sy),
+					_mm256_mul_ps(_mm256_add_ps(yz, wx), sy),
+					zero,
+			},
+			{
+					_mm256_mul_ps(_mm256_add_ps(xz, wy), sz),
+					_mm256_mul_ps(_mm256_sub_ps(yz, wx), sz),
+					_mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, yy)), sz),
+					zero,
+			},
+			{ px, py, pz, one },
+		};
+
+		// Transposes every column per 128 bit lane, `columns[c][k]` then holds
+		// column `c` of instance `k` in the low and of instance `k + 4` in the
+		// high lane
+		__m256 columns[4][4];
+		for (int c = 0; c < 4; c++) {
+			const __m256 t0 = _mm256_unpacklo_ps(cols[c][0], cols[c][1]);
+			const __m256 t1 = _mm256_unpackhi_ps(cols[c][0], cols[c][1]);
+			const __m256 t2 = _mm256_unpacklo_ps(cols[c][2], cols[c][3]);
+			const __m256 t3 = _mm256_unpackhi_ps(cols[c][2], cols[c][3]);
+
+			columns[c][0] = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+			columns[c][1] = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+			columns[c][2] = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+			columns[c][3] = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+		}
+
+		for (int k = 0; k < 8; k++) {
+			if (p_info.compact && !((visible_bits >> k) & 1)) {
+				continue;
+			}
+
+			// 0x20 joins the low, 0x31 the high lanes of both sources
+			const int n = k & 3;
+			const __m256 c01 = k < 4
+					? _mm256_permute2f128_ps(columns[0][n], columns[1][n], 0x20)
+					: _mm256_permute2f128_ps(columns[0][n], columns[1][n], 0x31);
+			const __m256 c23 = k < 4
+					? _mm256_permute2f128_ps(columns[2][n], columns[3][n], 0x20)
+					: _mm256_permute2f128_ps(columns[2][n], columns[3][n], 0x31);
+
+			Mat4& dst = o_out[p_info.compact ? written : i + k];
+			if (stream) {
+				_mm256_stream_ps(dst[0].data(), c01);
+				_mm256_stream_ps(dst[2].data(), c23);
+			} else {
+				_mm256_storeu_ps(dst[0].data(), c01);
+				_mm256_storeu_ps(dst[2].data(), c23);
+			}
+			written++;
+		}
+	}
+
+	if (stream) {
+		_mm_sfence();
+	}
+
+	return _instance_write_scalar(p_info, o_out, i, written);
+}
+
+#endif
+
+// ============================================================================
+// Dispatch
+// ============================================================================
+
+size_t instance_write_transforms(const InstanceWriteInfo& p_info, Mat4* o_out) {
+	GL_ASSERT(p_info.transforms.position_x && p_info.transforms.rotation_x);
+	GL_ASSERT(!p_info.transforms.scale_x ||
+			(p_info.transforms.scale_y && p_info.transforms.scale_z));
+
+	switch (simd_get_level()) {
+#if defined(GL_SIMD_SSE)
+		case SimdLevel::AVX2:
+			return _instance_write_avx2(p_info, o_out);
+#endif
+		case SimdLevel::SCALAR:
+			return _instance_write_scalar(p_info, o_out, 0, 0);
+		default:
+			return _instance_write_baseline(p_info, o_out);
+	}
+}
+
+} //namespace gl
@@ -10,26 +10,837 @@ constexpr const char* VERBOSITY_TO_COLOR[] = {
 	[LOG_LEVEL_FATAL] = "\x1B[31m", // Red
 };
 
-static std::string _get_timestamp() {
-	const auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+// Messages a thread can have in flight before new ones get dropped, power of
+// two.
+constexpr uint64_t LOG_RING_CAPACITY = 1024;
 
-	std::tm tm_now{};
-	std::stringstream ss;
+// How long the writer sleeps when there is nothing to write
+constexpr std::chrono::milliseconds LOG_WRITER_INTERVAL(5);
+
+// Messages a rate limited site lets through per second
+constexpr uint32_t LOG_RATE_LIMIT_BURST = 10;
+
+constexpr char LOG_BINARY_MAGIC[8] = { 'G', 'L', 'L', 'O', 'G', 'B', 'I', 'N' };
+
+enum LogBinaryRecordType : uint8_t {
+	LOG_BINARY_RECORD_SITE,
+	LOG_BINARY_RECORD_MESSAGE,
+};
+
+constexpr const char* LOG_LEVEL_NAMES[] = {
+	[LOG_LEVEL_TRACE] = "TRACE",
+	[LOG_LEVEL_INFO] = "INFO",
+	[LOG_LEVEL_WARNING] = "WARNING",
+	[LOG_LEVEL_ERROR] = "ERROR",
+	[LOG_LEVEL_FATAL] = "FATAL",
+};
+
+struct LogMessage {
+	// Encoded record instead of text when `binary` is set
+	std::string text;
+	std::time_t time;
+	LogLevel level;
+	bool binary;
+};
+
+/**
+ * Single producer single consumer ring owned by one logging thread and
+ * drained by the writer.
+ */
+struct LogRing {
+	LogMessage messages[LOG_RING_CAPACITY];
+	// Written by the owning thread
+	alignas(64) std::atomic<uint64_t> head = 0;
+	// Written by the writer
+	alignas(64) std::atomic<uint64_t> tail = 0;
+	// Set once the owning thread exits, the writer releases the ring after
+	// draining it
+	std::atomic<bool> retired = false;
+};
+
+/**
+ * Keeps the ring of a thread registered for as long as the thread lives.
+ */
+struct LogRingOwner {
+	std::shared_ptr<LogRing> ring;
+	// Writer session the ring was registered to
+	uint64_t session = 0;
+
+	~LogRingOwner() {
+		if (ring) {
+			ring->retired.store(true, std::memory_order_release);
+		}
+	}
+};
+
+/**
+ * Timestamp formatted once per second instead of once per message.
+ */
+struct LogTimestamp {
+	std::time_t time = -1;
+	char text[16] = {};
+
+	const char* get(std::time_t p_time) {
+		if (p_time != time) {
+			std::tm tm_now{};
 #if GL_PLATFORM_WINDOWS
-	localtime_s(&tm_now, &now);
+			localtime_s(&tm_now, &p_time);
 #else
-	localtime_r(&now, &tm_now);
+			localtime_r(&p_time, &tm_now);
 #endif
+			std::strftime(text, sizeof(text), "%H:%M:%S", &tm_now);
+			time = p_time;
+		}
+
+		return text;
+	}
+};
+
+static std::atomic<uint8_t> s_level = LOG_LEVEL_TRACE;
+static std::atomic<bool> s_async = false;
+static std::atomic<uint64_t> s_session = 0;
+static std::atomic<uint64_t> s_dropped_messages = 0;
+
+// Serializes starting and stopping the writer
+static std::mutex s_async_mutex;
+static std::thread s_writer;
+
+// Guards the ring registry and the writer state below
+static std::mutex s_writer_mutex;
+static std::condition_variable s_writer_cv;
+static std::vector<std::shared_ptr<LogRing>> s_rings;
+static uint64_t s_drain_count = 0;
+static uint64_t s_dropped_reported = 0;
+static bool s_writer_running = false;
+// Drain pass a flush is waiting for, the writer keeps going until it is done
+static uint64_t s_flush_target = 0;
+static bool s_stop_requested = false;
+
+// Serializes synchronous writes with the ones of the writer thread, guards
+// the binary file as well
+static std::mutex s_output_mutex;
+static FILE* s_binary_file = nullptr;
+
+static std::atomic<bool> s_binary_enabled = false;
+static std::atomic<uint32_t> s_binary_session = 0;
+static std::atomic<uint32_t> s_next_site_id = 1;
+
+// Rate limiters with suppressed messages not reported yet
+static std::mutex s_suppressed_mutex;
+static std::vector<LogRateLimiter*> s_suppressed_limiters;
+
+static void _append_message(std::string& o_out, LogTimestamp& p_timestamp, LogLevel p_level,
+		std::time_t p_time, const std::string& p_text) {
+	o_out += VERBOSITY_TO_COLOR[p_level];
+	o_out += '[';
+	o_out += p_timestamp.get(p_time);
+	o_out += "] ";
+	o_out += p_text;
+	o_out += "\x1B[0m\n";
+}
+
+static void _write(const std::string& p_out) {
+	if (p_out.empty()) {
+		return;
+	}
+
+	std::scoped_lock lock(s_output_mutex);
+
+	fwrite(p_out.data(), 1, p_out.size(), stdout);
+	fflush(stdout);
+}
+
+static void _write_binary(const std::string& p_out) {
+	if (p_out.empty()) {
+		return;
+	}
+
+	std::scoped_lock lock(s_output_mutex);
+
+	// Records racing with closing the sink are dropped
+	if (s_binary_file) {
+		fwrite(p_out.data(), 1, p_out.size(), s_binary_file);
+	}
+}
+
+static std::time_t _get_time() {
+	return std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+}
+
+static int64_t _get_time_ms() {
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::system_clock::now().time_since_epoch())
+			.count();
+}
+
+static int64_t _get_rate_limit_window() {
+	return std::chrono::duration_cast<std::chrono::seconds>(
+			std::chrono::steady_clock::now().time_since_epoch())
+			.count();
+}
+
+bool LogRateLimiter::acquire(uint32_t* o_suppressed) {
+	const int64_t now = _get_rate_limit_window();
+
+	int64_t current = window.load(std::memory_order_relaxed);
+	if (current != now &&
+			window.compare_exchange_strong(current, now, std::memory_order_relaxed)) {
+		window_count.store(0, std::memory_order_relaxed);
+	}
+
+	if (window_count.fetch_add(1, std::memory_order_relaxed) < LOG_RATE_LIMIT_BURST) {
+		*o_suppressed = suppressed.exchange(0, std::memory_order_relaxed);
+		return true;
+	}
+
+	// Queue for a summary in case the site goes quiet before it can report
+	if (suppressed.fetch_add(1, std::memory_order_relaxed) == 0 &&
+			!pending.exchange(true, std::memory_order_relaxed)) {
+		std::scoped_lock lock(s_suppressed_mutex);
+		s_suppressed_limiters.push_back(this);
+	}
+
+	return false;
+}
+
+// Logs summaries of the rate limiters that were not hit this second
+static void _report_suppressed() {
+	const int64_t now = _get_rate_limit_window();
+
+	std::vector<LogRateLimiter*> quiet;
+	{
+		std::scoped_lock lock(s_suppressed_mutex);
+		std::erase_if(s_suppressed_limiters, [&](LogRateLimiter* limiter) {
+			if (limiter->window.load(std::memory_order_relaxed) == now) {
+				return false;
+			}
+
+			limiter->pending.store(false, std::memory_order_relaxed);
+			quiet.push_back(limiter);
+			return true;
+		});
+	}
+
+	for (LogRateLimiter* limiter : quiet) {
+		const uint32_t suppressed = limiter->suppressed.exchange(0, std::memory_order_relaxed);
+		if (suppressed == 0) {
+			continue;
+		}
+
+		Logger::log(LOG_LEVEL_WARNING,
+				limiter->name
+						? std::format("[LOG] {} similar messages suppressed: '{}'", suppressed,
+								  limiter->name)
+						: std::format("[LOG] {} similar messages suppressed", suppressed));
+	}
+}
+
+// Moves everything queued so far into a single write per output
+static void _drain_rings(
+		std::string& p_batch, std::string& p_binary_batch, LogTimestamp& p_timestamp) {
+	std::vector<std::shared_ptr<LogRing>> rings;
+	{
+		std::scoped_lock lock(s_writer_mutex);
+		rings = s_rings;
+	}
+
+	p_batch.clear();
+	p_binary_batch.clear();
+
+	for (const auto& ring : rings) {
+		const uint64_t head = ring->head.load(std::memory_order_acquire);
+		uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+
+		for (; tail != head; tail++) {
+			LogMessage& message = ring->messages[tail & (LOG_RING_CAPACITY - 1)];
+			if (message.binary) {
+				p_binary_batch += message.text;
+			} else {
+				_append_message(p_batch, p_timestamp, message.level, message.time, message.text);
+			}
+			message.text.clear();
+		}
+
+		ring->tail.store(tail, std::memory_order_release);
+	}
+
+	const uint64_t dropped = s_dropped_messages.load(std::memory_order_relaxed);
+	if (dropped != s_dropped_reported) {
+		_append_message(p_batch, p_timestamp, LOG_LEVEL_WARNING, _get_time(),
+				std::format("[LOG] {} messages dropped, logging faster than they can be written.",
+						dropped - s_dropped_reported));
+		s_dropped_reported = dropped;
+	}
+
+	_write(p_batch);
+	_write_binary(p_binary_batch);
+
+	// Release the rings of exited threads, retiring happens after their last
+	// push so an empty retired ring is done for good.
+	std::scoped_lock lock(s_writer_mutex);
+	std::erase_if(s_rings, [](const std::shared_ptr<LogRing>& ring) {
+		return ring->retired.load(std::memory_order_acquire) &&
+				ring->tail.load(std::memory_order_relaxed) ==
+				ring->head.load(std::memory_order_acquire);
+	});
+}
+
+static void _writer_loop() {
+	std::string batch;
+	std::string binary_batch;
+	LogTimestamp timestamp;
+
+	while (true) {
+		bool stop = false;
+		{
+			std::unique_lock lock(s_writer_mutex);
+			s_writer_cv.wait_for(lock, LOG_WRITER_INTERVAL,
+					[] { return s_drain_count < s_flush_target || s_stop_requested; });
+
+			stop = s_stop_requested;
+		}
+
+		// Summaries land in the writer's own ring and go out with the next pass
+		_report_suppressed();
+		_drain_rings(batch, binary_batch, timestamp);
+
+		{
+			std::scoped_lock lock(s_writer_mutex);
+			s_drain_count++;
+			if (stop) {
+				s_writer_running = false;
+			}
+		}
+		s_writer_cv.notify_all();
+
+		if (stop) {
+			break;
+		}
+	}
+}
+
+static LogRing* _get_thread_ring() {
+	thread_local LogRingOwner owner;
+
+	// Register a ring on first use and again after the writer got restarted
+	const uint64_t session = s_session.load(std::memory_order_acquire);
+	if (!owner.ring || owner.session != session) {
+		std::scoped_lock lock(s_writer_mutex);
+
+		owner.ring = std::make_shared<LogRing>();
+		owner.session = session;
+		s_rings.push_back(owner.ring);
+	}
+
+	return owner.ring.get();
+}
+
+// Returns the next free slot of the ring, null if full. Only visible to the
+// writer after `_commit_message`.
+static LogMessage* _reserve_message(LogRing* p_ring) {
+	const uint64_t head = p_ring->head.load(std::memory_order_relaxed);
+	if (head - p_ring->tail.load(std::memory_order_acquire) >= LOG_RING_CAPACITY) {
+		s_dropped_messages.fetch_add(1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	return &p_ring->messages[head & (LOG_RING_CAPACITY - 1)];
+}
+
+static void _commit_message(LogRing* p_ring) {
+	const uint64_t head = p_ring->head.load(std::memory_order_relaxed);
+	p_ring->head.store(head + 1, std::memory_order_release);
+}
+
+static void _push_async(LogLevel p_level, std::string&& p_message) {
+	LogRing* ring = _get_thread_ring();
+
+	LogMessage* message = _reserve_message(ring);
+	if (!message) {
+		return;
+	}
+
+	message->text = std::move(p_message);
+	message->time = _get_time();
+	message->level = p_level;
+	message->binary = false;
+
+	_commit_message(ring);
+}
+
+/**
+ * Binary record being encoded by the calling thread.
+ */
+struct LogBinaryRecord {
+	// Used when not in asynchronous mode or when the ring is full
+	std::string scratch;
+	// Ring the record was reserved in, null if encoded into `scratch`
+	LogRing* ring = nullptr;
+	bool dropped = false;
+};
+
+static thread_local LogBinaryRecord t_binary_record;
+
+std::string& Logger::_begin_binary_record(
+		LogLevel p_level, LogSite& p_site, uint32_t p_suppressed, uint8_t p_arg_count) {
+	LogBinaryRecord& record = t_binary_record;
+	record.ring = nullptr;
+	record.dropped = false;
+	record.scratch.clear();
+
+	std::string* out = &record.scratch;
+
+	if (s_async.load(std::memory_order_acquire)) {
+		LogRing* ring = _get_thread_ring();
+
+		LogMessage* message = _reserve_message(ring);
+		if (!message) {
+			// Arguments still get encoded, into scratch that is thrown away
+			record.dropped = true;
+			return record.scratch;
+		}
+
+		message->text.clear();
+		message->binary = true;
+
+		record.ring = ring;
+		out = &message->text;
+	}
+
+	uint32_t id = p_site.id.load(std::memory_order_relaxed);
+	if (id == 0) {
+		const uint32_t new_id = s_next_site_id.fetch_add(1, std::memory_order_relaxed);
+		if (p_site.id.compare_exchange_strong(id, new_id, std::memory_order_relaxed)) {
+			id = new_id;
+		}
+	}
 
-	ss << std::put_time(&tm_now, "%H:%M:%S");
+	// Describe the site once per sink, records of other threads using the site
+	// might land before this one, decoding does not depend on the order.
+	const uint32_t session = s_binary_session.load(std::memory_order_acquire);
+	if (p_site.binary_session.exchange(session, std::memory_order_relaxed) != session) {
+		*out += (char)LOG_BINARY_RECORD_SITE;
+		_append_binary_value<uint32_t>(*out, id);
+		_append_binary_value<uint32_t>(*out, p_site.line);
+		_append_binary_arg(*out, p_site.file);
+		_append_binary_arg(*out, p_site.format);
+	}
 
-	return ss.str();
+	*out += (char)LOG_BINARY_RECORD_MESSAGE;
+	_append_binary_value<uint32_t>(*out, id);
+	_append_binary_value<uint8_t>(*out, p_level);
+	_append_binary_value<int64_t>(*out, _get_time_ms());
+	_append_binary_value<uint32_t>(*out, p_suppressed);
+	_append_binary_value<uint8_t>(*out, p_arg_count);
+
+	return *out;
+}
+
+void Logger::_end_binary_record() {
+	LogBinaryRecord& record = t_binary_record;
+
+	if (record.dropped) {
+		return;
+	}
+
+	if (record.ring) {
+		_commit_message(record.ring);
+	} else {
+		_write_binary(record.scratch);
+	}
+}
+
+void Logger::log(LogLevel p_level, std::string&& p_message) {
+	if (p_level < LOG_LEVEL_FATAL && s_async.load(std::memory_order_acquire)) {
+		_push_async(p_level, std::move(p_message));
+		return;
+	}
+
+	// Make sure what led up to a fatal message is printed before it
+	if (p_level == LOG_LEVEL_FATAL) {
+		flush();
+	}
+
+	thread_local LogTimestamp timestamp;
+
+	std::string out;
+	_append_message(out, timestamp, p_level, _get_time(), p_message);
+	_write(out);
+}
+
+void Logger::set_level(LogLevel p_level) { s_level.store(p_level, std::memory_order_relaxed); }
+
+LogLevel Logger::get_level() { return static_cast<LogLevel>(s_level.load()); }
+
+bool Logger::is_level_enabled(LogLevel p_level) {
+	return p_level >= s_level.load(std::memory_order_relaxed);
+}
+
+void Logger::set_async(bool p_async) {
+	std::scoped_lock async_lock(s_async_mutex);
+
+	if (p_async == s_writer.joinable()) {
+		return;
+	}
+
+	if (p_async) {
+		{
+			std::scoped_lock lock(s_writer_mutex);
+			s_stop_requested = false;
+			s_writer_running = true;
+		}
+
+		s_session.fetch_add(1, std::memory_order_release);
+		s_writer = std::thread(_writer_loop);
+
+		s_async.store(true, std::memory_order_release);
+	} else {
+		// A push racing with the stop can still end up in a ring after the
+		// final drain, that message is lost.
+		s_async.store(false, std::memory_order_release);
+
+		{
+			std::scoped_lock lock(s_writer_mutex);
+			s_stop_requested = true;
+		}
+		s_writer_cv.notify_all();
+
+		s_writer.join();
+
+		std::scoped_lock lock(s_writer_mutex);
+		s_rings.clear();
+	}
+}
+
+bool Logger::is_async() { return s_async.load(std::memory_order_relaxed); }
+
+bool Logger::set_binary_sink(const std::filesystem::path& p_path) {
+	std::scoped_lock async_lock(s_async_mutex);
+
+	// Write out whatever is queued for the previous sink before closing it
+	s_binary_enabled.store(false, std::memory_order_release);
+	flush();
+
+	{
+		std::scoped_lock lock(s_output_mutex);
+		if (s_binary_file) {
+			fclose(s_binary_file);
+			s_binary_file = nullptr;
+		}
+	}
+
+	if (p_path.empty()) {
+		return true;
+	}
+
+	FILE* file = fopen(p_path.string().c_str(), "wb");
+	if (!file) {
+		GL_LOG_ERROR("[LOG] Unable to open file '{}' for writing.", p_path.string());
+		return false;
+	}
+
+	fwrite(LOG_BINARY_MAGIC, 1, sizeof(LOG_BINARY_MAGIC), file);
+
+	{
+		std::scoped_lock lock(s_output_mutex);
+		s_binary_file = file;
+	}
+
+	// Sites describe themselves again in the new file
+	s_binary_session.fetch_add(1, std::memory_order_release);
+	s_binary_enabled.store(true, std::memory_order_release);
+
+	return true;
+}
+
+bool Logger::is_binary_sink_enabled() { return s_binary_enabled.load(std::memory_order_relaxed); }
+
+typedef std::variant<int64_t, uint64_t, double, bool, char, const void*, std::string> LogDecodedArg;
+
+struct LogDecodedSite {
+	std::string file;
+	std::string format;
+	uint32_t line;
+};
+
+/**
+ * Bounds checked cursor over an encoded binary log.
+ */
+struct LogBinaryReader {
+	const std::string& data;
+	size_t offset = 0;
+
+	bool is_at_end() const { return offset >= data.size(); }
+
+	template <typename T> bool read(T& o_value) {
+		if (data.size() - offset < sizeof(T)) {
+			return false;
+		}
+
+		memcpy(&o_value, data.data() + offset, sizeof(T));
+		offset += sizeof(T);
+		return true;
+	}
+
+	// Strings are stored as string arguments, type tag included
+	bool read_string(std::string& o_str) {
+		uint8_t type = 0;
+		uint32_t size = 0;
+		if (!read(type) || type != LOG_BINARY_ARG_STRING || !read(size) ||
+				data.size() - offset < size) {
+			return false;
+		}
+
+		o_str.assign(data.data() + offset, size);
+		offset += size;
+		return true;
+	}
+
+	bool read_arg(LogDecodedArg& o_arg) {
+		uint8_t type = 0;
+		if (!read(type)) {
+			return false;
+		}
+
+		return _read_arg_value(type, o_arg);
+	}
+
+private:
+	template <typename T> bool _read_as(LogDecodedArg& o_arg) {
+		T value = {};
+		if (!read(value)) {
+			return false;
+		}
+
+		o_arg = value;
+		return true;
+	}
+
+	bool _read_arg_value(uint8_t p_type, LogDecodedArg& o_arg);
+};
+
+bool LogBinaryReader::_read_arg_value(uint8_t p_type, LogDecodedArg& o_arg) {
+	switch (p_type) {
+		case LOG_BINARY_ARG_INT:
+			return _read_as<int64_t>(o_arg);
+		case LOG_BINARY_ARG_UINT:
+			return _read_as<uint64_t>(o_arg);
+		case LOG_BINARY_ARG_FLOAT:
+			return _read_as<double>(o_arg);
+		case LOG_BINARY_ARG_BOOL: {
+			uint8_t value = 0;
+			if (!read(value)) {
+				return false;
+			}
+			o_arg = value != 0;
+			return true;
+		}
+		case LOG_BINARY_ARG_CHAR:
+			return _read_as<char>(o_arg);
+		case LOG_BINARY_ARG_POINTER: {
+			uint64_t value = 0;
+			if (!read(value)) {
+				return false;
+			}
+			o_arg = (const void*)(uintptr_t)value;
+			return true;
+		}
+		case LOG_BINARY_ARG_STRING: {
+			uint32_t size = 0;
+			if (!read(size) || data.size() - offset < size) {
+				return false;
+			}
+			o_arg = std::string(data.data() + offset, size);
+			offset += size;
+			return true;
+		}
+		default:
+			return false;
+	}
+}
+
+static std::string _format_decoded_arg(std::string_view p_spec, const LogDecodedArg& p_arg) {
+	const std::string field = std::format("{{0{}}}", p_spec);
+
+	return std::visit(
+			[&](const auto& value) -> std::string {
+				try {
+					return std::vformat(field, std::make_format_args(value));
+				} catch (const std::format_error&) {
+					// Spec written for a type that got formatted to a string
+					return std::format("{}", value);
+				}
+			},
+			p_arg);
+}
+
+// Substitutes the replacement fields of `p_format` one argument at a time,
+// `std::format` can not take a list of arguments only known at runtime.
+static std::string _format_decoded(
+		std::string_view p_format, const std::vector<LogDecodedArg>& p_args) {
+	std::string out;
+	size_t next_arg = 0;
+
+	for (size_t i = 0; i < p_format.size(); i++) {
+		const char c = p_format[i];
+		const bool escaped = i + 1 < p_format.size() && p_format[i + 1] == c;
+
+		if ((c == '{' || c == '}') && escaped) {
+			out += c;
+			i++;
+			continue;
+		}
+
+		const size_t end = c == '{' ? p_format.find('}', i) : std::string_view::npos;
+		if (end == std::string_view::npos) {
+			out += c;
+			continue;
+		}
+
+		const std::string_view field = p_format.substr(i + 1, end - i - 1);
+		const size_t colon = field.find(':');
+		const std::string_view index = field.substr(0, colon);
+		const std::string_view spec =
+				colon == std::string_view::npos ? std::string_view() : field.substr(colon);
+
+		size_t arg_index = next_arg++;
+		if (!index.empty()) {
+			std::from_chars(index.data(), index.data() + index.size(), arg_index);
+		}
+
+		out += arg_index < p_args.size() ? _format_decoded_arg(spec, p_args[arg_index]) : "{?}";
+
+		i = end;
+	}
+
+	return out;
+}
+
+bool Logger::decode_binary_log(const std::filesystem::path& p_path, std::ostream& o_out) {
+	std::ifstream file(p_path, std::ios::binary);
+	if (!file.is_open()) {
+		GL_LOG_ERROR("[LOG] Unable to open file '{}' for reading.", p_path.string());
+		return false;
+	}
+
+	const std::string data(
+			(std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	if (data.size() < sizeof(LOG_BINARY_MAGIC) ||
+			memcmp(data.data(), LOG_BINARY_MAGIC, sizeof(LOG_BINARY_MAGIC)) != 0) {
+		GL_LOG_ERROR("[LOG] File '{}' is not a binary log.", p_path.string());
+		return false;
+	}
+
+	std::unordered_map<uint32_t, LogDecodedSite> sites;
+	LogTimestamp timestamp;
+
+	// Site records can come after the first message using them when several
+	// threads log from the same site, collect them all up front.
+	for (int pass = 0; pass < 2; pass++) {
+		LogBinaryReader reader = { data, sizeof(LOG_BINARY_MAGIC) };
+
+		while (!reader.is_at_end()) {
+			uint8_t type = 0;
+			uint32_t id = 0;
+			if (!reader.read(type) || !reader.read(id)) {
+				return false;
+			}
+
+			if (type == LOG_BINARY_RECORD_SITE) {
+				LogDecodedSite site = {};
+				if (!reader.read(site.line) || !reader.read_string(site.file) ||
+						!reader.read_string(site.format)) {
+					GL_LOG_ERROR("[LOG] Truncated site record in '{}'.", p_path.string());
+					return false;
+				}
+
+				sites[id] = std::move(site);
+				continue;
+			}
+
+			if (type != LOG_BINARY_RECORD_MESSAGE) {
+				GL_LOG_ERROR("[LOG] Unknown record in '{}'.", p_path.string());
+				return false;
+			}
+
+			uint8_t level = 0;
+			int64_t time_ms = 0;
+			uint32_t suppressed = 0;
+			uint8_t arg_count = 0;
+			if (!reader.read(level) || !reader.read(time_ms) || !reader.read(suppressed) ||
+					!reader.read(arg_count)) {
+				GL_LOG_ERROR("[LOG] Truncated message record in '{}'.", p_path.string());
+				return false;
+			}
+
+			std::vector<LogDecodedArg> args(arg_count);
+			for (LogDecodedArg& arg : args) {
+				if (!reader.read_arg(arg)) {
+					GL_LOG_ERROR("[LOG] Truncated message record in '{}'.", p_path.string());
+					return false;
+				}
+			}
+
+			if (pass == 0) {
+				continue;
+			}
+
+			const std::time_t time = time_ms / 1000;
+
+			const auto it = sites.find(id);
+			const std::string text = it != sites.end()
+					? _format_decoded(it->second.format, args)
+					: std::format("<unknown site {}>", id);
+
+			o_out << std::format("[{}.{:03}] [{}] {}", timestamp.get(time), time_ms % 1000,
+					LOG_LEVEL_NAMES[std::min<uint8_t>(level, LOG_LEVEL_FATAL)], text);
+			if (suppressed > 0) {
+				o_out << std::format(" ({} similar messages suppressed)", suppressed);
+			}
+			o_out << "\n";
+		}
+	}
+
+	return true;
 }
 
-void Logger::log(LogLevel p_level, const std::string& p_fmt) {
-	// Output to stdout
-	std::cout << VERBOSITY_TO_COLOR[p_level] << std::format("[{}] {}", _get_timestamp(), p_fmt)
-			  << "\x1B[0m\n";
+void Logger::flush() {
+	std::unique_lock lock(s_writer_mutex);
+
+	if (!s_writer_running) {
+		lock.unlock();
+		_report_suppressed();
+
+		std::scoped_lock output_lock(s_output_mutex);
+		if (s_binary_file) {
+			fflush(s_binary_file);
+		}
+
+		return;
+	}
+
+	// A drain already in progress might have missed the caller's messages,
+	// wait for one that started after this point.
+	const uint64_t target = s_drain_count + 2;
+
+	s_flush_target = std::max(s_flush_target, target);
+	s_writer_cv.notify_all();
+	s_writer_cv.wait(lock, [target] { return s_drain_count >= target || !s_writer_running; });
 }
 
+uint64_t Logger::get_dropped_message_count() {
+	return s_dropped_messages.load(std::memory_order_relaxed);
+}
+
+/**
+ * Stops the writer at exit so pending messages are written and the thread is
+ * joined before it gets destroyed.
+ */
+struct LogWriterGuard {
+	~LogWriterGuard() { Logger::set_async(false); }
+};
+
+static LogWriterGuard s_writer_guard;
+
 } //namespace gl
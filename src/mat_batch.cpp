@@ -0,0 +1,430 @@
+#include "glgpu/mat_batch.h"
+
+namespace gl {
+
+// ============================================================================
+// Scalar
+// ============================================================================
+
+static void _mat4_mul_batch_scalar(
+		const Mat4& p_lhs, const Mat4* p_rhs, Mat4* o_out, size_t p_count) {
+	for (size_t i = 0; i < p_count; i++) {
+		o_out[i] = p_lhs.mul_scalar(p_rhs[i]);
+	}
+}
+
+static void _mat4_mul_pairs_scalar(
+		const Mat4* p_lhs, const Mat4* p_rhs, Mat4* o_out, size_t p_count) {
+	for (size_t i = 0; i < p_count; i++) {
+		o_out[i] = p_lhs[i].mul_scalar(p_rhs[i]);
+	}
+}
+
+static void _mat4_transpose_batch_scalar(const Mat4* p_in, Mat4* o_out, size_t p_count) {
+	for (size_t i = 0; i < p_count; i++) {
+		o_out[i] = p_in[i].transpose_scalar();
+	}
+}
+
+static void _mat4_inverse_batch_scalar(const Mat4* p_in, Mat4* o_out, size_t p_count) {
+	for (size_t i = 0; i < p_count; i++) {
+		o_out[i] = p_in[i].inverse_scalar();
+	}
+}
+
+// Transforms vectors `p_begin` to `p_end`, also used for the tails of the
+// vectorized kernels
+static void _mat4_transform_soa_scalar(const Mat4& p_mat, const Vec4SoA& p_in,
+		const Vec4SoA& o_out, size_t p_begin, size_t p_end) {
+	for (size_t i = p_begin; i < p_end; i++) {
+		const float x = p_in.x[i];
+		const float y = p_in.y[i];
+		const float z = p_in.z[i];
+		const float w = p_in.w ? p_in.w[i] : 1.0f;
+
+		o_out.x[i] = p_mat[0][0] * x + p_mat[1][0] * y + p_mat[2][0] * z + p_mat[3][0] * w;
+		o_out.y[i] = p_mat[0][1] * x + p_mat[1][1] * y + p_mat[2][1] * z + p_mat[3][1] * w;
+		o_out.z[i] = p_mat[0][2] * x + p_mat[1][2] * y + p_mat[2][2] * z + p_mat[3][2] * w;
+		if (o_out.w) {
+			o_out.w[i] = p_mat[0][3] * x + p_mat[1][3] * y + p_mat[2][3] * z + p_mat[3][3] * w;
+		}
+	}
+}
+
+// ============================================================================
+// Baseline, SSE2 or NEON through the `Mat4` operators
+// ============================================================================
+
+static void _mat4_mul_batch_baseline(
+		const Mat4& p_lhs, const Mat4* p_rhs, Mat4* o_out, size_t p_count) {
+	for (size_t i = 0; i < p_count; i++) {
+		o_out[i] = p_lhs * p_rhs[i];
+	}
+}
+
+static void _mat4_mul_pairs_baseline(
+		const Mat4* p_lhs, const Mat4* p_rhs, Mat4* o_out, size_t p_count) {
+	for (size_t i = 0; i < p_count; i++) {
+		o_out[i] = p_lhs[i] * p_rhs[i];
+	}
+}
+
+static void _mat4_transpose_batch_baseline(const Mat4* p_in, Mat4* o_out, size_t p_count) {
+	for (size_t i = 0; i < p_count; i++) {
+		o_out[i] = p_in[i].transpose();
+	}
+}
+
+static void _mat4_inverse_batch_baseline(const Mat4* p_in, Mat4* o_out, size_t p_count) {
+	for (size_t i = 0; i < p_count; i++) {
+		o_out[i] = p_in[i].inverse();
+	}
+}
+
+static void _mat4_transform_soa_baseline(
+		const Mat4& p_mat, const Vec4SoA& p_in, const Vec4SoA& o_out, size_t p_count) {
+	size_t i = 0;
+
+#if defined(GL_SIMD_SSE)
+	__m128 m[4][4];
+	for (int c = 0; c < 4; c++) {
+		for (int r = 0; r < 4; r++) {
+			m[c][r] = _mm_set1_ps(p_mat[c][r]);
+		}
+	}
+
+	const __m128 one = _mm_set1_ps(1.0f);
+
+	for (; i + 4 <= p_count; i += 4) {
+		const __m128 x = _mm_loadu_ps(p_in.x + i);
+		const __m128 y = _mm_loadu_ps(p_in.y + i);
+		const __m128 z = _mm_loadu_ps(p_in.z + i);
+		const __m128 w = p_in.w ? _mm_loadu_ps(p_in.w + i) : one;
+
+		float* outputs[4] = { o_out.x, o_out.y, o_out.z, o_out.w };
+		for (int r = 0; r < 4; r++) {
+			if (!outputs[r]) {
+				continue;
+			}
+
+			__m128 v = _mm_mul_ps(m[0][r], x);
+			v = _mm_add_ps(v, _mm_mul_ps(m[1][r], y));
+			v = _mm_add_ps(v, _mm_mul_ps(m[2][r], z));
+			v = _mm_add_ps(v, _mm_mul_ps(m[3][r], w));
+			_mm_storeu_ps(outputs[r] + i, v);
+		}
+	}
+#elif defined(GL_SIMD_NEON)
+	float32x4_t m[4][4];
+	for (int c = 0; c < 4; c++) {
+		for (int r = 0; r < 4; r++) {
+			m[c][r] = vdupq_n_f32(p_mat[c][r]);
+		}
+	}
+
+	const float32x4_t one = vdupq_n_f32(1.0f);
+
+	for (; i + 4 <= p_count; i += 4) {
+		const float32x4_t x = vld1q_f32(p_in.x + i);
+		const float32x4_t y = vld1q_f32(p_in.y + i);
+		const float32x4_t z = vld1q_f32(p_in.z + i);
+		const float32x4_t w = p_in.w ? vld1q_f32(p_in.w + i) : one;
+
+		float* outputs[4] = { o_out.x, o_out.y, o_out.z, o_out.w };
+		for (int r = 0; r < 4; r++) {
+			if (!outputs[r]) {
+				continue;
+			}
+
+			float32x4_t v = vmulq_f32(m[0][r], x);
+			v = vfmaq_f32(v, m[1][r], y);
+			v = vfmaq_f32(v, m[2][r], z);
+			v = vfmaq_f32(v, m[3][r], w);
+			vst1q_f32(outputs[r] + i, v);
+		}
+	}
+#endif
+
+	_mat4_transform_soa_scalar(p_mat, p_in, o_out, i, p_count);
+}
+
+// ============================================================================
+// AVX2, two matrices or eight vectors per register
+// ============================================================================
+
+#if defined(GL_SIMD_SSE)
+
+// Same 4 floats in both halves
+GL_SIMD_TARGET_AVX2 static __m256 _broadcast_column(const std::array<float, 4>& p_col) {
+	const __m128 col = _mm_loadu_ps(p_col.data());
+	return _mm256_insertf128_ps(_mm256_castps128_ps256(col), col, 1);
+}
+
+// Columns `p_col` and `p_col + 1` of `p_rhs` combined by the broadcast
+// columns of the left hand side
+GL_SIMD_TARGET_AVX2 static __m256 _mul_columns_avx2(
+		const __m256 p_lhs[4], const Mat4& p_rhs, int p_col) {
+	const __m256 o = _mm256_loadu_ps(p_rhs[p_col].data());
+
+	__m256 r = _mm256_mul_ps(p_lhs[0], _mm256_permute_ps(o, _MM_SHUFFLE(0, 0, 0, 0)));
+	r = _mm256_fmadd_ps(p_lhs[1], _mm256_permute_ps(o, _MM_SHUFFLE(1, 1, 1, 1)), r);
+	r = _mm256_fmadd_ps(p_lhs[2], _mm256_permute_ps(o, _MM_SHUFFLE(2, 2, 2, 2)), r);
+	r = _mm256_fmadd_ps(p_lhs[3], _mm256_permute_ps(o, _MM_SHUFFLE(3, 3, 3, 3)), r);
+	return r;
+}
+
+GL_SIMD_TARGET_AVX2 static void _mat4_mul_batch_avx2(
+		const Mat4& p_lhs, const Mat4* p_rhs, Mat4* o_out, size_t p_count) {
+	const __m256 lhs[4] = {
+		_broadcast_column(p_lhs[0]),
+		_broadcast_column(p_lhs[1]),
+		_broadcast_column(p_lhs[2]),
+		_broadcast_column(p_lhs[3]),
+	};
+
+	for (size_t i = 0; i < p_count; i++) {
+		const __m256 c01 = _mul_columns_avx2(lhs, p_rhs[i], 0);
+		const __m256 c23 = _mul_columns_avx2(lhs, p_rhs[i], 2);
+		_mm256_storeu_ps(o_out[i][0].data(), c01);
+		_mm256_storeu_ps(o_out[i][2].data(), c23);
+	}
+}
+
+GL_SIMD_TARGET_AVX2 static void _mat4_mul_pairs_avx2(
+		const Mat4* p_lhs, const Mat4* p_rhs, Mat4* o_out, size_t p_count) {
+	for (size_t i = 0; i < p_count; i++) {
+		const __m256 lhs[4] = {
+			_broadcast_column(p_lhs[i][0]),
+			_broadcast_column(p_lhs[i][1]),
+			_broadcast_column(p_lhs[i][2]),
+			_broadcast_column(p_lhs[i][3]),
+		};
+
+		const __m256 c01 = _mul_columns_avx2(lhs, p_rhs[i], 0);
+		const __m256 c23 = _mul_columns_avx2(lhs, p_rhs[i], 2);
+		_mm256_storeu_ps(o_out[i][0].data(), c01);
+		_mm256_storeu_ps(o_out[i][2].data(), c23);
+	}
+}
+
+template <int X, int Y, int Z, int W>
+GL_SIMD_TARGET_AVX2 static __m256 _swizzle_avx2(__m256 p_v) {
+	return _mm256_permute_ps(p_v, _MM_SHUFFLE(W, Z, Y, X));
+}
+
+// 2x2 block helpers of `Mat4::_inverse_sse`, per 128 bit lane
+
+GL_SIMD_TARGET_AVX2 static __m256 _mat2_mul_avx2(__m256 p_a, __m256 p_b) {
+	return _mm256_fmadd_ps(p_a, _swizzle_avx2<0, 3, 0, 3>(p_b),
+			_mm256_mul_ps(_swizzle_avx2<1, 0, 3, 2>(p_a), _swizzle_avx2<2, 1, 2, 1>(p_b)));
+}
+
+GL_SIMD_TARGET_AVX2 static __m256 _mat2_adj_mul_avx2(__m256 p_a, __m256 p_b) {
+	return _mm256_fmsub_ps(_swizzle_avx2<3, 3, 0, 0>(p_a), p_b,
+			_mm256_mul_ps(_swizzle_avx2<1, 1, 2, 2>(p_a), _swizzle_avx2<2, 3, 0, 1>(p_b)));
+}
+
+GL_SIMD_TARGET_AVX2 static __m256 _mat2_mul_adj_avx2(__m256 p_a, __m256 p_b) {
+	return _mm256_fmsub_ps(p_a, _swizzle_avx2<3, 0, 3, 0>(p_b),
+			_mm256_mul_ps(_swizzle_avx2<1, 0, 3, 2>(p_a), _swizzle_avx2<2, 1, 2, 1>(p_b)));
+}
+
+// `_mm_movelh_ps` and `_mm_movehl_ps` per lane
+GL_SIMD_TARGET_AVX2 static __m256 _movelh_avx2(__m256 p_a, __m256 p_b) {
+	return _mm256_castpd_ps(_mm256_unpacklo_pd(_mm256_castps_pd(p_a), _mm256_castps_pd(p_b)));
+}
+
+GL_SIMD_TARGET_AVX2 static __m256 _movehl_avx2(__m256 p_a, __m256 p_b) {
+	return _mm256_castpd_ps(_mm256_unpackhi_pd(_mm256_castps_pd(p_b), _mm256_castps_pd(p_a)));
+}
+
+// Column `p_col` of two matrices, one per lane
+GL_SIMD_TARGET_AVX2 static __m256 _load_column_pair(
+		const Mat4& p_first, const Mat4& p_second, int p_col) {
+	return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p_first[p_col].data())),
+			_mm_loadu_ps(p_second[p_col].data()), 1);
+}
+
+GL_SIMD_TARGET_AVX2 static void _store_column_pair(
+		__m256 p_value, Mat4& o_first, Mat4& o_second, int p_col) {
+	_mm_storeu_ps(o_first[p_col].data(), _mm256_castps256_ps128(p_value));
+	_mm_storeu_ps(o_second[p_col].data(), _mm256_extractf128_ps(p_value, 1));
+}
+
+GL_SIMD_TARGET_AVX2 static void _mat4_inverse_batch_avx2(
+		const Mat4* p_in, Mat4* o_out, size_t p_count) {
+	size_t i = 0;
+
+	for (; i + 2 <= p_count; i += 2) {
+		const __m256 c0 = _load_column_pair(p_in[i], p_in[i + 1], 0);
+		const __m256 c1 = _load_column_pair(p_in[i], p_in[i + 1], 1);
+		const __m256 c2 = _load_column_pair(p_in[i], p_in[i + 1], 2);
+		const __m256 c3 = _load_column_pair(p_in[i], p_in[i + 1], 3);
+
+		const __m256 a = _movelh_avx2(c0, c1);
+		const __m256 b = _movehl_avx2(c1, c0);
+		const __m256 c = _movelh_avx2(c2, c3);
+		const __m256 d = _movehl_avx2(c3, c2);
+
+		const __m256 det_sub = _mm256_fmsub_ps(
+				_mm256_shuffle_ps(c0, c2, _MM_SHUFFLE(2, 0, 2, 0)),
+				_mm256_shuffle_ps(c1, c3, _MM_SHUFFLE(3, 1, 3, 1)),
+				_mm256_mul_ps(_mm256_shuffle_ps(c0, c2, _MM_SHUFFLE(3, 1, 3, 1)),
+						_mm256_shuffle_ps(c1, c3, _MM_SHUFFLE(2, 0, 2, 0))));
+		const __m256 det_a = _swizzle_avx2<0, 0, 0, 0>(det_sub);
+		const __m256 det_b = _swizzle_avx2<1, 1, 1, 1>(det_sub);
+		const __m256 det_c = _swizzle_avx2<2, 2, 2, 2>(det_sub);
+		const __m256 det_d = _swizzle_avx2<3, 3, 3, 3>(det_sub);
+
+		const __m256 d_c = _mat2_adj_mul_avx2(d, c);
+		const __m256 a_b = _mat2_adj_mul_avx2(a, b);
+
+		__m256 x = _mm256_fmsub_ps(det_d, a, _mat2_mul_avx2(b, d_c));
+		__m256 w = _mm256_fmsub_ps(det_a, d, _mat2_mul_avx2(c, a_b));
+		__m256 y = _mm256_fmsub_ps(det_b, c, _mat2_mul_adj_avx2(d, a_b));
+		__m256 z = _mm256_fmsub_ps(det_c, b, _mat2_mul_adj_avx2(a, d_c));
+
+		__m256 tr = _mm256_mul_ps(a_b, _swizzle_avx2<0, 2, 1, 3>(d_c));
+		tr = _mm256_add_ps(tr, _swizzle_avx2<2, 3, 0, 1>(tr));
+		tr = _mm256_add_ps(tr, _swizzle_avx2<1, 0, 3, 2>(tr));
+		const __m256 det = _mm256_sub_ps(
+				_mm256_fmadd_ps(det_a, det_d, _mm256_mul_ps(det_b, det_c)), tr);
+
+		// Zero the lanes of singular matrices, matching the scalar path
+		const __m256 abs_det = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), det);
+		const __m256 invertible = _mm256_cmp_ps(abs_det, _mm256_set1_ps(1e-6f), _CMP_GE_OQ);
+
+		const __m256 sign = _mm256_setr_ps(1.0f, -1.0f, -1.0f, 1.0f, 1.0f, -1.0f, -1.0f, 1.0f);
+		const __m256 inv_det = _mm256_and_ps(_mm256_div_ps(sign, det), invertible);
+		x = _mm256_mul_ps(x, inv_det);
+		y = _mm256_mul_ps(y, inv_det);
+		z = _mm256_mul_ps(z, inv_det);
+		w = _mm256_mul_ps(w, inv_det);
+
+		Mat4& first = o_out[i];
+		Mat4& second = o_out[i + 1];
+		_store_column_pair(_mm256_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)), first, second, 0);
+		_store_column_pair(_mm256_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)), first, second, 1);
+		_store_column_pair(_mm256_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)), first, second, 2);
+		_store_column_pair(_mm256_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)), first, second, 3);
+	}
+
+	_mat4_inverse_batch_baseline(p_in + i, o_out + i, p_count - i);
+}
+
+GL_SIMD_TARGET_AVX2 static void _mat4_transform_soa_avx2(
+		const Mat4& p_mat, const Vec4SoA& p_in, const Vec4SoA& o_out, size_t p_count) {
+	__m256 m[4][4];
+	for (int c = 0; c < 4; c++) {
+		for (int r = 0; r < 4; r++) {
+			m[c][r] = _mm256_set1_ps(p_mat[c][r]);
+		}
+	}
+
+	const __m256 one = _mm256_set1_ps(1.0f);
+	float* outputs[4] = { o_out.x, o_out.y, o_out.z, o_out.w };
+
+	size_t i = 0;
+	for (; i + 8 <= p_count; i += 8) {
+		const __m256 x = _mm256_loadu_ps(p_in.x + i);
+		const __m256 y = _mm256_loadu_ps(p_in.y + i);
+		const __m256 z = _mm256_loadu_ps(p_in.z + i);
+		const __m256 w = p_in.w ? _mm256_loadu_ps(p_in.w + i) : one;
+
+		for (int r = 0; r < 4; r++) {
+			if (!outputs[r]) {
+				continue;
+			}
+
+			__m256 v = _mm256_mul_ps(m[0][r], x);
+			v = _mm256_fmadd_ps(m[1][r], y, v);
+			v = _mm256_fmadd_ps(m[2][r], z, v);
+			v = _mm256_fmadd_ps(m[3][r], w, v);
+			_mm256_storeu_ps(outputs[r] + i, v);
+		}
+	}
+
+	_mat4_transform_soa_scalar(p_mat, p_in, o_out, i, p_count);
+}
+
+#endif
+
+// ============================================================================
+// Dispatch
+// ============================================================================
+
+void mat4_mul_batch(const Mat4& p_lhs, const Mat4* p_rhs, Mat4* o_out, size_t p_count) {
+	switch (simd_get_level()) {
+#if defined(GL_SIMD_SSE)
+		case SimdLevel::AVX2:
+			_mat4_mul_batch_avx2(p_lhs, p_rhs, o_out, p_count);
+			return;
+#endif
+		case SimdLevel::SCALAR:
+			_mat4_mul_batch_scalar(p_lhs, p_rhs, o_out, p_count);
+			return;
+		default:
+			_mat4_mul_batch_baseline(p_lhs, p_rhs, o_out, p_count);
+			return;
+	}
+}
+
+void mat4_mul_pairs(const Mat4* p_lhs, const Mat4* p_rhs, Mat4* o_out, size_t p_count) {
+	switch (simd_get_level()) {
+#if defined(GL_SIMD_SSE)
+		case SimdLevel::AVX2:
+			_mat4_mul_pairs_avx2(p_lhs, p_rhs, o_out, p_count);
+			return;
+#endif
+		case SimdLevel::SCALAR:
+			_mat4_mul_pairs_scalar(p_lhs, p_rhs, o_out, p_count);
+			return;
+		default:
+			_mat4_mul_pairs_baseline(p_lhs, p_rhs, o_out, p_count);
+			return;
+	}
+}
+
+void mat4_transpose_batch(const Mat4* p_in, Mat4* o_out, size_t p_count) {
+	// Bound by memory already at 128 bits, no AVX2 variant
+	if (simd_get_level() == SimdLevel::SCALAR) {
+		_mat4_transpose_batch_scalar(p_in, o_out, p_count);
+	} else {
+		_mat4_transpose_batch_baseline(p_in, o_out, p_count);
+	}
+}
+
+void mat4_inverse_batch(const Mat4* p_in, Mat4* o_out, size_t p_count) {
+	switch (simd_get_level()) {
+#if defined(GL_SIMD_SSE)
+		case SimdLevel::AVX2:
+			_mat4_inverse_batch_avx2(p_in, o_out, p_count);
+			return;
+#endif
+		case SimdLevel::SCALAR:
+			_mat4_inverse_batch_scalar(p_in, o_out, p_count);
+			return;
+		default:
+			_mat4_inverse_batch_baseline(p_in, o_out, p_count);
+			return;
+	}
+}
+
+void mat4_transform_soa(
+		const Mat4& p_mat, const Vec4SoA& p_in, const Vec4SoA& o_out, size_t p_count) {
+	switch (simd_get_level()) {
+#if defined(GL_SIMD_SSE)
+		case SimdLevel::AVX2:
+			_mat4_transform_soa_avx2(p_mat, p_in, o_out, p_count);
+			return;
+#endif
+		case SimdLevel::SCALAR:
+			_mat4_transform_soa_scalar(p_mat, p_in, o_out, 0, p_count);
+			return;
+		default:
+			_mat4_transform_soa_baseline(p_mat, p_in, o_out, p_count);
+			return;
+	}
+}
+
+} //namespace gl
@@ -1,5 +1,13 @@
 #include "glgpu/os.h"
 
+#include "glgpu/assert.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#endif
+
 namespace gl {
 
 WindowCompositor get_window_compositor() {
@@ -36,4 +44,75 @@ WindowCompositor get_window_compositor() {
 #endif
 }
 
+#if defined(__linux__)
+static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+#endif
+
+void* allocate_huge_pages(size_t p_size, size_t* o_size) {
+#if defined(_WIN32)
+	// Requires the "Lock pages in memory" privilege, commonly missing
+	const size_t large_page_size = GetLargePageMinimum();
+	if (large_page_size > 0) {
+		const size_t size = (p_size + large_page_size - 1) & ~(large_page_size - 1);
+
+		void* memory = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+				PAGE_READWRITE);
+		if (memory) {
+			*o_size = size;
+			return memory;
+		}
+	}
+
+	void* memory = VirtualAlloc(nullptr, p_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+	GL_ASSERT(memory != nullptr, "Unable to allocate memory");
+
+	*o_size = p_size;
+	return memory;
+#elif defined(__linux__)
+	const size_t size = (p_size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+	*o_size = size;
+
+	// Only succeeds if huge pages were reserved through `vm.nr_hugepages`
+	void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	if (memory != MAP_FAILED) {
+		return memory;
+	}
+
+	// Otherwise ask for transparent huge pages, which need the range to be
+	// aligned to the huge page size. Map more and trim the excess.
+	uint8_t* mapping = (uint8_t*)mmap(nullptr, size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	GL_ASSERT(mapping != MAP_FAILED, "Unable to map memory");
+
+	uint8_t* aligned =
+			(uint8_t*)((uintptr_t(mapping) + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1));
+	if (aligned > mapping) {
+		munmap(mapping, aligned - mapping);
+	}
+	munmap(aligned + size, mapping + HUGE_PAGE_SIZE - aligned);
+
+	madvise(aligned, size, MADV_HUGEPAGE);
+
+	return aligned;
+#else
+	*o_size = p_size;
+	return ::operator new(p_size, std::align_val_t(4096));
+#endif
+}
+
+void free_huge_pages(void* p_memory, size_t p_size) {
+	if (!p_memory) {
+		return;
+	}
+
+#if defined(_WIN32)
+	VirtualFree(p_memory, 0, MEM_RELEASE);
+#elif defined(__linux__)
+	munmap(p_memory, p_size);
+#else
+	::operator delete(p_memory, std::align_val_t(4096));
+#endif
+}
+
 } //namespace gl
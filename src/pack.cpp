@@ -0,0 +1,542 @@
+#include "glgpu/pack.h"
+
+#include "glgpu/assert.h"
+#include "glgpu/simd.h"
+
+namespace gl {
+
+// ============================================================================
+// Scalar
+// ============================================================================
+
+static uint32_t _float_bits(float p_value) {
+	uint32_t bits;
+	memcpy(&bits, &p_value, sizeof(bits));
+	return bits;
+}
+
+static float _bits_float(uint32_t p_bits) {
+	float value;
+	memcpy(&value, &p_bits, sizeof(value));
+	return value;
+}
+
+// Same results as the F16C and NEON conversions
+static uint16_t _float_to_half(float p_value) {
+	uint32_t x = _float_bits(p_value);
+	const uint16_t sign = (x >> 16) & 0x8000;
+	x &= 0x7fffffff;
+
+	if (x >= 0x7f800000) {
+		// Infinity, or a quiet NaN keeping the top of the mantissa
+		return sign | (x > 0x7f800000 ? 0x7e00 | ((x >> 13) & 0x3ff) : 0x7c00);
+	}
+
+	if (x >= 0x477ff000) {
+		// Rounds to a value above the largest half
+		return sign | 0x7c00;
+	}
+
+	if (x < 0x38800000) {
+		// Subnormal half, adding 0.5 lines the mantissa up and rounds it
+		return sign | (_float_bits(_bits_float(x) + 0.5f) - 0x3f000000);
+	}
+
+	// Rebias the exponent and round to nearest even
+	const uint32_t odd = (x >> 13) & 1;
+	x += 0xc8000fff + odd;
+	return sign | (x >> 13);
+}
+
+static float _half_to_float(uint16_t p_value) {
+	const uint32_t sign = uint32_t(p_value & 0x8000) << 16;
+	uint32_t bits = uint32_t(p_value & 0x7fff) << 13;
+	const uint32_t exponent = bits & 0x0f800000;
+
+	bits += 0x38000000;
+	if (exponent == 0x0f800000) {
+		// Infinity or NaN, NaNs come out quiet
+		bits += 0x38000000;
+		if (bits & 0x007fffff) {
+			bits |= 0x00400000;
+		}
+	} else if (exponent == 0) {
+		// Subnormal, renormalized by the float unit
+		bits = _float_bits(_bits_float(bits + 0x00800000) - _bits_float(0x38800000));
+	}
+
+	return _bits_float(bits | sign);
+}
+
+template <typename T> static T _pack_norm(float p_value, float p_min, float p_scale) {
+	// Comparisons with NaN are false
+	const float value = p_value == p_value ? p_value : 0.0f;
+	return T(std::nearbyint(std::min(std::max(value, p_min), 1.0f) * p_scale));
+}
+
+static uint32_t _pack_2_10_10_10(const float* p_in, float p_min, float p_scale, float p_scale_w) {
+	const uint32_t x = uint32_t(_pack_norm<int32_t>(p_in[0], p_min, p_scale)) & 0x3ff;
+	const uint32_t y = uint32_t(_pack_norm<int32_t>(p_in[1], p_min, p_scale)) & 0x3ff;
+	const uint32_t z = uint32_t(_pack_norm<int32_t>(p_in[2], p_min, p_scale)) & 0x3ff;
+	const uint32_t w = uint32_t(_pack_norm<int32_t>(p_in[3], p_min, p_scale_w)) & 0x3;
+	return x | (y << 10) | (z << 20) | (w << 30);
+}
+
+static void _pack_half_scalar(const float* p_in, uint16_t* o_out, size_t p_count) {
+	for (size_t i = 0; i < p_count; i++) {
+		o_out[i] = _float_to_half(p_in[i]);
+	}
+}
+
+static void _unpack_half_scalar(const uint16_t* p_in, float* o_out, size_t p_count) {
+	for (size_t i = 0; i < p_count; i++) {
+		o_out[i] = _half_to_float(p_in[i]);
+	}
+}
+
+template <typename T>
+static void _pack_norm_scalar(
+		const float* p_in, T* o_out, size_t p_count, float p_min, float p_scale) {
+	for (size_t i = 0; i < p_count; i++) {
+		o_out[i] = _pack_norm<T>(p_in[i], p_min, p_scale);
+	}
+}
+
+static void _pack_2_10_10_10_scalar(const float* p_in, uint32_t* o_out, size_t p_count,
+		float p_min, float p_scale, float p_scale_w) {
+	for (size_t i = 0; i < p_count; i++) {
+		o_out[i] = _pack_2_10_10_10(p_in + i * 4, p_min, p_scale, p_scale_w);
+	}
+}
+
+// ============================================================================
+// Baseline, SSE2 or NEON
+// ============================================================================
+
+#if defined(GL_SIMD_SSE)
+
+static __m128i _pack_norm_sse(__m128 p_value, __m128 p_min, __m128 p_scale) {
+	const __m128 value = _mm_and_ps(p_value, _mm_cmpeq_ps(p_value, p_value));
+	const __m128 clamped = _mm_min_ps(_mm_max_ps(value, p_min), _mm_set1_ps(1.0f));
+	return _mm_cvtps_epi32(_mm_mul_ps(clamped, p_scale));
+}
+
+// Truncates 32 bit lanes to 16 bits, SSE2 only has the signed saturating pack
+static __m128i _pack_u32_to_u16_sse(__m128i p_lo, __m128i p_hi) {
+	return _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(p_lo, 16), 16),
+			_mm_srai_epi32(_mm_slli_epi32(p_hi, 16), 16));
+}
+
+static __m128i _float_to_half_sse(__m128 p_value) {
+	const __m128i bits = _mm_castps_si128(p_value);
+	const __m128i sign = _mm_and_si128(bits, _mm_set1_epi32(int(0x80000000)));
+	const __m128i x = _mm_xor_si128(bits, sign);
+
+	const __m128i odd = _mm_and_si128(_mm_srli_epi32(x, 13), _mm_set1_epi32(1));
+	__m128i result = _mm_srli_epi32(
+			_mm_add_epi32(_mm_add_epi32(x, _mm_set1_epi32(int(0xc8000fff))), odd), 13);
+
+	const __m128i is_subnormal = _mm_cmplt_epi32(x, _mm_set1_epi32(0x38800000));
+	const __m128i subnormal = _mm_sub_epi32(
+			_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(x), _mm_set1_ps(0.5f))),
+			_mm_set1_epi32(0x3f000000));
+	result = _mm_or_si128(_mm_and_si128(is_subnormal, subnormal),
+			_mm_andnot_si128(is_subnormal, result));
+
+	const __m128i is_overflow = _mm_cmpgt_epi32(x, _mm_set1_epi32(0x477fefff));
+	result = _mm_or_si128(_mm_and_si128(is_overflow, _mm_set1_epi32(0x7c00)),
+			_mm_andnot_si128(is_overflow, result));
+
+	const __m128i is_nan = _mm_cmpgt_epi32(x, _mm_set1_epi32(0x7f800000));
+	const __m128i nan = _mm_or_si128(_mm_set1_epi32(0x7e00),
+			_mm_and_si128(_mm_srli_epi32(x, 13), _mm_set1_epi32(0x3ff)));
+	result = _mm_or_si128(_mm_and_si128(is_nan, nan), _mm_andnot_si128(is_nan, result));
+
+	return _mm_or_si128(result, _mm_srli_epi32(sign, 16));
+}
+
+static __m128 _half_to_float_sse(__m128i p_value) {
+	const __m128i sign = _mm_slli_epi32(_mm_and_si128(p_value, _mm_set1_epi32(0x8000)), 16);
+	__m128i bits = _mm_slli_epi32(_mm_and_si128(p_value, _mm_set1_epi32(0x7fff)), 13);
+	const __m128i exponent = _mm_and_si128(bits, _mm_set1_epi32(0x0f800000));
+
+	bits = _mm_add_epi32(bits, _mm_set1_epi32(0x38000000));
+
+	const __m128i is_inf_nan = _mm_cmpeq_epi32(exponent, _mm_set1_epi32(0x0f800000));
+	bits = _mm_add_epi32(bits, _mm_and_si128(is_inf_nan, _mm_set1_epi32(0x38000000)));
+
+	const __m128i mantissa = _mm_and_si128(bits, _mm_set1_epi32(0x007fffff));
+	const __m128i is_nan = _mm_andnot_si128(
+			_mm_cmpeq_epi32(mantissa, _mm_setzero_si128()), is_inf_nan);
+	bits = _mm_or_si128(bits, _mm_and_si128(is_nan, _mm_set1_epi32(0x00400000)));
+
+	const __m128i is_subnormal = _mm_cmpeq_epi32(exponent, _mm_setzero_si128());
+	const __m128i subnormal = _mm_castps_si128(
+			_mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(bits, _mm_set1_epi32(0x00800000))),
+					_mm_castsi128_ps(_mm_set1_epi32(0x38800000))));
+	bits = _mm_or_si128(_mm_and_si128(is_subnormal, subnormal),
+			_mm_andnot_si128(is_subnormal, bits));
+
+	return _mm_castsi128_ps(_mm_or_si128(bits, sign));
+}
+
+#elif defined(GL_SIMD_NEON)
+
+static int32x4_t _pack_norm_neon(float32x4_t p_value, float32x4_t p_min, float32x4_t p_scale) {
+	const float32x4_t value = vreinterpretq_f32_u32(
+			vandq_u32(vreinterpretq_u32_f32(p_value), vceqq_f32(p_value, p_value)));
+	const float32x4_t clamped = vminq_f32(vmaxq_f32(value, p_min), vdupq_n_f32(1.0f));
+	return vcvtnq_s32_f32(vmulq_f32(clamped, p_scale));
+}
+
+#endif
+
+static void _pack_half_baseline(const float* p_in, uint16_t* o_out, size_t p_count) {
+	size_t i = 0;
+
+#if defined(GL_SIMD_SSE)
+	for (; i + 8 <= p_count; i += 8) {
+		const __m128i lo = _float_to_half_sse(_mm_loadu_ps(p_in + i));
+		const __m128i hi = _float_to_half_sse(_mm_loadu_ps(p_in + i + 4));
+		_mm_storeu_si128((__m128i*)(o_out + i), _pack_u32_to_u16_sse(lo, hi));
+	}
+#elif defined(GL_SIMD_NEON)
+	for (; i + 8 <= p_count; i += 8) {
+		const float16x4_t lo = vcvt_f16_f32(vld1q_f32(p_in + i));
+		const float16x4_t hi = vcvt_f16_f32(vld1q_f32(p_in + i + 4));
+		vst1q_u16(o_out + i, vcombine_u16(vreinterpret_u16_f16(lo), vreinterpret_u16_f16(hi)));
+	}
+#endif
+
+	_pack_half_scalar(p_in + i, o_out + i, p_count - i);
+}
+
+static void _unpack_half_baseline(const uint16_t* p_in, float* o_out, size_t p_count) {
+	size_t i = 0;
+
+#if defined(GL_SIMD_SSE)
+	for (; i + 8 <= p_count; i += 8) {
+		const __m128i halves = _mm_loadu_si128((const __m128i*)(p_in + i));
+		const __m128i zero = _mm_setzero_si128();
+		_mm_storeu_ps(o_out + i, _half_to_float_sse(_mm_unpacklo_epi16(halves, zero)));
+		_mm_storeu_ps(o_out + i + 4, _half_to_float_sse(_mm_unpackhi_epi16(halves, zero)));
+	}
+#elif defined(GL_SIMD_NEON)
+	for (; i + 8 <= p_count; i += 8) {
+		const uint16x8_t halves = vld1q_u16(p_in + i);
+		vst1q_f32(o_out + i, vcvt_f32_f16(vreinterpret_f16_u16(vget_low_u16(halves))));
+		vst1q_f32(o_out + i + 4, vcvt_f32_f16(vreinterpret_f16_u16(vget_high_u16(halves))));
+	}
+#endif
+
+	_unpack_half_scalar(p_in + i, o_out + i, p_count - i);
+}
+
+// Packs 8 bit norms, `P_SIGNED` picks the saturation of the final pack
+template <bool P_SIGNED, typename T>
+static void _pack_norm8_baseline(
+		const float* p_in, T* o_out, size_t p_count, float p_min, float p_scale) {
+	size_t i = 0;
+
+#if defined(GL_SIMD_SSE)
+	const __m128 min = _mm_set1_ps(p_min);
+	const __m128 scale = _mm_set1_ps(p_scale);
+
+	for (; i + 16 <= p_count; i += 16) {
+		const __m128i a = _pack_norm_sse(_mm_loadu_ps(p_in + i), min, scale);
+		const __m128i b = _pack_norm_sse(_mm_loadu_ps(p_in + i + 4), min, scale);
+		const __m128i c = _pack_norm_sse(_mm_loadu_ps(p_in + i + 8), min, scale);
+		const __m128i d = _pack_norm_sse(_mm_loadu_ps(p_in + i + 12), min, scale);
+
+		const __m128i ab = _mm_packs_epi32(a, b);
+		const __m128i cd = _mm_packs_epi32(c, d);
+		const __m128i packed = P_SIGNED ? _mm_packs_epi16(ab, cd) : _mm_packus_epi16(ab, cd);
+		_mm_storeu_si128((__m128i*)(o_out + i), packed);
+	}
+#elif defined(GL_SIMD_NEON)
+	const float32x4_t min = vdupq_n_f32(p_min);
+	const float32x4_t scale = vdupq_n_f32(p_scale);
+
+	for (; i + 8 <= p_count; i += 8) {
+		const int32x4_t lo = _pack_norm_neon(vld1q_f32(p_in + i), min, scale);
+		const int32x4_t hi = _pack_norm_neon(vld1q_f32(p_in + i + 4), min, scale);
+		const int16x8_t wide = vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi));
+		if constexpr (P_SIGNED) {
+			vst1_s8((int8_t*)(o_out + i), vqmovn_s16(wide));
+		} else {
+			vst1_u8((uint8_t*)(o_out + i), vqmovun_s16(wide));
+		}
+	}
+#endif
+
+	_pack_norm_scalar(p_in + i, o_out + i, p_count - i, p_min, p_scale);
+}
+
+template <bool P_SIGNED, typename T>
+static void _pack_norm16_baseline(
+		const float* p_in, T* o_out, size_t p_count, float p_min, float p_scale) {
+	size_t i = 0;
+
+#if defined(GL_SIMD_SSE)
+	const __m128 min = _mm_set1_ps(p_min);
+	const __m128 scale = _mm_set1_ps(p_scale);
+
+	for (; i + 8 <= p_count; i += 8) {
+		const __m128i lo = _pack_norm_sse(_mm_loadu_ps(p_in + i), min, scale);
+		const __m128i hi = _pack_norm_sse(_mm_loadu_ps(p_in + i + 4), min, scale);
+		const __m128i packed = P_SIGNED ? _mm_packs_epi32(lo, hi) : _pack_u32_to_u16_sse(lo, hi);
+		_mm_storeu_si128((__m128i*)(o_out + i), packed);
+	}
+#elif defined(GL_SIMD_NEON)
+	const float32x4_t min = vdupq_n_f32(p_min);
+	const float32x4_t scale = vdupq_n_f32(p_scale);
+
+	for (; i + 8 <= p_count; i += 8) {
+		const int32x4_t lo = _pack_norm_neon(vld1q_f32(p_in + i), min, scale);
+		const int32x4_t hi = _pack_norm_neon(vld1q_f32(p_in + i + 4), min, scale);
+		if constexpr (P_SIGNED) {
+			vst1q_s16((int16_t*)(o_out + i), vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+		} else {
+			vst1q_u16((uint16_t*)(o_out + i), vcombine_u16(vqmovun_s32(lo), vqmovun_s32(hi)));
+		}
+	}
+#endif
+
+	_pack_norm_scalar(p_in + i, o_out + i, p_count - i, p_min, p_scale);
+}
+
+static void _pack_2_10_10_10_baseline(const float* p_in, uint32_t* o_out, size_t p_count,
+		float p_min, float p_scale, float p_scale_w) {
+	size_t i = 0;
+
+#if defined(GL_SIMD_SSE)
+	const __m128 min = _mm_set1_ps(p_min);
+	const __m128 scale = _mm_set1_ps(p_scale);
+	const __m128 scale_w = _mm_set1_ps(p_scale_w);
+	const __m128i mask = _mm_set1_epi32(0x3ff);
+
+	for (; i + 4 <= p_count; i += 4) {
+		__m128 x = _mm_loadu_ps(p_in + i * 4);
+		__m128 y = _mm_loadu_ps(p_in + i * 4 + 4);
+		__m128 z = _mm_loadu_ps(p_in + i * 4 + 8);
+		__m128 w = _mm_loadu_ps(p_in + i * 4 + 12);
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+
+		__m128i packed = _mm_and_si128(_pack_norm_sse(x, min, scale), mask);
+		packed = _mm_or_si128(packed,
+				_mm_slli_epi32(_mm_and_si128(_pack_norm_sse(y, min, scale), mask), 10));
+		packed = _mm_or_si128(packed,
+				_mm_slli_epi32(_mm_and_si128(_pack_norm_sse(z, min, scale), mask), 20));
+		packed = _mm_or_si128(packed, _mm_slli_epi32(_pack_norm_sse(w, min, scale_w), 30));
+		_mm_storeu_si128((__m128i*)(o_out + i), packed);
+	}
+#elif defined(GL_SIMD_NEON)
+	const float32x4_t min = vdupq_n_f32(p_min);
+	const float32x4_t scale = vdupq_n_f32(p_scale);
+	const float32x4_t scale_w = vdupq_n_f32(p_scale_w);
+	const uint32x4_t mask = vdupq_n_u32(0x3ff);
+
+	for (; i + 4 <= p_count; i += 4) {
+		const float32x4x4_t v = vld4q_f32(p_in + i * 4);
+
+		const uint32x4_t x = vreinterpretq_u32_s32(_pack_norm_neon(v.val[0], min, scale));
+		const uint32x4_t y = vreinterpretq_u32_s32(_pack_norm_neon(v.val[1], min, scale));
+		const uint32x4_t z = vreinterpretq_u32_s32(_pack_norm_neon(v.val[2], min, scale));
+		const uint32x4_t w = vreinterpretq_u32_s32(_pack_norm_neon(v.val[3], min, scale_w));
+
+		uint32x4_t packed = vandq_u32(x, mask);
+		packed = vorrq_u32(packed, vshlq_n_u32(vandq_u32(y, mask), 10));
+		packed = vorrq_u32(packed, vshlq_n_u32(vandq_u32(z, mask), 20));
+		packed = vorrq_u32(packed, vshlq_n_u32(w, 30));
+		vst1q_u32(o_out + i, packed);
+	}
+#endif
+
+	_pack_2_10_10_10_scalar(
+			p_in + i * 4, o_out + i, p_count - i, p_min, p_scale, p_scale_w);
+}
+
+// ============================================================================
+// AVX2, only the F16C half conversions. The integer packs stay at 128 bits
+// where the saturating packs do not cross lanes.
+// ============================================================================
+
+#if defined(GL_SIMD_SSE)
+
+GL_SIMD_TARGET_F16C static void _pack_half_f16c(
+		const float* p_in, uint16_t* o_out, size_t p_count) {
+	size_t i = 0;
+	for (; i + 16 <= p_count; i += 16) {
+		const __m128i lo = _mm256_cvtps_ph(_mm256_loadu_ps(p_in + i), _MM_FROUND_TO_NEAREST_INT);
+		const __m128i hi =
+				_mm256_cvtps_ph(_mm256_loadu_ps(p_in + i + 8), _MM_FROUND_TO_NEAREST_INT);
+		_mm_storeu_si128((__m128i*)(o_out + i), lo);
+		_mm_storeu_si128((__m128i*)(o_out + i + 8), hi);
+	}
+
+	_pack_half_baseline(p_in + i, o_out + i, p_count - i);
+}
+
+GL_SIMD_TARGET_F16C static void _unpack_half_f16c(
+		const uint16_t* p_in, float* o_out, size_t p_count) {
+	size_t i = 0;
+	for (; i + 16 <= p_count; i += 16) {
+		const __m128i lo = _mm_loadu_si128((const __m128i*)(p_in + i));
+		const __m128i hi = _mm_loadu_si128((const __m128i*)(p_in + i + 8));
+		_mm256_storeu_ps(o_out + i, _mm256_cvtph_ps(lo));
+		_mm256_storeu_ps(o_out + i + 8, _mm256_cvtph_ps(hi));
+	}
+
+	_unpack_half_baseline(p_in + i, o_out + i, p_count - i);
+}
+
+#endif
+
+// ============================================================================
+// Dispatch
+// ============================================================================
+
+// Largest values of the normalized integer formats
+constexpr float UNORM8_MAX = 255.0f;
+constexpr float SNORM8_MAX = 127.0f;
+constexpr float UNORM16_MAX = 65535.0f;
+constexpr float SNORM16_MAX = 32767.0f;
+constexpr float UNORM10_MAX = 1023.0f;
+constexpr float SNORM10_MAX = 511.0f;
+constexpr float UNORM2_MAX = 3.0f;
+constexpr float SNORM2_MAX = 1.0f;
+
+void pack_half(const float* p_in, uint16_t* o_out, size_t p_count) {
+	switch (simd_get_level()) {
+#if defined(GL_SIMD_SSE)
+		case SimdLevel::AVX2:
+			_pack_half_f16c(p_in, o_out, p_count);
+			return;
+#endif
+		case SimdLevel::SCALAR:
+			_pack_half_scalar(p_in, o_out, p_count);
+			return;
+		default:
+			_pack_half_baseline(p_in, o_out, p_count);
+			return;
+	}
+}
+
+void unpack_half(const uint16_t* p_in, float* o_out, size_t p_count) {
+	switch (simd_get_level()) {
+#if defined(GL_SIMD_SSE)
+		case SimdLevel::AVX2:
+			_unpack_half_f16c(p_in, o_out, p_count);
+			return;
+#endif
+		case SimdLevel::SCALAR:
+			_unpack_half_scalar(p_in, o_out, p_count);
+			return;
+		default:
+			_unpack_half_baseline(p_in, o_out, p_count);
+			return;
+	}
+}
+
+void pack_unorm8(const float* p_in, uint8_t* o_out, size_t p_count) {
+	if (simd_get_level() == SimdLevel::SCALAR) {
+		_pack_norm_scalar(p_in, o_out, p_count, 0.0f, UNORM8_MAX);
+	} else {
+		_pack_norm8_baseline<false>(p_in, o_out, p_count, 0.0f, UNORM8_MAX);
+	}
+}
+
+void pack_snorm8(const float* p_in, int8_t* o_out, size_t p_count) {
+	if (simd_get_level() == SimdLevel::SCALAR) {
+		_pack_norm_scalar(p_in, o_out, p_count, -1.0f, SNORM8_MAX);
+	} else {
+		_pack_norm8_baseline<true>(p_in, o_out, p_count, -1.0f, SNORM8_MAX);
+	}
+}
+
+void pack_unorm16(const float* p_in, uint16_t* o_out, size_t p_count) {
+	if (simd_get_level() == SimdLevel::SCALAR) {
+		_pack_norm_scalar(p_in, o_out, p_count, 0.0f, UNORM16_MAX);
+	} else {
+		_pack_norm16_baseline<false>(p_in, o_out, p_count, 0.0f, UNORM16_MAX);
+	}
+}
+
+void pack_snorm16(const float* p_in, int16_t* o_out, size_t p_count) {
+	if (simd_get_level() == SimdLevel::SCALAR) {
+		_pack_norm_scalar(p_in, o_out, p_count, -1.0f, SNORM16_MAX);
+	} else {
+		_pack_norm16_baseline<true>(p_in, o_out, p_count, -1.0f, SNORM16_MAX);
+	}
+}
+
+void pack_unorm_2_10_10_10(const float* p_in, uint32_t* o_out, size_t p_count) {
+	if (simd_get_level() == SimdLevel::SCALAR) {
+		_pack_2_10_10_10_scalar(p_in, o_out, p_count, 0.0f, UNORM10_MAX, UNORM2_MAX);
+	} else {
+		_pack_2_10_10_10_baseline(p_in, o_out, p_count, 0.0f, UNORM10_MAX, UNORM2_MAX);
+	}
+}
+
+void pack_snorm_2_10_10_10(const float* p_in, uint32_t* o_out, size_t p_count) {
+	if (simd_get_level() == SimdLevel::SCALAR) {
+		_pack_2_10_10_10_scalar(p_in, o_out, p_count, -1.0f, SNORM10_MAX, SNORM2_MAX);
+	} else {
+		_pack_2_10_10_10_baseline(p_in, o_out, p_count, -1.0f, SNORM10_MAX, SNORM2_MAX);
+	}
+}
+
+size_t pack_to_format(DataFormat p_format, const float* p_in, size_t p_count, void* o_out) {
+	switch (p_format) {
+		case DataFormat::R8_UNORM:
+		case DataFormat::R8G8_UNORM:
+		case DataFormat::R8G8B8_UNORM:
+		case DataFormat::R8G8B8A8_UNORM:
+		case DataFormat::A8B8G8R8_UNORM_PACK32:
+			pack_unorm8(p_in, (uint8_t*)o_out, p_count);
+			return p_count;
+		case DataFormat::R8_SNORM:
+		case DataFormat::R8G8_SNORM:
+		case DataFormat::R8G8B8_SNORM:
+		case DataFormat::R8G8B8A8_SNORM:
+		case DataFormat::A8B8G8R8_SNORM_PACK32:
+			pack_snorm8(p_in, (int8_t*)o_out, p_count);
+			return p_count;
+		case DataFormat::R16_UNORM:
+		case DataFormat::R16G16_UNORM:
+		case DataFormat::R16G16B16_UNORM:
+		case DataFormat::R16G16B16A16_UNORM:
+			pack_unorm16(p_in, (uint16_t*)o_out, p_count);
+			return p_count * sizeof(uint16_t);
+		case DataFormat::R16_SNORM:
+		case DataFormat::R16G16_SNORM:
+		case DataFormat::R16G16B16_SNORM:
+		case DataFormat::R16G16B16A16_SNORM:
+			pack_snorm16(p_in, (int16_t*)o_out, p_count);
+			return p_count * sizeof(int16_t);
+		case DataFormat::R16_SFLOAT:
+		case DataFormat::R16G16_SFLOAT:
+		case DataFormat::R16G16B16_SFLOAT:
+		case DataFormat::R16G16B16A16_SFLOAT:
+			pack_half(p_in, (uint16_t*)o_out, p_count);
+			return p_count * sizeof(uint16_t);
+		case DataFormat::R32_SFLOAT:
+		case DataFormat::R32G32_SFLOAT:
+		case DataFormat::R32G32B32_SFLOAT:
+		case DataFormat::R32G32B32A32_SFLOAT:
+			memcpy(o_out, p_in, p_count * sizeof(float));
+			return p_count * sizeof(float);
+		case DataFormat::A2B10G10R10_UNORM_PACK32:
+			GL_ASSERT(p_count % 4 == 0, "Packed formats take whole xyzw vectors.");
+			pack_unorm_2_10_10_10(p_in, (uint32_t*)o_out, p_count / 4);
+			return p_count / 4 * sizeof(uint32_t);
+		case DataFormat::A2B10G10R10_SNORM_PACK32:
+			GL_ASSERT(p_count % 4 == 0, "Packed formats take whole xyzw vectors.");
+			pack_snorm_2_10_10_10(p_in, (uint32_t*)o_out, p_count / 4);
+			return p_count / 4 * sizeof(uint32_t);
+		default:
+			return 0;
+	}
+}
+
+} //namespace gl
@@ -0,0 +1,578 @@
+#include "glgpu/null_backend.h"
+
+namespace gl {
+
+NullRenderBackend::NullRenderBackend(const RenderBackendCreateInfo& p_info) {
+	imm_command_pool = command_pool_create(queue_get(QueueType::GRAPHICS));
+	imm_command_buffer = command_pool_allocate(imm_command_pool);
+}
+
+NullRenderBackend::~NullRenderBackend() {
+	command_pool_free(imm_command_pool);
+
+	if (live_resource_count > 0) {
+		GL_LOG_WARNING("[NULL] {} resources were not freed before the backend got destroyed.",
+				live_resource_count);
+	}
+}
+
+const NullRenderBackend::NullCommandBuffer& NullRenderBackend::get_command_buffer(
+		CommandBuffer p_cmd) const {
+	return *_get<NullCommandBuffer>(p_cmd);
+}
+
+const std::vector<NullSubmission>& NullRenderBackend::get_submissions() const {
+	return submissions;
+}
+
+void NullRenderBackend::clear_submissions() { submissions.clear(); }
+
+std::string NullRenderBackend::get_object_name(const void* p_handle) const {
+	const auto it = object_names.find(p_handle);
+	return it != object_names.end() ? it->second : "";
+}
+
+uint64_t NullRenderBackend::get_live_resource_count() const { return live_resource_count; }
+
+// =============================================================================
+// Device & Surface
+// =============================================================================
+
+void NullRenderBackend::device_wait() {}
+
+Error NullRenderBackend::attach_surface(void* p_connection_handle, void* p_window_handle) {
+	return Error::NONE;
+}
+
+bool NullRenderBackend::is_swapchain_supported() { return true; }
+
+CommandQueue NullRenderBackend::queue_get(QueueType p_type) {
+	switch (p_type) {
+		case QueueType::PRESENT:
+			return CommandQueue(&present_queue);
+		case QueueType::TRANSFER:
+			return CommandQueue(&transfer_queue);
+		case QueueType::COMPUTE:
+			return CommandQueue(&compute_queue);
+		case QueueType::GRAPHICS:
+		default:
+			return CommandQueue(&graphics_queue);
+	}
+}
+
+uint32_t NullRenderBackend::get_max_msaa_samples() const { return 8; }
+
+FrameStats NullRenderBackend::get_frame_stats() const { return stats; }
+
+void NullRenderBackend::reset_frame_stats() {
+	const uint64_t descriptor_pools_live = stats.descriptor_pools_live;
+	stats = {};
+	stats.descriptor_pools_live = descriptor_pools_live;
+}
+
+// =============================================================================
+// Swapchain
+// =============================================================================
+
+Swapchain NullRenderBackend::swapchain_create() {
+	NullSwapchain* swapchain = _allocate<NullSwapchain>();
+	return handles.insert<Swapchain>(swapchain);
+}
+
+void NullRenderBackend::swapchain_resize(
+		CommandQueue p_cmd_queue, Swapchain p_swapchain, const SwapchainCreateInfo& p_info) {
+	NullSwapchain* swapchain = _get<NullSwapchain>(p_swapchain);
+
+	// Triple buffering like most presentation engines hand out
+	constexpr uint32_t DEFAULT_IMAGE_COUNT = 3;
+
+	swapchain->extent = p_info.size;
+	swapchain->present_mode = p_info.present_mode;
+	swapchain->image_index = 0;
+
+	_swapchain_release_images(swapchain);
+
+	swapchain->images.resize(p_info.image_count > 0 ? p_info.image_count : DEFAULT_IMAGE_COUNT);
+	for (NullImage& image : swapchain->images) {
+		image.format = swapchain->format;
+		image.size = { p_info.size.x, p_info.size.y, 1 };
+		image.usage = IMAGE_USAGE_COLOR_ATTACHMENT_BIT | IMAGE_USAGE_TRANSFER_DST_BIT;
+
+		swapchain->image_handles.push_back(handles.insert<Image>(&image));
+	}
+}
+
+size_t NullRenderBackend::swapchain_get_image_count(Swapchain p_swapchain) {
+	NullSwapchain* swapchain = _get<NullSwapchain>(p_swapchain);
+	return swapchain->images.size();
+}
+
+std::vector<Image> NullRenderBackend::swapchain_get_images(Swapchain p_swapchain) {
+	NullSwapchain* swapchain = _get<NullSwapchain>(p_swapchain);
+	return swapchain->image_handles;
+}
+
+Result<Image, Error> NullRenderBackend::swapchain_acquire_image(Swapchain p_swapchain,
+		Semaphore p_semaphore, uint64_t p_timeout, uint32_t* o_image_index) {
+	NullSwapchain* swapchain = _get<NullSwapchain>(p_swapchain);
+
+	if (swapchain->images.empty()) {
+		return make_err<Image>(Error::SWAPCHAIN_OUT_OF_DATE);
+	}
+
+	if (p_semaphore) {
+		_get<NullSemaphore>(p_semaphore)->signal_count++;
+	}
+
+	const uint32_t image_index = swapchain->image_index;
+	swapchain->image_index = (swapchain->image_index + 1) % swapchain->images.size();
+
+	if (o_image_index) {
+		*o_image_index = image_index;
+	}
+
+	return swapchain->image_handles[image_index];
+}
+
+Vec2u NullRenderBackend::swapchain_get_extent(Swapchain p_swapchain) {
+	NullSwapchain* swapchain = _get<NullSwapchain>(p_swapchain);
+	return swapchain->extent;
+}
+
+DataFormat NullRenderBackend::swapchain_get_format(Swapchain p_swapchain) {
+	NullSwapchain* swapchain = _get<NullSwapchain>(p_swapchain);
+	return swapchain->format;
+}
+
+bool NullRenderBackend::swapchain_pop_frame(Swapchain p_swapchain, SwapchainFrame* o_frame) {
+	// Nothing is rendered, there are no pixels to read back
+	return false;
+}
+
+void NullRenderBackend::swapchain_free(Swapchain p_swapchain) {
+	if (!p_swapchain) {
+		return;
+	}
+
+	_swapchain_release_images(_get<NullSwapchain>(p_swapchain));
+	_free<NullSwapchain>(p_swapchain);
+}
+
+void NullRenderBackend::_swapchain_release_images(NullSwapchain* p_swapchain) {
+	// Images handed out before are stale from now on
+	for (Image image : p_swapchain->image_handles) {
+		object_names.erase(image);
+		handles.remove(image);
+	}
+
+	p_swapchain->image_handles.clear();
+}
+
+// =============================================================================
+// Resource Management (Buffers & Images)
+// =============================================================================
+
+Buffer NullRenderBackend::buffer_create(
+		uint64_t p_size, BufferUsageFlags p_usage, MemoryAllocationType p_allocation_type) {
+	NullBuffer* buffer = _allocate<NullBuffer>();
+	buffer->size = p_size;
+	buffer->usage = p_usage;
+	buffer->allocation_type = p_allocation_type;
+
+	return handles.insert<Buffer>(buffer);
+}
+
+void NullRenderBackend::buffer_free(Buffer p_buffer) {
+	if (!p_buffer) {
+		return;
+	}
+
+	_free<NullBuffer>(p_buffer);
+}
+
+BufferDeviceAddress NullRenderBackend::buffer_get_device_address(Buffer p_buffer) {
+	// Unique and stable for the lifetime of the buffer
+	return BufferDeviceAddress(p_buffer);
+}
+
+uint8_t* NullRenderBackend::buffer_map(Buffer p_buffer) {
+	NullBuffer* buffer = _get<NullBuffer>(p_buffer);
+
+	if (buffer->data.size() != buffer->size) {
+		buffer->data.resize(buffer->size);
+	}
+
+	return buffer->data.data();
+}
+
+void NullRenderBackend::buffer_unmap(Buffer p_buffer) {}
+
+void NullRenderBackend::buffer_invalidate(Buffer p_buffer) {}
+
+void NullRenderBackend::buffer_flush(Buffer p_buffer) {}
+
+Image NullRenderBackend::image_create(const ImageCreateInfo& p_info) {
+	NullImage* image = _allocate<NullImage>();
+	image->format = p_info.format;
+	image->size = { p_info.size.x, p_info.size.y, 1 };
+	image->usage = p_info.usage;
+	image->samples = p_info.samples;
+	// A zero extent still gets its single level instead of log2(0)
+	const uint32_t largest_side = std::max({ p_info.size.x, p_info.size.y, 1u });
+	image->mip_levels = p_info.mipmapped
+			? static_cast<uint32_t>(std::floor(std::log2(largest_side))) + 1
+			: 1;
+
+	if (p_info.data) {
+		// Initial data goes through a staging copy on real backends
+		stats.bytes_copied +=
+				uint64_t(p_info.size.x) * p_info.size.y * get_data_format_size(p_info.format);
+	}
+
+	return handles.insert<Image>(image);
+}
+
+void NullRenderBackend::image_free(Image p_image) {
+	if (!p_image) {
+		return;
+	}
+
+	_free<NullImage>(p_image);
+}
+
+Vec3u NullRenderBackend::image_get_size(Image p_image) {
+	NullImage* image = _get<NullImage>(p_image);
+	return image->size;
+}
+
+DataFormat NullRenderBackend::image_get_format(Image p_image) {
+	NullImage* image = _get<NullImage>(p_image);
+	return image->format;
+}
+
+uint32_t NullRenderBackend::image_get_mip_levels(Image p_image) {
+	NullImage* image = _get<NullImage>(p_image);
+	return image->mip_levels;
+}
+
+Sampler NullRenderBackend::sampler_create(const SamplerCreateInfo& p_info) {
+	NullSampler* sampler = _allocate<NullSampler>();
+	sampler->info = p_info;
+
+	return handles.insert<Sampler>(sampler);
+}
+
+void NullRenderBackend::sampler_free(Sampler p_sampler) {
+	if (!p_sampler) {
+		return;
+	}
+
+	_free<NullSampler>(p_sampler);
+}
+
+// =============================================================================
+// Shader & Pipelines
+// =============================================================================
+
+Shader NullRenderBackend::shader_create_from_bytecode(const std::vector<SpirvEntry>& p_shaders) {
+	NullShader* shader = _allocate<NullShader>();
+	for (const SpirvEntry& entry : p_shaders) {
+		shader->stages.push_back(entry.stage);
+		shader->byte_code_size += entry.byte_code.size() * sizeof(uint32_t);
+	}
+
+	return handles.insert<Shader>(shader);
+}
+
+void NullRenderBackend::shader_free(Shader p_shader) {
+	if (!p_shader) {
+		return;
+	}
+
+	_free<NullShader>(p_shader);
+}
+
+std::vector<ShaderInterfaceVariable> NullRenderBackend::shader_get_vertex_inputs(
+		Shader p_shader) {
+	// No reflection is done without a driver
+	return {};
+}
+
+Pipeline NullRenderBackend::render_pipeline_create(const RenderPipelineCreateInfo& p_info) {
+	NullPipeline* pipeline = _allocate<NullPipeline>();
+	pipeline->shader = p_info.shader;
+	pipeline->type = PipelineType::GRAPHICS;
+
+	return handles.insert<Pipeline>(pipeline);
+}
+
+Pipeline NullRenderBackend::compute_pipeline_create(Shader p_shader) {
+	NullPipeline* pipeline = _allocate<NullPipeline>();
+	pipeline->shader = p_shader;
+	pipeline->type = PipelineType::COMPUTE;
+
+	return handles.insert<Pipeline>(pipeline);
+}
+
+void NullRenderBackend::pipeline_free(Pipeline p_pipeline) {
+	if (!p_pipeline) {
+		return;
+	}
+
+	_free<NullPipeline>(p_pipeline);
+}
+
+UniformSet NullRenderBackend::uniform_set_create(
+		std::vector<ShaderUniform> p_uniforms, Shader p_shader, uint32_t p_set_index) {
+	NullUniformSet* uniform_set = _allocate<NullUniformSet>();
+	uniform_set->shader = p_shader;
+	uniform_set->set_index = p_set_index;
+	uniform_set->uniforms = std::move(p_uniforms);
+
+	return handles.insert<UniformSet>(uniform_set);
+}
+
+void NullRenderBackend::uniform_set_free(UniformSet p_uniform_set) {
+	if (!p_uniform_set) {
+		return;
+	}
+
+	_free<NullUniformSet>(p_uniform_set);
+}
+
+// =============================================================================
+// Render Pass & Framebuffer
+// =============================================================================
+
+RenderPass NullRenderBackend::render_pass_create(
+		std::vector<RenderPassAttachment> p_attachments, std::vector<SubpassInfo> p_subpasses) {
+	NullRenderPass* render_pass = _allocate<NullRenderPass>();
+	render_pass->attachments = std::move(p_attachments);
+	render_pass->subpasses = std::move(p_subpasses);
+
+	return handles.insert<RenderPass>(render_pass);
+}
+
+void NullRenderBackend::render_pass_destroy(RenderPass p_render_pass) {
+	if (!p_render_pass) {
+		return;
+	}
+
+	_free<NullRenderPass>(p_render_pass);
+}
+
+FrameBuffer NullRenderBackend::frame_buffer_create(
+		RenderPass p_render_pass, std::vector<Image> p_attachments, const Vec2u& p_extent) {
+	NullFrameBuffer* frame_buffer = _allocate<NullFrameBuffer>();
+	frame_buffer->render_pass = p_render_pass;
+	frame_buffer->attachments = std::move(p_attachments);
+	frame_buffer->extent = p_extent;
+
+	return handles.insert<FrameBuffer>(frame_buffer);
+}
+
+void NullRenderBackend::frame_buffer_destroy(FrameBuffer p_frame_buffer) {
+	if (!p_frame_buffer) {
+		return;
+	}
+
+	_free<NullFrameBuffer>(p_frame_buffer);
+}
+
+// =============================================================================
+// Synchronization
+// =============================================================================
+
+Fence NullRenderBackend::fence_create(bool p_create_signaled) {
+	NullFence* fence = _allocate<NullFence>();
+	fence->signaled = p_create_signaled;
+
+	return handles.insert<Fence>(fence);
+}
+
+void NullRenderBackend::fence_free(Fence p_fence) {
+	if (!p_fence) {
+		return;
+	}
+
+	_free<NullFence>(p_fence);
+}
+
+void NullRenderBackend::fence_wait(Fence p_fence) {
+	NullFence* fence = _get<NullFence>(p_fence);
+
+	// Every submission completes immediately, waiting on a fence that was never
+	// submitted would deadlock on a real device.
+	GL_ASSERT(fence->signaled, "Waiting on a fence that will never be signaled");
+}
+
+void NullRenderBackend::fence_reset(Fence p_fence) {
+	NullFence* fence = _get<NullFence>(p_fence);
+	fence->signaled = false;
+}
+
+Semaphore NullRenderBackend::semaphore_create() {
+	NullSemaphore* semaphore = _allocate<NullSemaphore>();
+	return handles.insert<Semaphore>(semaphore);
+}
+
+void NullRenderBackend::semaphore_free(Semaphore p_semaphore) {
+	if (!p_semaphore) {
+		return;
+	}
+
+	_free<NullSemaphore>(p_semaphore);
+}
+
+// =============================================================================
+// Queries
+// =============================================================================
+
+QueryPool NullRenderBackend::query_pool_create(QueryType p_type, uint32_t p_query_count) {
+	NullQueryPool* query_pool = _allocate<NullQueryPool>();
+	query_pool->type = p_type;
+	query_pool->query_count = p_query_count;
+
+	return handles.insert<QueryPool>(query_pool);
+}
+
+void NullRenderBackend::query_pool_free(QueryPool p_query_pool) {
+	if (!p_query_pool) {
+		return;
+	}
+
+	_free<NullQueryPool>(p_query_pool);
+}
+
+bool NullRenderBackend::query_pool_get_results(QueryPool p_query_pool, uint32_t p_first_query,
+		uint32_t p_query_count, uint64_t* o_results) {
+	NullQueryPool* query_pool = _get<NullQueryPool>(p_query_pool);
+
+	GL_ASSERT(p_first_query + p_query_count <= query_pool->query_count,
+			"Query range exceeds the size of the pool");
+
+	memset(o_results, 0,
+			p_query_count * get_query_result_count(query_pool->type) * sizeof(uint64_t));
+
+	return true;
+}
+
+float NullRenderBackend::get_timestamp_period() const {
+	// Timestamps are meaningless without a device
+	return 0.0f;
+}
+
+uint32_t NullRenderBackend::get_timestamp_valid_bits() const { return 64; }
+
+bool NullRenderBackend::is_pipeline_statistics_supported() const { return true; }
+
+// =============================================================================
+// Debugging
+// =============================================================================
+
+void NullRenderBackend::_set_name(const void* p_handle, const char* p_name) {
+	if (!p_handle) {
+		return;
+	}
+
+	object_names[p_handle] = p_name;
+}
+
+void NullRenderBackend::buffer_set_name(Buffer p_buffer, const char* p_name) {
+	_set_name(p_buffer, p_name);
+}
+
+void NullRenderBackend::image_set_name(Image p_image, const char* p_name) {
+	_set_name(p_image, p_name);
+}
+
+void NullRenderBackend::sampler_set_name(Sampler p_sampler, const char* p_name) {
+	_set_name(p_sampler, p_name);
+}
+
+void NullRenderBackend::command_pool_set_name(CommandPool p_command_pool, const char* p_name) {
+	_set_name(p_command_pool, p_name);
+}
+
+void NullRenderBackend::command_buffer_set_name(
+		CommandBuffer p_command_buffer, const char* p_name) {
+	_set_name(p_command_buffer, p_name);
+}
+
+void NullRenderBackend::queue_set_name(CommandQueue p_queue, const char* p_name) {
+	_set_name(p_queue, p_name);
+}
+
+void NullRenderBackend::render_pass_set_name(RenderPass p_render_pass, const char* p_name) {
+	_set_name(p_render_pass, p_name);
+}
+
+void NullRenderBackend::frame_buffer_set_name(FrameBuffer p_frame_buffer, const char* p_name) {
+	_set_name(p_frame_buffer, p_name);
+}
+
+void NullRenderBackend::swapchain_set_name(Swapchain p_swapchain, const char* p_name) {
+	_set_name(p_swapchain, p_name);
+}
+
+void NullRenderBackend::pipeline_set_name(Pipeline p_pipeline, const char* p_name) {
+	_set_name(p_pipeline, p_name);
+}
+
+void NullRenderBackend::shader_set_name(Shader p_shader, const char* p_name) {
+	_set_name(p_shader, p_name);
+}
+
+void NullRenderBackend::uniform_set_set_name(UniformSet p_uniform_set, const char* p_name) {
+	_set_name(p_uniform_set, p_name);
+}
+
+void NullRenderBackend::fence_set_name(Fence p_fence, const char* p_name) {
+	_set_name(p_fence, p_name);
+}
+
+void NullRenderBackend::semaphore_set_name(Semaphore p_semaphore, const char* p_name) {
+	_set_name(p_semaphore, p_name);
+}
+
+void NullRenderBackend::query_pool_set_name(QueryPool p_query_pool, const char* p_name) {
+	_set_name(p_query_pool, p_name);
+}
+
+// =============================================================================
+// Command Submission
+// =============================================================================
+
+void NullRenderBackend::queue_submit(CommandQueue p_queue, CommandBuffer p_cmd, Fence p_fence,
+		Semaphore p_wait_semaphore, Semaphore p_signal_semaphore) {
+	NullCommandBuffer* command_buffer = _get<NullCommandBuffer>(p_cmd);
+
+	GL_ASSERT(!command_buffer->recording, "Submitting a command buffer that is still recording");
+
+	NullSubmission submission = {};
+	submission.queue = p_queue;
+	submission.command_buffer = p_cmd;
+	submission.fence = p_fence;
+	submission.wait_semaphore = p_wait_semaphore;
+	submission.signal_semaphore = p_signal_semaphore;
+	submission.command_count = static_cast<uint32_t>(command_buffer->commands.size());
+
+	submissions.push_back(submission);
+
+	stats.submits++;
+
+	// Work completes as soon as it is submitted
+	if (p_signal_semaphore) {
+		_get<NullSemaphore>(p_signal_semaphore)->signal_count++;
+	}
+	if (p_fence) {
+		_get<NullFence>(p_fence)->signaled = true;
+	}
+}
+
+bool NullRenderBackend::queue_present(
+		CommandQueue p_queue, Swapchain p_swapchain, Semaphore p_wait_semaphore) {
+	return true;
+}
+
+} //namespace gl
@@ -0,0 +1,551 @@
+#include "glgpu/null_backend.h"
+
+namespace gl {
+
+const char* get_null_command_name(NullCommandType p_type) {
+	switch (p_type) {
+		case NullCommandType::BEGIN_RENDER_PASS:
+			return "begin_render_pass";
+		case NullCommandType::END_RENDER_PASS:
+			return "end_render_pass";
+		case NullCommandType::BEGIN_RENDERING:
+			return "begin_rendering";
+		case NullCommandType::END_RENDERING:
+			return "end_rendering";
+		case NullCommandType::BIND_GRAPHICS_PIPELINE:
+			return "bind_graphics_pipeline";
+		case NullCommandType::BIND_COMPUTE_PIPELINE:
+			return "bind_compute_pipeline";
+		case NullCommandType::BIND_VERTEX_BUFFERS:
+			return "bind_vertex_buffers";
+		case NullCommandType::BIND_INDEX_BUFFER:
+			return "bind_index_buffer";
+		case NullCommandType::BIND_UNIFORM_SETS:
+			return "bind_uniform_sets";
+		case NullCommandType::PUSH_CONSTANTS:
+			return "push_constants";
+		case NullCommandType::DRAW:
+			return "draw";
+		case NullCommandType::DRAW_INDEXED:
+			return "draw_indexed";
+		case NullCommandType::DRAW_INDEXED_INDIRECT:
+			return "draw_indexed_indirect";
+		case NullCommandType::DISPATCH:
+			return "dispatch";
+		case NullCommandType::SET_VIEWPORT:
+			return "set_viewport";
+		case NullCommandType::SET_SCISSOR:
+			return "set_scissor";
+		case NullCommandType::SET_DEPTH_BIAS:
+			return "set_depth_bias";
+		case NullCommandType::CLEAR_COLOR:
+			return "clear_color";
+		case NullCommandType::COPY_BUFFER:
+			return "copy_buffer";
+		case NullCommandType::BUFFER_MEMORY_BARRIER:
+			return "buffer_memory_barrier";
+		case NullCommandType::COPY_BUFFER_TO_IMAGE:
+			return "copy_buffer_to_image";
+		case NullCommandType::COPY_IMAGE_TO_BUFFER:
+			return "copy_image_to_buffer";
+		case NullCommandType::COPY_IMAGE_TO_IMAGE:
+			return "copy_image_to_image";
+		case NullCommandType::TRANSITION_IMAGE:
+			return "transition_image";
+		case NullCommandType::RESET_QUERY_POOL:
+			return "reset_query_pool";
+		case NullCommandType::WRITE_TIMESTAMP:
+			return "write_timestamp";
+		case NullCommandType::BEGIN_QUERY:
+			return "begin_query";
+		case NullCommandType::END_QUERY:
+			return "end_query";
+		case NullCommandType::BEGIN_LABEL:
+			return "begin_label";
+		case NullCommandType::END_LABEL:
+			return "end_label";
+		default:
+			return "unknown";
+	}
+}
+
+static uint64_t _float_bits(float p_value) {
+	uint32_t bits;
+	memcpy(&bits, &p_value, sizeof(float));
+	return bits;
+}
+
+NullRenderBackend::NullCommandBuffer* NullRenderBackend::_get_recording_command_buffer(
+		CommandBuffer p_cmd) {
+	NullCommandBuffer* command_buffer = _get<NullCommandBuffer>(p_cmd);
+
+	GL_ASSERT(command_buffer->recording, "Recording into a command buffer that has not begun");
+	return command_buffer;
+}
+
+NullCommand& NullRenderBackend::_record(CommandBuffer p_cmd, NullCommandType p_type,
+		std::initializer_list<const void*> p_handles) {
+	NullCommandBuffer* command_buffer = _get_recording_command_buffer(p_cmd);
+
+	NullCommand& command = command_buffer->commands.emplace_back();
+	command.type = p_type;
+	command.handle_offset = static_cast<uint32_t>(command_buffer->handles.size());
+	command.handle_count = static_cast<uint32_t>(p_handles.size());
+
+	command_buffer->handles.insert(command_buffer->handles.end(), p_handles);
+
+	return command;
+}
+
+void NullRenderBackend::command_immediate_submit(
+		std::function<void(CommandBuffer p_cmd)>&& p_function, QueueType p_queue_type) {
+	command_reset(imm_command_buffer);
+
+	command_begin(imm_command_buffer);
+	{
+		p_function(imm_command_buffer);
+	}
+	command_end(imm_command_buffer);
+
+	queue_submit((p_queue_type == QueueType::TRANSFER) ? queue_get(QueueType::TRANSFER)
+													   : queue_get(QueueType::GRAPHICS),
+			imm_command_buffer);
+}
+
+CommandPool NullRenderBackend::command_pool_create(CommandQueue p_queue) {
+	NullCommandPool* command_pool = _allocate<NullCommandPool>();
+	command_pool->queue = p_queue;
+
+	return handles.insert<CommandPool>(command_pool);
+}
+
+void NullRenderBackend::command_pool_free(CommandPool p_command_pool) {
+	if (!p_command_pool) {
+		return;
+	}
+
+	NullCommandPool* command_pool = _get<NullCommandPool>(p_command_pool);
+
+	// Command buffers are owned by their pool, same as in Vulkan
+	for (CommandBuffer cmd : command_pool->command_buffers) {
+		live_resource_count--;
+		object_names.erase(cmd);
+
+		_get_allocator<NullCommandBuffer>().free((NullCommandBuffer*)handles.remove(cmd));
+	}
+
+	_free<NullCommandPool>(p_command_pool);
+}
+
+CommandBuffer NullRenderBackend::command_pool_allocate(CommandPool p_command_pool) {
+	NullCommandPool* command_pool = _get<NullCommandPool>(p_command_pool);
+
+	// Not reported through `FrameStats`, matching the Vulkan backend which
+	// does not count command buffers as resources.
+	NullCommandBuffer* command_buffer = _get_allocator<NullCommandBuffer>().alloc();
+	command_buffer->pool = p_command_pool;
+	live_resource_count++;
+
+	const CommandBuffer cmd = handles.insert<CommandBuffer>(command_buffer);
+	command_pool->command_buffers.push_back(cmd);
+
+	return cmd;
+}
+
+std::vector<CommandBuffer> NullRenderBackend::command_pool_allocate(
+		CommandPool p_command_pool, const uint32_t p_count) {
+	std::vector<CommandBuffer> command_buffers(p_count);
+	for (uint32_t i = 0; i < p_count; i++) {
+		command_buffers[i] = command_pool_allocate(p_command_pool);
+	}
+
+	return command_buffers;
+}
+
+void NullRenderBackend::command_pool_reset(CommandPool p_command_pool) {
+	NullCommandPool* command_pool = _get<NullCommandPool>(p_command_pool);
+
+	for (CommandBuffer cmd : command_pool->command_buffers) {
+		command_reset(cmd);
+	}
+}
+
+void NullRenderBackend::command_begin(CommandBuffer p_cmd) {
+	NullCommandBuffer* command_buffer = _get<NullCommandBuffer>(p_cmd);
+
+	GL_ASSERT(!command_buffer->recording, "Command buffer is already recording");
+
+	// One time submit semantics, beginning implicitly resets the buffer
+	command_buffer->commands.clear();
+	command_buffer->handles.clear();
+	command_buffer->offsets.clear();
+	command_buffer->labels.clear();
+	command_buffer->state.reset();
+	command_buffer->recording = true;
+}
+
+void NullRenderBackend::command_end(CommandBuffer p_cmd) {
+	NullCommandBuffer* command_buffer = _get_recording_command_buffer(p_cmd);
+	command_buffer->recording = false;
+}
+
+void NullRenderBackend::command_reset(CommandBuffer p_cmd) {
+	NullCommandBuffer* command_buffer = _get<NullCommandBuffer>(p_cmd);
+
+	command_buffer->commands.clear();
+	command_buffer->handles.clear();
+	command_buffer->offsets.clear();
+	command_buffer->labels.clear();
+	command_buffer->state.reset();
+	command_buffer->recording = false;
+}
+
+void NullRenderBackend::command_begin_render_pass(CommandBuffer p_cmd, RenderPass p_render_pass,
+		FrameBuffer p_framebuffer, const Vec2u& p_draw_extent, Color p_clear_color) {
+	NullCommand& command =
+			_record(p_cmd, NullCommandType::BEGIN_RENDER_PASS, { p_render_pass, p_framebuffer });
+	command.args[0] = p_draw_extent.x;
+	command.args[1] = p_draw_extent.y;
+	command.args[2] = p_clear_color.as_uint();
+}
+
+void NullRenderBackend::command_end_render_pass(CommandBuffer p_cmd) {
+	_record(p_cmd, NullCommandType::END_RENDER_PASS);
+}
+
+void NullRenderBackend::command_begin_rendering(CommandBuffer p_cmd, const Vec2u& p_draw_extent,
+		std::vector<RenderingAttachment> p_color_attachments, Image p_depth_attachment) {
+	NullCommand& command = _record(p_cmd, NullCommandType::BEGIN_RENDERING, { p_depth_attachment });
+	command.args[0] = p_draw_extent.x;
+	command.args[1] = p_draw_extent.y;
+	command.args[2] = p_color_attachments.size();
+
+	NullCommandBuffer* command_buffer = _get<NullCommandBuffer>(p_cmd);
+	for (const RenderingAttachment& attachment : p_color_attachments) {
+		command_buffer->handles.push_back(attachment.image);
+	}
+	command.handle_count += static_cast<uint32_t>(p_color_attachments.size());
+}
+
+void NullRenderBackend::command_end_rendering(CommandBuffer p_cmd) {
+	_record(p_cmd, NullCommandType::END_RENDERING);
+}
+
+void NullRenderBackend::command_bind_graphics_pipeline(CommandBuffer p_cmd, Pipeline p_pipeline) {
+	NullCommandBuffer* command_buffer = _get_recording_command_buffer(p_cmd);
+
+	if (!command_buffer->state.bind_pipeline(PipelineType::GRAPHICS, p_pipeline)) {
+		stats.filtered_pipeline_binds++;
+		return;
+	}
+
+	_record(p_cmd, NullCommandType::BIND_GRAPHICS_PIPELINE, { p_pipeline });
+
+	stats.pipeline_binds++;
+}
+
+void NullRenderBackend::command_bind_compute_pipeline(CommandBuffer p_cmd, Pipeline p_pipeline) {
+	NullCommandBuffer* command_buffer = _get_recording_command_buffer(p_cmd);
+
+	if (!command_buffer->state.bind_pipeline(PipelineType::COMPUTE, p_pipeline)) {
+		stats.filtered_pipeline_binds++;
+		return;
+	}
+
+	_record(p_cmd, NullCommandType::BIND_COMPUTE_PIPELINE, { p_pipeline });
+
+	stats.pipeline_binds++;
+}
+
+void NullRenderBackend::command_bind_vertex_buffers(CommandBuffer p_cmd, uint32_t p_first_binding,
+		std::vector<Buffer> p_vertex_buffers, std::vector<uint64_t> p_offsets) {
+	GL_ASSERT(p_vertex_buffers.size() == p_offsets.size(),
+			"Buffer array size and offset array size does not match");
+
+	NullCommandBuffer* command_buffer = _get_recording_command_buffer(p_cmd);
+
+	if (!command_buffer->state.bind_vertex_buffers(p_first_binding, p_vertex_buffers, p_offsets)) {
+		stats.filtered_buffer_binds++;
+		return;
+	}
+
+	NullCommand& command = _record(p_cmd, NullCommandType::BIND_VERTEX_BUFFERS);
+	command.args[0] = p_first_binding;
+	command.args[1] = command_buffer->offsets.size();
+
+	command_buffer->offsets.insert(
+			command_buffer->offsets.end(), p_offsets.begin(), p_offsets.end());
+
+	command_buffer->handles.insert(
+			command_buffer->handles.end(), p_vertex_buffers.begin(), p_vertex_buffers.end());
+	command.handle_count = static_cast<uint32_t>(p_vertex_buffers.size());
+
+	stats.buffer_binds++;
+}
+
+void NullRenderBackend::command_bind_index_buffer(
+		CommandBuffer p_cmd, Buffer p_index_buffer, uint64_t p_offset, IndexType p_index_type) {
+	NullCommandBuffer* command_buffer = _get_recording_command_buffer(p_cmd);
+
+	if (!command_buffer->state.bind_index_buffer(p_index_buffer, p_offset, p_index_type)) {
+		stats.filtered_buffer_binds++;
+		return;
+	}
+
+	NullCommand& command = _record(p_cmd, NullCommandType::BIND_INDEX_BUFFER, { p_index_buffer });
+	command.args[0] = p_offset;
+	command.args[1] = static_cast<uint64_t>(p_index_type);
+
+	stats.buffer_binds++;
+}
+
+void NullRenderBackend::command_bind_uniform_sets(CommandBuffer p_cmd, Shader p_shader,
+		uint32_t p_first_set, std::vector<UniformSet> p_uniform_sets, PipelineType p_type) {
+	NullCommandBuffer* command_buffer = _get_recording_command_buffer(p_cmd);
+
+	if (!command_buffer->state.bind_uniform_sets(p_type, p_shader, p_first_set, p_uniform_sets)) {
+		stats.filtered_uniform_set_binds++;
+		return;
+	}
+
+	NullCommand& command = _record(p_cmd, NullCommandType::BIND_UNIFORM_SETS, { p_shader });
+	command.args[0] = p_first_set;
+	command.args[1] = static_cast<uint64_t>(p_type);
+
+	command_buffer->handles.insert(
+			command_buffer->handles.end(), p_uniform_sets.begin(), p_uniform_sets.end());
+	command.handle_count += static_cast<uint32_t>(p_uniform_sets.size());
+
+	stats.uniform_set_binds++;
+}
+
+void NullRenderBackend::command_push_constants(CommandBuffer p_cmd, Shader p_shader,
+		uint64_t p_offset, uint32_t p_size, const void* p_push_constants) {
+	NullCommand& command = _record(p_cmd, NullCommandType::PUSH_CONSTANTS, { p_shader });
+	command.args[0] = p_offset;
+	command.args[1] = p_size;
+
+	// Push constants are limited to 128 bytes by most drivers, keep the first
+	// 16 so tests can check small payloads without a side allocation.
+	memcpy(&command.args[2], p_push_constants, std::min<size_t>(p_size, 2 * sizeof(uint64_t)));
+}
+
+void NullRenderBackend::command_draw(CommandBuffer p_cmd, uint32_t p_vertex_count,
+		uint32_t p_instance_count, uint32_t p_first_vertex, uint32_t p_first_instance) {
+	NullCommand& command = _record(p_cmd, NullCommandType::DRAW);
+	command.args[0] = p_vertex_count;
+	command.args[1] = p_instance_count;
+	command.args[2] = p_first_vertex;
+	command.args[3] = p_first_instance;
+
+	stats.draw_calls++;
+}
+
+void NullRenderBackend::command_draw_indexed(CommandBuffer p_cmd, uint32_t p_index_count,
+		uint32_t p_instance_count, uint32_t p_first_index, int32_t p_vertex_offset,
+		uint32_t p_first_instance) {
+	NullCommand& command = _record(p_cmd, NullCommandType::DRAW_INDEXED);
+	command.args[0] = p_index_count;
+	command.args[1] = p_instance_count;
+	command.args[2] = p_first_index;
+	// Both values are packed, vertex offset keeps its sign in the upper half
+	command.args[3] = (uint64_t(uint32_t(p_vertex_offset)) << 32) | p_first_instance;
+
+	stats.draw_calls++;
+}
+
+void NullRenderBackend::command_draw_indexed_indirect(CommandBuffer p_cmd, Buffer p_buffer,
+		uint64_t p_offset, uint32_t p_draw_count, uint32_t p_stride) {
+	NullCommand& command = _record(p_cmd, NullCommandType::DRAW_INDEXED_INDIRECT, { p_buffer });
+	command.args[0] = p_offset;
+	command.args[1] = p_draw_count;
+	command.args[2] = p_stride;
+
+	stats.draw_calls += p_draw_count;
+}
+
+void NullRenderBackend::command_dispatch(CommandBuffer p_cmd, uint32_t p_group_count_x,
+		uint32_t p_group_count_y, uint32_t p_group_count_z) {
+	NullCommand& command = _record(p_cmd, NullCommandType::DISPATCH);
+	command.args[0] = p_group_count_x;
+	command.args[1] = p_group_count_y;
+	command.args[2] = p_group_count_z;
+
+	stats.dispatches++;
+}
+
+void NullRenderBackend::command_set_viewport(CommandBuffer p_cmd, const Vec2u& p_size) {
+	NullCommandBuffer* command_buffer = _get_recording_command_buffer(p_cmd);
+
+	if (!command_buffer->state.set_viewport(p_size)) {
+		stats.filtered_dynamic_states++;
+		return;
+	}
+
+	NullCommand& command = _record(p_cmd, NullCommandType::SET_VIEWPORT);
+	command.args[0] = p_size.x;
+	command.args[1] = p_size.y;
+}
+
+void NullRenderBackend::command_set_scissor(
+		CommandBuffer p_cmd, const Vec2u& p_size, const Vec2u& p_offset) {
+	NullCommandBuffer* command_buffer = _get_recording_command_buffer(p_cmd);
+
+	if (!command_buffer->state.set_scissor(p_size, p_offset)) {
+		stats.filtered_dynamic_states++;
+		return;
+	}
+
+	NullCommand& command = _record(p_cmd, NullCommandType::SET_SCISSOR);
+	command.args[0] = p_size.x;
+	command.args[1] = p_size.y;
+	command.args[2] = p_offset.x;
+	command.args[3] = p_offset.y;
+}
+
+void NullRenderBackend::command_set_depth_bias(CommandBuffer p_cmd,
+		float p_depth_bias_constant_factor, float p_depth_bias_clamp,
+		float p_depth_bias_slope_factor) {
+	NullCommand& command = _record(p_cmd, NullCommandType::SET_DEPTH_BIAS);
+	command.args[0] = _float_bits(p_depth_bias_constant_factor);
+	command.args[1] = _float_bits(p_depth_bias_clamp);
+	command.args[2] = _float_bits(p_depth_bias_slope_factor);
+}
+
+void NullRenderBackend::command_clear_color(CommandBuffer p_cmd, Image p_image,
+		const Color& p_clear_color, ImageAspectFlags p_image_aspect) {
+	NullCommand& command = _record(p_cmd, NullCommandType::CLEAR_COLOR, { p_image });
+	command.args[0] = p_clear_color.as_uint();
+	command.args[1] = p_image_aspect;
+}
+
+void NullRenderBackend::command_copy_buffer(CommandBuffer p_cmd, Buffer p_src_buffer,
+		Buffer p_dst_buffer, std::vector<BufferCopyRegion> p_regions) {
+	uint64_t bytes_copied = 0;
+	for (const BufferCopyRegion& region : p_regions) {
+		bytes_copied += region.size;
+	}
+
+	NullCommand& command =
+			_record(p_cmd, NullCommandType::COPY_BUFFER, { p_src_buffer, p_dst_buffer });
+	command.args[0] = p_regions.size();
+	command.args[1] = bytes_copied;
+
+	stats.bytes_copied += bytes_copied;
+}
+
+void NullRenderBackend::command_buffer_memory_barrier(CommandBuffer p_cmd,
+		BufferUsageFlags p_src_usage, BufferUsageFlags p_dst_usage, Buffer p_buffer) {
+	NullCommand& command = _record(p_cmd, NullCommandType::BUFFER_MEMORY_BARRIER, { p_buffer });
+	command.args[0] = p_src_usage;
+	command.args[1] = p_dst_usage;
+
+	stats.barriers++;
+}
+
+void NullRenderBackend::command_copy_buffer_to_image(CommandBuffer p_cmd, Buffer p_src_buffer,
+		Image p_dst_image, std::vector<BufferImageCopyRegion> p_regions) {
+	NullImage* dst_image = _get<NullImage>(p_dst_image);
+
+	const size_t texel_size = get_data_format_size(dst_image->format);
+
+	uint64_t bytes_copied = 0;
+	for (const BufferImageCopyRegion& region : p_regions) {
+		const Vec3u& extent = region.image_extent;
+		bytes_copied += uint64_t(extent.x) * extent.y * extent.z * texel_size;
+	}
+
+	NullCommand& command =
+			_record(p_cmd, NullCommandType::COPY_BUFFER_TO_IMAGE, { p_src_buffer, p_dst_image });
+	command.args[0] = p_regions.size();
+	command.args[1] = bytes_copied;
+
+	stats.bytes_copied += bytes_copied;
+}
+
+void NullRenderBackend::command_copy_image_to_buffer(CommandBuffer p_cmd, Image p_src_image,
+		Buffer p_dst_buffer, std::vector<BufferImageCopyRegion> p_regions) {
+	NullImage* src_image = _get<NullImage>(p_src_image);
+
+	const size_t texel_size = get_data_format_size(src_image->format);
+
+	uint64_t bytes_copied = 0;
+	for (const BufferImageCopyRegion& region : p_regions) {
+		const Vec3u& extent = region.image_extent;
+		bytes_copied += uint64_t(extent.x) * extent.y * extent.z * texel_size;
+	}
+
+	NullCommand& command =
+			_record(p_cmd, NullCommandType::COPY_IMAGE_TO_BUFFER, { p_src_image, p_dst_buffer });
+	command.args[0] = p_regions.size();
+	command.args[1] = bytes_copied;
+
+	stats.bytes_copied += bytes_copied;
+}
+
+void NullRenderBackend::command_copy_image_to_image(CommandBuffer p_cmd, Image p_src_image,
+		Image p_dst_image, const Vec2u& p_src_extent, const Vec2u& p_dst_extent,
+		uint32_t p_src_mip_level, uint32_t p_dst_mip_level) {
+	NullCommand& command =
+			_record(p_cmd, NullCommandType::COPY_IMAGE_TO_IMAGE, { p_src_image, p_dst_image });
+	command.args[0] = (uint64_t(p_src_extent.x) << 32) | p_src_extent.y;
+	command.args[1] = (uint64_t(p_dst_extent.x) << 32) | p_dst_extent.y;
+	command.args[2] = p_src_mip_level;
+	command.args[3] = p_dst_mip_level;
+}
+
+void NullRenderBackend::command_transition_image(CommandBuffer p_cmd, Image p_image,
+		ImageLayout p_current_layout, ImageLayout p_new_layout, uint32_t p_base_mip_level,
+		uint32_t p_level_count) {
+	NullCommand& command = _record(p_cmd, NullCommandType::TRANSITION_IMAGE, { p_image });
+	command.args[0] = static_cast<uint64_t>(p_current_layout);
+	command.args[1] = static_cast<uint64_t>(p_new_layout);
+	command.args[2] = p_base_mip_level;
+	command.args[3] = p_level_count;
+
+	stats.barriers++;
+}
+
+void NullRenderBackend::command_reset_query_pool(CommandBuffer p_cmd, QueryPool p_query_pool,
+		uint32_t p_first_query, uint32_t p_query_count) {
+	NullCommand& command = _record(p_cmd, NullCommandType::RESET_QUERY_POOL, { p_query_pool });
+	command.args[0] = p_first_query;
+	command.args[1] = p_query_count;
+}
+
+void NullRenderBackend::command_write_timestamp(
+		CommandBuffer p_cmd, QueryPool p_query_pool, uint32_t p_query_index) {
+	NullCommand& command = _record(p_cmd, NullCommandType::WRITE_TIMESTAMP, { p_query_pool });
+	command.args[0] = p_query_index;
+}
+
+void NullRenderBackend::command_begin_query(
+		CommandBuffer p_cmd, QueryPool p_query_pool, uint32_t p_query_index, bool p_precise) {
+	NullCommand& command = _record(p_cmd, NullCommandType::BEGIN_QUERY, { p_query_pool });
+	command.args[0] = p_query_index;
+	command.args[1] = p_precise;
+}
+
+void NullRenderBackend::command_end_query(
+		CommandBuffer p_cmd, QueryPool p_query_pool, uint32_t p_query_index) {
+	NullCommand& command = _record(p_cmd, NullCommandType::END_QUERY, { p_query_pool });
+	command.args[0] = p_query_index;
+}
+
+void NullRenderBackend::command_begin_label(
+		CommandBuffer p_cmd, const char* p_name, const Color& p_color) {
+	NullCommandBuffer* command_buffer = _get_recording_command_buffer(p_cmd);
+
+	// Copied, the caller's string may not outlive the call
+	NullCommand& command = _record(p_cmd, NullCommandType::BEGIN_LABEL);
+	command.args[0] = p_color.as_uint();
+	command.args[1] = command_buffer->labels.size();
+
+	command_buffer->labels.emplace_back(p_name);
+}
+
+void NullRenderBackend::command_end_label(CommandBuffer p_cmd) {
+	_record(p_cmd, NullCommandType::END_LABEL);
+}
+
+} //namespace gl
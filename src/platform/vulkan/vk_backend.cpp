@@ -28,18 +28,67 @@ const std::vector<const char*> DEVICE_EXTENSIONS_REQUIRED = {
 	VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME,
 };
 
+// Validation messages are rate limited per message id, ids sharing a slot are
+// limited together.
+constexpr uint32_t VALIDATION_RATE_LIMITER_COUNT = 64;
+
+static LogRateLimiter s_validation_rate_limiters[VALIDATION_RATE_LIMITER_COUNT];
+
+// Summaries of a slot name the first message id that used it, the callback's
+// strings do not outlive the call so they are copied
+static std::string s_validation_rate_limiter_names[VALIDATION_RATE_LIMITER_COUNT];
+static std::once_flag s_validation_rate_limiter_named[VALIDATION_RATE_LIMITER_COUNT];
+
 static VKAPI_ATTR VkBool32 VKAPI_CALL _vk_debug_callback(
 		VkDebugUtilsMessageSeverityFlagBitsEXT message_severity,
 		VkDebugUtilsMessageTypeFlagsEXT message_type,
 		const VkDebugUtilsMessengerCallbackDataEXT* callback_data, void* user_data) {
+	LogLevel level = LOG_LEVEL_TRACE;
 	if (message_severity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT) {
-		GL_LOG_ERROR("[VULKAN] {}", callback_data->pMessage);
+		level = LOG_LEVEL_ERROR;
 	} else if (message_severity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT) {
-		GL_LOG_WARNING("[VULKAN] {}", callback_data->pMessage);
+		level = LOG_LEVEL_WARNING;
 	} else if (message_severity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT) {
-		GL_LOG_INFO("[VULKAN] {}", callback_data->pMessage);
-	} else {
-		GL_LOG_TRACE("[VULKAN] {}", callback_data->pMessage);
+		level = LOG_LEVEL_INFO;
+	}
+
+	// Filtered messages must not use up the burst of the ones that are shown
+	if (!Logger::is_level_enabled(level)) {
+		return VK_FALSE;
+	}
+
+	const uint32_t slot = (uint32_t)callback_data->messageIdNumber % VALIDATION_RATE_LIMITER_COUNT;
+	LogRateLimiter& limiter = s_validation_rate_limiters[slot];
+
+	std::call_once(s_validation_rate_limiter_named[slot], [&]() {
+		s_validation_rate_limiter_names[slot] = callback_data->pMessageIdName
+				? std::format("[VULKAN] {}", callback_data->pMessageIdName)
+				: std::format("[VULKAN] message id {}", callback_data->messageIdNumber);
+		limiter.name = s_validation_rate_limiter_names[slot].c_str();
+	});
+
+	uint32_t suppressed = 0;
+	if (!limiter.acquire(&suppressed)) {
+		return VK_FALSE;
+	}
+
+	const std::string suffix = suppressed > 0
+			? std::format(" ({} similar messages suppressed)", suppressed)
+			: std::string();
+
+	switch (level) {
+		case LOG_LEVEL_ERROR:
+			GL_LOG_ERROR("[VULKAN] {}{}", callback_data->pMessage, suffix);
+			break;
+		case LOG_LEVEL_WARNING:
+			GL_LOG_WARNING("[VULKAN] {}{}", callback_data->pMessage, suffix);
+			break;
+		case LOG_LEVEL_INFO:
+			GL_LOG_INFO("[VULKAN] {}{}", callback_data->pMessage, suffix);
+			break;
+		default:
+			GL_LOG_TRACE("[VULKAN] {}{}", callback_data->pMessage, suffix);
+			break;
 	}
 
 	return VK_FALSE;
@@ -80,8 +129,16 @@ VulkanRenderBackend::VulkanRenderBackend(const RenderBackendCreateInfo& p_info)
 	extensions.push_back(VK_KHR_XLIB_SURFACE_EXTENSION_NAME);
 #endif
 
-#ifdef GL_DEBUG_BUILD
-	extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+#ifndef GL_DIST_BUILD
+	// Used by the debug messenger and for object names and labels
+	const bool debug_utils_supported =
+			_check_instance_extension_support(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+	if (debug_utils_supported) {
+		extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+	} else {
+		GL_LOG_WARNING("[VULKAN] {} is not available, objects will not be named.",
+				VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+	}
 #endif
 
 	instance_info.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
@@ -102,7 +159,9 @@ VulkanRenderBackend::VulkanRenderBackend(const RenderBackendCreateInfo& p_info)
 			VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
 	debug_create_info.pfnUserCallback = _vk_debug_callback;
 
-	instance_info.pNext = (VkDebugUtilsMessengerCreateInfoEXT*)&debug_create_info;
+	if (debug_utils_supported) {
+		instance_info.pNext = (VkDebugUtilsMessengerCreateInfoEXT*)&debug_create_info;
+	}
 #else
 	instance_info.enabledLayerCount = 0;
 	instance_info.pNext = nullptr;
@@ -114,12 +173,19 @@ VulkanRenderBackend::VulkanRenderBackend(const RenderBackendCreateInfo& p_info)
 	}
 
 #ifdef GL_DEBUG_BUILD
-	if (_create_debug_utils_messenger_ext(
-				instance, &debug_create_info, nullptr, &debug_messenger) != VK_SUCCESS) {
+	if (debug_utils_supported &&
+			_create_debug_utils_messenger_ext(
+					instance, &debug_create_info, nullptr, &debug_messenger) != VK_SUCCESS) {
 		GL_LOG_WARNING("[VULKAN] Failed to set up debug messenger!");
 	}
 #endif
 
+#ifndef GL_DIST_BUILD
+	if (debug_utils_supported) {
+		_load_debug_utils_functions();
+	}
+#endif
+
 	s_initialized = true;
 
 	const bool swapchain_support_required =
@@ -185,6 +251,28 @@ VulkanRenderBackend::VulkanRenderBackend(const RenderBackendCreateInfo& p_info)
 
 		swapchain_supported = _check_device_extension_support(
 				physical_device, { VK_KHR_SWAPCHAIN_EXTENSION_NAME });
+
+		// Optional, lets `SwapchainCreateInfo::max_frame_latency` wait on presents
+		if (swapchain_supported &&
+				_check_device_extension_support(physical_device,
+						{ VK_KHR_PRESENT_ID_EXTENSION_NAME,
+								VK_KHR_PRESENT_WAIT_EXTENSION_NAME })) {
+			VkPhysicalDevicePresentWaitFeaturesKHR present_wait_features = {
+				.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR,
+			};
+			VkPhysicalDevicePresentIdFeaturesKHR present_id_features = {
+				.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR,
+				.pNext = &present_wait_features,
+			};
+			VkPhysicalDeviceFeatures2 features = {
+				.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+				.pNext = &present_id_features,
+			};
+			vkGetPhysicalDeviceFeatures2(physical_device, &features);
+
+			present_wait_supported =
+					present_id_features.presentId && present_wait_features.presentWait;
+		}
 	} else {
 		GL_ASSERT(false, "Failed to find a suitable GPU!");
 	}
@@ -213,8 +301,20 @@ VulkanRenderBackend::VulkanRenderBackend(const RenderBackendCreateInfo& p_info)
 	}
 
 	// Prepare Features Chain
+	VkPhysicalDevicePresentWaitFeaturesKHR present_wait_features = {
+		.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR,
+		.presentWait = VK_TRUE,
+	};
+
+	VkPhysicalDevicePresentIdFeaturesKHR present_id_features = {
+		.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR,
+		.pNext = &present_wait_features,
+		.presentId = VK_TRUE,
+	};
+
 	VkPhysicalDeviceVulkan13Features features_13 = {
 		.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES,
+		.pNext = present_wait_supported ? &present_id_features : nullptr,
 		.synchronization2 = VK_TRUE,
 		.dynamicRendering = VK_TRUE,
 	};
@@ -232,6 +332,9 @@ VulkanRenderBackend::VulkanRenderBackend(const RenderBackendCreateInfo& p_info)
         .features = {
             .sampleRateShading = VK_TRUE,
             .samplerAnisotropy = VK_TRUE,
+            // Optional, only enabled when available
+            .occlusionQueryPrecise = physical_device_features.occlusionQueryPrecise,
+            .pipelineStatisticsQuery = physical_device_features.pipelineStatisticsQuery,
         },
     };
 
@@ -246,6 +349,10 @@ VulkanRenderBackend::VulkanRenderBackend(const RenderBackendCreateInfo& p_info)
 	if (swapchain_support_required || swapchain_supported) {
 		enabled_extensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
 	}
+	if (present_wait_supported) {
+		enabled_extensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+		enabled_extensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+	}
 	device_create_info.enabledExtensionCount = static_cast<uint32_t>(enabled_extensions.size());
 	device_create_info.ppEnabledExtensionNames = enabled_extensions.data();
 
@@ -254,6 +361,16 @@ VulkanRenderBackend::VulkanRenderBackend(const RenderBackendCreateInfo& p_info)
 		return;
 	}
 
+	if (!swapchain_support_required && !swapchain_supported) {
+		present_src_layout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	}
+
+	if (present_wait_supported) {
+		vk_wait_for_present =
+				(PFN_vkWaitForPresentKHR)vkGetDeviceProcAddr(device, "vkWaitForPresentKHR");
+		present_wait_supported = vk_wait_for_present != nullptr;
+	}
+
 	// Retrieve Queues
 	vkGetDeviceQueue(device, selected_indices.graphics_family.value(), 0, &graphics_queue.queue);
 	graphics_queue.queue_family = selected_indices.graphics_family.value();
@@ -277,6 +394,17 @@ VulkanRenderBackend::VulkanRenderBackend(const RenderBackendCreateInfo& p_info)
 		present_queue.queue_family = graphics_queue.queue_family;
 	}
 
+	uint32_t queue_family_count = 0;
+	vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &queue_family_count, nullptr);
+	std::vector<VkQueueFamilyProperties> queue_families(queue_family_count);
+	vkGetPhysicalDeviceQueueFamilyProperties(
+			physical_device, &queue_family_count, queue_families.data());
+
+	for (uint32_t queue_family : { graphics_queue.queue_family, compute_queue.queue_family }) {
+		timestamp_valid_bits =
+				std::min(timestamp_valid_bits, queue_families[queue_family].timestampValidBits);
+	}
+
 	// Cleanup
 	deletion_queue.push_function([this]() {
 		if (surface != VK_NULL_HANDLE) {
@@ -351,6 +479,11 @@ Error VulkanRenderBackend::attach_surface(void* p_connection_handle, void* p_win
 
 bool VulkanRenderBackend::is_swapchain_supported() { return swapchain_supported; }
 
+VkImageLayout VulkanRenderBackend::_to_vk_image_layout(ImageLayout p_layout) const {
+	return p_layout == ImageLayout::PRESENT_SRC ? present_src_layout
+			: static_cast<VkImageLayout>(p_layout);
+}
+
 void VulkanRenderBackend::device_wait() { vkDeviceWaitIdle(device); }
 
 uint32_t VulkanRenderBackend::get_max_msaa_samples() const {
@@ -375,6 +508,48 @@ uint32_t VulkanRenderBackend::get_max_msaa_samples() const {
 	return 1;
 }
 
+FrameStats VulkanRenderBackend::get_frame_stats() const {
+	FrameStats frame_stats = {};
+	frame_stats.draw_calls = stats.draw_calls.load(std::memory_order_relaxed);
+	frame_stats.dispatches = stats.dispatches.load(std::memory_order_relaxed);
+	frame_stats.pipeline_binds = stats.pipeline_binds.load(std::memory_order_relaxed);
+	frame_stats.uniform_set_binds = stats.uniform_set_binds.load(std::memory_order_relaxed);
+	frame_stats.buffer_binds = stats.buffer_binds.load(std::memory_order_relaxed);
+	frame_stats.barriers = stats.barriers.load(std::memory_order_relaxed);
+	frame_stats.submits = stats.submits.load(std::memory_order_relaxed);
+	frame_stats.bytes_copied = stats.bytes_copied.load(std::memory_order_relaxed);
+	frame_stats.resources_created = stats.resources_created.load(std::memory_order_relaxed);
+	frame_stats.resources_destroyed = stats.resources_destroyed.load(std::memory_order_relaxed);
+	frame_stats.descriptor_pools_live =
+			stats.descriptor_pools_live.load(std::memory_order_relaxed);
+	frame_stats.filtered_pipeline_binds =
+			stats.filtered_pipeline_binds.load(std::memory_order_relaxed);
+	frame_stats.filtered_uniform_set_binds =
+			stats.filtered_uniform_set_binds.load(std::memory_order_relaxed);
+	frame_stats.filtered_buffer_binds = stats.filtered_buffer_binds.load(std::memory_order_relaxed);
+	frame_stats.filtered_dynamic_states =
+			stats.filtered_dynamic_states.load(std::memory_order_relaxed);
+
+	return frame_stats;
+}
+
+void VulkanRenderBackend::reset_frame_stats() {
+	stats.draw_calls.store(0, std::memory_order_relaxed);
+	stats.dispatches.store(0, std::memory_order_relaxed);
+	stats.pipeline_binds.store(0, std::memory_order_relaxed);
+	stats.uniform_set_binds.store(0, std::memory_order_relaxed);
+	stats.buffer_binds.store(0, std::memory_order_relaxed);
+	stats.barriers.store(0, std::memory_order_relaxed);
+	stats.submits.store(0, std::memory_order_relaxed);
+	stats.bytes_copied.store(0, std::memory_order_relaxed);
+	stats.resources_created.store(0, std::memory_order_relaxed);
+	stats.resources_destroyed.store(0, std::memory_order_relaxed);
+	stats.filtered_pipeline_binds.store(0, std::memory_order_relaxed);
+	stats.filtered_uniform_set_binds.store(0, std::memory_order_relaxed);
+	stats.filtered_buffer_binds.store(0, std::memory_order_relaxed);
+	stats.filtered_dynamic_states.store(0, std::memory_order_relaxed);
+}
+
 bool VulkanRenderBackend::_check_validation_layer_support() {
 	uint32_t layer_count;
 	vkEnumerateInstanceLayerProperties(&layer_count, nullptr);
@@ -397,6 +572,22 @@ bool VulkanRenderBackend::_check_validation_layer_support() {
 	return true;
 }
 
+bool VulkanRenderBackend::_check_instance_extension_support(const char* p_extension) {
+	uint32_t extension_count;
+	vkEnumerateInstanceExtensionProperties(nullptr, &extension_count, nullptr);
+
+	std::vector<VkExtensionProperties> available_extensions(extension_count);
+	vkEnumerateInstanceExtensionProperties(
+			nullptr, &extension_count, available_extensions.data());
+
+	for (const auto& extension : available_extensions) {
+		if (strcmp(p_extension, extension.extensionName) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
 uint32_t VulkanRenderBackend::_rate_device_suitability(VkPhysicalDevice p_physical_device,
 		const std::vector<const char*>& p_required_extensions,
 		RenderBackendFeatureFlags p_required_features, VkSurfaceKHR p_surface) {
@@ -1,9 +1,11 @@
 #pragma once
 
 #include "glgpu/backend.h"
+#include "glgpu/command_state.h"
 #include "glgpu/deletion_queue.h"
+#include "glgpu/handle_table.h"
 #include "glgpu/types.h"
-#include "glgpu/versatile_resource.h"
+#include "glgpu/paged_allocator.h"
 
 #include "platform/vulkan/vk_common.h"
 
@@ -32,6 +34,10 @@ public:
 
 	uint32_t get_max_msaa_samples() const override;
 
+	FrameStats get_frame_stats() const override;
+
+	void reset_frame_stats() override;
+
 	// Command Queue
 	CommandQueue queue_get(QueueType p_type) override;
 
@@ -42,12 +48,12 @@ public:
 	// Buffer
 	struct VulkanBuffer {
 		VkBuffer vk_buffer;
+		uint64_t size = 0;
+		VkBufferView vk_view = VK_NULL_HANDLE;
 		struct {
 			VmaAllocation handle;
 			uint64_t size = UINT64_MAX;
 		} allocation;
-		uint64_t size = 0;
-		VkBufferView vk_view = VK_NULL_HANDLE;
 	};
 
 	Buffer buffer_create(uint64_t p_size, BufferUsageFlags p_usage,
@@ -69,10 +75,10 @@ public:
 	struct VulkanImage {
 		VkImage vk_image;
 		VkImageView vk_image_view;
-		VmaAllocation allocation;
 		VkExtent3D image_extent;
 		VkFormat image_format;
 		uint32_t mip_levels;
+		VmaAllocation allocation;
 	};
 
 	// Signature updated to use ImageCreateInfo struct
@@ -98,13 +104,14 @@ public:
 
 	// Shader
 	struct VulkanShader {
-		std::vector<VkPipelineShaderStageCreateInfo> stage_create_infos;
-		uint32_t push_constant_stages = 0;
-		std::vector<VkDescriptorSetLayout> descriptor_set_layouts;
+		// Read on every bind and push, the rest only at creation time
 		VkPipelineLayout pipeline_layout = VK_NULL_HANDLE;
+		uint32_t push_constant_stages = 0;
+		size_t shader_hash;
 
+		std::vector<VkPipelineShaderStageCreateInfo> stage_create_infos;
+		std::vector<VkDescriptorSetLayout> descriptor_set_layouts;
 		std::vector<ShaderInterfaceVariable> vertex_input_variables;
-		size_t shader_hash;
 	};
 
 	Shader shader_create_from_bytecode(const std::vector<SpirvEntry>& p_shaders) override;
@@ -177,33 +184,85 @@ public:
 	// Swapchain
 	// =========================================================================
 
+	// A swapchain replaced by `swapchain_resize`, its images may still be queued
+	// for presentation so it is destroyed only after enough presents of its
+	// successor
+	struct RetiredSwapchain {
+		DeletionQueue deletion_queue;
+		uint32_t presents_remaining = 0;
+	};
+
+	// Presentable image of a swapchain without a surface
+	struct HeadlessImage {
+		Image image = GL_NULL_HANDLE;
+		CommandBuffer cmd = GL_NULL_HANDLE;
+		// Signaled once the present copying the image out finished
+		Fence fence = GL_NULL_HANDLE;
+		// Persistently mapped, null if the swapchain has no readback
+		Buffer readback = GL_NULL_HANDLE;
+		uint8_t* readback_data = nullptr;
+		// Present whose readback is still to be collected, 0 if none
+		uint64_t frame_index = 0;
+	};
+
+	struct HeadlessSwapchain {
+		CommandQueue queue = GL_NULL_HANDLE;
+		CommandPool command_pool = GL_NULL_HANDLE;
+		std::vector<HeadlessImage> images;
+		// Handed out round robin, it holds the oldest pending readback
+		uint32_t next_image = 0;
+		uint64_t present_count = 0;
+
+		uint32_t frame_queue_size = 0;
+		std::deque<SwapchainFrame> frames;
+		// Storage of popped frames, reused for the next readbacks
+		std::vector<std::vector<uint8_t>> free_frame_data;
+	};
+
 	struct VulkanSwapchain {
 		VkSwapchainKHR vk_swapchain = VK_NULL_HANDLE;
 		VkFormat format = VK_FORMAT_UNDEFINED;
 		VkColorSpaceKHR color_space = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
 		VkExtent2D extent;
 		std::vector<VulkanImage> images;
+		std::vector<Image> image_handles;
+		std::vector<RetiredSwapchain> retired;
 		uint32_t image_index;
 		bool initialized;
+
+		// Frame latency limit, 0 when disabled or unsupported. `present_id` is
+		// the id of the last present and restarts with every recreation.
+		uint32_t max_frame_latency = 0;
+		uint64_t present_id = 0;
+
+		// Set by an acquire returning VK_SUBOPTIMAL_KHR, the next present
+		// reports that a resize is needed
+		bool suboptimal = false;
+
+		// Set when resized without a surface, `vk_swapchain` and `images` stay
+		// empty and `image_handles` refer to offscreen images
+		std::unique_ptr<HeadlessSwapchain> headless;
 	};
 
 	Swapchain swapchain_create() override;
 
-	void swapchain_resize(CommandQueue p_cmd_queue, Swapchain p_swapchain, Vec2u size,
-			bool p_vsync = false) override;
+	void swapchain_resize(CommandQueue p_cmd_queue, Swapchain p_swapchain,
+			const SwapchainCreateInfo& p_info) override;
 
 	size_t swapchain_get_image_count(Swapchain p_swapchain) override;
 
 	std::vector<Image> swapchain_get_images(Swapchain p_swapchain) override;
 
 	// Result type updated to use the global Error enum
-	Result<Image, Error> swapchain_acquire_image(
-			Swapchain p_swapchain, Semaphore p_semaphore, uint32_t* o_image_index) override;
+	Result<Image, Error> swapchain_acquire_image(Swapchain p_swapchain, Semaphore p_semaphore,
+			uint64_t p_timeout, uint32_t* o_image_index) override;
 
 	Vec2u swapchain_get_extent(Swapchain p_swapchain) override;
 
 	DataFormat swapchain_get_format(Swapchain p_swapchain) override;
 
+	bool swapchain_pop_frame(Swapchain p_swapchain, SwapchainFrame* o_frame) override;
+
 	void swapchain_free(Swapchain p_swapchain) override;
 
 	// =========================================================================
@@ -222,6 +281,63 @@ public:
 
 	void semaphore_free(Semaphore p_semaphore) override;
 
+	// =========================================================================
+	// Queries
+	// =========================================================================
+
+	struct VulkanQueryPool {
+		VkQueryPool vk_query_pool = VK_NULL_HANDLE;
+		QueryType type;
+		uint32_t query_count = 0;
+	};
+
+	QueryPool query_pool_create(QueryType p_type, uint32_t p_query_count) override;
+
+	void query_pool_free(QueryPool p_query_pool) override;
+
+	bool query_pool_get_results(QueryPool p_query_pool, uint32_t p_first_query,
+			uint32_t p_query_count, uint64_t* o_results) override;
+
+	float get_timestamp_period() const override;
+
+	uint32_t get_timestamp_valid_bits() const override;
+
+	bool is_pipeline_statistics_supported() const override;
+
+	// =========================================================================
+	// Debugging
+	// =========================================================================
+
+	void buffer_set_name(Buffer p_buffer, const char* p_name) override;
+
+	void image_set_name(Image p_image, const char* p_name) override;
+
+	void sampler_set_name(Sampler p_sampler, const char* p_name) override;
+
+	void command_pool_set_name(CommandPool p_command_pool, const char* p_name) override;
+
+	void command_buffer_set_name(CommandBuffer p_command_buffer, const char* p_name) override;
+
+	void queue_set_name(CommandQueue p_queue, const char* p_name) override;
+
+	void render_pass_set_name(RenderPass p_render_pass, const char* p_name) override;
+
+	void frame_buffer_set_name(FrameBuffer p_frame_buffer, const char* p_name) override;
+
+	void swapchain_set_name(Swapchain p_swapchain, const char* p_name) override;
+
+	void pipeline_set_name(Pipeline p_pipeline, const char* p_name) override;
+
+	void shader_set_name(Shader p_shader, const char* p_name) override;
+
+	void uniform_set_set_name(UniformSet p_uniform_set, const char* p_name) override;
+
+	void fence_set_name(Fence p_fence, const char* p_name) override;
+
+	void semaphore_set_name(Semaphore p_semaphore, const char* p_name) override;
+
+	void query_pool_set_name(QueryPool p_query_pool, const char* p_name) override;
+
 	// =========================================================================
 	// Command Submission & Recording
 	// =========================================================================
@@ -232,6 +348,17 @@ public:
 		std::mutex mutex;
 	};
 
+	struct VulkanCommandBuffer {
+		VkCommandBuffer vk_command_buffer = VK_NULL_HANDLE;
+		CommandStateCache state;
+	};
+
+	struct VulkanCommandPool {
+		VkCommandPool vk_command_pool = VK_NULL_HANDLE;
+		// Freed along with the pool, same as their Vulkan counterparts
+		std::vector<CommandBuffer> command_buffers;
+	};
+
 	void queue_submit(CommandQueue p_queue, CommandBuffer p_cmd, Fence p_fence = GL_NULL_HANDLE,
 			Semaphore p_wait_semaphore = GL_NULL_HANDLE,
 			Semaphore p_signal_semaphore = GL_NULL_HANDLE) override;
@@ -322,6 +449,9 @@ public:
 	void command_copy_buffer_to_image(CommandBuffer p_cmd, Buffer p_src_buffer, Image p_dst_image,
 			std::vector<BufferImageCopyRegion> p_regions) override;
 
+	void command_copy_image_to_buffer(CommandBuffer p_cmd, Image p_src_image, Buffer p_dst_buffer,
+			std::vector<BufferImageCopyRegion> p_regions) override;
+
 	void command_copy_image_to_image(CommandBuffer p_cmd, Image p_src_image, Image p_dst_image,
 			const Vec2u& p_src_extent, const Vec2u& p_dst_extent, uint32_t p_src_mip_level = 0,
 			uint32_t p_dst_mip_level = 0) override;
@@ -330,11 +460,30 @@ public:
 			ImageLayout p_new_layout, uint32_t p_base_mip_level = 0,
 			uint32_t p_level_count = GL_REMAINING_MIP_LEVELS) override;
 
+	void command_reset_query_pool(CommandBuffer p_cmd, QueryPool p_query_pool,
+			uint32_t p_first_query, uint32_t p_query_count) override;
+
+	void command_write_timestamp(
+			CommandBuffer p_cmd, QueryPool p_query_pool, uint32_t p_query_index) override;
+
+	void command_begin_query(CommandBuffer p_cmd, QueryPool p_query_pool, uint32_t p_query_index,
+			bool p_precise = false) override;
+
+	void command_end_query(
+			CommandBuffer p_cmd, QueryPool p_query_pool, uint32_t p_query_index) override;
+
+	void command_begin_label(
+			CommandBuffer p_cmd, const char* p_name, const Color& p_color = COLOR_WHITE) override;
+
+	void command_end_label(CommandBuffer p_cmd) override;
+
 private:
 	// Vulkan helpers
 
 	bool _check_validation_layer_support();
 
+	static bool _check_instance_extension_support(const char* p_extension);
+
 	struct QueueFamilyIndices {
 		std::optional<uint32_t> graphics_family;
 		std::optional<uint32_t> present_family;
@@ -376,15 +525,35 @@ private:
 	static void _destroy_debug_utils_messenger_ext(VkInstance p_instance,
 			VkDebugUtilsMessengerEXT p_debug_messenger, const VkAllocationCallbacks* p_allocator);
 
+	void _load_debug_utils_functions();
+
+	void _set_object_name(VkObjectType p_type, uint64_t p_handle, const char* p_name);
+
 	// API Helpers
 
 	// Helper signature updated to use internal/Vulkan types
-	VulkanImage* _image_create(VkFormat p_format, VkExtent3D p_size, VkImageUsageFlags p_usage,
+	Image _image_create(VkFormat p_format, VkExtent3D p_size, VkImageUsageFlags p_usage,
 			bool p_mipmapped, VkSampleCountFlagBits p_samples);
 
 	void _generate_image_mipmaps(CommandBuffer p_cmd, Image p_image, Vec2u p_size);
 
-	void _swapchain_release(VulkanSwapchain* p_swapchain);
+	void _swapchain_retire(VulkanSwapchain* p_swapchain);
+
+	void _swapchain_collect_retired(VulkanSwapchain* p_swapchain, bool p_force = false);
+
+	void _swapchain_resize_headless(CommandQueue p_cmd_queue, VulkanSwapchain* p_swapchain,
+			const SwapchainCreateInfo& p_info);
+
+	Result<Image, Error> _swapchain_acquire_headless(
+			VulkanSwapchain* p_swapchain, Semaphore p_semaphore, uint64_t p_timeout);
+
+	bool _swapchain_present_headless(VulkanSwapchain* p_swapchain, Semaphore p_wait_semaphore);
+
+	// Moves finished readbacks to the frame queue in present order, stops at
+	// the first one still in flight unless `p_wait` is set
+	void _swapchain_collect_frames(VulkanSwapchain* p_swapchain, bool p_wait);
+
+	VkImageLayout _to_vk_image_layout(ImageLayout p_layout) const;
 
 	VmaPool _find_or_create_small_allocs_pool(uint32_t p_mem_type_index);
 
@@ -393,22 +562,59 @@ private:
 	void _uniform_pool_unreference(
 			const DescriptorSetPoolKey& p_key, VkDescriptorPool p_vk_descriptor_pool);
 
-private:
-	using VersatileResource = VersatileResourceTemplate<VulkanBuffer, VulkanImage, VulkanShader,
-			VulkanUniformSet, VulkanPipeline>;
+	static void _stats_add(std::atomic<uint64_t>& p_counter, uint64_t p_value = 1) {
+		p_counter.fetch_add(p_value, std::memory_order_relaxed);
+	}
 
+private:
 	VkInstance instance;
 	VkDevice device;
 
 	VkPhysicalDevice physical_device;
 	VkPhysicalDeviceProperties physical_device_properties;
 	VkPhysicalDeviceFeatures physical_device_features;
+	// Smallest `timestampValidBits` of the queues timestamps are written on
+	uint32_t timestamp_valid_bits = 64;
 	bool swapchain_supported;
 
-	VkDebugUtilsMessengerEXT debug_messenger;
+	// PRESENT_SRC needs VK_KHR_swapchain, without it only headless swapchains
+	// are presented and their images are copied out of TRANSFER_SRC instead
+	VkImageLayout present_src_layout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+	// VK_KHR_present_id and VK_KHR_present_wait, backs the frame latency limit
+	bool present_wait_supported = false;
+	PFN_vkWaitForPresentKHR vk_wait_for_present = nullptr;
+
+	VkDebugUtilsMessengerEXT debug_messenger = VK_NULL_HANDLE;
+
+	// Only loaded if VK_EXT_debug_utils is available, never in dist builds
+	PFN_vkSetDebugUtilsObjectNameEXT vk_set_debug_utils_object_name = nullptr;
+	PFN_vkCmdBeginDebugUtilsLabelEXT vk_cmd_begin_debug_utils_label = nullptr;
+	PFN_vkCmdEndDebugUtilsLabelEXT vk_cmd_end_debug_utils_label = nullptr;
 
 	VkSurfaceKHR surface = VK_NULL_HANDLE;
 
+	// Relaxed atomics, only read for reporting
+	struct FrameStatsCounters {
+		std::atomic<uint64_t> draw_calls = 0;
+		std::atomic<uint64_t> dispatches = 0;
+		std::atomic<uint64_t> pipeline_binds = 0;
+		std::atomic<uint64_t> uniform_set_binds = 0;
+		std::atomic<uint64_t> buffer_binds = 0;
+		std::atomic<uint64_t> barriers = 0;
+		std::atomic<uint64_t> submits = 0;
+		std::atomic<uint64_t> bytes_copied = 0;
+		std::atomic<uint64_t> resources_created = 0;
+		std::atomic<uint64_t> resources_destroyed = 0;
+		std::atomic<uint64_t> descriptor_pools_live = 0;
+		std::atomic<uint64_t> filtered_pipeline_binds = 0;
+		std::atomic<uint64_t> filtered_uniform_set_binds = 0;
+		std::atomic<uint64_t> filtered_buffer_binds = 0;
+		std::atomic<uint64_t> filtered_dynamic_states = 0;
+	};
+
+	FrameStatsCounters stats;
+
 	VulkanQueue graphics_queue;
 	VulkanQueue transfer_queue;
 	VulkanQueue present_queue;
@@ -418,10 +624,38 @@ private:
 
 	VmaAllocator allocator = nullptr;
 	std::unordered_map<uint32_t, VmaPool> small_allocs_pools;
+	std::mutex small_allocs_pools_mutex;
 
+	// Also guards allocating from and freeing into the pools, Vulkan requires
+	// descriptor pools to be externally synchronized.
 	DescriptorSetPools descriptor_set_pools;
-
-	PagedAllocator<VersatileResource> resources_allocator;
+	std::mutex descriptor_set_pools_mutex;
+
+	// One pool per type so each slot is only as large as its resource. Types
+	// an application only creates a handful of get smaller pages.
+	static constexpr size_t SMALL_POOL_PAGE_SIZE = 4 * 1024;
+
+	PagedAllocator<VulkanBuffer> buffers_allocator;
+	PagedAllocator<VulkanImage> images_allocator;
+	PagedAllocator<VulkanShader> shaders_allocator{ SMALL_POOL_PAGE_SIZE };
+	PagedAllocator<VulkanPipeline> pipelines_allocator{ SMALL_POOL_PAGE_SIZE };
+	PagedAllocator<VulkanUniformSet> uniform_sets_allocator;
+	PagedAllocator<VulkanRenderPass> render_passes_allocator{ SMALL_POOL_PAGE_SIZE };
+	PagedAllocator<VulkanQueryPool> query_pools_allocator{ SMALL_POOL_PAGE_SIZE };
+	PagedAllocator<VulkanCommandPool> command_pools_allocator{ SMALL_POOL_PAGE_SIZE };
+	PagedAllocator<VulkanCommandBuffer> command_buffers_allocator;
+
+	// Handles are indices into these tables, see `HandleTable`
+	HandleTable<VulkanBuffer> buffer_table;
+	HandleTable<VulkanImage> image_table;
+	HandleTable<VulkanShader> shader_table;
+	HandleTable<VulkanPipeline> pipeline_table;
+	HandleTable<VulkanUniformSet> uniform_set_table;
+	HandleTable<VulkanRenderPass> render_pass_table;
+	HandleTable<VulkanSwapchain> swapchain_table;
+	HandleTable<VulkanQueryPool> query_pool_table;
+	HandleTable<VulkanCommandPool> command_pool_table;
+	HandleTable<VulkanCommandBuffer> command_buffer_table;
 
 	// immediate commands
 	struct ImmediateBuffer {
@@ -1,9 +1,13 @@
 #include "platform/vulkan/vk_backend.h"
 
+#include "glgpu/trace.h"
+
 namespace gl {
 
 Buffer VulkanRenderBackend::buffer_create(
 		uint64_t p_size, BufferUsageFlags p_usage, MemoryAllocationType p_allocation_type) {
+	GL_TRACE_SCOPE("buffer_create");
+
 	VkBufferCreateInfo create_info = {};
 	create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
 	create_info.pNext = nullptr;
@@ -53,13 +57,15 @@ Buffer VulkanRenderBackend::buffer_create(
 			allocator, &create_info, &alloc_create_info, &vk_buffer, &allocation, &alloc_info));
 
 	// Bookkeep.
-	VulkanBuffer* buf_info = VersatileResource::allocate<VulkanBuffer>(resources_allocator);
+	VulkanBuffer* buf_info = buffers_allocator.alloc();
 	buf_info->vk_buffer = vk_buffer;
 	buf_info->allocation.handle = allocation;
 	buf_info->allocation.size = alloc_info.size;
 	buf_info->size = p_size;
 
-	return Buffer(buf_info);
+	_stats_add(stats.resources_created);
+
+	return buffer_table.insert<Buffer>(buf_info);
 }
 
 void VulkanRenderBackend::buffer_free(Buffer p_buffer) {
@@ -67,17 +73,19 @@ void VulkanRenderBackend::buffer_free(Buffer p_buffer) {
 		return;
 	}
 
-	VulkanBuffer* buffer = (VulkanBuffer*)p_buffer;
+	VulkanBuffer* buffer = buffer_table.remove(p_buffer);
 
 	if (buffer->vk_view) {
 		vkDestroyBufferView(device, buffer->vk_view, nullptr);
 	}
 	vmaDestroyBuffer(allocator, buffer->vk_buffer, buffer->allocation.handle);
-	VersatileResource::free(resources_allocator, p_buffer);
+	buffers_allocator.free(buffer);
+
+	_stats_add(stats.resources_destroyed);
 }
 
 BufferDeviceAddress VulkanRenderBackend::buffer_get_device_address(Buffer p_buffer) {
-	VulkanBuffer* buffer = (VulkanBuffer*)p_buffer;
+	VulkanBuffer* buffer = buffer_table.get(p_buffer);
 
 	VkBufferDeviceAddressInfo info = {};
 	info.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO_KHR;
@@ -87,7 +95,7 @@ BufferDeviceAddress VulkanRenderBackend::buffer_get_device_address(Buffer p_buff
 }
 
 uint8_t* VulkanRenderBackend::buffer_map(Buffer p_buffer) {
-	VulkanBuffer* buffer = (VulkanBuffer*)p_buffer;
+	VulkanBuffer* buffer = buffer_table.get(p_buffer);
 
 	void* data_ptr = nullptr;
 	VK_CHECK(vmaMapMemory(allocator, buffer->allocation.handle, &data_ptr));
@@ -96,13 +104,13 @@ uint8_t* VulkanRenderBackend::buffer_map(Buffer p_buffer) {
 }
 
 void VulkanRenderBackend::buffer_unmap(Buffer p_buffer) {
-	VulkanBuffer* buffer = (VulkanBuffer*)p_buffer;
+	VulkanBuffer* buffer = buffer_table.get(p_buffer);
 
 	vmaUnmapMemory(allocator, buffer->allocation.handle);
 }
 
 void VulkanRenderBackend::buffer_invalidate(Buffer p_buffer) {
-	VulkanBuffer* buffer = (VulkanBuffer*)p_buffer;
+	VulkanBuffer* buffer = buffer_table.get(p_buffer);
 
 	VmaAllocationInfo alloc_info;
 	vmaGetAllocationInfo(allocator, buffer->allocation.handle, &alloc_info);
@@ -111,7 +119,7 @@ void VulkanRenderBackend::buffer_invalidate(Buffer p_buffer) {
 }
 
 void VulkanRenderBackend::buffer_flush(Buffer p_buffer) {
-	VulkanBuffer* buffer = (VulkanBuffer*)p_buffer;
+	VulkanBuffer* buffer = buffer_table.get(p_buffer);
 
 	VmaAllocationInfo alloc_info;
 	vmaGetAllocationInfo(allocator, buffer->allocation.handle, &alloc_info);
@@ -120,6 +128,8 @@ void VulkanRenderBackend::buffer_flush(Buffer p_buffer) {
 }
 
 VmaPool VulkanRenderBackend::_find_or_create_small_allocs_pool(uint32_t p_mem_type_index) {
+	std::lock_guard<std::mutex> lock(small_allocs_pools_mutex);
+
 	if (small_allocs_pools.find(p_mem_type_index) != small_allocs_pools.end()) {
 		return small_allocs_pools[p_mem_type_index];
 	}
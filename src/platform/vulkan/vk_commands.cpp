@@ -1,11 +1,15 @@
 #include "platform/vulkan/vk_backend.h"
 
+#include "glgpu/trace.h"
+
 #include <vulkan/vulkan_core.h>
 
 namespace gl {
 
 void VulkanRenderBackend::command_immediate_submit(
 		std::function<void(CommandBuffer p_cmd)>&& p_function, QueueType p_queue_type) {
+	GL_TRACE_SCOPE("command_immediate_submit");
+
 	std::mutex& cmd_mutex =
 			(p_queue_type == QueueType::TRANSFER) ? imm_cmd_transfer_mutex : imm_cmd_graphics_mutex;
 
@@ -32,6 +36,7 @@ void VulkanRenderBackend::command_immediate_submit(
 			imm->command_buffer, imm->fence);
 
 	// wait till the operation finishes
+	GL_TRACE_SCOPE_CATEGORY("fence_wait", "wait");
 	VK_CHECK(vkWaitForFences(device, 1, (VkFence*)&imm->fence, true, UINT64_MAX));
 }
 
@@ -46,77 +51,103 @@ CommandPool VulkanRenderBackend::command_pool_create(CommandQueue p_queue) {
 	VkCommandPool vk_command_pool = VK_NULL_HANDLE;
 	VK_CHECK(vkCreateCommandPool(device, &create_info, nullptr, &vk_command_pool));
 
-	return CommandPool(vk_command_pool);
+	VulkanCommandPool* command_pool = command_pools_allocator.alloc();
+	command_pool->vk_command_pool = vk_command_pool;
+
+	_stats_add(stats.resources_created);
+
+	return command_pool_table.insert<CommandPool>(command_pool);
 }
 
 void VulkanRenderBackend::command_pool_free(CommandPool p_command_pool) {
-	VkCommandPool command_pool = (VkCommandPool)p_command_pool;
+	VulkanCommandPool* command_pool = command_pool_table.remove(p_command_pool);
 
-	vkDestroyCommandPool(device, command_pool, nullptr);
-}
+	vkDestroyCommandPool(device, command_pool->vk_command_pool, nullptr);
 
-CommandBuffer VulkanRenderBackend::command_pool_allocate(CommandPool p_command_pool) {
-	VkCommandPool command_pool = (VkCommandPool)p_command_pool;
+	for (CommandBuffer command_buffer : command_pool->command_buffers) {
+		command_buffers_allocator.free(command_buffer_table.remove(command_buffer));
+	}
 
-	VkCommandBufferAllocateInfo alloc_info = {};
-	alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-	alloc_info.pNext = nullptr;
-	alloc_info.commandPool = command_pool;
-	alloc_info.commandBufferCount = 1;
-	alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	command_pools_allocator.free(command_pool);
 
-	VkCommandBuffer vk_command_buffer = VK_NULL_HANDLE;
-	VK_CHECK(vkAllocateCommandBuffers(device, &alloc_info, &vk_command_buffer));
+	_stats_add(stats.resources_destroyed);
+}
 
-	return CommandBuffer(vk_command_buffer);
+CommandBuffer VulkanRenderBackend::command_pool_allocate(CommandPool p_command_pool) {
+	return command_pool_allocate(p_command_pool, 1).front();
 }
 
 std::vector<CommandBuffer> VulkanRenderBackend::command_pool_allocate(
 		CommandPool p_command_pool, const uint32_t p_count) {
-	VkCommandPool command_pool = (VkCommandPool)p_command_pool;
+	VulkanCommandPool* command_pool = command_pool_table.get(p_command_pool);
 
 	VkCommandBufferAllocateInfo alloc_info = {};
 	alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
 	alloc_info.pNext = nullptr;
-	alloc_info.commandPool = command_pool;
+	alloc_info.commandPool = command_pool->vk_command_pool;
 	alloc_info.commandBufferCount = p_count;
 	alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
 
+	std::vector<VkCommandBuffer> vk_command_buffers(p_count);
+	VK_CHECK(vkAllocateCommandBuffers(device, &alloc_info, vk_command_buffers.data()));
+
 	std::vector<CommandBuffer> command_buffers(p_count);
-	VK_CHECK(vkAllocateCommandBuffers(
-			device, &alloc_info, (VkCommandBuffer*)&command_buffers.front()));
+	for (uint32_t i = 0; i < p_count; i++) {
+		VulkanCommandBuffer* command_buffer = command_buffers_allocator.alloc();
+		command_buffer->vk_command_buffer = vk_command_buffers[i];
+
+		command_buffers[i] = command_buffer_table.insert<CommandBuffer>(command_buffer);
+		command_pool->command_buffers.push_back(command_buffers[i]);
+	}
 
 	return command_buffers;
 }
 
 void VulkanRenderBackend::command_pool_reset(CommandPool p_command_pool) {
-	vkResetCommandPool(
-			device, (VkCommandPool)p_command_pool, VK_COMMAND_POOL_RESET_FLAG_BITS_MAX_ENUM);
+	VulkanCommandPool* command_pool = command_pool_table.get(p_command_pool);
+
+	vkResetCommandPool(device, command_pool->vk_command_pool, 0);
+
+	for (CommandBuffer command_buffer : command_pool->command_buffers) {
+		command_buffer_table.get(command_buffer)->state.reset();
+	}
 }
 
 void VulkanRenderBackend::command_begin(CommandBuffer p_cmd) {
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+
 	VkCommandBufferBeginInfo begin_info = {};
 	begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 	begin_info.pNext = nullptr;
 	begin_info.pInheritanceInfo = nullptr;
 	begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
-	vkBeginCommandBuffer((VkCommandBuffer)p_cmd, &begin_info);
+	vkBeginCommandBuffer(cmd->vk_command_buffer, &begin_info);
+
+	// Beginning implicitly resets the buffer, nothing is bound anymore
+	cmd->state.reset();
 }
 
 void VulkanRenderBackend::command_end(CommandBuffer p_cmd) {
-	vkEndCommandBuffer((VkCommandBuffer)p_cmd);
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+
+	vkEndCommandBuffer(cmd->vk_command_buffer);
 }
 
 void VulkanRenderBackend::command_reset(CommandBuffer p_cmd) {
-	vkResetCommandBuffer((VkCommandBuffer)p_cmd, 0);
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+
+	vkResetCommandBuffer(cmd->vk_command_buffer, 0);
+	cmd->state.reset();
 }
 
 void VulkanRenderBackend::command_begin_rendering(CommandBuffer p_cmd, const Vec2u& p_draw_extent,
 		std::vector<RenderingAttachment> p_color_attachments, Image p_depth_attachment) {
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+
 	std::vector<VkRenderingAttachmentInfo> color_attachment_infos;
 	for (const auto& attachment : p_color_attachments) {
-		VulkanImage* vk_image = (VulkanImage*)attachment.image;
+		VulkanImage* vk_image = image_table.get(attachment.image);
 
 		VkRenderingAttachmentInfo info = {};
 		info.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
@@ -137,7 +168,7 @@ void VulkanRenderBackend::command_begin_rendering(CommandBuffer p_cmd, const Vec
 
 		// Resolve image (MSAA) if provided
 		if (attachment.resolve_image != GL_NULL_HANDLE) {
-			VulkanImage* vk_resolve = (VulkanImage*)attachment.resolve_image;
+			VulkanImage* vk_resolve = image_table.get(attachment.resolve_image);
 
 			info.resolveMode = static_cast<VkResolveModeFlagBits>(attachment.resolve_mode);
 			info.resolveImageView = vk_resolve->vk_image_view;
@@ -149,7 +180,7 @@ void VulkanRenderBackend::command_begin_rendering(CommandBuffer p_cmd, const Vec
 
 	VkRenderingAttachmentInfo depth_attachment_info = {};
 	if (p_depth_attachment) {
-		VulkanImage* vk_depth_image = (VulkanImage*)p_depth_attachment;
+		VulkanImage* vk_depth_image = image_table.get(p_depth_attachment);
 
 		depth_attachment_info.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
 		depth_attachment_info.pNext = nullptr;
@@ -169,16 +200,19 @@ void VulkanRenderBackend::command_begin_rendering(CommandBuffer p_cmd, const Vec
 	render_info.pDepthAttachment = p_depth_attachment == nullptr ? nullptr : &depth_attachment_info;
 	render_info.pStencilAttachment = nullptr;
 
-	vkCmdBeginRendering((VkCommandBuffer)p_cmd, &render_info);
+	vkCmdBeginRendering(cmd->vk_command_buffer, &render_info);
 }
 
 void VulkanRenderBackend::command_end_rendering(CommandBuffer p_cmd) {
-	vkCmdEndRendering((VkCommandBuffer)p_cmd);
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+
+	vkCmdEndRendering(cmd->vk_command_buffer);
 }
 
 void VulkanRenderBackend::command_begin_render_pass(CommandBuffer p_cmd, RenderPass p_render_pass,
 		FrameBuffer framebuffer, const Vec2u& p_draw_extent, Color p_clear_color) {
-	VulkanRenderPass* render_pass_info = (VulkanRenderPass*)p_render_pass;
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+	VulkanRenderPass* render_pass_info = render_pass_table.get(p_render_pass);
 
 	std::vector<VkClearValue> clear_values(render_pass_info->attachments.size());
 	for (size_t i = 0; i < render_pass_info->attachments.size(); ++i) {
@@ -201,16 +235,19 @@ void VulkanRenderBackend::command_begin_render_pass(CommandBuffer p_cmd, RenderP
 	begin_info.clearValueCount = clear_values.size();
 	begin_info.pClearValues = clear_values.data();
 
-	vkCmdBeginRenderPass((VkCommandBuffer)p_cmd, &begin_info, VK_SUBPASS_CONTENTS_INLINE);
+	vkCmdBeginRenderPass(cmd->vk_command_buffer, &begin_info, VK_SUBPASS_CONTENTS_INLINE);
 }
 
 void VulkanRenderBackend::command_end_render_pass(CommandBuffer p_cmd) {
-	vkCmdEndRenderPass((VkCommandBuffer)p_cmd);
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+
+	vkCmdEndRenderPass(cmd->vk_command_buffer);
 }
 
 void VulkanRenderBackend::command_clear_color(CommandBuffer p_cmd, Image p_image,
 		const Color& p_clear_color, ImageAspectFlags p_image_aspect) {
-	VulkanImage* image = (VulkanImage*)p_image;
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+	VulkanImage* image = image_table.get(p_image);
 
 	VkClearColorValue clear_color = {};
 	static_assert(sizeof(VkClearColorValue) == sizeof(Color));
@@ -232,22 +269,38 @@ void VulkanRenderBackend::command_clear_color(CommandBuffer p_cmd, Image p_image
 	image_range.levelCount = 1;
 	image_range.layerCount = 1;
 
-	vkCmdClearColorImage((VkCommandBuffer)p_cmd, image->vk_image, VK_IMAGE_LAYOUT_GENERAL,
+	vkCmdClearColorImage(cmd->vk_command_buffer, image->vk_image, VK_IMAGE_LAYOUT_GENERAL,
 			&clear_color, 1, &image_range);
 }
 
 void VulkanRenderBackend::command_bind_graphics_pipeline(CommandBuffer p_cmd, Pipeline p_pipeline) {
-	VulkanPipeline* pipeline = (VulkanPipeline*)p_pipeline;
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+	VulkanPipeline* pipeline = pipeline_table.get(p_pipeline);
+
+	if (!cmd->state.bind_pipeline(PipelineType::GRAPHICS, p_pipeline)) {
+		_stats_add(stats.filtered_pipeline_binds);
+		return;
+	}
 
 	vkCmdBindPipeline(
-			(VkCommandBuffer)p_cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->vk_pipeline);
+			cmd->vk_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->vk_pipeline);
+
+	_stats_add(stats.pipeline_binds);
 }
 
 void VulkanRenderBackend::command_bind_compute_pipeline(CommandBuffer p_cmd, Pipeline p_pipeline) {
-	VulkanPipeline* pipeline = (VulkanPipeline*)p_pipeline;
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+	VulkanPipeline* pipeline = pipeline_table.get(p_pipeline);
+
+	if (!cmd->state.bind_pipeline(PipelineType::COMPUTE, p_pipeline)) {
+		_stats_add(stats.filtered_pipeline_binds);
+		return;
+	}
 
 	vkCmdBindPipeline(
-			(VkCommandBuffer)p_cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->vk_pipeline);
+			cmd->vk_command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->vk_pipeline);
+
+	_stats_add(stats.pipeline_binds);
 }
 
 void VulkanRenderBackend::command_bind_vertex_buffers(CommandBuffer p_cmd, uint32_t p_first_binding,
@@ -255,77 +308,125 @@ void VulkanRenderBackend::command_bind_vertex_buffers(CommandBuffer p_cmd, uint3
 	GL_ASSERT(p_vertex_buffers.size() == p_offsets.size(),
 			"Buffer array size and offset array size does not match");
 
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+
+	if (!cmd->state.bind_vertex_buffers(p_first_binding, p_vertex_buffers, p_offsets)) {
+		_stats_add(stats.filtered_buffer_binds);
+		return;
+	}
+
 	std::vector<VkBuffer> vk_buffers(p_vertex_buffers.size());
 	for (size_t i = 0; i < p_vertex_buffers.size(); ++i) {
-		VulkanBuffer* vk_buffer = (VulkanBuffer*)p_vertex_buffers[i];
+		VulkanBuffer* vk_buffer = buffer_table.get(p_vertex_buffers[i]);
 		vk_buffers[i] = vk_buffer->vk_buffer;
 	}
 
-	vkCmdBindVertexBuffers((VkCommandBuffer)p_cmd, p_first_binding,
+	vkCmdBindVertexBuffers(cmd->vk_command_buffer, p_first_binding,
 			static_cast<uint32_t>(vk_buffers.size()), vk_buffers.data(), p_offsets.data());
+
+	_stats_add(stats.buffer_binds);
 }
 
 void VulkanRenderBackend::command_bind_index_buffer(
 		CommandBuffer p_cmd, Buffer p_index_buffer, uint64_t p_offset, IndexType p_index_type) {
-	VulkanBuffer* index_buffer = (VulkanBuffer*)p_index_buffer;
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+	VulkanBuffer* index_buffer = buffer_table.get(p_index_buffer);
+
+	if (!cmd->state.bind_index_buffer(p_index_buffer, p_offset, p_index_type)) {
+		_stats_add(stats.filtered_buffer_binds);
+		return;
+	}
 
-	vkCmdBindIndexBuffer((VkCommandBuffer)p_cmd, index_buffer->vk_buffer, p_offset,
+	vkCmdBindIndexBuffer(cmd->vk_command_buffer, index_buffer->vk_buffer, p_offset,
 			p_index_type == IndexType::UINT16 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32);
+
+	_stats_add(stats.buffer_binds);
 }
 
 void VulkanRenderBackend::command_draw(CommandBuffer p_cmd, uint32_t p_vertex_count,
 		uint32_t p_instance_count, uint32_t p_first_vertex, uint32_t p_first_instance) {
-	vkCmdDraw((VkCommandBuffer)p_cmd, p_vertex_count, p_instance_count, p_first_vertex,
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+
+	vkCmdDraw(cmd->vk_command_buffer, p_vertex_count, p_instance_count, p_first_vertex,
 			p_first_instance);
+
+	_stats_add(stats.draw_calls);
 }
 
 void VulkanRenderBackend::command_draw_indexed(CommandBuffer p_cmd, uint32_t p_index_count,
 		uint32_t p_instance_count, uint32_t p_first_index, int32_t p_vertex_offset,
 		uint32_t p_first_instance) {
-	vkCmdDrawIndexed((VkCommandBuffer)p_cmd, p_index_count, p_instance_count, p_first_index,
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+
+	vkCmdDrawIndexed(cmd->vk_command_buffer, p_index_count, p_instance_count, p_first_index,
 			p_vertex_offset, p_first_instance);
+
+	_stats_add(stats.draw_calls);
 }
 
 void VulkanRenderBackend::command_draw_indexed_indirect(CommandBuffer p_cmd, Buffer p_buffer,
 		uint64_t p_offset, uint32_t p_draw_count, uint32_t p_stride) {
-	VulkanBuffer* buffer = (VulkanBuffer*)p_buffer;
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+	VulkanBuffer* buffer = buffer_table.get(p_buffer);
 
 	vkCmdDrawIndexedIndirect(
-			(VkCommandBuffer)p_cmd, buffer->vk_buffer, p_offset, p_draw_count, p_stride);
+			cmd->vk_command_buffer, buffer->vk_buffer, p_offset, p_draw_count, p_stride);
+
+	_stats_add(stats.draw_calls, p_draw_count);
 }
 
 void VulkanRenderBackend::command_dispatch(CommandBuffer p_cmd, uint32_t p_group_count_x,
 		uint32_t p_group_count_y, uint32_t p_group_count_z) {
-	vkCmdDispatch((VkCommandBuffer)p_cmd, p_group_count_x, p_group_count_y, p_group_count_z);
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+
+	vkCmdDispatch(cmd->vk_command_buffer, p_group_count_x, p_group_count_y, p_group_count_z);
+
+	_stats_add(stats.dispatches);
 }
 
 void VulkanRenderBackend::command_bind_uniform_sets(CommandBuffer p_cmd, Shader p_shader,
 		uint32_t p_first_set, std::vector<UniformSet> p_uniform_sets, PipelineType p_type) {
-	VulkanShader* shader = (VulkanShader*)p_shader;
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+	VulkanShader* shader = shader_table.get(p_shader);
+
+	if (!cmd->state.bind_uniform_sets(p_type, p_shader, p_first_set, p_uniform_sets)) {
+		_stats_add(stats.filtered_uniform_set_binds);
+		return;
+	}
 
 	std::vector<VkDescriptorSet> uniform_sets;
 	for (uint32_t i = 0; i < p_uniform_sets.size(); i++) {
-		VulkanUniformSet* uniform_set = (VulkanUniformSet*)p_uniform_sets[i];
+		VulkanUniformSet* uniform_set = uniform_set_table.get(p_uniform_sets[i]);
 
 		uniform_sets.push_back(uniform_set->vk_descriptor_set);
 	}
 
-	vkCmdBindDescriptorSets((VkCommandBuffer)p_cmd,
+	vkCmdBindDescriptorSets(cmd->vk_command_buffer,
 			p_type == PipelineType::GRAPHICS ? VK_PIPELINE_BIND_POINT_GRAPHICS
 											 : VK_PIPELINE_BIND_POINT_COMPUTE,
 			shader->pipeline_layout, p_first_set, p_uniform_sets.size(), uniform_sets.data(), 0,
 			nullptr);
+
+	_stats_add(stats.uniform_set_binds);
 }
 
 void VulkanRenderBackend::command_push_constants(CommandBuffer p_cmd, Shader p_shader,
 		uint64_t p_offset, uint32_t p_size, const void* p_push_constants) {
-	VulkanShader* shader = (VulkanShader*)p_shader;
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+	VulkanShader* shader = shader_table.get(p_shader);
 
-	vkCmdPushConstants((VkCommandBuffer)p_cmd, shader->pipeline_layout,
+	vkCmdPushConstants(cmd->vk_command_buffer, shader->pipeline_layout,
 			shader->push_constant_stages, p_offset, p_size, p_push_constants);
 }
 
 void VulkanRenderBackend::command_set_viewport(CommandBuffer p_cmd, const Vec2u& size) {
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+
+	if (!cmd->state.set_viewport(size)) {
+		_stats_add(stats.filtered_dynamic_states);
+		return;
+	}
+
 	VkViewport viewport = {
 		.x = 0,
 		.y = 0,
@@ -335,28 +436,38 @@ void VulkanRenderBackend::command_set_viewport(CommandBuffer p_cmd, const Vec2u&
 		.maxDepth = 1.0f,
 	};
 
-	vkCmdSetViewport((VkCommandBuffer)p_cmd, 0, 1, &viewport);
+	vkCmdSetViewport(cmd->vk_command_buffer, 0, 1, &viewport);
 }
 
 void VulkanRenderBackend::command_set_scissor(
 		CommandBuffer p_cmd, const Vec2u& p_size, const Vec2u& p_offset) {
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+
+	if (!cmd->state.set_scissor(p_size, p_offset)) {
+		_stats_add(stats.filtered_dynamic_states);
+		return;
+	}
+
 	VkRect2D scissor = {};
 	memcpy(&scissor.extent, &p_size, sizeof(VkExtent2D));
 	memcpy(&scissor.offset, &p_offset, sizeof(VkExtent2D));
 
-	vkCmdSetScissor((VkCommandBuffer)p_cmd, 0, 1, &scissor);
+	vkCmdSetScissor(cmd->vk_command_buffer, 0, 1, &scissor);
 }
 
 void VulkanRenderBackend::command_set_depth_bias(CommandBuffer p_cmd,
 		float p_depth_bias_constant_factor, float p_depth_bias_clamp,
 		float p_depth_bias_slope_factor) {
-	vkCmdSetDepthBias((VkCommandBuffer)p_cmd, p_depth_bias_constant_factor, p_depth_bias_clamp,
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+
+	vkCmdSetDepthBias(cmd->vk_command_buffer, p_depth_bias_constant_factor, p_depth_bias_clamp,
 			p_depth_bias_slope_factor);
 }
 
 void VulkanRenderBackend::command_buffer_memory_barrier(CommandBuffer p_cmd,
 		BufferUsageFlags p_src_usage, BufferUsageFlags p_dst_usage, Buffer p_buffer) {
-	VulkanBuffer* buffer = (VulkanBuffer*)p_buffer;
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+	VulkanBuffer* buffer = buffer_table.get(p_buffer);
 
 	VkAccessFlags src_access = static_cast<VkAccessFlags>(p_src_usage);
 	VkAccessFlags dst_access = static_cast<VkAccessFlags>(p_dst_usage);
@@ -379,47 +490,111 @@ void VulkanRenderBackend::command_buffer_memory_barrier(CommandBuffer p_cmd,
 	buffer_barrier.size =
 			buffer->allocation.size != UINT64_MAX ? buffer->allocation.size : VK_WHOLE_SIZE;
 
-	vkCmdPipelineBarrier((VkCommandBuffer)p_cmd, src_stage, dst_stage, 0, 0, nullptr, 1,
+	vkCmdPipelineBarrier(cmd->vk_command_buffer, src_stage, dst_stage, 0, 0, nullptr, 1,
 			&buffer_barrier, 0, nullptr);
+
+	_stats_add(stats.barriers);
 }
 
 void VulkanRenderBackend::command_copy_buffer(CommandBuffer p_cmd, Buffer p_src_buffer,
 		Buffer p_dst_buffer, std::vector<BufferCopyRegion> p_regions) {
-	VulkanBuffer* src_buffer = (VulkanBuffer*)p_src_buffer;
-	VulkanBuffer* dst_buffer = (VulkanBuffer*)p_dst_buffer;
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+	VulkanBuffer* src_buffer = buffer_table.get(p_src_buffer);
+	VulkanBuffer* dst_buffer = buffer_table.get(p_dst_buffer);
 
 	static_assert(sizeof(BufferCopyRegion) == sizeof(VkBufferCopy));
 
+	uint64_t bytes_copied = 0;
+
 	std::vector<VkBufferCopy> regions(p_regions.size());
 	for (uint32_t i = 0; i < p_regions.size(); i++) {
 		VkBufferCopy& copy = regions[i];
 		memcpy(&copy, &p_regions[i], sizeof(VkBufferCopy));
+
+		bytes_copied += p_regions[i].size;
 	}
 
-	vkCmdCopyBuffer((VkCommandBuffer)p_cmd, src_buffer->vk_buffer, dst_buffer->vk_buffer,
+	_stats_add(stats.bytes_copied, bytes_copied);
+
+	vkCmdCopyBuffer(cmd->vk_command_buffer, src_buffer->vk_buffer, dst_buffer->vk_buffer,
 			p_regions.size(), regions.data());
 }
 
 void VulkanRenderBackend::command_copy_buffer_to_image(CommandBuffer p_cmd, Buffer p_src_buffer,
 		Image p_dst_image, std::vector<BufferImageCopyRegion> p_regions) {
-	VulkanBuffer* src_buffer = (VulkanBuffer*)p_src_buffer;
-	VulkanImage* dst_image = (VulkanImage*)p_dst_image;
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+	VulkanBuffer* src_buffer = buffer_table.get(p_src_buffer);
+	VulkanImage* dst_image = image_table.get(p_dst_image);
 
 	static_assert(sizeof(BufferImageCopyRegion) == sizeof(VkBufferImageCopy));
 
+	const size_t texel_size =
+			get_data_format_size(static_cast<DataFormat>(dst_image->image_format));
+	uint64_t bytes_copied = 0;
+
 	std::vector<VkBufferImageCopy> regions(p_regions.size());
 	for (uint32_t i = 0; i < p_regions.size(); i++) {
 		VkBufferImageCopy& copy = regions[i];
 		memcpy(&copy, &p_regions[i], sizeof(VkBufferImageCopy));
+
+		const Vec3u& extent = p_regions[i].image_extent;
+		bytes_copied += uint64_t(extent.x) * extent.y * extent.z * texel_size;
 	}
 
-	vkCmdCopyBufferToImage((VkCommandBuffer)p_cmd, src_buffer->vk_buffer, dst_image->vk_image,
+	_stats_add(stats.bytes_copied, bytes_copied);
+
+	vkCmdCopyBufferToImage(cmd->vk_command_buffer, src_buffer->vk_buffer, dst_image->vk_image,
 			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, p_regions.size(), regions.data());
 }
 
+void VulkanRenderBackend::command_copy_image_to_buffer(CommandBuffer p_cmd, Image p_src_image,
+		Buffer p_dst_buffer, std::vector<BufferImageCopyRegion> p_regions) {
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+	VulkanImage* src_image = image_table.get(p_src_image);
+	VulkanBuffer* dst_buffer = buffer_table.get(p_dst_buffer);
+
+	const size_t texel_size =
+			get_data_format_size(static_cast<DataFormat>(src_image->image_format));
+	uint64_t bytes_copied = 0;
+
+	std::vector<VkBufferImageCopy> regions(p_regions.size());
+	for (uint32_t i = 0; i < p_regions.size(); i++) {
+		VkBufferImageCopy& copy = regions[i];
+		memcpy(&copy, &p_regions[i], sizeof(VkBufferImageCopy));
+
+		const Vec3u& extent = p_regions[i].image_extent;
+		bytes_copied += uint64_t(extent.x) * extent.y * extent.z * texel_size;
+	}
+
+	_stats_add(stats.bytes_copied, bytes_copied);
+
+	vkCmdCopyImageToBuffer(cmd->vk_command_buffer, src_image->vk_image,
+			VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dst_buffer->vk_buffer, p_regions.size(),
+			regions.data());
+
+	// Waiting on a fence does not make device writes visible to the host
+	VkMemoryBarrier2 host_barrier = {};
+	host_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+	host_barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+	host_barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+	host_barrier.dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT;
+	host_barrier.dstAccessMask = VK_ACCESS_2_HOST_READ_BIT;
+
+	VkDependencyInfo dep_info = {};
+	dep_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+	dep_info.memoryBarrierCount = 1;
+	dep_info.pMemoryBarriers = &host_barrier;
+
+	vkCmdPipelineBarrier2(cmd->vk_command_buffer, &dep_info);
+
+	_stats_add(stats.barriers);
+}
+
 void VulkanRenderBackend::command_copy_image_to_image(CommandBuffer p_cmd, Image p_src_image,
 		Image p_dst_image, const Vec2u& p_src_extent, const Vec2u& p_dst_extent,
 		uint32_t p_src_mip_level, uint32_t p_dst_mip_level) {
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+
 	VkImageBlit2 blit_region = {};
 	blit_region.sType = VK_STRUCTURE_TYPE_IMAGE_BLIT_2;
 
@@ -441,8 +616,8 @@ void VulkanRenderBackend::command_copy_image_to_image(CommandBuffer p_cmd, Image
 	blit_region.dstSubresource.layerCount = 1;
 	blit_region.dstSubresource.mipLevel = p_dst_mip_level;
 
-	VulkanImage* src_image = (VulkanImage*)p_src_image;
-	VulkanImage* dst_image = (VulkanImage*)p_dst_image;
+	VulkanImage* src_image = image_table.get(p_src_image);
+	VulkanImage* dst_image = image_table.get(p_dst_image);
 
 	VkBlitImageInfo2 blit_info = {};
 	blit_info.sType = VK_STRUCTURE_TYPE_BLIT_IMAGE_INFO_2;
@@ -454,22 +629,24 @@ void VulkanRenderBackend::command_copy_image_to_image(CommandBuffer p_cmd, Image
 	blit_info.pRegions = &blit_region;
 	blit_info.filter = VK_FILTER_LINEAR;
 
-	vkCmdBlitImage2((VkCommandBuffer)p_cmd, &blit_info);
+	vkCmdBlitImage2(cmd->vk_command_buffer, &blit_info);
 }
 
 void VulkanRenderBackend::command_transition_image(CommandBuffer p_cmd, Image p_image,
 		ImageLayout p_current_layout, ImageLayout p_new_layout, uint32_t p_base_mip_level,
 		uint32_t p_level_count) {
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+
 	VkImageAspectFlags aspect_mask =
 			(p_current_layout == ImageLayout::DEPTH_STENCIL_ATTACHMENT_OPTIMAL ||
 					p_new_layout == ImageLayout::DEPTH_STENCIL_ATTACHMENT_OPTIMAL)
 			? VK_IMAGE_ASPECT_DEPTH_BIT
 			: VK_IMAGE_ASPECT_COLOR_BIT;
 
-	VkImageLayout vk_current_layout = static_cast<VkImageLayout>(p_current_layout);
-	VkImageLayout vk_new_layout = static_cast<VkImageLayout>(p_new_layout);
+	VkImageLayout vk_current_layout = _to_vk_image_layout(p_current_layout);
+	VkImageLayout vk_new_layout = _to_vk_image_layout(p_new_layout);
 
-	VulkanImage* image = (VulkanImage*)p_image;
+	VulkanImage* image = image_table.get(p_image);
 
 	VkImageSubresourceRange sub_image = {};
 	sub_image.aspectMask = aspect_mask;
@@ -496,7 +673,9 @@ void VulkanRenderBackend::command_transition_image(CommandBuffer p_cmd, Image p_
 	dep_info.imageMemoryBarrierCount = 1;
 	dep_info.pImageMemoryBarriers = &image_barrier;
 
-	vkCmdPipelineBarrier2((VkCommandBuffer)p_cmd, &dep_info);
+	vkCmdPipelineBarrier2(cmd->vk_command_buffer, &dep_info);
+
+	_stats_add(stats.barriers);
 }
 
 } //namespace gl
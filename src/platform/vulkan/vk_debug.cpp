@@ -0,0 +1,166 @@
+#include "platform/vulkan/vk_backend.h"
+
+#include <vulkan/vulkan_core.h>
+
+namespace gl {
+
+void VulkanRenderBackend::_load_debug_utils_functions() {
+	vk_set_debug_utils_object_name = (PFN_vkSetDebugUtilsObjectNameEXT)vkGetInstanceProcAddr(
+			instance, "vkSetDebugUtilsObjectNameEXT");
+	vk_cmd_begin_debug_utils_label = (PFN_vkCmdBeginDebugUtilsLabelEXT)vkGetInstanceProcAddr(
+			instance, "vkCmdBeginDebugUtilsLabelEXT");
+	vk_cmd_end_debug_utils_label = (PFN_vkCmdEndDebugUtilsLabelEXT)vkGetInstanceProcAddr(
+			instance, "vkCmdEndDebugUtilsLabelEXT");
+}
+
+void VulkanRenderBackend::_set_object_name(
+		VkObjectType p_type, uint64_t p_handle, const char* p_name) {
+#ifndef GL_DIST_BUILD
+	if (!vk_set_debug_utils_object_name || !p_handle) {
+		return;
+	}
+
+	VkDebugUtilsObjectNameInfoEXT name_info = {};
+	name_info.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT;
+	name_info.objectType = p_type;
+	name_info.objectHandle = p_handle;
+	name_info.pObjectName = p_name;
+
+	vk_set_debug_utils_object_name(device, &name_info);
+#endif
+}
+
+void VulkanRenderBackend::buffer_set_name(Buffer p_buffer, const char* p_name) {
+	VulkanBuffer* buffer = buffer_table.get(p_buffer);
+
+	_set_object_name(VK_OBJECT_TYPE_BUFFER, (uint64_t)buffer->vk_buffer, p_name);
+	if (buffer->vk_view != VK_NULL_HANDLE) {
+		_set_object_name(VK_OBJECT_TYPE_BUFFER_VIEW, (uint64_t)buffer->vk_view, p_name);
+	}
+}
+
+void VulkanRenderBackend::image_set_name(Image p_image, const char* p_name) {
+	VulkanImage* image = image_table.get(p_image);
+
+	_set_object_name(VK_OBJECT_TYPE_IMAGE, (uint64_t)image->vk_image, p_name);
+	_set_object_name(VK_OBJECT_TYPE_IMAGE_VIEW, (uint64_t)image->vk_image_view, p_name);
+}
+
+void VulkanRenderBackend::sampler_set_name(Sampler p_sampler, const char* p_name) {
+	_set_object_name(VK_OBJECT_TYPE_SAMPLER, (uint64_t)p_sampler, p_name);
+}
+
+void VulkanRenderBackend::command_pool_set_name(CommandPool p_command_pool, const char* p_name) {
+	VulkanCommandPool* command_pool = command_pool_table.get(p_command_pool);
+
+	_set_object_name(VK_OBJECT_TYPE_COMMAND_POOL, (uint64_t)command_pool->vk_command_pool, p_name);
+}
+
+void VulkanRenderBackend::command_buffer_set_name(
+		CommandBuffer p_command_buffer, const char* p_name) {
+	VulkanCommandBuffer* command_buffer = command_buffer_table.get(p_command_buffer);
+
+	_set_object_name(
+			VK_OBJECT_TYPE_COMMAND_BUFFER, (uint64_t)command_buffer->vk_command_buffer, p_name);
+}
+
+void VulkanRenderBackend::queue_set_name(CommandQueue p_queue, const char* p_name) {
+	VulkanQueue* queue = (VulkanQueue*)p_queue;
+
+	_set_object_name(VK_OBJECT_TYPE_QUEUE, (uint64_t)queue->queue, p_name);
+}
+
+void VulkanRenderBackend::render_pass_set_name(RenderPass p_render_pass, const char* p_name) {
+	VulkanRenderPass* render_pass = render_pass_table.get(p_render_pass);
+
+	_set_object_name(VK_OBJECT_TYPE_RENDER_PASS, (uint64_t)render_pass->vk_render_pass, p_name);
+}
+
+void VulkanRenderBackend::frame_buffer_set_name(FrameBuffer p_frame_buffer, const char* p_name) {
+	_set_object_name(VK_OBJECT_TYPE_FRAMEBUFFER, (uint64_t)p_frame_buffer, p_name);
+}
+
+void VulkanRenderBackend::swapchain_set_name(Swapchain p_swapchain, const char* p_name) {
+	VulkanSwapchain* swapchain = swapchain_table.get(p_swapchain);
+
+	_set_object_name(VK_OBJECT_TYPE_SWAPCHAIN_KHR, (uint64_t)swapchain->vk_swapchain, p_name);
+	for (Image image_handle : swapchain->image_handles) {
+		const VulkanImage* image = image_table.get(image_handle);
+		_set_object_name(VK_OBJECT_TYPE_IMAGE, (uint64_t)image->vk_image, p_name);
+		_set_object_name(VK_OBJECT_TYPE_IMAGE_VIEW, (uint64_t)image->vk_image_view, p_name);
+	}
+}
+
+void VulkanRenderBackend::pipeline_set_name(Pipeline p_pipeline, const char* p_name) {
+	VulkanPipeline* pipeline = pipeline_table.get(p_pipeline);
+
+	_set_object_name(VK_OBJECT_TYPE_PIPELINE, (uint64_t)pipeline->vk_pipeline, p_name);
+}
+
+void VulkanRenderBackend::shader_set_name(Shader p_shader, const char* p_name) {
+	VulkanShader* shader = shader_table.get(p_shader);
+
+	_set_object_name(VK_OBJECT_TYPE_PIPELINE_LAYOUT, (uint64_t)shader->pipeline_layout, p_name);
+	for (const VkPipelineShaderStageCreateInfo& stage : shader->stage_create_infos) {
+		_set_object_name(VK_OBJECT_TYPE_SHADER_MODULE, (uint64_t)stage.module, p_name);
+	}
+	for (const VkDescriptorSetLayout layout : shader->descriptor_set_layouts) {
+		_set_object_name(VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, (uint64_t)layout, p_name);
+	}
+}
+
+void VulkanRenderBackend::uniform_set_set_name(UniformSet p_uniform_set, const char* p_name) {
+	VulkanUniformSet* uniform_set = uniform_set_table.get(p_uniform_set);
+
+	_set_object_name(
+			VK_OBJECT_TYPE_DESCRIPTOR_SET, (uint64_t)uniform_set->vk_descriptor_set, p_name);
+}
+
+void VulkanRenderBackend::fence_set_name(Fence p_fence, const char* p_name) {
+	_set_object_name(VK_OBJECT_TYPE_FENCE, (uint64_t)p_fence, p_name);
+}
+
+void VulkanRenderBackend::semaphore_set_name(Semaphore p_semaphore, const char* p_name) {
+	_set_object_name(VK_OBJECT_TYPE_SEMAPHORE, (uint64_t)p_semaphore, p_name);
+}
+
+void VulkanRenderBackend::query_pool_set_name(QueryPool p_query_pool, const char* p_name) {
+	VulkanQueryPool* query_pool = query_pool_table.get(p_query_pool);
+
+	_set_object_name(VK_OBJECT_TYPE_QUERY_POOL, (uint64_t)query_pool->vk_query_pool, p_name);
+}
+
+void VulkanRenderBackend::command_begin_label(
+		CommandBuffer p_cmd, const char* p_name, const Color& p_color) {
+#ifndef GL_DIST_BUILD
+	if (!vk_cmd_begin_debug_utils_label) {
+		return;
+	}
+
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+
+	VkDebugUtilsLabelEXT label = {};
+	label.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+	label.pLabelName = p_name;
+	label.color[0] = p_color.r;
+	label.color[1] = p_color.g;
+	label.color[2] = p_color.b;
+	label.color[3] = p_color.a;
+
+	vk_cmd_begin_debug_utils_label(cmd->vk_command_buffer, &label);
+#endif
+}
+
+void VulkanRenderBackend::command_end_label(CommandBuffer p_cmd) {
+#ifndef GL_DIST_BUILD
+	if (!vk_cmd_end_debug_utils_label) {
+		return;
+	}
+
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+
+	vk_cmd_end_debug_utils_label(cmd->vk_command_buffer);
+#endif
+}
+
+} //namespace gl
@@ -27,9 +27,8 @@ static VkImageUsageFlags _gl_to_vk_image_usage_flags(ImageUsageFlags p_usage) {
 	return vk_usage;
 }
 
-VulkanRenderBackend::VulkanImage* VulkanRenderBackend::_image_create(VkFormat p_format,
-		VkExtent3D p_size, VkImageUsageFlags p_usage, bool p_mipmapped,
-		VkSampleCountFlagBits p_samples) {
+Image VulkanRenderBackend::_image_create(VkFormat p_format, VkExtent3D p_size,
+		VkImageUsageFlags p_usage, bool p_mipmapped, VkSampleCountFlagBits p_samples) {
 	const uint32_t mip_levels = p_mipmapped
 			? static_cast<uint32_t>(std::floor(std::log2(std::max(p_size.width, p_size.height)))) +
 					1
@@ -87,7 +86,7 @@ VulkanRenderBackend::VulkanImage* VulkanRenderBackend::_image_create(VkFormat p_
 	VK_CHECK(vkCreateImageView(device, &view_info, nullptr, &vk_image_view));
 
 	// Bookkeep
-	VulkanImage* image = VersatileResource::allocate<VulkanImage>(resources_allocator);
+	VulkanImage* image = images_allocator.alloc();
 	image->vk_image = vk_image;
 	image->vk_image_view = vk_image_view;
 	image->allocation = vma_allocation;
@@ -95,7 +94,9 @@ VulkanRenderBackend::VulkanImage* VulkanRenderBackend::_image_create(VkFormat p_
 	image->image_format = p_format;
 	image->mip_levels = mip_levels;
 
-	return image;
+	_stats_add(stats.resources_created);
+
+	return image_table.insert<Image>(image);
 }
 
 void VulkanRenderBackend::_generate_image_mipmaps(
@@ -133,7 +134,7 @@ Image VulkanRenderBackend::image_create(const ImageCreateInfo& p_info) {
 	VkImageUsageFlags vk_usage = _gl_to_vk_image_usage_flags(p_info.usage);
 
 	if (!p_info.data) {
-		return (Image)_image_create(vk_format, vk_size, vk_usage, p_info.mipmapped,
+		return _image_create(vk_format, vk_size, vk_usage, p_info.mipmapped,
 				static_cast<VkSampleCountFlagBits>(p_info.samples));
 	} else {
 		const size_t data_size = vk_size.depth * vk_size.width * vk_size.height * 4;
@@ -151,7 +152,7 @@ Image VulkanRenderBackend::image_create(const ImageCreateInfo& p_info) {
 		image_usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
 		image_usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
 
-		Image new_image = (Image)_image_create(vk_format, vk_size, image_usage, p_info.mipmapped,
+		Image new_image = _image_create(vk_format, vk_size, image_usage, p_info.mipmapped,
 				static_cast<VkSampleCountFlagBits>(p_info.samples));
 
 		command_immediate_submit(
@@ -186,19 +187,22 @@ Image VulkanRenderBackend::image_create(const ImageCreateInfo& p_info) {
 
 		buffer_free(staging_buffer);
 
-		return Image(new_image);
+		return new_image;
 	}
 }
 
 void VulkanRenderBackend::image_free(Image p_image) {
-	VulkanImage* image = (VulkanImage*)p_image;
+	VulkanImage* image = image_table.remove(p_image);
 
 	vkDestroyImageView(device, image->vk_image_view, nullptr);
 	vmaDestroyImage(allocator, image->vk_image, image->allocation);
+	images_allocator.free(image);
+
+	_stats_add(stats.resources_destroyed);
 }
 
 Vec3u VulkanRenderBackend::image_get_size(Image p_image) {
-	VulkanImage* image = (VulkanImage*)p_image;
+	VulkanImage* image = image_table.get(p_image);
 
 	Vec3u size;
 	static_assert(sizeof(Vec3u) == sizeof(VkExtent3D));
@@ -208,12 +212,12 @@ Vec3u VulkanRenderBackend::image_get_size(Image p_image) {
 }
 
 DataFormat VulkanRenderBackend::image_get_format(Image p_image) {
-	VulkanImage* image = (VulkanImage*)p_image;
+	VulkanImage* image = image_table.get(p_image);
 	return static_cast<DataFormat>(image->image_format);
 }
 
 uint32_t VulkanRenderBackend::image_get_mip_levels(Image p_image) {
-	VulkanImage* image = (VulkanImage*)p_image;
+	VulkanImage* image = image_table.get(p_image);
 	return image->mip_levels;
 }
 
@@ -237,11 +241,15 @@ Sampler VulkanRenderBackend::sampler_create(const SamplerCreateInfo& p_info) {
 	VkSampler vk_sampler = VK_NULL_HANDLE;
 	VK_CHECK(vkCreateSampler(device, &create_info, nullptr, &vk_sampler));
 
+	_stats_add(stats.resources_created);
+
 	return Sampler(vk_sampler);
 }
 
 void VulkanRenderBackend::sampler_free(Sampler p_sampler) {
 	vkDestroySampler(device, (VkSampler)p_sampler, nullptr);
+
+	_stats_add(stats.resources_destroyed);
 }
 
 } //namespace gl
@@ -1,5 +1,7 @@
 #include "platform/vulkan/vk_backend.h"
 
+#include "glgpu/trace.h"
+
 #include <vulkan/vulkan_core.h>
 #include <filesystem>
 
@@ -336,8 +338,10 @@ constexpr static VkPipelineViewportStateCreateInfo _get_viewport_state() {
 }
 
 Pipeline VulkanRenderBackend::render_pipeline_create(const RenderPipelineCreateInfo& p_info) {
+	GL_TRACE_SCOPE("render_pipeline_create");
+
 	// Cast handles
-	VulkanShader* shader = (VulkanShader*)p_info.shader;
+	VulkanShader* shader = shader_table.get(p_info.shader);
 
 	// Collect pipeline state infos
 	const VkPipelineVertexInputStateCreateInfo vertex_info =
@@ -387,7 +391,7 @@ Pipeline VulkanRenderBackend::render_pipeline_create(const RenderPipelineCreateI
 
 	// If RenderPass is used, set the renderPass field directly
 	if (p_info.render_pass != GL_NULL_HANDLE) {
-		VulkanRenderPass* render_pass = (VulkanRenderPass*)p_info.render_pass;
+		VulkanRenderPass* render_pass = render_pass_table.get(p_info.render_pass);
 		create_info.renderPass = render_pass->vk_render_pass;
 		create_info.subpass = 0; // Assuming subpass 0
 	}
@@ -417,16 +421,18 @@ Pipeline VulkanRenderBackend::render_pipeline_create(const RenderPipelineCreateI
 			device, vk_pipeline_cache, 1, &create_info, nullptr, &vk_pipeline));
 
 	// Bookkeep
-	VulkanPipeline* pipeline = VersatileResource::allocate<VulkanPipeline>(resources_allocator);
+	VulkanPipeline* pipeline = pipelines_allocator.alloc();
 	pipeline->vk_pipeline = vk_pipeline;
 	pipeline->vk_pipeline_cache = vk_pipeline_cache;
 	pipeline->shader_hash = shader->shader_hash;
 
-	return Pipeline(pipeline);
+	_stats_add(stats.resources_created);
+
+	return pipeline_table.insert<Pipeline>(pipeline);
 }
 
 Pipeline VulkanRenderBackend::compute_pipeline_create(Shader p_shader) {
-	VulkanShader* shader = (VulkanShader*)p_shader;
+	VulkanShader* shader = shader_table.get(p_shader);
 
 	VkComputePipelineCreateInfo create_info = {};
 	create_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
@@ -443,16 +449,18 @@ Pipeline VulkanRenderBackend::compute_pipeline_create(Shader p_shader) {
 	VK_CHECK(vkCreateComputePipelines(
 			device, vk_pipeline_cache, 1, &create_info, nullptr, &vk_pipeline));
 
-	VulkanPipeline* pipeline = VersatileResource::allocate<VulkanPipeline>(resources_allocator);
+	VulkanPipeline* pipeline = pipelines_allocator.alloc();
 	pipeline->vk_pipeline = vk_pipeline;
 	pipeline->vk_pipeline_cache = vk_pipeline_cache;
 	pipeline->shader_hash = shader->shader_hash;
 
-	return Pipeline(pipeline);
+	_stats_add(stats.resources_created);
+
+	return pipeline_table.insert<Pipeline>(pipeline);
 }
 
 void VulkanRenderBackend::pipeline_free(Pipeline p_pipeline) {
-	VulkanPipeline* pipeline = (VulkanPipeline*)p_pipeline;
+	VulkanPipeline* pipeline = pipeline_table.remove(p_pipeline);
 
 	// save the pipeline cache
 	if (pipeline->vk_pipeline_cache != VK_NULL_HANDLE) {
@@ -495,7 +503,9 @@ void VulkanRenderBackend::pipeline_free(Pipeline p_pipeline) {
 	vkDestroyPipeline(device, pipeline->vk_pipeline, nullptr);
 	vkDestroyPipelineCache(device, pipeline->vk_pipeline_cache, nullptr);
 
-	VersatileResource::free(resources_allocator, pipeline);
+	pipelines_allocator.free(pipeline);
+
+	_stats_add(stats.resources_destroyed);
 }
 
 } //namespace gl
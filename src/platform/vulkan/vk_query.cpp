@@ -0,0 +1,146 @@
+#include "platform/vulkan/vk_backend.h"
+
+#include <vulkan/vulkan_core.h>
+
+namespace gl {
+
+static VkQueryType _gl_to_vk_query_type(QueryType p_type) {
+	switch (p_type) {
+		case QueryType::TIMESTAMP:
+			return VK_QUERY_TYPE_TIMESTAMP;
+		case QueryType::OCCLUSION:
+			return VK_QUERY_TYPE_OCCLUSION;
+		case QueryType::PIPELINE_STATISTICS:
+			return VK_QUERY_TYPE_PIPELINE_STATISTICS;
+		default:
+			return VK_QUERY_TYPE_MAX_ENUM;
+	}
+}
+
+// Enabled statistics in the order of the members of PipelineStatistics, Vulkan
+// writes the results in the order of the bits.
+static constexpr VkQueryPipelineStatisticFlags PIPELINE_STATISTICS_FLAGS =
+		VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+		VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+		VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+		VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |
+		VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+		VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |
+		VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+
+QueryPool VulkanRenderBackend::query_pool_create(QueryType p_type, uint32_t p_query_count) {
+	if (p_type == QueryType::PIPELINE_STATISTICS &&
+			!physical_device_features.pipelineStatisticsQuery) {
+		GL_LOG_ERROR("[VULKAN] [VulkanRenderBackend::query_pool_create] Pipeline statistics "
+					 "queries are not supported by the device.");
+		return QueryPool();
+	}
+
+	VkQueryPoolCreateInfo create_info = {};
+	create_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	create_info.queryType = _gl_to_vk_query_type(p_type);
+	create_info.queryCount = p_query_count;
+	if (p_type == QueryType::PIPELINE_STATISTICS) {
+		create_info.pipelineStatistics = PIPELINE_STATISTICS_FLAGS;
+	}
+
+	VkQueryPool vk_query_pool = VK_NULL_HANDLE;
+	VK_CHECK(vkCreateQueryPool(device, &create_info, nullptr, &vk_query_pool));
+
+	// Bookkeep
+	VulkanQueryPool* query_pool = query_pools_allocator.alloc();
+	query_pool->vk_query_pool = vk_query_pool;
+	query_pool->type = p_type;
+	query_pool->query_count = p_query_count;
+
+	_stats_add(stats.resources_created);
+
+	return query_pool_table.insert<QueryPool>(query_pool);
+}
+
+void VulkanRenderBackend::query_pool_free(QueryPool p_query_pool) {
+	if (!p_query_pool) {
+		return;
+	}
+
+	VulkanQueryPool* query_pool = query_pool_table.remove(p_query_pool);
+
+	vkDestroyQueryPool(device, query_pool->vk_query_pool, nullptr);
+
+	query_pools_allocator.free(query_pool);
+
+	_stats_add(stats.resources_destroyed);
+}
+
+bool VulkanRenderBackend::query_pool_get_results(QueryPool p_query_pool, uint32_t p_first_query,
+		uint32_t p_query_count, uint64_t* o_results) {
+	VulkanQueryPool* query_pool = query_pool_table.get(p_query_pool);
+
+	GL_ASSERT(p_first_query + p_query_count <= query_pool->query_count,
+			"Query range exceeds the size of the pool");
+
+	const size_t stride = get_query_result_count(query_pool->type) * sizeof(uint64_t);
+
+	// Do not wait for the results, VK_NOT_READY is returned if any of the
+	// queries are not available yet.
+	const VkResult res = vkGetQueryPoolResults(device, query_pool->vk_query_pool, p_first_query,
+			p_query_count, p_query_count * stride, o_results, stride, VK_QUERY_RESULT_64_BIT);
+
+	return res == VK_SUCCESS;
+}
+
+float VulkanRenderBackend::get_timestamp_period() const {
+	if (!physical_device_properties.limits.timestampComputeAndGraphics) {
+		return 0.0f;
+	}
+
+	return physical_device_properties.limits.timestampPeriod;
+}
+
+uint32_t VulkanRenderBackend::get_timestamp_valid_bits() const { return timestamp_valid_bits; }
+
+bool VulkanRenderBackend::is_pipeline_statistics_supported() const {
+	return physical_device_features.pipelineStatisticsQuery;
+}
+
+void VulkanRenderBackend::command_reset_query_pool(CommandBuffer p_cmd, QueryPool p_query_pool,
+		uint32_t p_first_query, uint32_t p_query_count) {
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+	VulkanQueryPool* query_pool = query_pool_table.get(p_query_pool);
+
+	vkCmdResetQueryPool(
+			cmd->vk_command_buffer, query_pool->vk_query_pool, p_first_query, p_query_count);
+}
+
+void VulkanRenderBackend::command_write_timestamp(
+		CommandBuffer p_cmd, QueryPool p_query_pool, uint32_t p_query_index) {
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+	VulkanQueryPool* query_pool = query_pool_table.get(p_query_pool);
+
+	vkCmdWriteTimestamp2(cmd->vk_command_buffer, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+			query_pool->vk_query_pool, p_query_index);
+}
+
+void VulkanRenderBackend::command_begin_query(
+		CommandBuffer p_cmd, QueryPool p_query_pool, uint32_t p_query_index, bool p_precise) {
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+	VulkanQueryPool* query_pool = query_pool_table.get(p_query_pool);
+
+	VkQueryControlFlags flags = 0;
+	if (p_precise && query_pool->type == QueryType::OCCLUSION &&
+			physical_device_features.occlusionQueryPrecise) {
+		flags |= VK_QUERY_CONTROL_PRECISE_BIT;
+	}
+
+	vkCmdBeginQuery(cmd->vk_command_buffer, query_pool->vk_query_pool, p_query_index, flags);
+}
+
+void VulkanRenderBackend::command_end_query(
+		CommandBuffer p_cmd, QueryPool p_query_pool, uint32_t p_query_index) {
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+	VulkanQueryPool* query_pool = query_pool_table.get(p_query_pool);
+
+	vkCmdEndQuery(cmd->vk_command_buffer, query_pool->vk_query_pool, p_query_index);
+}
+
+} //namespace gl
@@ -1,5 +1,7 @@
 #include "platform/vulkan/vk_backend.h"
 
+#include "glgpu/trace.h"
+
 namespace gl {
 
 CommandQueue VulkanRenderBackend::queue_get(QueueType p_type) {
@@ -26,10 +28,14 @@ CommandQueue VulkanRenderBackend::queue_get(QueueType p_type) {
 
 void VulkanRenderBackend::queue_submit(CommandQueue p_queue, CommandBuffer p_cmd, Fence p_fence,
 		Semaphore p_wait_semaphore, Semaphore p_signal_semaphore) {
+	GL_TRACE_SCOPE("queue_submit");
+
+	VulkanCommandBuffer* cmd = command_buffer_table.get(p_cmd);
+
 	VkCommandBufferSubmitInfo cmd_info = {};
 	cmd_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
 	cmd_info.pNext = nullptr;
-	cmd_info.commandBuffer = (VkCommandBuffer)p_cmd;
+	cmd_info.commandBuffer = cmd->vk_command_buffer;
 	cmd_info.deviceMask = 0;
 
 	VkSemaphoreSubmitInfo wait_semaphore_info = {};
@@ -65,12 +71,18 @@ void VulkanRenderBackend::queue_submit(CommandQueue p_queue, CommandBuffer p_cmd
 	// Lock queue for thread safe access
 	std::lock_guard<std::mutex> lock(queue->mutex);
 
+	_stats_add(stats.submits);
+
 	VK_CHECK(vkQueueSubmit2(queue->queue, 1, &submit_info, (VkFence)p_fence));
 }
 
 bool VulkanRenderBackend::queue_present(
 		CommandQueue p_queue, Swapchain p_swapchain, Semaphore p_wait_semaphore) {
-	VulkanSwapchain* swapchain = (VulkanSwapchain*)p_swapchain;
+	VulkanSwapchain* swapchain = swapchain_table.get(p_swapchain);
+	if (swapchain->headless) {
+		return _swapchain_present_headless(swapchain, p_wait_semaphore);
+	}
+
 	VulkanQueue* queue = (VulkanQueue*)p_queue;
 
 	VkPresentInfoKHR present_info = {};
@@ -81,11 +93,27 @@ bool VulkanRenderBackend::queue_present(
 	present_info.pSwapchains = &swapchain->vk_swapchain;
 	present_info.pImageIndices = &swapchain->image_index;
 
+	// Lets `swapchain_acquire_image` wait for this present to be displayed
+	const uint64_t next_present_id = swapchain->present_id + 1;
+	VkPresentIdKHR present_id = {};
+	if (swapchain->max_frame_latency > 0) {
+		present_id.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+		present_id.swapchainCount = 1;
+		present_id.pPresentIds = &next_present_id;
+		present_info.pNext = &present_id;
+	}
+
 	// Lock queue for thread safe access
 	std::lock_guard<std::mutex> lock(queue->mutex);
 
 	const VkResult res = vkQueuePresentKHR(queue->queue, &present_info);
-	return res == VK_SUCCESS;
+
+	if (res == VK_SUCCESS || res == VK_SUBOPTIMAL_KHR) {
+		swapchain->present_id = next_present_id;
+		_swapchain_collect_retired(swapchain);
+	}
+
+	return res == VK_SUCCESS && !swapchain->suboptimal;
 }
 
 } //namespace gl
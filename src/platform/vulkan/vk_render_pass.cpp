@@ -22,7 +22,7 @@ RenderPass VulkanRenderBackend::render_pass_create(
 		} else {
 			vk_attachment.finalLayout = attachment.is_depth_attachment
 					? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
-					: VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+					: present_src_layout;
 		}
 
 		vk_attachments.push_back(vk_attachment);
@@ -104,32 +104,35 @@ RenderPass VulkanRenderBackend::render_pass_create(
 	VK_CHECK(vkCreateRenderPass(device, &create_info, nullptr, &vk_render_pass));
 
 	// Bookkeeping
-	VulkanRenderPass* render_pass_info =
-			VersatileResource::allocate<VulkanRenderPass>(resources_allocator);
+	VulkanRenderPass* render_pass_info = render_passes_allocator.alloc();
 	render_pass_info->vk_render_pass = vk_render_pass;
 
 	// Copy attachments
 	render_pass_info->attachments =
 			std::vector<RenderPassAttachment>(p_attachments.begin(), p_attachments.end());
 
-	return RenderPass(render_pass_info);
+	_stats_add(stats.resources_created);
+
+	return render_pass_table.insert<RenderPass>(render_pass_info);
 }
 
 void VulkanRenderBackend::render_pass_destroy(RenderPass p_render_pass) {
-	VulkanRenderPass* render_pass_info = (VulkanRenderPass*)p_render_pass;
+	VulkanRenderPass* render_pass_info = render_pass_table.remove(p_render_pass);
 
 	vkDestroyRenderPass(device, render_pass_info->vk_render_pass, nullptr);
 
-	VersatileResource::free(resources_allocator, render_pass_info);
+	render_passes_allocator.free(render_pass_info);
+
+	_stats_add(stats.resources_destroyed);
 }
 
 FrameBuffer VulkanRenderBackend::frame_buffer_create(
 		RenderPass p_render_pass, std::vector<Image> p_attachments, const Vec2u& p_extent) {
-	VulkanRenderPass* render_pass_info = (VulkanRenderPass*)p_render_pass;
+	VulkanRenderPass* render_pass_info = render_pass_table.get(p_render_pass);
 
 	std::vector<VkImageView> vk_attachments;
 	for (const auto& attachment : p_attachments) {
-		VulkanImage* vk_image = (VulkanImage*)attachment;
+		VulkanImage* vk_image = image_table.get(attachment);
 		vk_attachments.push_back(vk_image->vk_image_view);
 	}
 
@@ -145,11 +148,15 @@ FrameBuffer VulkanRenderBackend::frame_buffer_create(
 	VkFramebuffer frame_buffer;
 	VK_CHECK(vkCreateFramebuffer(device, &frame_buffer_info, nullptr, &frame_buffer));
 
+	_stats_add(stats.resources_created);
+
 	return FrameBuffer(frame_buffer);
 }
 
 void VulkanRenderBackend::frame_buffer_destroy(FrameBuffer p_frame_buffer) {
 	vkDestroyFramebuffer(device, (VkFramebuffer)p_frame_buffer, nullptr);
+
+	_stats_add(stats.resources_destroyed);
 }
 
 } //namespace gl
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "platform/vulkan/vk_backend.h"
 
+#include "glgpu/trace.h"
+
 #include <spirv_reflect.h>
 #include <vulkan/vulkan_core.h>
 
@@ -98,6 +100,8 @@ template <typename T> void _hash_combine(std::size_t& seed, const T& value) {
 }
 
 Shader VulkanRenderBackend::shader_create_from_bytecode(const std::vector<SpirvEntry>& p_shaders) {
+	GL_TRACE_SCOPE("shader_create_from_bytecode");
+
 	std::vector<VkShaderModule> vk_shaders;
 
 	std::map<uint32_t, std::vector<VkDescriptorSetLayoutBinding>> set_bindings;
@@ -258,7 +262,7 @@ Shader VulkanRenderBackend::shader_create_from_bytecode(const std::vector<SpirvE
 	}
 
 	// Bookkeep
-	VulkanShader* shader_info = VersatileResource::allocate<VulkanShader>(resources_allocator);
+	VulkanShader* shader_info = shaders_allocator.alloc();
 	shader_info->stage_create_infos = shader_stages;
 	shader_info->push_constant_stages = push_constant_stages;
 	shader_info->descriptor_set_layouts = descriptor_set_layouts;
@@ -266,11 +270,13 @@ Shader VulkanRenderBackend::shader_create_from_bytecode(const std::vector<SpirvE
 	shader_info->vertex_input_variables = vertex_input_variables;
 	shader_info->shader_hash = shader_hash;
 
-	return Shader(shader_info);
+	_stats_add(stats.resources_created);
+
+	return shader_table.insert<Shader>(shader_info);
 }
 
 void VulkanRenderBackend::shader_free(Shader p_shader) {
-	VulkanShader* shader_info = (VulkanShader*)p_shader;
+	VulkanShader* shader_info = shader_table.remove(p_shader);
 
 	for (size_t i = 0; i < shader_info->descriptor_set_layouts.size(); i++) {
 		vkDestroyDescriptorSetLayout(device, shader_info->descriptor_set_layouts[i], nullptr);
@@ -282,12 +288,14 @@ void VulkanRenderBackend::shader_free(Shader p_shader) {
 		vkDestroyShaderModule(device, shader_info->stage_create_infos[i].module, nullptr);
 	}
 
-	VersatileResource::free(resources_allocator, shader_info);
+	shaders_allocator.free(shader_info);
+
+	_stats_add(stats.resources_destroyed);
 }
 
 std::vector<ShaderInterfaceVariable> VulkanRenderBackend::shader_get_vertex_inputs(
 		Shader p_shader) {
-	VulkanShader* shader_info = (VulkanShader*)p_shader;
+	VulkanShader* shader_info = shader_table.get(p_shader);
 	return shader_info->vertex_input_variables;
 }
 
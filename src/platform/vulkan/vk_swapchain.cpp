@@ -4,30 +4,118 @@
 
 namespace gl {
 
-void VulkanRenderBackend::_swapchain_release(VulkanSwapchain* p_swapchain) {
-	if (!p_swapchain) {
-		return;
+// Picks the requested mode if the surface supports it, otherwise the closest
+// supported one. FIFO is always available.
+static VkPresentModeKHR _select_present_mode(
+		PresentMode p_mode, const std::vector<VkPresentModeKHR>& p_available) {
+	std::vector<VkPresentModeKHR> preferred;
+	switch (p_mode) {
+		case PresentMode::IMMEDIATE:
+			preferred = { VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR };
+			break;
+		case PresentMode::MAILBOX:
+			preferred = { VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR };
+			break;
+		case PresentMode::FIFO_RELAXED:
+			preferred = { VK_PRESENT_MODE_FIFO_RELAXED_KHR };
+			break;
+		case PresentMode::FIFO:
+		default:
+			break;
 	}
 
-	// Destroy image views
-	for (auto& image : p_swapchain->images) {
-		if (image.vk_image_view != VK_NULL_HANDLE) {
-			vkDestroyImageView(device, image.vk_image_view, nullptr);
-			image.vk_image_view = VK_NULL_HANDLE;
+	for (VkPresentModeKHR mode : preferred) {
+		if (std::find(p_available.begin(), p_available.end(), mode) != p_available.end()) {
+			return mode;
 		}
 	}
-	p_swapchain->images.clear();
 
-	// Destroy the swapchain handle
+	return VK_PRESENT_MODE_FIFO_KHR;
+}
+
+void VulkanRenderBackend::_swapchain_retire(VulkanSwapchain* p_swapchain) {
+	// Without VK_EXT_swapchain_maintenance1 there is no fence for a present,
+	// once the successor presented as many images as the old swapchain had
+	// every old image has left the presentation queue
+	const uint32_t image_count = uint32_t(p_swapchain->image_handles.size());
+	RetiredSwapchain& retired = p_swapchain->retired.emplace_back(
+			RetiredSwapchain{ DeletionQueue(image_count + 2), image_count });
+
+	if (p_swapchain->headless) {
+		// Pending frames are delivered before their buffers go away
+		_swapchain_collect_frames(p_swapchain, true);
+
+		HeadlessSwapchain& headless = *p_swapchain->headless;
+		retired.deletion_queue.push_function([this, command_pool = headless.command_pool]() {
+			command_pool_free(command_pool);
+		});
+
+		for (const HeadlessImage& image : headless.images) {
+			// The successor's fences start signaled, so its presents do not
+			// prove these submits finished. Without a readback the wait above
+			// skipped them. Fences of unused images are still signaled.
+			fence_wait(image.fence);
+
+			if (image.readback) {
+				buffer_unmap(image.readback);
+			}
+
+			VulkanImage* vk_image = image_table.remove(image.image);
+			retired.deletion_queue.push_function(
+					[this, vk_image, readback = image.readback, fence = image.fence]() {
+						vkDestroyImageView(device, vk_image->vk_image_view, nullptr);
+						vmaDestroyImage(allocator, vk_image->vk_image, vk_image->allocation);
+						images_allocator.free(vk_image);
+						_stats_add(stats.resources_destroyed);
+
+						buffer_free(readback);
+						fence_free(fence);
+					});
+		}
+		headless.images.clear();
+	} else {
+		// Stale handles to the old images are caught from now on
+		for (Image image : p_swapchain->image_handles) {
+			image_table.remove(image);
+		}
+	}
+	p_swapchain->image_handles.clear();
+
+	// Flushed in reverse, the views go before the swapchain owning their images
+	VkDevice vk_device = device;
 	if (p_swapchain->vk_swapchain != VK_NULL_HANDLE) {
-		vkDestroySwapchainKHR(device, p_swapchain->vk_swapchain, nullptr);
+		retired.deletion_queue.push_function(
+				[vk_device, vk_swapchain = p_swapchain->vk_swapchain]() {
+					vkDestroySwapchainKHR(vk_device, vk_swapchain, nullptr);
+				});
 		p_swapchain->vk_swapchain = VK_NULL_HANDLE;
 	}
 
+	for (const VulkanImage& image : p_swapchain->images) {
+		if (image.vk_image_view != VK_NULL_HANDLE) {
+			retired.deletion_queue.push_function([vk_device, vk_view = image.vk_image_view]() {
+				vkDestroyImageView(vk_device, vk_view, nullptr);
+			});
+		}
+	}
+	p_swapchain->images.clear();
+
 	p_swapchain->initialized = false;
 	p_swapchain->image_index = UINT32_MAX;
 }
 
+void VulkanRenderBackend::_swapchain_collect_retired(
+		VulkanSwapchain* p_swapchain, bool p_force) {
+	std::erase_if(p_swapchain->retired, [p_force](RetiredSwapchain& p_retired) {
+		if (!p_force && p_retired.presents_remaining > 0 && --p_retired.presents_remaining > 0) {
+			return false;
+		}
+
+		p_retired.deletion_queue.flush();
+		return true;
+	});
+}
+
 Swapchain VulkanRenderBackend::swapchain_create() {
 	VulkanSwapchain* swapchain = new VulkanSwapchain();
 	swapchain->format = VK_FORMAT_R8G8B8A8_UNORM; // preferred but not guaranteed
@@ -35,24 +123,22 @@ Swapchain VulkanRenderBackend::swapchain_create() {
 	swapchain->vk_swapchain = VK_NULL_HANDLE;
 	swapchain->initialized = false;
 
-	return Swapchain(swapchain);
+	return swapchain_table.insert<Swapchain>(swapchain);
 }
 
 void VulkanRenderBackend::swapchain_resize(
-		CommandQueue p_cmd_queue, Swapchain p_swapchain, Vec2u p_size, bool p_vsync) {
-	if (!surface) {
-		GL_LOG_WARNING("[VULKAN] Headless mode: skipping swapchain resize.");
-		return;
-	}
-
+		CommandQueue p_cmd_queue, Swapchain p_swapchain, const SwapchainCreateInfo& p_info) {
 	if (!p_swapchain) {
 		GL_LOG_ERROR("[VULKAN] Unable to resize null swapchain!");
 		return;
 	}
 
-	VulkanSwapchain* swapchain = (VulkanSwapchain*)p_swapchain;
+	VulkanSwapchain* swapchain = swapchain_table.get(p_swapchain);
 
-	vkDeviceWaitIdle(device);
+	if (!surface) {
+		_swapchain_resize_headless(p_cmd_queue, swapchain, p_info);
+		return;
+	}
 
 	// Query Surface Capabilities
 	VkSurfaceCapabilitiesKHR capabilities;
@@ -67,14 +153,21 @@ void VulkanRenderBackend::swapchain_resize(
 	if (capabilities.currentExtent.width != UINT32_MAX) {
 		extent = capabilities.currentExtent;
 	} else {
-		extent.width = std::clamp(
-				p_size.x, capabilities.minImageExtent.width, capabilities.maxImageExtent.width);
-		extent.height = std::clamp(
-				p_size.y, capabilities.minImageExtent.height, capabilities.maxImageExtent.height);
+		extent.width = std::clamp(p_info.size.x, capabilities.minImageExtent.width,
+				capabilities.maxImageExtent.width);
+		extent.height = std::clamp(p_info.size.y, capabilities.minImageExtent.height,
+				capabilities.maxImageExtent.height);
+	}
+
+	if (extent.width == 0 || extent.height == 0) {
+		// Minimized, keep the current swapchain until the window is visible again
+		return;
 	}
 
 	// Determine Image Count (Min + 1 for Triple Buffering usually, clamped to max)
-	uint32_t image_count = capabilities.minImageCount + 1;
+	uint32_t image_count = p_info.image_count > 0
+			? std::max(p_info.image_count, capabilities.minImageCount)
+			: capabilities.minImageCount + 1;
 	if (capabilities.maxImageCount > 0 && image_count > capabilities.maxImageCount) {
 		image_count = capabilities.maxImageCount;
 	}
@@ -106,29 +199,8 @@ void VulkanRenderBackend::swapchain_resize(
 	vkGetPhysicalDeviceSurfacePresentModesKHR(
 			physical_device, surface, &mode_count, present_modes.data());
 
-	VkPresentModeKHR present_mode =
-			VK_PRESENT_MODE_FIFO_KHR; // VSync on (guaranteed to be available)
-
-	if (!p_vsync) {
-		// Try Mailbox (Triple Buffering / uncapped)
-		bool mailbox_found = false;
-		for (const auto& mode : present_modes) {
-			if (mode == VK_PRESENT_MODE_MAILBOX_KHR) {
-				present_mode = mode;
-				mailbox_found = true;
-				break;
-			}
-		}
-		// Fallback to Immediate if Mailbox not supported
-		if (!mailbox_found) {
-			for (const auto& mode : present_modes) {
-				if (mode == VK_PRESENT_MODE_IMMEDIATE_KHR) {
-					present_mode = mode;
-					break;
-				}
-			}
-		}
-	}
+	const VkPresentModeKHR present_mode =
+			_select_present_mode(p_info.present_mode, present_modes);
 
 	// Create the Swapchain
 	VkSwapchainCreateInfoKHR create_info = {};
@@ -140,6 +212,10 @@ void VulkanRenderBackend::swapchain_resize(
 	create_info.imageExtent = extent;
 	create_info.imageArrayLayers = 1;
 	create_info.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+	// Lets `FrameCapture` copy presented images out
+	if (capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT) {
+		create_info.imageUsage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+	}
 
 	// Handle Queue Families (Graphics vs Present)
 	uint32_t queue_family_indices[] = { graphics_queue.queue_family, present_queue.queue_family };
@@ -166,10 +242,11 @@ void VulkanRenderBackend::swapchain_resize(
 		return;
 	}
 
-	// Clean up the old swapchain resources
-	// The create info used the old handle, now we destroy the old wrapper and handle.
+	// The old swapchain is retired now, its last presented images may still be
+	// queued for display. It is destroyed by `queue_present` once they are off
+	// the screen, the device is never idled.
 	if (swapchain->initialized) {
-		_swapchain_release(swapchain);
+		_swapchain_retire(swapchain);
 	}
 
 	// Update the wrapper with new data
@@ -177,6 +254,9 @@ void VulkanRenderBackend::swapchain_resize(
 	swapchain->format = selected_format.format;
 	swapchain->color_space = selected_format.colorSpace;
 	swapchain->extent = extent;
+	swapchain->max_frame_latency = present_wait_supported ? p_info.max_frame_latency : 0;
+	swapchain->present_id = 0;
+	swapchain->suboptimal = false;
 
 	// Retrieve Images
 	vkGetSwapchainImagesKHR(device, swapchain->vk_swapchain, &image_count, nullptr);
@@ -214,6 +294,12 @@ void VulkanRenderBackend::swapchain_resize(
 		}
 	}
 
+	// Handed out after the vector is final so the addresses stay valid
+	swapchain->image_handles.resize(image_count);
+	for (size_t i = 0; i < image_count; i++) {
+		swapchain->image_handles[i] = image_table.insert<Image>(&swapchain->images[i]);
+	}
+
 	swapchain->initialized = true;
 #ifdef GL_DEBUG_BUILD
 	GL_LOG_TRACE("[VULKAN] Swapchain resized to {}x{}", extent.width, extent.height);
@@ -221,45 +307,86 @@ void VulkanRenderBackend::swapchain_resize(
 }
 
 size_t VulkanRenderBackend::swapchain_get_image_count(Swapchain p_swapchain) {
-	VulkanSwapchain* swapchain = (VulkanSwapchain*)p_swapchain;
-	return swapchain->images.size();
+	VulkanSwapchain* swapchain = swapchain_table.get(p_swapchain);
+	return swapchain->image_handles.size();
 }
 
 std::vector<Image> VulkanRenderBackend::swapchain_get_images(Swapchain p_swapchain) {
-	VulkanSwapchain* swapchain = (VulkanSwapchain*)p_swapchain;
+	VulkanSwapchain* swapchain = swapchain_table.get(p_swapchain);
 
-	std::vector<Image> images(swapchain->images.size());
-	for (size_t i = 0; i < swapchain->images.size(); i++) {
-		images[i] = Image(&swapchain->images[i]);
-	}
-
-	return images;
+	return swapchain->image_handles;
 }
 
-Result<Image, Error> VulkanRenderBackend::swapchain_acquire_image(
-		Swapchain p_swapchain, Semaphore p_semaphore, uint32_t* o_image_index) {
-	VulkanSwapchain* swapchain = (VulkanSwapchain*)p_swapchain;
+Result<Image, Error> VulkanRenderBackend::swapchain_acquire_image(Swapchain p_swapchain,
+		Semaphore p_semaphore, uint64_t p_timeout, uint32_t* o_image_index) {
+	VulkanSwapchain* swapchain = swapchain_table.get(p_swapchain);
+
+	if (swapchain->headless) {
+		Result<Image, Error> image =
+				_swapchain_acquire_headless(swapchain, p_semaphore, p_timeout);
+		if (image && o_image_index) {
+			*o_image_index = swapchain->image_index;
+		}
+		return image;
+	}
+
+	// Keep at most `max_frame_latency` presents in flight, waiting here rather
+	// than after the frame is recorded keeps input to display latency low. The
+	// timeout applies to this wait and the acquire separately.
+	if (swapchain->max_frame_latency > 0 &&
+			swapchain->present_id > swapchain->max_frame_latency) {
+		const VkResult wait_res = vk_wait_for_present(device, swapchain->vk_swapchain,
+				swapchain->present_id - swapchain->max_frame_latency, p_timeout);
+
+		// Mapped like the results of the acquire below
+		switch (wait_res) {
+			case VK_SUCCESS:
+			case VK_SUBOPTIMAL_KHR:
+				break;
+			case VK_TIMEOUT:
+				return make_err<Image>(Error::NOT_READY);
+			case VK_ERROR_OUT_OF_DATE_KHR:
+				return make_err<Image>(Error::SWAPCHAIN_OUT_OF_DATE);
+			case VK_ERROR_DEVICE_LOST:
+				return make_err<Image>(Error::DEVICE_LOST);
+			default:
+				return make_err<Image>(Error::SWAPCHAIN_LOST);
+		}
+	}
 
-	const VkResult res = vkAcquireNextImageKHR(device, swapchain->vk_swapchain, UINT64_MAX,
+	const VkResult res = vkAcquireNextImageKHR(device, swapchain->vk_swapchain, p_timeout,
 			(VkSemaphore)p_semaphore, VK_NULL_HANDLE, &swapchain->image_index);
 
-	if (res == VK_ERROR_OUT_OF_DATE_KHR || res == VK_SUBOPTIMAL_KHR) {
-		return make_err<Image>(Error::SWAPCHAIN_OUT_OF_DATE);
-	} else if (res != VK_SUCCESS) {
-		return make_err<Image>(Error::SWAPCHAIN_LOST);
+	switch (res) {
+		case VK_SUCCESS:
+			break;
+		case VK_SUBOPTIMAL_KHR:
+			// The image is still presentable, recreating right away would throw
+			// away a frame the presentation engine already handed out
+			swapchain->suboptimal = true;
+			break;
+		case VK_NOT_READY:
+		case VK_TIMEOUT:
+			return make_err<Image>(Error::NOT_READY);
+		case VK_ERROR_OUT_OF_DATE_KHR:
+			return make_err<Image>(Error::SWAPCHAIN_OUT_OF_DATE);
+		case VK_ERROR_DEVICE_LOST:
+			return make_err<Image>(Error::DEVICE_LOST);
+		default:
+			return make_err<Image>(Error::SWAPCHAIN_LOST);
 	}
 
 	if (o_image_index) {
 		*o_image_index = swapchain->image_index;
 	}
 
-	return Image(&swapchain->images[swapchain->image_index]);
+	return swapchain->image_handles[swapchain->image_index];
 }
 
 Vec2u VulkanRenderBackend::swapchain_get_extent(Swapchain p_swapchain) {
 	GL_ASSERT(p_swapchain != nullptr);
 
-	VulkanSwapchain* swapchain = (VulkanSwapchain*)p_swapchain;
+	VulkanSwapchain* swapchain = swapchain_table.get(p_swapchain);
 
 	Vec2u extent;
 	static_assert(sizeof(Vec2u) == sizeof(VkExtent2D));
@@ -271,17 +398,227 @@ Vec2u VulkanRenderBackend::swapchain_get_extent(Swapchain p_swapchain) {
 DataFormat VulkanRenderBackend::swapchain_get_format(Swapchain p_swapchain) {
 	GL_ASSERT(p_swapchain != nullptr);
 
-	VulkanSwapchain* swapchain = (VulkanSwapchain*)p_swapchain;
+	VulkanSwapchain* swapchain = swapchain_table.get(p_swapchain);
 	return static_cast<DataFormat>(swapchain->format);
 }
 
+bool VulkanRenderBackend::swapchain_pop_frame(Swapchain p_swapchain, SwapchainFrame* o_frame) {
+	VulkanSwapchain* swapchain = swapchain_table.get(p_swapchain);
+	if (!swapchain->headless) {
+		return false;
+	}
+
+	_swapchain_collect_frames(swapchain, false);
+
+	HeadlessSwapchain& headless = *swapchain->headless;
+	if (headless.frames.empty()) {
+		return false;
+	}
+
+	std::swap(*o_frame, headless.frames.front());
+	headless.free_frame_data.push_back(std::move(headless.frames.front().data));
+	headless.frames.pop_front();
+
+	return true;
+}
+
 void VulkanRenderBackend::swapchain_free(Swapchain p_swapchain) {
 	GL_ASSERT(p_swapchain != nullptr);
 
-	VulkanSwapchain* swapchain = (VulkanSwapchain*)p_swapchain;
-	_swapchain_release(swapchain);
+	// Like every other resource the caller makes sure the device is done with
+	// it, retired swapchains included
+	VulkanSwapchain* swapchain = swapchain_table.remove(p_swapchain);
+	_swapchain_retire(swapchain);
+	_swapchain_collect_retired(swapchain, true);
 
 	delete swapchain;
 }
 
+// =============================================================================
+// Headless
+// =============================================================================
+
+void VulkanRenderBackend::_swapchain_resize_headless(CommandQueue p_cmd_queue,
+		VulkanSwapchain* p_swapchain, const SwapchainCreateInfo& p_info) {
+	GL_ASSERT(p_cmd_queue != nullptr, "[VULKAN] Headless swapchains need a queue to read back on.");
+
+	// Same count most presentation engines settle on
+	constexpr uint32_t DEFAULT_IMAGE_COUNT = 3;
+
+	if (p_info.size.x == 0 || p_info.size.y == 0) {
+		return;
+	}
+
+	if (p_swapchain->initialized) {
+		_swapchain_retire(p_swapchain);
+	}
+	if (!p_swapchain->headless) {
+		p_swapchain->headless = std::make_unique<HeadlessSwapchain>();
+	}
+
+	HeadlessSwapchain& headless = *p_swapchain->headless;
+	headless.queue = p_cmd_queue;
+	headless.next_image = 0;
+	headless.frame_queue_size = p_info.readback_queue_size;
+	while (headless.frames.size() > headless.frame_queue_size) {
+		headless.frames.pop_front();
+	}
+
+	const uint32_t image_count =
+			p_info.image_count > 0 ? p_info.image_count : DEFAULT_IMAGE_COUNT;
+	const VkExtent3D extent = { p_info.size.x, p_info.size.y, 1 };
+	const uint64_t readback_size = uint64_t(extent.width) * extent.height *
+			get_data_format_size(static_cast<DataFormat>(p_swapchain->format));
+
+	headless.command_pool = command_pool_create(p_cmd_queue);
+	const std::vector<CommandBuffer> command_buffers =
+			command_pool_allocate(headless.command_pool, image_count);
+
+	headless.images.resize(image_count);
+	for (uint32_t i = 0; i < image_count; i++) {
+		HeadlessImage& image = headless.images[i];
+		image.image = _image_create(p_swapchain->format, extent,
+				VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+						VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+				false, VK_SAMPLE_COUNT_1_BIT);
+		image.cmd = command_buffers[i];
+		image.fence = fence_create(true);
+
+		if (headless.frame_queue_size > 0) {
+			image.readback = buffer_create(
+					readback_size, BUFFER_USAGE_TRANSFER_DST_BIT, MemoryAllocationType::CPU);
+			image.readback_data = buffer_map(image.readback);
+		}
+
+		p_swapchain->image_handles.push_back(image.image);
+	}
+
+	p_swapchain->extent = { extent.width, extent.height };
+	p_swapchain->max_frame_latency = 0;
+	p_swapchain->initialized = true;
+#ifdef GL_DEBUG_BUILD
+	GL_LOG_TRACE("[VULKAN] Headless swapchain resized to {}x{}", extent.width, extent.height);
+#endif
+}
+
+Result<Image, Error> VulkanRenderBackend::_swapchain_acquire_headless(
+		VulkanSwapchain* p_swapchain, Semaphore p_semaphore, uint64_t p_timeout) {
+	HeadlessSwapchain& headless = *p_swapchain->headless;
+	if (headless.images.empty()) {
+		return make_err<Image>(Error::SWAPCHAIN_OUT_OF_DATE);
+	}
+
+	// Blocks only once every image is queued, there is no display to wait for
+	// so frames are produced as fast as the GPU renders them
+	const uint32_t index = headless.next_image;
+	const VkResult res = vkWaitForFences(
+			device, 1, (VkFence*)&headless.images[index].fence, VK_TRUE, p_timeout);
+	if (res == VK_TIMEOUT) {
+		return make_err<Image>(Error::NOT_READY);
+	}
+	VK_CHECK(res);
+	_swapchain_collect_frames(p_swapchain, false);
+
+	headless.next_image = (index + 1) % uint32_t(headless.images.size());
+	p_swapchain->image_index = index;
+
+	// The image is free already, signal right away for submits waiting on it
+	if (p_semaphore) {
+		VkSemaphoreSubmitInfo signal_info = {};
+		signal_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+		signal_info.semaphore = (VkSemaphore)p_semaphore;
+		signal_info.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+		VkSubmitInfo2 submit_info = {};
+		submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+		submit_info.signalSemaphoreInfoCount = 1;
+		submit_info.pSignalSemaphoreInfos = &signal_info;
+
+		VulkanQueue* queue = (VulkanQueue*)headless.queue;
+
+		std::lock_guard<std::mutex> lock(queue->mutex);
+		VK_CHECK(vkQueueSubmit2(queue->queue, 1, &submit_info, VK_NULL_HANDLE));
+	}
+
+	return p_swapchain->image_handles[index];
+}
+
+bool VulkanRenderBackend::_swapchain_present_headless(
+		VulkanSwapchain* p_swapchain, Semaphore p_wait_semaphore) {
+	HeadlessSwapchain& headless = *p_swapchain->headless;
+	if (p_swapchain->image_index >= headless.images.size()) {
+		return false;
+	}
+
+	HeadlessImage& image = headless.images[p_swapchain->image_index];
+
+	// Submitted even without readback, the fence tells `acquire` when the
+	// rendering waited on here is done with the image
+	command_begin(image.cmd);
+	if (image.readback) {
+		command_transition_image(image.cmd, image.image, ImageLayout::PRESENT_SRC,
+				ImageLayout::TRANSFER_SRC_OPTIMAL);
+
+		BufferImageCopyRegion region = {};
+		region.image_subresource.aspect_mask = IMAGE_ASPECT_COLOR_BIT;
+		region.image_subresource.layer_count = 1;
+		region.image_extent = { p_swapchain->extent.width, p_swapchain->extent.height, 1 };
+
+		command_copy_image_to_buffer(image.cmd, image.image, image.readback, { region });
+	}
+	command_end(image.cmd);
+
+	// On the queue the command pool belongs to, whichever queue presents
+	fence_reset(image.fence);
+	queue_submit(headless.queue, image.cmd, image.fence, p_wait_semaphore);
+
+	headless.present_count++;
+	if (image.readback) {
+		image.frame_index = headless.present_count;
+	}
+	p_swapchain->image_index = UINT32_MAX;
+
+	_swapchain_collect_retired(p_swapchain);
+	_swapchain_collect_frames(p_swapchain, false);
+
+	return true;
+}
+
+void VulkanRenderBackend::_swapchain_collect_frames(VulkanSwapchain* p_swapchain, bool p_wait) {
+	HeadlessSwapchain& headless = *p_swapchain->headless;
+	const uint32_t image_count = uint32_t(headless.images.size());
+
+	for (uint32_t i = 0; i < image_count; i++) {
+		HeadlessImage& image = headless.images[(headless.next_image + i) % image_count];
+		if (image.frame_index == 0) {
+			continue;
+		}
+
+		if (p_wait) {
+			fence_wait(image.fence);
+		} else if (vkGetFenceStatus(device, (VkFence)image.fence) != VK_SUCCESS) {
+			break;
+		}
+
+		// Nobody is popping, the oldest frame makes room
+		SwapchainFrame frame;
+		if (headless.frames.size() >= headless.frame_queue_size) {
+			frame = std::move(headless.frames.front());
+			headless.frames.pop_front();
+		} else if (!headless.free_frame_data.empty()) {
+			frame.data = std::move(headless.free_frame_data.back());
+			headless.free_frame_data.pop_back();
+		}
+
+		frame.frame_index = image.frame_index;
+		frame.size = { p_swapchain->extent.width, p_swapchain->extent.height };
+		frame.format = static_cast<DataFormat>(p_swapchain->format);
+		frame.data.assign(image.readback_data,
+				image.readback_data + buffer_table.get(image.readback)->size);
+
+		headless.frames.push_back(std::move(frame));
+		image.frame_index = 0;
+	}
+}
+
 } //namespace gl
@@ -1,5 +1,7 @@
 #include "platform/vulkan/vk_backend.h"
 
+#include "glgpu/trace.h"
+
 namespace gl {
 
 Fence VulkanRenderBackend::fence_create(bool p_create_signaled) {
@@ -12,15 +14,21 @@ Fence VulkanRenderBackend::fence_create(bool p_create_signaled) {
 	VkFence vk_fence = VK_NULL_HANDLE;
 	VK_CHECK(vkCreateFence(device, &create_info, nullptr, &vk_fence));
 
+	_stats_add(stats.resources_created);
+
 	return Fence(vk_fence);
 }
 
 void VulkanRenderBackend::fence_free(Fence p_fence) {
 	vkDestroyFence(device, (VkFence)p_fence, nullptr);
+
+	_stats_add(stats.resources_destroyed);
 }
 
 void VulkanRenderBackend::fence_wait(Fence p_fence) {
- 	VK_CHECK(vkWaitForFences(device, 1, (VkFence*)&p_fence, VK_TRUE, UINT64_MAX));
+	GL_TRACE_SCOPE_CATEGORY("fence_wait", "wait");
+
+	VK_CHECK(vkWaitForFences(device, 1, (VkFence*)&p_fence, VK_TRUE, UINT64_MAX));
 }
 
 void VulkanRenderBackend::fence_reset(Fence p_fence) {
@@ -34,11 +42,15 @@ Semaphore VulkanRenderBackend::semaphore_create() {
 	VkSemaphore vk_semaphore = VK_NULL_HANDLE;
 	VK_CHECK(vkCreateSemaphore(device, &create_info, nullptr, &vk_semaphore));
 
+	_stats_add(stats.resources_created);
+
 	return Semaphore(vk_semaphore);
 }
 
 void VulkanRenderBackend::semaphore_free(Semaphore p_semaphore) {
 	vkDestroySemaphore(device, (VkSemaphore)p_semaphore, nullptr);
+
+	_stats_add(stats.resources_destroyed);
 }
 
 } //namespace gl
\ No newline at end of file
@@ -1,3 +1,4 @@
+#include "glgpu/trace.h"
 #include "glgpu/types.h"
 
 #include "platform/vulkan/vk_backend.h"
@@ -6,6 +7,8 @@ namespace gl {
 
 UniformSet VulkanRenderBackend::uniform_set_create(
 		std::vector<ShaderUniform> p_uniforms, Shader p_shader, uint32_t p_set_index) {
+	GL_TRACE_SCOPE("uniform_set_create");
+
 	DescriptorSetPoolKey pool_key;
 
 	std::vector<VkWriteDescriptorSet> vk_writes;
@@ -46,8 +49,7 @@ UniformSet VulkanRenderBackend::uniform_set_create(
 				for (uint32_t j = 0; j < num_descriptors; j++) {
 					VkDescriptorImageInfo vk_img_info = {};
 					vk_img_info.sampler = (VkSampler)uniform.data[j * 2 + 0];
-					vk_img_info.imageView =
-							((const VulkanImage*)uniform.data[j * 2 + 1])->vk_image_view;
+					vk_img_info.imageView = image_table.get(uniform.data[j * 2 + 1])->vk_image_view;
 					vk_img_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
 					vk_image_infos[i].push_back(std::move(vk_img_info));
@@ -60,7 +62,7 @@ UniformSet VulkanRenderBackend::uniform_set_create(
 
 				for (uint32_t j = 0; j < num_descriptors; j++) {
 					VkDescriptorImageInfo vk_img_info = {};
-					vk_img_info.imageView = ((const VulkanImage*)uniform.data[j])->vk_image_view;
+					vk_img_info.imageView = image_table.get(uniform.data[j])->vk_image_view;
 					vk_img_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
 					vk_image_infos[i].push_back(std::move(vk_img_info));
@@ -73,14 +75,14 @@ UniformSet VulkanRenderBackend::uniform_set_create(
 
 				for (uint32_t j = 0; j < num_descriptors; j++) {
 					VkDescriptorImageInfo vk_img_info = {};
-					vk_img_info.imageView = ((VulkanImage*)uniform.data[j])->vk_image_view;
+					vk_img_info.imageView = image_table.get(uniform.data[j])->vk_image_view;
 					vk_img_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
 
 					vk_image_infos[i].push_back(std::move(vk_img_info));
 				}
 			} break;
 			case ShaderUniformType::UNIFORM_BUFFER: {
-				const VulkanBuffer* buf_info = (const VulkanBuffer*)uniform.data[0];
+				const VulkanBuffer* buf_info = buffer_table.get(uniform.data[0]);
 
 				vk_write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
 
@@ -91,7 +93,7 @@ UniformSet VulkanRenderBackend::uniform_set_create(
 				vk_buffer_infos[i] = std::move(vk_buf_info);
 			} break;
 			case ShaderUniformType::STORAGE_BUFFER: {
-				const VulkanBuffer* buf_info = (const VulkanBuffer*)uniform.data[0];
+				const VulkanBuffer* buf_info = buffer_table.get(uniform.data[0]);
 
 				vk_write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
 
@@ -122,6 +124,8 @@ UniformSet VulkanRenderBackend::uniform_set_create(
 		pool_key.uniform_type[type_int] += num_descriptors;
 	}
 
+	std::unique_lock<std::mutex> pools_lock(descriptor_set_pools_mutex);
+
 	// Need a descriptor pool.
 	VkDescriptorPool vk_pool = (VkDescriptorPool)_uniform_pool_find_or_create(pool_key);
 	GL_ASSERT(vk_pool);
@@ -147,6 +151,8 @@ UniformSet VulkanRenderBackend::uniform_set_create(
 		return UniformSet();
 	}
 
+	pools_lock.unlock();
+
 	for (const auto& img_info : vk_image_infos) {
 		vk_writes[img_info.first].pImageInfo = img_info.second.data();
 	}
@@ -162,12 +168,14 @@ UniformSet VulkanRenderBackend::uniform_set_create(
 	vkUpdateDescriptorSets(device, p_uniforms.size(), vk_writes.data(), 0, nullptr);
 
 	// Bookkeep.
-	VulkanUniformSet* usi = VersatileResource::allocate<VulkanUniformSet>(resources_allocator);
+	VulkanUniformSet* usi = uniform_sets_allocator.alloc();
 	usi->vk_descriptor_set = vk_descriptor_set;
 	usi->vk_descriptor_pool = vk_pool;
 	usi->pool_key = pool_key;
 
-	return UniformSet(usi);
+	_stats_add(stats.resources_created);
+
+	return uniform_set_table.insert<UniformSet>(usi);
 }
 
 void VulkanRenderBackend::uniform_set_free(UniformSet p_uniform_set) {
@@ -175,13 +183,19 @@ void VulkanRenderBackend::uniform_set_free(UniformSet p_uniform_set) {
 		return;
 	}
 
-	VulkanUniformSet* usi = (VulkanUniformSet*)p_uniform_set;
+	VulkanUniformSet* usi = uniform_set_table.remove(p_uniform_set);
 
-	vkFreeDescriptorSets(device, usi->vk_descriptor_pool, 1, &usi->vk_descriptor_set);
+	{
+		std::lock_guard<std::mutex> lock(descriptor_set_pools_mutex);
 
-	_uniform_pool_unreference(usi->pool_key, usi->vk_descriptor_pool);
+		vkFreeDescriptorSets(device, usi->vk_descriptor_pool, 1, &usi->vk_descriptor_set);
 
-	VersatileResource::free(resources_allocator, usi);
+		_uniform_pool_unreference(usi->pool_key, usi->vk_descriptor_pool);
+	}
+
+	uniform_sets_allocator.free(usi);
+
+	_stats_add(stats.resources_destroyed);
 }
 
 static const uint32_t MAX_DESCRIPTOR_SETS_PER_POOL = 10;
@@ -275,6 +289,8 @@ VkDescriptorPool VulkanRenderBackend::_uniform_pool_find_or_create(
 	VkDescriptorPool vk_pool = VK_NULL_HANDLE;
 	VK_CHECK(vkCreateDescriptorPool(device, &descriptor_set_pool_create_info, nullptr, &vk_pool));
 
+	_stats_add(stats.descriptor_pools_live);
+
 	// Bookkeep.
 	descriptor_set_pools[p_key][vk_pool] = 1;
 
@@ -288,6 +304,7 @@ void VulkanRenderBackend::_uniform_pool_unreference(
 	pool_rcs_it->second--;
 	if (pool_rcs_it->second == 0) {
 		vkDestroyDescriptorPool(device, p_vk_descriptor_pool, nullptr);
+		stats.descriptor_pools_live.fetch_sub(1, std::memory_order_relaxed);
 		pool_sets_it->second.erase(p_vk_descriptor_pool);
 		if (pool_sets_it->second.empty()) {
 			descriptor_set_pools.erase(pool_sets_it);
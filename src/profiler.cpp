@@ -0,0 +1,223 @@
+#include "glgpu/profiler.h"
+
+#include "glgpu/assert.h"
+#include "glgpu/log.h"
+#include "glgpu/trace.h"
+
+namespace gl {
+
+Profiler::Profiler(
+		std::shared_ptr<RenderBackend> p_backend, uint32_t p_frames_in_flight, uint32_t p_max_scopes) :
+		backend(p_backend), max_scopes(p_max_scopes) {
+	GL_ASSERT(p_frames_in_flight > 0, "Profiler needs at least one frame in flight");
+
+	timestamp_period = backend->get_timestamp_period();
+	if (timestamp_period == 0.0f) {
+		GL_LOG_WARNING("[PROFILER] Timestamp queries are not supported, only CPU timings will be "
+					   "collected.");
+	}
+
+	const uint32_t valid_bits = backend->get_timestamp_valid_bits();
+	if (valid_bits > 0 && valid_bits < 64) {
+		timestamp_mask = (uint64_t(1) << valid_bits) - 1;
+	}
+
+	statistics_supported = backend->is_pipeline_statistics_supported();
+
+	frames.resize(p_frames_in_flight);
+	for (FrameData& frame : frames) {
+		if (timestamp_period != 0.0f) {
+			frame.query_pool = backend->query_pool_create(QueryType::TIMESTAMP, max_scopes * 2);
+		}
+		if (statistics_supported) {
+			frame.statistics_query_pool =
+					backend->query_pool_create(QueryType::PIPELINE_STATISTICS, max_scopes);
+		}
+		frame.scopes.reserve(max_scopes);
+	}
+
+	timestamps.resize(max_scopes * 2);
+}
+
+Profiler::~Profiler() {
+	for (FrameData& frame : frames) {
+		backend->query_pool_free(frame.query_pool);
+		backend->query_pool_free(frame.statistics_query_pool);
+	}
+}
+
+void Profiler::begin_frame(CommandBuffer p_cmd) {
+	GL_ASSERT(scope_stack.empty(), "Profiler scopes must be closed before a new frame begins");
+
+	current_frame = frame_counter % frames.size();
+
+	FrameData& frame = frames[current_frame];
+
+	// The slot was last used `frames_in_flight` frames ago, which means its
+	// commands are expected to have finished by now.
+	if (frame.frame_index != UINT64_MAX) {
+		_resolve_frame(frame);
+	}
+
+	frame.scopes.clear();
+	frame.frame_index = frame_counter++;
+
+	if (frame.query_pool) {
+		backend->command_reset_query_pool(p_cmd, frame.query_pool, 0, max_scopes * 2);
+	}
+	if (frame.statistics_query_pool) {
+		backend->command_reset_query_pool(p_cmd, frame.statistics_query_pool, 0, max_scopes);
+	}
+}
+
+void Profiler::begin_scope(CommandBuffer p_cmd, const char* p_name, bool p_collect_statistics) {
+	FrameData& frame = frames[current_frame];
+
+	// Labels are emitted for every scope so captures show them even if the
+	// profiler ran out of queries.
+	backend->command_begin_label(p_cmd, p_name);
+
+	if (frame.scopes.size() >= max_scopes) {
+		// Out of queries, ignore the scope but keep the stack balanced. Its
+		// children are attached to its nearest recorded ancestor.
+		scope_stack.push_back(PROFILE_SCOPE_NO_PARENT);
+		return;
+	}
+
+	const uint32_t index = static_cast<uint32_t>(frame.scopes.size());
+
+	Scope scope = {};
+	scope.name = p_name;
+	scope.parent = _get_recorded_parent();
+	scope.depth =
+			scope.parent == PROFILE_SCOPE_NO_PARENT ? 0 : frame.scopes[scope.parent].depth + 1;
+	scope.has_statistics = p_collect_statistics && statistics_supported &&
+			statistics_scope == PROFILE_SCOPE_NO_PARENT;
+
+	if (frame.query_pool) {
+		backend->command_write_timestamp(p_cmd, frame.query_pool, index * 2);
+	}
+
+	if (scope.has_statistics) {
+		backend->command_begin_query(p_cmd, frame.statistics_query_pool, index);
+		statistics_scope = index;
+	}
+
+	scope.cpu_begin = std::chrono::high_resolution_clock::now();
+
+	frame.scopes.push_back(scope);
+	scope_stack.push_back(index);
+}
+
+void Profiler::end_scope(CommandBuffer p_cmd) {
+	GL_ASSERT(!scope_stack.empty(), "Profiler::end_scope called without a matching begin_scope");
+
+	const uint32_t index = scope_stack.back();
+	scope_stack.pop_back();
+
+	backend->command_end_label(p_cmd);
+
+	if (index == PROFILE_SCOPE_NO_PARENT) {
+		return;
+	}
+
+	FrameData& frame = frames[current_frame];
+
+	Scope& scope = frame.scopes[index];
+	scope.cpu_end = std::chrono::high_resolution_clock::now();
+
+#ifndef GL_DIST_BUILD
+	TraceRecorder::add_event(scope.name, "profiler", scope.cpu_begin, scope.cpu_end);
+#endif
+
+	if (statistics_scope == index) {
+		backend->command_end_query(p_cmd, frame.statistics_query_pool, index);
+		statistics_scope = PROFILE_SCOPE_NO_PARENT;
+	}
+
+	if (frame.query_pool) {
+		backend->command_write_timestamp(p_cmd, frame.query_pool, index * 2 + 1);
+	}
+}
+
+const std::vector<ProfileScopeResult>& Profiler::get_results() const { return results; }
+
+
+uint64_t Profiler::get_results_frame_index() const { return results_frame_index; }
+
+uint32_t Profiler::_get_recorded_parent() const {
+	for (auto it = scope_stack.rbegin(); it != scope_stack.rend(); it++) {
+		if (*it != PROFILE_SCOPE_NO_PARENT) {
+			return *it;
+		}
+	}
+	return PROFILE_SCOPE_NO_PARENT;
+}
+
+void Profiler::_resolve_frame(FrameData& p_frame) {
+	const uint32_t scope_count = static_cast<uint32_t>(p_frame.scopes.size());
+
+	bool gpu_results_ready = false;
+	if (p_frame.query_pool && scope_count > 0) {
+		gpu_results_ready = backend->query_pool_get_results(
+				p_frame.query_pool, 0, scope_count * 2, timestamps.data());
+	}
+
+	// GPU and CPU clocks are not calibrated against each other, the GPU
+	// timeline of the frame is anchored to the moment its first scope was
+	// recorded when exporting to the trace.
+	const bool export_gpu_trace = gpu_results_ready && TraceRecorder::is_enabled();
+
+	results.resize(scope_count);
+	for (uint32_t i = 0; i < scope_count; i++) {
+		const Scope& scope = p_frame.scopes[i];
+
+		ProfileScopeResult& result = results[i];
+		result.name = scope.name;
+		result.depth = scope.depth;
+		result.parent = scope.parent;
+		result.cpu_time_ms =
+				std::chrono::duration<double, std::milli>(scope.cpu_end - scope.cpu_begin).count();
+
+		// GPU timings are left zeroed if the frame has not finished executing
+		result.gpu_time_ms = 0.0;
+		if (gpu_results_ready) {
+			// Masking the difference drops the garbage bits and keeps it right
+			// when the counter wrapped in between
+			const uint64_t ticks = (timestamps[i * 2 + 1] - timestamps[i * 2]) & timestamp_mask;
+			result.gpu_time_ms = static_cast<double>(ticks) * timestamp_period / 1e6;
+		}
+
+		if (export_gpu_trace) {
+			const auto offset = std::chrono::nanoseconds(static_cast<int64_t>(
+					static_cast<double>((timestamps[i * 2] - timestamps[0]) & timestamp_mask) *
+					timestamp_period));
+			const auto duration = std::chrono::nanoseconds(
+					static_cast<int64_t>(result.gpu_time_ms * 1e6));
+
+			const TracePoint gpu_begin = p_frame.scopes[0].cpu_begin +
+					std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(
+							offset);
+			const TracePoint gpu_end = gpu_begin +
+					std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(
+							duration);
+
+			TraceRecorder::add_event(scope.name, "gpu", gpu_begin, gpu_end, TRACE_GPU_THREAD_ID);
+		}
+
+		// Statistics queries are resolved one by one since only some of them
+		// have been written and unwritten queries never become available.
+		result.statistics.reset();
+		if (scope.has_statistics) {
+			PipelineStatistics statistics = {};
+			if (backend->query_pool_get_results(
+						p_frame.statistics_query_pool, i, 1, (uint64_t*)&statistics)) {
+				result.statistics = statistics;
+			}
+		}
+	}
+
+	results_frame_index = p_frame.frame_index;
+}
+
+} //namespace gl
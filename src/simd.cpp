@@ -0,0 +1,67 @@
+#include "glgpu/simd.h"
+
+#if defined(_MSC_VER) && defined(GL_SIMD_SSE)
+#include <intrin.h>
+#endif
+
+namespace gl {
+
+static SimdLevel _detect_simd_level() {
+#if defined(GL_SIMD_SSE)
+#if defined(_MSC_VER)
+	int info[4] = {};
+	__cpuid(info, 1);
+	const bool fma = info[2] & (1 << 12);
+	const bool osxsave = info[2] & (1 << 27);
+	const bool f16c = info[2] & (1 << 29);
+
+	__cpuidex(info, 7, 0);
+	const bool avx2 = info[1] & (1 << 5);
+
+	// The OS has to save the upper halves of the ymm registers as well
+	const bool ymm_enabled = osxsave && (_xgetbv(0) & 0x6) == 0x6;
+
+	if (avx2 && fma && f16c && ymm_enabled) {
+		return SimdLevel::AVX2;
+	}
+#else
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") &&
+			__builtin_cpu_supports("f16c")) {
+		return SimdLevel::AVX2;
+	}
+#endif
+	return SimdLevel::BASELINE;
+#elif defined(GL_SIMD_NEON)
+	return SimdLevel::BASELINE;
+#else
+	return SimdLevel::SCALAR;
+#endif
+}
+
+static const SimdLevel s_supported_level = _detect_simd_level();
+static std::atomic<SimdLevel> s_level = s_supported_level;
+
+SimdLevel simd_get_level() { return s_level.load(std::memory_order_relaxed); }
+
+void simd_set_level(SimdLevel p_level) {
+	s_level.store(std::min(p_level, s_supported_level), std::memory_order_relaxed);
+}
+
+const char* simd_level_to_string(SimdLevel p_level) {
+	switch (p_level) {
+		case SimdLevel::SCALAR:
+			return "scalar";
+		case SimdLevel::BASELINE:
+#if defined(GL_SIMD_NEON)
+			return "neon";
+#else
+			return "sse2";
+#endif
+		case SimdLevel::AVX2:
+			return "avx2";
+		default:
+			return "unknown";
+	}
+}
+
+} //namespace gl
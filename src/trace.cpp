@@ -0,0 +1,154 @@
+#include "glgpu/trace.h"
+
+namespace gl {
+
+// Upper bound of the recorded events to keep memory usage in check when
+// recording is left enabled, ~64MB worth of events.
+constexpr size_t TRACE_MAX_EVENTS = 1 << 20;
+
+static std::atomic<bool> s_enabled = false;
+static std::atomic<uint32_t> s_thread_counter = 0;
+static std::atomic<uint64_t> s_dropped_events = 0;
+
+static std::mutex s_events_mutex;
+static std::vector<TraceEvent> s_events;
+static TracePoint s_origin;
+
+static std::string _escape_json(const std::string& p_str) {
+	std::string escaped;
+	escaped.reserve(p_str.size());
+
+	for (const char c : p_str) {
+		switch (c) {
+			case '"':
+				escaped += "\\\"";
+				break;
+			case '\\':
+				escaped += "\\\\";
+				break;
+			case '\n':
+				escaped += "\\n";
+				break;
+			case '\t':
+				escaped += "\\t";
+				break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20) {
+					escaped += std::format("\\u{:04x}", c);
+				} else {
+					escaped += c;
+				}
+				break;
+		}
+	}
+
+	return escaped;
+}
+
+void TraceRecorder::set_enabled(bool p_enabled) {
+	std::scoped_lock lock(s_events_mutex);
+
+	if (p_enabled && !s_enabled) {
+		s_origin = std::chrono::high_resolution_clock::now();
+		s_events.clear();
+		s_dropped_events = 0;
+	}
+
+	s_enabled = p_enabled;
+}
+
+bool TraceRecorder::is_enabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+void TraceRecorder::add_event(const char* p_name, const char* p_category, TracePoint p_begin,
+		TracePoint p_end, uint32_t p_thread_id) {
+	if (!is_enabled()) {
+		return;
+	}
+
+	std::scoped_lock lock(s_events_mutex);
+
+	if (s_events.size() >= TRACE_MAX_EVENTS) {
+		s_dropped_events++;
+		return;
+	}
+
+	// Events that started before recording began are clamped to the origin
+	const auto begin = std::max(p_begin, s_origin);
+	const auto end = std::max(p_end, begin);
+
+	TraceEvent event = {};
+	event.name = p_name;
+	event.category = p_category;
+	event.thread_id = p_thread_id;
+	event.begin_us =
+			std::chrono::duration_cast<std::chrono::microseconds>(begin - s_origin).count();
+	event.duration_us = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+
+	s_events.push_back(std::move(event));
+}
+
+uint32_t TraceRecorder::get_thread_id() {
+	thread_local const uint32_t thread_id = s_thread_counter++;
+	return thread_id;
+}
+
+uint64_t TraceRecorder::get_dropped_event_count() { return s_dropped_events; }
+
+void TraceRecorder::clear() {
+	std::scoped_lock lock(s_events_mutex);
+
+	s_origin = std::chrono::high_resolution_clock::now();
+	s_events.clear();
+	s_dropped_events = 0;
+}
+
+bool TraceRecorder::write_chrome_trace(const std::filesystem::path& p_path) {
+	std::ofstream file(p_path);
+	if (!file.is_open()) {
+		GL_LOG_ERROR("[TRACE] Unable to open file '{}' for writing.", p_path.string());
+		return false;
+	}
+
+	std::scoped_lock lock(s_events_mutex);
+
+	std::set<uint32_t> thread_ids;
+
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+	bool first = true;
+	for (const TraceEvent& event : s_events) {
+		if (!first) {
+			file << ",";
+		}
+		first = false;
+
+		file << std::format("\n{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"ts\":{},\"dur\":{},"
+							"\"pid\":0,\"tid\":{}}}",
+				_escape_json(event.name), event.category, event.begin_us, event.duration_us,
+				event.thread_id);
+
+		thread_ids.insert(event.thread_id);
+	}
+
+	// Name the tracks so the GPU timeline is distinguishable
+	for (const uint32_t thread_id : thread_ids) {
+		if (!first) {
+			file << ",";
+		}
+		first = false;
+
+		const std::string thread_name = thread_id == TRACE_GPU_THREAD_ID
+				? "GPU"
+				: std::format("Thread {}", thread_id);
+
+		file << std::format("\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":{},"
+							"\"args\":{{\"name\":\"{}\"}}}}",
+				thread_id, thread_name);
+	}
+
+	file << "\n]}\n";
+
+	return file.good();
+}
+
+} //namespace gl
@@ -68,6 +68,8 @@ size_t get_data_format_size(DataFormat format) {
 		case DataFormat::A8B8G8R8_UINT_PACK32:
 		case DataFormat::A8B8G8R8_SINT_PACK32:
 		case DataFormat::A8B8G8R8_SRGB_PACK32:
+		case DataFormat::A2B10G10R10_UNORM_PACK32:
+		case DataFormat::A2B10G10R10_SNORM_PACK32:
 		case DataFormat::R16G16_UNORM:
 		case DataFormat::R16G16_SNORM:
 		case DataFormat::R16G16_USCALED:
@@ -120,4 +122,13 @@ bool is_depth_format(DataFormat format) {
 			format == DataFormat::D16_UNORM || format == DataFormat::D32_SFLOAT);
 }
 
+uint32_t get_query_result_count(QueryType p_type) {
+	switch (p_type) {
+		case QueryType::PIPELINE_STATISTICS:
+			return sizeof(PipelineStatistics) / sizeof(uint64_t);
+		default:
+			return 1;
+	}
+}
+
 } //namespace gl
\ No newline at end of file
@@ -54,9 +54,13 @@ int main(void) {
 	CommandQueue graphics_queue = backend->queue_get(QueueType::GRAPHICS);
 	CommandQueue present_queue = backend->queue_get(QueueType::PRESENT);
 
+	SwapchainCreateInfo swapchain_info = {};
+	swapchain_info.size = { WINDOW_WIDTH, WINDOW_HEIGHT };
+	swapchain_info.present_mode = PresentMode::FIFO;
+	swapchain_info.max_frame_latency = 2;
+
 	Swapchain swapchain = backend->swapchain_create();
-	backend->swapchain_resize(
-			graphics_queue, swapchain, { WINDOW_WIDTH, WINDOW_HEIGHT }, true /* vsync */);
+	backend->swapchain_resize(graphics_queue, swapchain, swapchain_info);
 
 	// Create Command Pool and Buffer
 	CommandPool cmd_pool = backend->command_pool_create(graphics_queue);
@@ -77,29 +81,41 @@ int main(void) {
 				quit = true;
 			}
 			if (e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_RESIZED) {
-				backend->device_wait();
-				backend->swapchain_resize(graphics_queue, swapchain,
-						{ (uint32_t)e.window.data1, (uint32_t)e.window.data2 }, true);
+				swapchain_info.size = { (uint32_t)e.window.data1, (uint32_t)e.window.data2 };
+				backend->swapchain_resize(graphics_queue, swapchain, swapchain_info);
 			}
 		}
 
 		// Wait for the previous frame to finish processing on the CPU side
 		backend->fence_wait(frame_fence);
-		backend->fence_reset(frame_fence);
 
 		// Acquire the next image from the swapchain
 		// This tells the GPU: "Give me an image index I can draw into."
 		// It signals 'image_available_sem' when the image is actually ready to be written to.
+		// Waits at most a millisecond so window events keep being handled while
+		// the presentation engine holds on to every image.
+		constexpr uint64_t ACQUIRE_TIMEOUT_NS = 1'000'000;
+
 		uint32_t image_index = 0;
-		auto acquire_result =
-				backend->swapchain_acquire_image(swapchain, image_available_sem, &image_index);
+		auto acquire_result = backend->swapchain_acquire_image(
+				swapchain, image_available_sem, ACQUIRE_TIMEOUT_NS, &image_index);
 
+		if (!acquire_result && acquire_result.get_error() == Error::NOT_READY) {
+			continue;
+		}
 		if (!acquire_result) {
-			// If acquire failed (e.g. window resized), handle it or skip frame
+			// Out of date, recreate and skip the frame. The fence is still
+			// signaled since nothing was submitted.
+			int width = 0, height = 0;
+			SDL_GetWindowSize(window, &width, &height);
+			swapchain_info.size = { (uint32_t)width, (uint32_t)height };
+			backend->swapchain_resize(graphics_queue, swapchain, swapchain_info);
 			continue;
 		}
 		Image swapchain_image = *acquire_result;
 
+		backend->fence_reset(frame_fence);
+
 		// Record Commands
 		backend->command_reset(cmd);
 		backend->command_begin(cmd);
@@ -133,7 +149,14 @@ int main(void) {
 
 		// Present the image to the screen
 		// Waits for 'render_finished_sem'
-		backend->queue_present(present_queue, swapchain, render_finished_sem);
+		// Fails once the swapchain went suboptimal or out of date, the frame is
+		// shown if possible and the swapchain recreated before the next one
+		if (!backend->queue_present(present_queue, swapchain, render_finished_sem)) {
+			int width = 0, height = 0;
+			SDL_GetWindowSize(window, &width, &height);
+			swapchain_info.size = { (uint32_t)width, (uint32_t)height };
+			backend->swapchain_resize(graphics_queue, swapchain, swapchain_info);
+		}
 	}
 
 	// Wait for GPU to finish all operations before destroying resources